@@ -30,6 +30,8 @@
 
 namespace cphd
 {
+class ThreadPool;
+
 /*
  * Threaded byte-swapping
  *
@@ -37,24 +39,30 @@ namespace cphd
  * \param elemSize Size of each element in 'buffer'
  * \param numElements Number of elements in 'buffer'
  * \param numThreads Number of threads to use for byte-swapping
+ * \param threadPool Optional pool to do the work on.  If provided,
+ *        'numThreads' is ignored.  Otherwise new threads are started for
+ *        this call.  This applies to the functions below as well.
  */
 void byteSwap(void* buffer,
               size_t elemSize,
               size_t numElements,
-              size_t numThreads);
+              size_t numThreads,
+              ThreadPool* threadPool = NULL);
 
 void byteSwapAndPromote(const void* input,
                         size_t elementSize,
                         const types::RowCol<size_t>& dims,
                         size_t numThreads,
-                        std::complex<float>* output);
+                        std::complex<float>* output,
+                        ThreadPool* threadPool = NULL);
 
 void byteSwapAndScale(const void* input,
                       size_t elementSize,
                       const types::RowCol<size_t>& dims,
                       const double* scaleFactors,
                       size_t numThreads,
-                      std::complex<float>* output);
+                      std::complex<float>* output,
+                      ThreadPool* threadPool = NULL);
 }
 
 #endif
@@ -26,8 +26,10 @@
 #include <memory>
 
 #include <sys/Conf.h>
+#include <sys/Mutex.h>
 #include <cphd/Metadata.h>
 #include <cphd/FileHeader.h>
+#include <cphd/ThreadPool.h>
 #include <cphd/VBM.h>
 #include <cphd/Wideband.h>
 
@@ -36,39 +38,81 @@ namespace cphd
 class CPHDReader
 {
 public:
+    /*
+     *  How much of the file the constructors read.  Anything that isn't
+     *  read up front is read the first time it's asked for, so opening a
+     *  large file to look at one channel only costs what that channel
+     *  needs.
+     *
+     *  Reading on demand uses the same stream as the Wideband, so it
+     *  shouldn't be done while the Wideband is being read from another
+     *  thread.
+     */
+    enum LoadMode
+    {
+        //! The file header, the XML, and the VBM for every channel
+        LOAD_ALL,
+
+        //! The file header and the XML.  Each channel of the VBM is read
+        //  the first time getVBM() is called for it.
+        LOAD_METADATA,
+
+        //! Only the file header.  The XML is parsed the first time the
+        //  metadata is needed, and the VBM is read as in LOAD_METADATA.
+        LOAD_HEADER
+    };
+
     //!  Constructor
     // Provides access to wideband but doesn't read it
     CPHDReader(mem::SharedPtr<io::SeekableInputStream> inStream,
                size_t numThreads,
                mem::SharedPtr<logging::Logger> logger =
-                       mem::SharedPtr<logging::Logger>());
+                       mem::SharedPtr<logging::Logger>(),
+               LoadMode loadMode = LOAD_ALL);
 
     CPHDReader(const std::string& fromFile,
                size_t numThreads,
                mem::SharedPtr<logging::Logger> logger =
-                       mem::SharedPtr<logging::Logger>());
+                       mem::SharedPtr<logging::Logger>(),
+               LoadMode loadMode = LOAD_ALL);
+
+    // Same as above, but all threaded work (loading the VBM and any
+    // conversion done by the Wideband's reads) is done on 'threadPool'
+    // rather than on newly created threads.  The pool may be shared
+    // across readers.
+    CPHDReader(mem::SharedPtr<io::SeekableInputStream> inStream,
+               mem::SharedPtr<ThreadPool> threadPool,
+               mem::SharedPtr<logging::Logger> logger =
+                       mem::SharedPtr<logging::Logger>(),
+               LoadMode loadMode = LOAD_ALL);
+
+    CPHDReader(const std::string& fromFile,
+               mem::SharedPtr<ThreadPool> threadPool,
+               mem::SharedPtr<logging::Logger> logger =
+                       mem::SharedPtr<logging::Logger>(),
+               LoadMode loadMode = LOAD_ALL);
 
     size_t getNumChannels() const
     {
-        return mMetadata->getNumChannels();
+        return getMetadata().getNumChannels();
     }
 
     // 0-based channel number
     size_t getNumVectors(size_t channel) const
     {
-        return mMetadata->getNumVectors(channel);
+        return getMetadata().getNumVectors(channel);
     }
 
     // 0-based channel number
     size_t getNumSamples(size_t channel) const
     {
-        return mMetadata->getNumSamples(channel);
+        return getMetadata().getNumSamples(channel);
     }
 
     // returns total per complex sample (2, 4, or 8)
     size_t getNumBytesPerSample() const
     {
-        return mMetadata->getNumBytesPerSample();
+        return getMetadata().getNumBytesPerSample();
     }
 
     // Return offset from start of CPHD file for a vector and sample for a channel
@@ -77,7 +121,7 @@ public:
     // 0-based sample in channel
     sys::Off_T getFileOffset(size_t channel, size_t vector, size_t sample) const
     {
-        return mWideband->getFileOffset(channel, vector, sample);
+        return getWidebandImpl().getFileOffset(channel, vector, sample);
     }
 
     bool isFX() const
@@ -99,7 +143,7 @@ public:
     // returns enum for FX, TOA, or NOT_SET
     cphd::DomainType getDomainType() const
     {
-        return mMetadata->getDomainType();
+        return getMetadata().getDomainType();
     }
 
     // Functions required to access Header, Metadata, VBP and PH data
@@ -108,32 +152,52 @@ public:
         return mFileHeader;
     }
 
-    const Metadata& getMetadata() const
-    {
-        return *mMetadata;
-    }
+    const Metadata& getMetadata() const;
 
-    const VBM& getVBM() const
-    {
-        return *mVBM;
-    }
+    // Reads in any channels of the VBM that haven't been yet
+    const VBM& getVBM() const;
+
+    // Reads in just this channel of the VBM if it hasn't been yet.  Other
+    // channels of the returned VBM may not be loaded (see VBM::isLoaded()).
+    const VBM& getVBM(size_t channel) const;
 
     Wideband& getWideband()
     {
-        return *mWideband;
+        return getWidebandImpl();
     }
 
 private:
-    // Keep info about the CPHD collection
-    FileHeader mFileHeader;
-    std::auto_ptr<Metadata> mMetadata;
-    std::auto_ptr<VBM> mVBM;
-    std::auto_ptr<Wideband> mWideband;
+    // Unimplemented - the lazily loaded members aren't copyable
+    CPHDReader(const CPHDReader& other);
+    CPHDReader& operator=(const CPHDReader& other);
+
+    // Assumes mMutex is held
+    void loadMetadata() const;
+
+    // Assumes mMutex is held
+    void loadVBMChannel(size_t channel) const;
+
+    Wideband& getWidebandImpl() const;
 
     void initialize(mem::SharedPtr<io::SeekableInputStream> inStream,
                     size_t numThreads,
-                    mem::SharedPtr<logging::Logger> logger);
+                    mem::SharedPtr<ThreadPool> threadPool,
+                    mem::SharedPtr<logging::Logger> logger,
+                    LoadMode loadMode);
 
+private:
+    mem::SharedPtr<io::SeekableInputStream> mInStream;
+    size_t mNumThreads;
+    mem::SharedPtr<ThreadPool> mThreadPool;
+    mem::SharedPtr<logging::Logger> mLogger;
+
+    // Keep info about the CPHD collection.  All but the file header may
+    // be read on demand.
+    FileHeader mFileHeader;
+    mutable std::auto_ptr<Metadata> mMetadata;
+    mutable std::auto_ptr<VBM> mVBM;
+    mutable std::auto_ptr<Wideband> mWideband;
+    mutable sys::Mutex mMutex;
 };
 }
 
@@ -27,6 +27,8 @@
 #include <vector>
 
 #include <sys/Conf.h>
+#include <sys/File.h>
+#include <sys/Mutex.h>
 #include <mem/SharedPtr.h>
 #include <cphd/Metadata.h>
 #include <types/RowCol.h>
@@ -172,12 +174,67 @@ public:
                const std::string& classification = "",
                const std::string& releaseInfo = "");
 
+    /*
+     *  \func openForRandomAccess
+     *  \brief Writes the header, metadata, and VBM into the file and sizes
+     *         it to hold all of the CPHD data, which can then be written
+     *         in any order with writeCPHDData(data, channel, firstVector,
+     *         numVectors).  Use this instead of writeMetadata when the data
+     *         isn't produced in file order.
+     *
+     *  \param pathname The desired pathname of the file.
+     *  \param vbm The vector based metadata to write.
+     *  \param classification The classification of the file. Optional
+     *         By default, CPHD will not be populated with this value.
+     *  \param releaseInfo The release information for the file. Optional
+     *         By default, CPHD will not be populated with this value.
+     */
+    void openForRandomAccess(const std::string& pathname,
+                             const VBM& vbm,
+                             const std::string& classification = "",
+                             const std::string& releaseInfo = "");
+
+    /*
+     *  \func writeCPHDData
+     *  \brief Writes a block of vectors of one channel to their place in
+     *         the file.  openForRandomAccess must be called first.  Blocks
+     *         may be written in any order, and may be written from
+     *         multiple threads at once as long as they don't overlap.
+     *         Byte swapping is done on the calling thread.  This only works
+     *         with valid CPHDWriter data types:
+     *              std::complex<float>
+     *              std::complex<sys::Int16_T>
+     *              std::complex<sys::Int8_T>
+     *
+     *  \param data numVectors * the channel's number of samples elements
+     *  \param channel 0 based channel
+     *  \param firstVector 0 based vector in the channel to start at
+     *  \param numVectors The number of vectors in 'data'
+     */
+    template <typename T>
+    void writeCPHDData(const T* data,
+                       size_t channel,
+                       size_t firstVector,
+                       size_t numVectors);
+
+    /*
+     *  \func getFileOffset
+     *  \brief Returns where a vector of CPHD data goes in the file.  Only
+     *         valid after openForRandomAccess.
+     *
+     *  \param channel 0 based channel
+     *  \param vector 0 based vector in the channel
+     */
+    sys::Off_T getFileOffset(size_t channel, size_t vector) const;
+
     void close()
     {
         if (mOutStream.get())
         {
             mOutStream->close();
         }
+        mFreeHandles.clear();
+        mHandles.clear();
     }
 
 private:
@@ -192,6 +249,23 @@ private:
     void writeCPHDDataImpl(const sys::ubyte* data,
                            size_t size);
 
+    void writeCPHDDataImpl(const sys::ubyte* data,
+                           size_t channel,
+                           size_t firstVector,
+                           size_t numVectors);
+
+    // A file handle and byte swapping scratch for one random access write
+    // at a time
+    struct FileHandle
+    {
+        sys::File file;
+        std::vector<sys::byte> scratch;
+    };
+
+    FileHandle* acquireHandle();
+
+    void releaseHandle(FileHandle* handle);
+
     class DataWriter
     {
     public:
@@ -250,6 +324,16 @@ private:
 
     size_t mCPHDSize;
     size_t mVBMSize;
+
+    // CPHD byte offset from the header written by writeMetadata
+    sys::Off_T mCPHDOffset;
+
+    // Set by openForRandomAccess
+    std::string mPathname;
+    std::vector<sys::Off_T> mChannelOffsets;
+    std::vector<mem::SharedPtr<FileHandle> > mHandles;
+    std::vector<FileHandle*> mFreeHandles;
+    sys::Mutex mHandleMutex;
 };
 }
 
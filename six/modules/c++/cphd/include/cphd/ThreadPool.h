@@ -0,0 +1,140 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __CPHD_THREAD_POOL_H__
+#define __CPHD_THREAD_POOL_H__
+
+#include <memory>
+#include <vector>
+
+#include <mem/SharedPtr.h>
+#include <sys/Runnable.h>
+#include <sys/Thread.h>
+#include <mt/RequestQueue.h>
+
+namespace cphd
+{
+/*!
+ * \class ThreadPool
+ * \brief A fixed set of worker threads that live as long as the pool does.
+ *
+ * The byte swapping, promotion, and scaling in Wideband and VBM normally
+ * start up new threads on every call.  When reading many small blocks, the
+ * cost of creating those threads can rival the work itself, so a pool can
+ * be created once and handed to Wideband (or CPHDReader) instead.
+ *
+ * A pool may be shared by any number of readers.  Calls to run() from
+ * different threads share the workers, and each one returns as soon as its
+ * own runnables are done.
+ */
+class ThreadPool
+{
+public:
+    /*!
+     * Starts the worker threads
+     *
+     * \param numThreads Number of worker threads.  Must be at least 1.
+     */
+    explicit ThreadPool(size_t numThreads);
+
+    //! Stops and joins the worker threads
+    ~ThreadPool();
+
+    size_t getNumThreads() const
+    {
+        return mNumThreads;
+    }
+
+    /*!
+     * Runs each of the runnables on the pool and waits for all of them to
+     * finish.
+     *
+     * \param runnables The runnables to run.  These are deleted as they
+     * complete, and the vector is cleared.
+     *
+     * \throws except::Exception if any of the runnables threw.  The rest of
+     * them still run to completion first.
+     */
+    void run(std::vector<sys::Runnable*>& runnables);
+
+private:
+    // Noncopyable
+    ThreadPool(const ThreadPool& );
+    const ThreadPool& operator=(const ThreadPool& );
+
+    // Completion state of one call to run()
+    class Group;
+
+    struct Task
+    {
+        sys::Runnable* runnable;
+        Group* group;
+    };
+
+    class Worker;
+
+    // Has each worker exit once it's done with the tasks ahead of it, and
+    // joins them
+    void stop();
+
+private:
+    const size_t mNumThreads;
+    mt::RequestQueue<Task> mTasks;
+    std::vector<mem::SharedPtr<sys::Thread> > mThreads;
+};
+
+/*!
+ * \class RunnableGroup
+ * \brief Collects runnables and then runs them to completion, either on a
+ * ThreadPool or, if no pool is provided, each on a new thread of its own.
+ */
+class RunnableGroup
+{
+public:
+    /*!
+     * \param threadPool Pool to run on.  If NULL, a thread is started for
+     * each runnable.
+     */
+    explicit RunnableGroup(ThreadPool* threadPool);
+
+    //! Deletes any runnables that were never run
+    ~RunnableGroup();
+
+    //! Takes ownership of 'runnable'
+    void add(std::auto_ptr<sys::Runnable> runnable);
+
+    //! Runs all the runnables that have been added and waits for them
+    void run();
+
+private:
+    // Noncopyable
+    RunnableGroup(const RunnableGroup& );
+    const RunnableGroup& operator=(const RunnableGroup& );
+
+private:
+    ThreadPool* const mThreadPool;
+    std::vector<sys::Runnable*> mRunnables;
+};
+}
+
+#endif
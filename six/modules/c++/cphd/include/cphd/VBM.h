@@ -27,7 +27,7 @@
 
 #include <sys/Conf.h>
 #include <io/SeekableStreams.h>
-#include <mem/ScopedCopyablePtr.h>
+#include <cphd/ThreadPool.h>
 #include <cphd/Types.h>
 #include <cphd/Data.h>
 #include <cphd/VectorParameters.h>
@@ -59,8 +59,11 @@ public:
      *         per vector regardless of the optional values.
      *  \param vp A filled out vector parameters struct. This will be
      *         used to populate the correct optional parameters.
+     *  \param allocate If false, no memory is set aside for the channels
+     *         until they're read in with load() or loadChannel().  Until
+     *         then, only the sizes of the VBM are available.
     */
-    VBM(const Data& data, const VectorParameters &vp);
+    VBM(const Data& data, const VectorParameters &vp, bool allocate = true);
 
     /*
      *  \func Constructor
@@ -130,6 +133,27 @@ public:
     void setDeltaTOA0(double value, size_t channel, size_t vector);
     void setTOASS(double value, size_t channel, size_t vector);
 
+    /*
+     *  Whole-channel access to a VBM parameter.  These return a pointer to
+     *  getNumVectors(channel) contiguous values, which remains valid until
+     *  the VBM is modified or destroyed.  Requests for parameters that
+     *  aren't present throw exceptions, as above.
+     */
+    const double* getTxTimes(size_t channel) const;
+    const Vector3* getTxPositions(size_t channel) const;
+    const double* getRcvTimes(size_t channel) const;
+    const Vector3* getRcvPositions(size_t channel) const;
+    const double* getSRPTimes(size_t channel) const;
+    const Vector3* getSRPPositions(size_t channel) const;
+    const double* getTropoSRPs(size_t channel) const;
+    const double* getAmpSFs(size_t channel) const;
+    const double* getFx0s(size_t channel) const;
+    const double* getFxSSs(size_t channel) const;
+    const double* getFx1s(size_t channel) const;
+    const double* getFx2s(size_t channel) const;
+    const double* getDeltaTOA0s(size_t channel) const;
+    const double* getTOASSs(size_t channel) const;
+
     // More convenience functions
 
     /*
@@ -150,6 +174,13 @@ public:
         return mData.size();
     }
 
+    // Returns the number of vectors in a channel.
+    size_t getNumVectors(size_t channel) const;
+
+    // Returns true if a channel's parameters are in memory.  Accessing the
+    // parameters of a channel that isn't throws an exception.
+    bool isLoaded(size_t channel) const;
+
     void clearAmpSF();
 
     bool haveSRPTime() const
@@ -180,10 +211,33 @@ public:
     // Read the entire VBM, return number of bytes read or -1 if error
     // startVBM = cphd header keyword "VB_BYTE_OFFSET"
     // sizeVBM = cphd header keyword "VB_DATA_SIZE"
+    // If threadPool is provided, byte swapping is done on it and
+    // numThreads is ignored
     sys::Off_T load(io::SeekableInputStream& inStream,
                     sys::Off_T startVBM,
                     sys::Off_T sizeVBM,
-                    size_t numThreads);
+                    size_t numThreads,
+                    ThreadPool* threadPool = NULL);
+
+    /*
+     *  \func loadChannel
+     *  \brief Reads a single channel of the VBM, leaving the others as they
+     *         are.
+     *
+     *  \param inStream The CPHD file
+     *  \param startVBM cphd header keyword "VB_BYTE_OFFSET"
+     *  \param channel 0 based index
+     *  \param numThreads Number of threads to byte swap on
+     *  \param threadPool If provided, byte swapping is done on it and
+     *         numThreads is ignored
+     *
+     *  \return The number of bytes read
+     */
+    sys::Off_T loadChannel(io::SeekableInputStream& inStream,
+                           sys::Off_T startVBM,
+                           size_t channel,
+                           size_t numThreads,
+                           ThreadPool* threadPool = NULL);
 
     /*
      *  \func getVBMdata
@@ -221,6 +275,8 @@ public:
                mAmpSFEnabled == other.mAmpSFEnabled &&
                mDomainType == other.mDomainType &&
                mNumBytesPerVector == other.mNumBytesPerVector &&
+               mNumVectors == other.mNumVectors &&
+               mLoaded == other.mLoaded &&
                mData == other.mData;
     }
 
@@ -230,82 +286,65 @@ public:
     }
 
 private:
-    struct FrequencyParameters
+    // Vector based parameters for one channel, stored one array per
+    // parameter rather than one struct per vector.  Arrays for parameters
+    // that aren't enabled are left empty.
+    struct ChannelData
     {
-        FrequencyParameters();
-
-        bool operator==(const FrequencyParameters& other) const
-        {
-            return fx0 == other.fx0 &&
-                   fxSS == other.fxSS &&
-                   fx1 == other.fx1 &&
-                   fx2 == other.fx2;
-        }
+        void resize(size_t numVectors,
+                    bool srpTimeEnabled,
+                    bool tropoSrpEnabled,
+                    bool ampSFEnabled,
+                    DomainType domainType);
 
-        bool operator!=(const FrequencyParameters& other) const
+        size_t size() const
         {
-            return !((*this) == other);
+            return txTime.size();
         }
 
-        double fx0;
-        double fxSS;
-        double fx1;
-        double fx2;
-    };
+        // Copy to/from the packed, per-vector layout used in the file
+        void getData(size_t numBytesPerVector, sys::ubyte* data) const;
 
-    struct TOAParameters
-    {
-        TOAParameters();
+        void setData(size_t numBytesPerVector, const sys::ubyte* data);
 
-        bool operator==(const TOAParameters& other) const
-        {
-            return deltaTOA0 == other.deltaTOA0 &&
-                   toaSS == other.toaSS;
-        }
+        bool operator==(const ChannelData& other) const;
 
-        bool operator!=(const TOAParameters& other) const
+        bool operator!=(const ChannelData& other) const
         {
             return !((*this) == other);
         }
 
-        double deltaTOA0;
-        double toaSS;
+        std::vector<double> txTime;
+        std::vector<Vector3> txPos;
+        std::vector<double> rcvTime;
+        std::vector<Vector3> rcvPos;
+        std::vector<double> srpTime;
+        std::vector<Vector3> srpPos;
+        std::vector<double> tropoSrp;
+        std::vector<double> ampSF;
+        std::vector<double> fx0;
+        std::vector<double> fxSS;
+        std::vector<double> fx1;
+        std::vector<double> fx2;
+        std::vector<double> deltaTOA0;
+        std::vector<double> toaSS;
     };
 
-    struct VectorBasedParameters
-    {
-        VectorBasedParameters(bool srpTimeEnabled,
-                              bool tropoSrpEnabled,
-                              bool ampSFEnabled, 
-                              DomainType domainType);
-
-        size_t getNumBytes() const;
-
-        void getData(sys::ubyte* data) const;
-
-        void setData(const sys::byte* data);
-
-        bool operator==(const VectorBasedParameters& other) const;
+    size_t calculateNumBytesPerVector() const;
 
-        bool operator!=(const VectorBasedParameters& other) const
-        {
-            return !((*this) == other);
-        }
-
-        double txTime;
-        Vector3 txPos;
-        double rcvTime;
-        Vector3 rcvPos;
-        double srpTime;
-        Vector3 srpPos;
-        double tropoSrp;
-        double ampSF;
-        mem::ScopedCopyablePtr<FrequencyParameters> frequencyParameters;
-        mem::ScopedCopyablePtr<TOAParameters> toaParameters;
-    };
+    // Only checks that the channel and vector exist
+    void verifyRange(size_t channel, size_t vector) const;
 
+    // Also checks that the channel is loaded
     void verifyChannelVector(size_t channel, size_t vector) const;
 
+    // Reads a channel from the current position of 'inStream'
+    sys::Off_T readChannel(io::SeekableInputStream& inStream,
+                           size_t channel,
+                           size_t numThreads,
+                           ThreadPool* threadPool,
+                           std::vector<sys::ubyte>& scratch);
+
     void setupInitialData(size_t numChannels,
                           const std::vector<size_t>& numVectors);
 
@@ -315,9 +354,15 @@ private:
     DomainType mDomainType;
     size_t mNumBytesPerVector;
 
-    // One vector of VectorBasedParameters per channel.
-    // Then one VectorBasedParameter per vector.
-    std::vector<std::vector<VectorBasedParameters> > mData;
+    // One ChannelData per channel
+    std::vector<ChannelData> mData;
+
+    // Kept separately from mData so they're known for unloaded channels
+    std::vector<size_t> mNumVectors;
+
+    // Whether each channel of mData is populated.  Not a vector<bool> so
+    // that different channels can be loaded from different threads.
+    std::vector<char> mLoaded;
 
     friend std::ostream& operator<< (std::ostream& os, const VBM& d);
 };
@@ -28,6 +28,7 @@
 
 #include <sys/Conf.h>
 #include <cphd/Data.h>
+#include <cphd/ThreadPool.h>
 #include <mem/ScopedArray.h>
 #include <mem/SharedPtr.h>
 #include <io/SeekableStreams.h>
@@ -157,6 +158,26 @@ public:
         return mData.sampleType;
     }
 
+    /*
+     *  \func setThreadPool
+     *  \brief Has all subsequent reads do their byte swapping, promotion,
+     *         and scaling on 'threadPool' rather than starting new threads.
+     *         The numThreads argument to read() is then ignored.
+     *
+     *  \param threadPool The pool to use.  This may be shared with other
+     *         readers.  Pass an empty pointer to go back to creating
+     *         threads for each read.
+     */
+    void setThreadPool(mem::SharedPtr<ThreadPool> threadPool)
+    {
+        mThreadPool = threadPool;
+    }
+
+    mem::SharedPtr<ThreadPool> getThreadPool() const
+    {
+        return mThreadPool;
+    }
+
 private:
     void initialize();
 
@@ -192,6 +213,7 @@ private:
     const size_t mElementSize;        // element size (bytes / complex sample)
 
     std::vector<sys::Off_T> mOffsets; // Offset to start of each channel
+    mem::SharedPtr<ThreadPool> mThreadPool;
 
     friend std::ostream& operator<< (std::ostream& os, const Wideband& d);
 };
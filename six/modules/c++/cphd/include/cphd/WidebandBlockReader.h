@@ -0,0 +1,156 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef __CPHD_WIDEBAND_BLOCK_READER_H__
+#define __CPHD_WIDEBAND_BLOCK_READER_H__
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <sys/Thread.h>
+#include <mt/RequestQueue.h>
+#include <cphd/CPHDReader.h>
+
+namespace cphd
+{
+/*!
+ * \class WidebandBlockReader
+ * \brief Streams one channel of a CPHD a block of vectors at a time.
+ *
+ * A background thread reads ahead of the caller, filling a ring of reusable
+ * buffers with the next several blocks.  Each block is already promoted to
+ * complex<float> and, if requested, scaled by the AmpSF from the VBM.  This
+ * hides disk latency behind whatever the caller does with each block, and
+ * only ever holds numBlocksToPrefetch + 1 blocks in memory.
+ *
+ * While a WidebandBlockReader exists, the CPHDReader's Wideband must not be
+ * used for other reads since they would share its input stream.
+ *
+ * This class is not copyable.
+ */
+class WidebandBlockReader
+{
+public:
+    //! One block of vectors.  'data' holds numVectors * numSamples samples.
+    struct Block
+    {
+        size_t firstVector;
+        size_t numVectors;
+        size_t numSamples;
+        const std::complex<float>* data;
+    };
+
+    /*!
+     * Starts prefetching the first blocks of the channel
+     *
+     * \param reader Reader for the CPHD.  Must outlive this object.
+     * \param channel 0-based channel to read
+     * \param numVectorsPerBlock Number of vectors in each block.  The last
+     * block of the channel may be smaller.
+     * \param numBlocksToPrefetch Number of blocks to read ahead of the one
+     * the caller is working on.  Must be at least 1.
+     * \param applyAmpSF If true, scale each vector by its AmpSF.  Throws if
+     * the VBM has no AmpSF.
+     * \param numThreads Number of threads to convert each block with.  If
+     * the Wideband has a ThreadPool, that is used instead.
+     */
+    WidebandBlockReader(CPHDReader& reader,
+                        size_t channel,
+                        size_t numVectorsPerBlock,
+                        size_t numBlocksToPrefetch,
+                        bool applyAmpSF,
+                        size_t numThreads);
+
+    //! Stops the background thread
+    ~WidebandBlockReader();
+
+    /*!
+     * Waits for the next block to be read.  The block's data remains valid
+     * until the next call to next() (or until this object is destroyed), at
+     * which point its buffer is handed back for prefetching.
+     *
+     * \param[out] block The next block
+     *
+     * \return False once every block in the channel has been returned
+     *
+     * \throws except::Exception if reading the block failed
+     */
+    bool next(Block& block);
+
+    //! \return The total number of blocks in the channel
+    size_t getNumBlocks() const
+    {
+        // mNumVectorsPerBlock is clamped to mNumVectors, so it's 0 too for
+        // an empty channel
+        if (mNumVectors == 0)
+        {
+            return 0;
+        }
+        return (mNumVectors + mNumVectorsPerBlock - 1) / mNumVectorsPerBlock;
+    }
+
+private:
+    // Noncopyable
+    WidebandBlockReader(const WidebandBlockReader& );
+    const WidebandBlockReader& operator=(const WidebandBlockReader& );
+
+    class PrefetchRunnable;
+    friend class PrefetchRunnable;
+
+    // Runs on the background thread
+    void prefetch();
+
+    void releaseCurrentBuffer();
+
+    void stop();
+
+private:
+    Wideband& mWideband;
+    const size_t mChannel;
+    const size_t mNumVectors;
+    const size_t mNumSamples;
+    const size_t mNumVectorsPerBlock;
+    const size_t mNumThreads;
+    std::vector<double> mScaleFactors;
+
+    // The ring of buffers along with which block each one currently holds
+    std::vector<std::vector<std::complex<float> > > mBuffers;
+    std::vector<size_t> mFirstVectors;
+    std::vector<sys::ubyte> mScratch;
+
+    // Buffer indices move from mFreeBuffers to the background thread, to
+    // mReadyBuffers, to the caller (mCurrentBuffer), and back again
+    mt::RequestQueue<size_t> mFreeBuffers;
+    mt::RequestQueue<size_t> mReadyBuffers;
+    size_t mCurrentBuffer;
+    bool mDone;
+    std::string mError;
+
+    std::auto_ptr<sys::Thread> mThread;
+};
+}
+
+#endif
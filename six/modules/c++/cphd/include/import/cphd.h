@@ -34,10 +34,12 @@
 #include "cphd/Global.h"
 #include "cphd/Metadata.h"
 #include "cphd/SRP.h"
+#include "cphd/ThreadPool.h"
 #include "cphd/Types.h"
 #include "cphd/Utilities.h"
 #include "cphd/VBM.h"
 #include "cphd/VectorParameters.h"
 #include "cphd/Wideband.h"
+#include "cphd/WidebandBlockReader.h"
 
 #endif
@@ -22,8 +22,8 @@
 
 #include <sys/Conf.h>
 #include <mt/ThreadPlanner.h>
-#include <mt/ThreadGroup.h>
 #include <cphd/ByteSwap.h>
+#include <cphd/ThreadPool.h>
 
 namespace
 {
@@ -174,7 +174,8 @@ template <typename InT>
 void byteSwapAndPromote(const void* input,
                       const types::RowCol<size_t>& dims,
                       size_t numThreads,
-                      std::complex<float>* output)
+                      std::complex<float>* output,
+                      cphd::ThreadPool* threadPool)
 {
     if (numThreads <= 1)
     {
@@ -182,7 +183,7 @@ void byteSwapAndPromote(const void* input,
     }
     else
     {
-        mt::ThreadGroup threads;
+        cphd::RunnableGroup threads(threadPool);
         const mt::ThreadPlanner planner(dims.row, numThreads);
 
         size_t threadNum(0);
@@ -199,10 +200,10 @@ void byteSwapAndPromote(const void* input,
                     numRowsThisThread,
                     dims.col,
                     output));
-            threads.createThread(scaler);
+            threads.add(scaler);
         }
 
-        threads.joinAll();
+        threads.run();
     }
 }
 
@@ -211,7 +212,8 @@ void byteSwapAndScale(const void* input,
                       const types::RowCol<size_t>& dims,
                       const double* scaleFactors,
                       size_t numThreads,
-                      std::complex<float>* output)
+                      std::complex<float>* output,
+                      cphd::ThreadPool* threadPool)
 {
     if (numThreads <= 1)
     {
@@ -220,7 +222,7 @@ void byteSwapAndScale(const void* input,
     }
     else
     {
-        mt::ThreadGroup threads;
+        cphd::RunnableGroup threads(threadPool);
         const mt::ThreadPlanner planner(dims.row, numThreads);
 
         size_t threadNum(0);
@@ -237,10 +239,10 @@ void byteSwapAndScale(const void* input,
                     dims.col,
                     scaleFactors,
                     output));
-            threads.createThread(scaler);
+            threads.add(scaler);
         }
 
-        threads.joinAll();
+        threads.run();
     }
 }
 }
@@ -250,8 +252,14 @@ namespace cphd
 void byteSwap(void* buffer,
               size_t elemSize,
               size_t numElements,
-              size_t numThreads)
+              size_t numThreads,
+              ThreadPool* threadPool)
 {
+    if (threadPool)
+    {
+        numThreads = threadPool->getNumThreads();
+    }
+
     if (numThreads <= 1)
     {
         sys::byteSwap(buffer,
@@ -260,7 +268,7 @@ void byteSwap(void* buffer,
     }
     else
     {
-        mt::ThreadGroup threads;
+        RunnableGroup threads(threadPool);
         const mt::ThreadPlanner planner(numElements, numThreads);
 
         size_t threadNum(0);
@@ -276,9 +284,9 @@ void byteSwap(void* buffer,
                     startElement,
                     numElementsThisThread));
 
-            threads.createThread(thread);
+            threads.add(thread);
         }
-        threads.joinAll();
+        threads.run();
     }
 }
 
@@ -286,18 +294,27 @@ void byteSwapAndPromote(const void* input,
                       size_t elementSize,
                       const types::RowCol<size_t>& dims,
                       size_t numThreads,
-                      std::complex<float>* output)
+                      std::complex<float>* output,
+                      ThreadPool* threadPool)
 {
+    if (threadPool)
+    {
+        numThreads = threadPool->getNumThreads();
+    }
+
     switch (elementSize)
     {
     case 2:
-        ::byteSwapAndPromote<sys::Int8_T>(input, dims, numThreads, output);
+        ::byteSwapAndPromote<sys::Int8_T>(input, dims, numThreads, output,
+                                          threadPool);
         break;
     case 4:
-        ::byteSwapAndPromote<sys::Int16_T>(input, dims, numThreads, output);
+        ::byteSwapAndPromote<sys::Int16_T>(input, dims, numThreads, output,
+                                          threadPool);
         break;
     case 8:
-        ::byteSwapAndPromote<float>(input, dims, numThreads, output);
+        ::byteSwapAndPromote<float>(input, dims, numThreads, output,
+                                          threadPool);
         break;
     default:
         throw except::Exception(Ctxt(
@@ -310,21 +327,27 @@ void byteSwapAndScale(const void* input,
                       const types::RowCol<size_t>& dims,
                       const double* scaleFactors,
                       size_t numThreads,
-                      std::complex<float>* output)
+                      std::complex<float>* output,
+                      ThreadPool* threadPool)
 {
+    if (threadPool)
+    {
+        numThreads = threadPool->getNumThreads();
+    }
+
     switch (elementSize)
     {
     case 2:
         ::byteSwapAndScale<sys::Int8_T>(input, dims, scaleFactors, numThreads,
-                                        output);
+                                        output, threadPool);
         break;
     case 4:
         ::byteSwapAndScale<sys::Int16_T>(input, dims, scaleFactors, numThreads,
-                                         output);
+                                         output, threadPool);
         break;
     case 8:
         ::byteSwapAndScale<float>(input, dims, scaleFactors, numThreads,
-                                  output);
+                                  output, threadPool);
         break;
     default:
         throw except::Exception(Ctxt(
@@ -27,6 +27,7 @@
 #include <logging/NullLogger.h>
 #include <mem/ScopedArray.h>
 #include <mem/SharedPtr.h>
+#include <mt/CriticalSection.h>
 #include <xml/lite/MinidomParser.h>
 #include <cphd/CPHDReader.h>
 #include <cphd/CPHDXMLControl.h>
@@ -35,50 +36,171 @@ namespace cphd
 {
 CPHDReader::CPHDReader(mem::SharedPtr<io::SeekableInputStream> inStream,
                        size_t numThreads,
-                       mem::SharedPtr<logging::Logger> logger)
+                       mem::SharedPtr<logging::Logger> logger,
+                       LoadMode loadMode)
 {
-    initialize(inStream, numThreads, logger);
+    initialize(inStream, numThreads, mem::SharedPtr<ThreadPool>(), logger,
+               loadMode);
 }
 
 CPHDReader::CPHDReader(const std::string& fromFile,
                        size_t numThreads,
-                       mem::SharedPtr<logging::Logger> logger)
+                       mem::SharedPtr<logging::Logger> logger,
+                       LoadMode loadMode)
 {
     initialize(mem::SharedPtr<io::SeekableInputStream>(
-        new io::FileInputStream(fromFile)), numThreads, logger);
+        new io::FileInputStream(fromFile)), numThreads,
+        mem::SharedPtr<ThreadPool>(), logger, loadMode);
+}
+
+CPHDReader::CPHDReader(mem::SharedPtr<io::SeekableInputStream> inStream,
+                       mem::SharedPtr<ThreadPool> threadPool,
+                       mem::SharedPtr<logging::Logger> logger,
+                       LoadMode loadMode)
+{
+    initialize(inStream, threadPool->getNumThreads(), threadPool, logger,
+               loadMode);
+}
+
+CPHDReader::CPHDReader(const std::string& fromFile,
+                       mem::SharedPtr<ThreadPool> threadPool,
+                       mem::SharedPtr<logging::Logger> logger,
+                       LoadMode loadMode)
+{
+    initialize(mem::SharedPtr<io::SeekableInputStream>(
+        new io::FileInputStream(fromFile)), threadPool->getNumThreads(),
+        threadPool, logger, loadMode);
 }
 
 void CPHDReader::initialize(mem::SharedPtr<io::SeekableInputStream> inStream,
                             size_t numThreads,
-                            mem::SharedPtr<logging::Logger> logger)
+                            mem::SharedPtr<ThreadPool> threadPool,
+                            mem::SharedPtr<logging::Logger> logger,
+                            LoadMode loadMode)
 {
-    mFileHeader.read(*inStream);
+    mInStream = inStream;
+    mNumThreads = numThreads;
+    mThreadPool = threadPool;
+    mLogger = logger;
+    if (mLogger.get() == NULL)
+    {
+        mLogger.reset(new logging::NullLogger());
+    }
+
+    mFileHeader.read(*mInStream);
+
+    if (loadMode == LOAD_HEADER)
+    {
+        return;
+    }
+
+    loadMetadata();
+
+    if (loadMode == LOAD_ALL)
+    {
+        // Load the VBP into memory
+        mVBM.reset(new VBM(mMetadata->data, mMetadata->vectorParameters));
+        mVBM->load(*mInStream,
+                   mFileHeader.getVBMoffset(),
+                   mFileHeader.getVBMsize(),
+                   mNumThreads,
+                   mThreadPool.get());
+    }
+}
 
+void CPHDReader::loadMetadata() const
+{
     // Read in the XML string
     const int xmlSize = static_cast<int>(mFileHeader.getXMLsize());
-    inStream->seek(mFileHeader.getXMLoffset(), io::Seekable::START);
+    mInStream->seek(mFileHeader.getXMLoffset(), io::Seekable::START);
 
     xml::lite::MinidomParser xmlParser;
     xmlParser.preserveCharacterData(true);
-    xmlParser.parse(*inStream, xmlSize);
+    xmlParser.parse(*mInStream, xmlSize);
+
+    mMetadata = CPHDXMLControl(mLogger.get()).fromXML(
+            xmlParser.getDocument());
+}
+
+void CPHDReader::loadVBMChannel(size_t channel) const
+{
+    if (mMetadata.get() == NULL)
+    {
+        loadMetadata();
+    }
+
+    // Only set aside memory for the channels that get read
+    if (mVBM.get() == NULL)
+    {
+        mVBM.reset(new VBM(mMetadata->data, mMetadata->vectorParameters,
+                           false));
+    }
+
+    if (!mVBM->isLoaded(channel))
+    {
+        mVBM->loadChannel(*mInStream,
+                          mFileHeader.getVBMoffset(),
+                          channel,
+                          mNumThreads,
+                          mThreadPool.get());
+    }
+}
+
+const Metadata& CPHDReader::getMetadata() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    if (mMetadata.get() == NULL)
+    {
+        loadMetadata();
+    }
+    return *mMetadata;
+}
 
-    if (logger.get() == NULL)
+const VBM& CPHDReader::getVBM() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    if (mMetadata.get() == NULL)
     {
-        logger.reset(new logging::NullLogger());
+        loadMetadata();
     }
 
-    mMetadata = CPHDXMLControl(logger.get()).fromXML(xmlParser.getDocument());
+    const size_t numChannels = mMetadata->getNumChannels();
+    for (size_t ii = 0; ii < numChannels; ++ii)
+    {
+        loadVBMChannel(ii);
+    }
 
-    // Load the VBP into memory
-    mVBM.reset(new VBM(mMetadata->data, mMetadata->vectorParameters));
-    mVBM->load(*inStream,
-               mFileHeader.getVBMoffset(),
-               mFileHeader.getVBMsize(),
-               numThreads);
+    // Only reached with no channels
+    if (mVBM.get() == NULL)
+    {
+        mVBM.reset(new VBM(mMetadata->data, mMetadata->vectorParameters));
+    }
+    return *mVBM;
+}
 
-    // Setup for wideband reading
-    mWideband.reset(new Wideband(inStream, mMetadata->data,
-                                 mFileHeader.getCPHDoffset(),
-                                 mFileHeader.getCPHDsize()));
+const VBM& CPHDReader::getVBM(size_t channel) const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    loadVBMChannel(channel);
+    return *mVBM;
+}
+
+Wideband& CPHDReader::getWidebandImpl() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    if (mWideband.get() == NULL)
+    {
+        if (mMetadata.get() == NULL)
+        {
+            loadMetadata();
+        }
+
+        // Setup for wideband reading
+        mWideband.reset(new Wideband(mInStream, mMetadata->data,
+                                     mFileHeader.getCPHDoffset(),
+                                     mFileHeader.getCPHDsize()));
+        mWideband->setThreadPool(mThreadPool);
+    }
+    return *mWideband;
 }
 }
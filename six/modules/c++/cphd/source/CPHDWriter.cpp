@@ -20,8 +20,13 @@
  *
  */
 
+#include <string.h>
+
+#include <algorithm>
+
 #include <except/Exception.h>
 #include <io/FileOutputStream.h>
+#include <mt/CriticalSection.h>
 #include <cphd/CPHDWriter.h>
 #include <cphd/CPHDXMLControl.h>
 #include <cphd/Utilities.h>
@@ -46,7 +51,8 @@ CPHDWriter::DataWriterLittleEndian::DataWriterLittleEndian(
         size_t numThreads,
         size_t scratchSize) :
     DataWriter(stream, numThreads),
-    mScratchSize(scratchSize),
+    // Room for at least one of the largest (64 bit VBM) elements
+    mScratchSize(std::max(scratchSize, sizeof(double))),
     mScratch(new sys::byte[mScratchSize])
 {
 }
@@ -59,10 +65,13 @@ void CPHDWriter::DataWriterLittleEndian::operator()(
     size_t dataProcessed = 0;
     const size_t dataSize = numElements * elementSize;
 
+    // Only swap whole elements at a time
+    const size_t scratchSize = mScratchSize - mScratchSize % elementSize;
+
     while (dataProcessed < dataSize)
     {
         const size_t dataToProcess =
-                std::min(mScratchSize, dataSize - dataProcessed);
+                std::min(scratchSize, dataSize - dataProcessed);
 
         memcpy(mScratch.get(),
                data + dataProcessed,
@@ -101,7 +110,8 @@ CPHDWriter::CPHDWriter(const Metadata& metadata,
     mScratchSpaceSize(scratchSpaceSize),
     mNumThreads(numThreads),
     mCPHDSize(0),
-    mVBMSize(0)
+    mVBMSize(0),
+    mCPHDOffset(0)
 {
     //! Get the correct dataWriter.
     //  The CPHD file needs to be big endian.
@@ -182,6 +192,7 @@ void CPHDWriter::writeMetadata(size_t vbmSize,
 
     // set header size, final step before write
     header.set(xmlMetadata.size(), vbmSize, cphdSize);
+    mCPHDOffset = header.getCPHDoffset();
     mOutStream->write(header.toString().c_str(), header.size());
     mOutStream->write("\f\n", 2);
     mOutStream->write(xmlMetadata.c_str(), xmlMetadata.size());
@@ -284,6 +295,185 @@ void CPHDWriter::writeCPHDData<std::complex<float> >(
         const std::complex<float>* data,
         size_t numElements);
 
+void CPHDWriter::openForRandomAccess(const std::string& pathname,
+                                     const VBM& vbm,
+                                     const std::string& classification,
+                                     const std::string& releaseInfo)
+{
+    writeMetadata(pathname, vbm, classification, releaseInfo);
+    mOutStream->close();
+    mOutStream.reset();
+
+    sys::File file(pathname, sys::File::READ_AND_WRITE,
+                   sys::File::EXISTING);
+    sys::Off_T offset = mCPHDOffset;
+
+    const size_t numChannels = mMetadata.data.getNumChannels();
+    mChannelOffsets.resize(numChannels);
+    for (size_t ii = 0; ii < numChannels; ++ii)
+    {
+        mChannelOffsets[ii] = offset;
+        offset += static_cast<sys::Off_T>(mMetadata.data.getNumVectors(ii) *
+                mMetadata.data.getNumSamples(ii) * mElementSize);
+    }
+
+    // Size the file up front so blocks can be written anywhere in it
+    if (offset > file.length())
+    {
+        const char zero = 0;
+        file.seekTo(offset - 1, sys::File::FROM_START);
+        file.writeFrom(&zero, 1);
+    }
+    file.close();
+
+    mt::CriticalSection<sys::Mutex> lock(&mHandleMutex);
+    mFreeHandles.clear();
+    mHandles.clear();
+    mPathname = pathname;
+}
+
+sys::Off_T CPHDWriter::getFileOffset(size_t channel, size_t vector) const
+{
+    if (channel >= mChannelOffsets.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid channel number: " + str::toString<size_t>(channel)));
+    }
+    if (vector > mMetadata.data.getNumVectors(channel))
+    {
+        throw except::Exception(Ctxt(
+                "Invalid vector number: " + str::toString<size_t>(vector)));
+    }
+
+    return mChannelOffsets[channel] + static_cast<sys::Off_T>(
+            vector * mMetadata.data.getNumSamples(channel) * mElementSize);
+}
+
+CPHDWriter::FileHandle* CPHDWriter::acquireHandle()
+{
+    mt::CriticalSection<sys::Mutex> lock(&mHandleMutex);
+    if (mPathname.empty())
+    {
+        throw except::Exception(Ctxt(
+                "openForRandomAccess must be called before writing blocks"));
+    }
+
+    if (!mFreeHandles.empty())
+    {
+        FileHandle* const handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+        return handle;
+    }
+
+    // Not WRITE_ONLY, which truncates the file
+    mem::SharedPtr<FileHandle> handle(new FileHandle());
+    handle->file.create(mPathname, sys::File::READ_AND_WRITE,
+                        sys::File::EXISTING);
+    if (!sys::isBigEndianSystem())
+    {
+        handle->scratch.resize(std::max(mScratchSpaceSize, mElementSize));
+    }
+    mHandles.push_back(handle);
+    return handle.get();
+}
+
+void CPHDWriter::releaseHandle(FileHandle* handle)
+{
+    mt::CriticalSection<sys::Mutex> lock(&mHandleMutex);
+    mFreeHandles.push_back(handle);
+}
+
+void CPHDWriter::writeCPHDDataImpl(const sys::ubyte* data,
+                                   size_t channel,
+                                   size_t firstVector,
+                                   size_t numVectors)
+{
+    const sys::Off_T offset = getFileOffset(channel, firstVector);
+    if (firstVector + numVectors > mMetadata.data.getNumVectors(channel))
+    {
+        throw except::Exception(Ctxt(
+                "Writing past the end of channel " +
+                str::toString<size_t>(channel)));
+    }
+
+    const size_t dataSize =
+            numVectors * mMetadata.data.getNumSamples(channel) * mElementSize;
+    if (dataSize == 0)
+    {
+        return;
+    }
+
+    FileHandle* const handle = acquireHandle();
+    try
+    {
+        handle->file.seekTo(offset, sys::File::FROM_START);
+        if (handle->scratch.empty())
+        {
+            handle->file.writeFrom(data, dataSize);
+        }
+        else
+        {
+            //! Each complex sample is swapped as two real values
+            const size_t elementSize = mElementSize / 2;
+            const size_t scratchSize = handle->scratch.size() -
+                    handle->scratch.size() % mElementSize;
+            sys::byte* const scratch = &handle->scratch[0];
+            for (size_t dataProcessed = 0; dataProcessed < dataSize;)
+            {
+                const size_t dataToProcess =
+                        std::min(scratchSize, dataSize - dataProcessed);
+                memcpy(scratch, data + dataProcessed, dataToProcess);
+                byteSwap(scratch, elementSize, dataToProcess / elementSize,
+                         1);
+                handle->file.writeFrom(scratch, dataToProcess);
+                dataProcessed += dataToProcess;
+            }
+        }
+    }
+    catch (...)
+    {
+        releaseHandle(handle);
+        throw;
+    }
+    releaseHandle(handle);
+}
+
+template <typename T>
+void CPHDWriter::writeCPHDData(const T* data,
+                               size_t channel,
+                               size_t firstVector,
+                               size_t numVectors)
+{
+    if (mElementSize != sizeof(T))
+    {
+        throw except::Exception(Ctxt(
+                "Incorrect buffer data type used for metadata!"));
+    }
+    writeCPHDDataImpl(reinterpret_cast<const sys::ubyte*>(data),
+                      channel, firstVector, numVectors);
+}
+
+template
+void CPHDWriter::writeCPHDData<std::complex<sys::Int8_T> >(
+        const std::complex<sys::Int8_T>* data,
+        size_t channel,
+        size_t firstVector,
+        size_t numVectors);
+
+template
+void CPHDWriter::writeCPHDData<std::complex<sys::Int16_T> >(
+        const std::complex<sys::Int16_T>* data,
+        size_t channel,
+        size_t firstVector,
+        size_t numVectors);
+
+template
+void CPHDWriter::writeCPHDData<std::complex<float> >(
+        const std::complex<float>* data,
+        size_t channel,
+        size_t firstVector,
+        size_t numVectors);
+
 void CPHDWriter::write(const std::string& pathname,
                        const std::string& classification,
                        const std::string& releaseInfo)
@@ -0,0 +1,242 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <except/Exception.h>
+#include <sys/Conf.h>
+#include <sys/ConditionVar.h>
+#include <sys/Mutex.h>
+#include <mt/CriticalSection.h>
+#include <mt/ThreadGroup.h>
+#include <cphd/ThreadPool.h>
+
+namespace cphd
+{
+class ThreadPool::Group
+{
+public:
+    explicit Group(size_t numTasks) :
+        mNumRemaining(numTasks),
+        mDone(&mMutex)
+    {
+    }
+
+    // Runs and deletes 'runnable', holding on to the first exception
+    // thrown by any of the group's runnables
+    void execute(sys::Runnable* runnable)
+    {
+        std::auto_ptr<sys::Runnable> scopedRunnable(runnable);
+        try
+        {
+            scopedRunnable->run();
+        }
+        catch (const except::Exception& ex)
+        {
+            fail(ex);
+        }
+        catch (const std::exception& ex)
+        {
+            fail(except::Exception(Ctxt(ex.what())));
+        }
+        catch (...)
+        {
+            fail(except::Exception(Ctxt("Unknown exception")));
+        }
+        scopedRunnable.reset();
+
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        if (--mNumRemaining == 0)
+        {
+            mDone.signal();
+        }
+    }
+
+    // Waits for all of the group's runnables and rethrows the first
+    // exception, if there was one
+    void wait()
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        while (mNumRemaining > 0)
+        {
+            mDone.wait();
+        }
+
+        if (mException.get())
+        {
+            throw except::Exception(*mException, Ctxt(
+                    "A runnable on the thread pool failed"));
+        }
+    }
+
+private:
+    void fail(const except::Exception& ex)
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        if (!mException.get())
+        {
+            mException.reset(new except::Exception(ex));
+        }
+    }
+
+private:
+    size_t mNumRemaining;
+    std::auto_ptr<except::Exception> mException;
+    sys::Mutex mMutex;
+    sys::ConditionVar mDone;
+};
+
+class ThreadPool::Worker : public sys::Runnable
+{
+public:
+    explicit Worker(mt::RequestQueue<Task>& tasks) :
+        mTasks(tasks)
+    {
+    }
+
+    virtual void run()
+    {
+        while (true)
+        {
+            Task task;
+            mTasks.dequeue(task);
+            if (task.runnable == NULL)
+            {
+                return;
+            }
+            task.group->execute(task.runnable);
+        }
+    }
+
+private:
+    mt::RequestQueue<Task>& mTasks;
+};
+
+ThreadPool::ThreadPool(size_t numThreads) :
+    mNumThreads(numThreads)
+{
+    if (numThreads == 0)
+    {
+        throw except::Exception(Ctxt(
+                "A thread pool needs at least one thread"));
+    }
+
+    try
+    {
+        for (size_t ii = 0; ii < mNumThreads; ++ii)
+        {
+            mem::SharedPtr<sys::Thread> thread(
+                    new sys::Thread(new Worker(mTasks)));
+            thread->start();
+            mThreads.push_back(thread);
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    try
+    {
+        stop();
+    }
+    catch (...)
+    {
+    }
+}
+
+void ThreadPool::stop()
+{
+    const Task stopTask = { NULL, NULL };
+    for (size_t ii = 0; ii < mThreads.size(); ++ii)
+    {
+        mTasks.enqueue(stopTask);
+    }
+    for (size_t ii = 0; ii < mThreads.size(); ++ii)
+    {
+        mThreads[ii]->join();
+    }
+    mThreads.clear();
+}
+
+void ThreadPool::run(std::vector<sys::Runnable*>& runnables)
+{
+    if (runnables.empty())
+    {
+        return;
+    }
+
+    // The workers take ownership of the runnables as they're queued
+    Group group(runnables.size());
+    for (size_t ii = 0; ii < runnables.size(); ++ii)
+    {
+        const Task task = { runnables[ii], &group };
+        runnables[ii] = NULL;
+        mTasks.enqueue(task);
+    }
+    runnables.clear();
+
+    group.wait();
+}
+
+RunnableGroup::RunnableGroup(ThreadPool* threadPool) :
+    mThreadPool(threadPool)
+{
+}
+
+RunnableGroup::~RunnableGroup()
+{
+    for (size_t ii = 0; ii < mRunnables.size(); ++ii)
+    {
+        delete mRunnables[ii];
+    }
+}
+
+void RunnableGroup::add(std::auto_ptr<sys::Runnable> runnable)
+{
+    mRunnables.push_back(NULL);
+    mRunnables.back() = runnable.release();
+}
+
+void RunnableGroup::run()
+{
+    if (mThreadPool)
+    {
+        mThreadPool->run(mRunnables);
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        for (size_t ii = 0; ii < mRunnables.size(); ++ii)
+        {
+            std::auto_ptr<sys::Runnable> runnable(mRunnables[ii]);
+            mRunnables[ii] = NULL;
+            threads.createThread(runnable);
+        }
+        mRunnables.clear();
+        threads.joinAll();
+    }
+}
+}
@@ -20,6 +20,7 @@
  *
  */
 
+#include <algorithm>
 #include <sstream>
 #include <string.h>
 
@@ -29,14 +30,17 @@
 
 namespace
 {
-inline void setData(const sys::byte*& data,
+//! These use memcpy's because on Sun these addresses may not be
+//  8 byte aligned. So trying to derefence data as a double results in
+//  a crash.
+inline void setData(const sys::ubyte*& data,
                     double& dest)
 {
     memcpy(&dest, data, sizeof(double));
-    data += sizeof(double); 
+    data += sizeof(double);
 }
 
-inline void setData(const sys::byte*& data,
+inline void setData(const sys::ubyte*& data,
                     cphd::Vector3& dest)
 {
     setData(data, dest[0]);
@@ -58,206 +62,173 @@ inline void getData(const cphd::Vector3& value,
     getData(value[1], dest);
     getData(value[2], dest);
 }
-}
-
-namespace cphd
-{
-VBM::FrequencyParameters::FrequencyParameters() :
-    fx0(0.0),
-    fxSS(0.0),
-    fx1(0.0),
-    fx2(0.0)
-{
-}
-
-VBM::TOAParameters::TOAParameters() :
-    deltaTOA0(0.0),
-    toaSS(0.0)
-{
-}
-
-VBM::VectorBasedParameters::VectorBasedParameters(
-        bool srpTimeEnabled,
-        bool tropoSrpEnabled,
-        bool ampSFEnabled,
-        DomainType domainType) :
-    txTime(0.0),
-    txPos(0.0),
-    rcvTime(0.0),
-    rcvPos(0.0),
-    srpTime(srpTimeEnabled ? 0.0 : six::Init::undefined<double>()),
-    srpPos(0.0),
-    tropoSrp(tropoSrpEnabled ? 0.0 : six::Init::undefined<double>()),
-    ampSF(ampSFEnabled ? 0.0 : six::Init::undefined<double>()),
-    frequencyParameters(domainType == DomainType::FX ?
-            new FrequencyParameters() : NULL),
-    toaParameters(domainType == DomainType::TOA ?
-            new TOAParameters() : NULL)
-{
-}
 
-size_t VBM::VectorBasedParameters::getNumBytes() const
+template <typename T>
+const T* getColumn(const std::vector<T>& column)
 {
-    size_t ret = 11 * sizeof(double);
-    if (!six::Init::isUndefined<double>(srpTime))
-    {
-        ret += sizeof(srpTime);
-    }
-    if (!six::Init::isUndefined<double>(tropoSrp))
-    {
-        ret += sizeof(tropoSrp);
-    }
-    if (!six::Init::isUndefined<double>(ampSF))
-    {
-        ret += sizeof(ampSF);
-    }
-
-    if (frequencyParameters.get())
-    {
-        ret += sizeof(FrequencyParameters);
-    }
-    else if (toaParameters.get())
-    {
-        ret += sizeof(TOAParameters);
-    }
-    return ret;
+    return column.empty() ? NULL : &column[0];
 }
-
-void VBM::VectorBasedParameters::getData(sys::ubyte* data) const
-{
-    //! This uses memcpy's here because on Sun these addresses may not be
-    //  8 byte aligned. So trying to derefence data as a double results in
-    //  a crash.
-    ::getData(txTime, data);
-    ::getData(txPos, data);
-    ::getData(rcvTime, data);
-    ::getData(rcvPos, data);
-    if (!six::Init::isUndefined<double>(srpTime))
-    {
-        ::getData(srpTime, data);
-    }
-    ::getData(srpPos, data);
-    if (!six::Init::isUndefined<double>(tropoSrp))
-    {
-        ::getData(tropoSrp, data);
-    }
-    if (!six::Init::isUndefined<double>(ampSF))
-    {
-        ::getData(ampSF, data);
-    }
-    if (frequencyParameters.get())
-    {
-        ::getData(frequencyParameters->fx0, data);
-        ::getData(frequencyParameters->fxSS, data);
-        ::getData(frequencyParameters->fx1, data);
-        ::getData(frequencyParameters->fx2, data);
-    }
-    else if (toaParameters.get())
-    {
-        ::getData(toaParameters->deltaTOA0, data);
-        ::getData(toaParameters->toaSS, data);
-    }
 }
 
-void VBM::VectorBasedParameters::setData(const sys::byte* data)
+namespace cphd
 {
-    //! This uses memcpy's here because on Sun these addresses may not be
-    //  8 byte aligned. So trying to derefence data as a double results in
-    //  a crash.
-    ::setData(data, txTime);
-    ::setData(data, txPos);
-    ::setData(data, rcvTime);
-    ::setData(data, rcvPos);
-    if (!six::Init::isUndefined<double>(srpTime))
-    {
-        ::setData(data, srpTime);
-    }
-    ::setData(data, srpPos);
-    if (!six::Init::isUndefined<double>(tropoSrp))
-    {
-        ::setData(data, tropoSrp);
-    }
-    if (!six::Init::isUndefined<double>(ampSF))
-    {
-        ::setData(data, ampSF);
-    }
-    if (frequencyParameters.get())
-    {
-        ::setData(data, frequencyParameters->fx0);
-        ::setData(data, frequencyParameters->fxSS);
-        ::setData(data, frequencyParameters->fx1);
-        ::setData(data, frequencyParameters->fx2);
-    }
-    else if (toaParameters.get())
-    {
-        ::setData(data, toaParameters->deltaTOA0);
-        ::setData(data, toaParameters->toaSS);
+void VBM::ChannelData::resize(size_t numVectors,
+                              bool srpTimeEnabled,
+                              bool tropoSrpEnabled,
+                              bool ampSFEnabled,
+                              DomainType domainType)
+{
+    const Vector3 zero(0.0);
+    const size_t numFx = (domainType == DomainType::FX) ? numVectors : 0;
+    const size_t numTOA = (domainType == DomainType::TOA) ? numVectors : 0;
+
+    txTime.resize(numVectors, 0.0);
+    txPos.resize(numVectors, zero);
+    rcvTime.resize(numVectors, 0.0);
+    rcvPos.resize(numVectors, zero);
+    srpTime.resize(srpTimeEnabled ? numVectors : 0, 0.0);
+    srpPos.resize(numVectors, zero);
+    tropoSrp.resize(tropoSrpEnabled ? numVectors : 0, 0.0);
+    ampSF.resize(ampSFEnabled ? numVectors : 0, 0.0);
+    fx0.resize(numFx, 0.0);
+    fxSS.resize(numFx, 0.0);
+    fx1.resize(numFx, 0.0);
+    fx2.resize(numFx, 0.0);
+    deltaTOA0.resize(numTOA, 0.0);
+    toaSS.resize(numTOA, 0.0);
+}
+
+void VBM::ChannelData::getData(size_t numBytesPerVector,
+                               sys::ubyte* data) const
+{
+    const bool haveSRPTime = !srpTime.empty();
+    const bool haveTropoSRP = !tropoSrp.empty();
+    const bool haveAmpSF = !ampSF.empty();
+    const bool haveFx = !fx0.empty();
+    const bool haveTOA = !deltaTOA0.empty();
+
+    for (size_t ii = 0; ii < size(); ++ii, data += numBytesPerVector)
+    {
+        sys::ubyte* ptr = data;
+        ::getData(txTime[ii], ptr);
+        ::getData(txPos[ii], ptr);
+        ::getData(rcvTime[ii], ptr);
+        ::getData(rcvPos[ii], ptr);
+        if (haveSRPTime)
+        {
+            ::getData(srpTime[ii], ptr);
+        }
+        ::getData(srpPos[ii], ptr);
+        if (haveTropoSRP)
+        {
+            ::getData(tropoSrp[ii], ptr);
+        }
+        if (haveAmpSF)
+        {
+            ::getData(ampSF[ii], ptr);
+        }
+        if (haveFx)
+        {
+            ::getData(fx0[ii], ptr);
+            ::getData(fxSS[ii], ptr);
+            ::getData(fx1[ii], ptr);
+            ::getData(fx2[ii], ptr);
+        }
+        else if (haveTOA)
+        {
+            ::getData(deltaTOA0[ii], ptr);
+            ::getData(toaSS[ii], ptr);
+        }
     }
 }
 
-bool VBM::VectorBasedParameters::operator==(
-        const VBM::VectorBasedParameters& other) const
+void VBM::ChannelData::setData(size_t numBytesPerVector,
+                               const sys::ubyte* data)
 {
-    if (txTime != other.txTime ||
-        txPos != other.txPos ||
-        rcvTime != other.rcvTime ||
-        rcvPos != other.rcvPos ||
-        srpPos != other.srpPos)
-    {
-        return false;
-    }
+    const bool haveSRPTime = !srpTime.empty();
+    const bool haveTropoSRP = !tropoSrp.empty();
+    const bool haveAmpSF = !ampSF.empty();
+    const bool haveFx = !fx0.empty();
+    const bool haveTOA = !deltaTOA0.empty();
 
-    if (!six::Init::isUndefined<double>(srpTime) ||
-        !six::Init::isUndefined<double>(other.srpTime))
+    for (size_t ii = 0; ii < size(); ++ii, data += numBytesPerVector)
     {
-        if (srpTime != other.srpTime)
+        const sys::ubyte* ptr = data;
+        ::setData(ptr, txTime[ii]);
+        ::setData(ptr, txPos[ii]);
+        ::setData(ptr, rcvTime[ii]);
+        ::setData(ptr, rcvPos[ii]);
+        if (haveSRPTime)
         {
-            return false;
+            ::setData(ptr, srpTime[ii]);
         }
-    }
-
-    if (!six::Init::isUndefined<double>(tropoSrp) ||
-        !six::Init::isUndefined<double>(other.tropoSrp))
-    {
-        if (tropoSrp != other.tropoSrp)
+        ::setData(ptr, srpPos[ii]);
+        if (haveTropoSRP)
         {
-            return false;
+            ::setData(ptr, tropoSrp[ii]);
         }
-    }
-
-    if (!six::Init::isUndefined<double>(ampSF) ||
-        !six::Init::isUndefined<double>(other.ampSF))
-    {
-        if (ampSF != other.ampSF)
+        if (haveAmpSF)
+        {
+            ::setData(ptr, ampSF[ii]);
+        }
+        if (haveFx)
+        {
+            ::setData(ptr, fx0[ii]);
+            ::setData(ptr, fxSS[ii]);
+            ::setData(ptr, fx1[ii]);
+            ::setData(ptr, fx2[ii]);
+        }
+        else if (haveTOA)
         {
-            return false;
+            ::setData(ptr, deltaTOA0[ii]);
+            ::setData(ptr, toaSS[ii]);
         }
     }
+}
+
+bool VBM::ChannelData::operator==(const VBM::ChannelData& other) const
+{
+    return txTime == other.txTime &&
+           txPos == other.txPos &&
+           rcvTime == other.rcvTime &&
+           rcvPos == other.rcvPos &&
+           srpTime == other.srpTime &&
+           srpPos == other.srpPos &&
+           tropoSrp == other.tropoSrp &&
+           ampSF == other.ampSF &&
+           fx0 == other.fx0 &&
+           fxSS == other.fxSS &&
+           fx1 == other.fx1 &&
+           fx2 == other.fx2 &&
+           deltaTOA0 == other.deltaTOA0 &&
+           toaSS == other.toaSS;
+}
 
-    if (frequencyParameters.get() && other.frequencyParameters.get())
+size_t VBM::calculateNumBytesPerVector() const
+{
+    size_t ret = 11 * sizeof(double);
+    if (mSRPTimeEnabled)
     {
-        if (*frequencyParameters != *other.frequencyParameters)
-        {
-            return false;
-        }
+        ret += sizeof(double);
+    }
+    if (mTropoSRPEnabled)
+    {
+        ret += sizeof(double);
     }
-    else if (frequencyParameters.get() || other.frequencyParameters.get())
+    if (mAmpSFEnabled)
     {
-        return false;
+        ret += sizeof(double);
     }
 
-    if (toaParameters.get() && other.toaParameters.get())
+    if (mDomainType == DomainType::FX)
     {
-        if (*toaParameters != *other.toaParameters)
-        {
-            return false;
-        }
+        ret += 4 * sizeof(double);
     }
-    else if (toaParameters.get() || other.toaParameters.get())
+    else if (mDomainType == DomainType::TOA)
     {
-        return false;
+        ret += 2 * sizeof(double);
     }
-    return true;
+    return ret;
 }
 
 VBM::VBM() :
@@ -269,29 +240,33 @@ VBM::VBM() :
 {
 }
 
-VBM::VBM(const Data& data, const VectorParameters &vp) :
+VBM::VBM(const Data& data, const VectorParameters &vp, bool allocate) :
     mSRPTimeEnabled(vp.srpTimeOffset() > 0),
     mTropoSRPEnabled(vp.tropoSRPOffset() > 0),
     mAmpSFEnabled(vp.ampSFOffset() > 0),
     mDomainType(vp.fxParameters.get() ? DomainType::FX :
             vp.toaParameters.get() ? DomainType::TOA : DomainType::NOT_SET),
     mNumBytesPerVector(data.getNumBytesVBP()),
-    mData(data.numCPHDChannels)
+    mData(data.numCPHDChannels),
+    mNumVectors(data.numCPHDChannels),
+    mLoaded(data.numCPHDChannels, allocate)
 {
-    const VectorBasedParameters copy(mSRPTimeEnabled,
-                                     mTropoSRPEnabled,
-                                     mAmpSFEnabled,
-                                     mDomainType);
-
     for (size_t ii = 0; ii < data.numCPHDChannels; ++ii)
     {
-        mData[ii].resize(data.getNumVectors(ii), copy);
+        mNumVectors[ii] = data.getNumVectors(ii);
+        if (allocate)
+        {
+            mData[ii].resize(mNumVectors[ii],
+                             mSRPTimeEnabled,
+                             mTropoSRPEnabled,
+                             mAmpSFEnabled,
+                             mDomainType);
+        }
     }
 
-    if (!mData.empty() && !mData[0].empty())
+    if (!mNumVectors.empty() && mNumVectors[0] > 0)
     {
-        const size_t calculateBytesPerVector =
-                mData[0][0].getNumBytes();
+        const size_t calculateBytesPerVector = calculateNumBytesPerVector();
         if (six::Init::isUndefined<size_t>(mNumBytesPerVector) ||
             calculateBytesPerVector > mNumBytesPerVector)
         {
@@ -343,32 +318,36 @@ VBM::VBM(size_t numChannels,
     //! For each channel
     for (size_t ii = 0; ii < mData.size(); ++ii)
     {
-        const sys::byte* ptr = static_cast<const sys::byte*>(data[ii]);
-
-        //! For each vector
-        for (size_t jj = 0;
-             jj < mData[ii].size();
-             ++jj, ptr += mNumBytesPerVector)
-        {
-            mData[ii][jj].setData(ptr);
-        }
+        mData[ii].setData(mNumBytesPerVector,
+                          static_cast<const sys::ubyte*>(data[ii]));
     }
 }
 
-void VBM::verifyChannelVector(size_t channel, size_t vector) const
+void VBM::verifyRange(size_t channel, size_t vector) const
 {
     if (channel >= mData.size())
     {
         throw except::Exception(Ctxt(
                 "Invalid channel number: " + str::toString<size_t>(channel)));
     }
-    if (vector >= mData[channel].size())
+    if (vector >= mNumVectors[channel])
     {
         throw except::Exception(Ctxt(
                 "Invalid vector number: " + str::toString<size_t>(vector)));
     }
 }
 
+void VBM::verifyChannelVector(size_t channel, size_t vector) const
+{
+    verifyRange(channel, vector);
+    if (!mLoaded[channel])
+    {
+        throw except::Exception(Ctxt(
+                "VBM channel " + str::toString<size_t>(channel) +
+                " has not been loaded"));
+    }
+}
+
 void VBM::setupInitialData(size_t numChannels,
                            const std::vector<size_t>& numVectors)
 {
@@ -377,44 +356,45 @@ void VBM::setupInitialData(size_t numChannels,
         throw except::Exception(Ctxt("Invalid numVectors parameter: "
                 "You must pass a vector sized to the number of channels"));
     }
-    const VectorBasedParameters copy(mSRPTimeEnabled,
-                                     mTropoSRPEnabled,
-                                     mAmpSFEnabled,
-                                     mDomainType);
-
+    mNumVectors.assign(numVectors.begin(), numVectors.begin() + numChannels);
+    mLoaded.assign(numChannels, true);
     for (size_t ii = 0; ii < numChannels; ++ii)
     {
-        mData[ii].resize(numVectors[ii], copy);
+        mData[ii].resize(numVectors[ii],
+                         mSRPTimeEnabled,
+                         mTropoSRPEnabled,
+                         mAmpSFEnabled,
+                         mDomainType);
     }
 
-    if (!mData.empty() && !mData[0].empty())
+    if (!mNumVectors.empty() && mNumVectors[0] > 0)
     {
-        mNumBytesPerVector = mData[0][0].getNumBytes();
+        mNumBytesPerVector = calculateNumBytesPerVector();
     }
 }
 
 double VBM::getTxTime(size_t channel, size_t vector) const
 {
     verifyChannelVector(channel, vector);
-    return mData[channel][vector].txTime;
+    return mData[channel].txTime[vector];
 }
 
 Vector3 VBM::getTxPos(size_t channel, size_t vector) const
 {
     verifyChannelVector(channel, vector);
-    return mData[channel][vector].txPos;
+    return mData[channel].txPos[vector];
 }
 
 double VBM::getRcvTime(size_t channel, size_t vector) const
 {
     verifyChannelVector(channel, vector);
-    return mData[channel][vector].rcvTime;
+    return mData[channel].rcvTime[vector];
 }
 
 Vector3 VBM::getRcvPos(size_t channel, size_t vector) const
 {
     verifyChannelVector(channel, vector);
-    return mData[channel][vector].rcvPos;
+    return mData[channel].rcvPos[vector];
 }
 
 double VBM::getSRPTime(size_t channel, size_t vector) const
@@ -424,13 +404,13 @@ double VBM::getSRPTime(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid SRP time."));
     }
-    return mData[channel][vector].srpTime;
+    return mData[channel].srpTime[vector];
 }
 
 Vector3 VBM::getSRPPos(size_t channel, size_t vector) const
 {
     verifyChannelVector(channel, vector);
-    return mData[channel][vector].srpPos;
+    return mData[channel].srpPos[vector];
 }
 
 double VBM::getTropoSRP(size_t channel, size_t vector) const
@@ -440,7 +420,7 @@ double VBM::getTropoSRP(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid TropoSRP."));
     }
-    return mData[channel][vector].tropoSrp;
+    return mData[channel].tropoSrp[vector];
 }
 
 double VBM::getAmpSF(size_t channel, size_t vector) const
@@ -450,7 +430,7 @@ double VBM::getAmpSF(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid AmpSF."));
     }
-    return mData[channel][vector].ampSF;
+    return mData[channel].ampSF[vector];
 }
 
 double VBM::getFx0(size_t channel, size_t vector) const
@@ -460,7 +440,7 @@ double VBM::getFx0(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid Fx0."));
     }
-    return mData[channel][vector].frequencyParameters->fx0;
+    return mData[channel].fx0[vector];
 }
 
 double VBM::getFxSS(size_t channel, size_t vector) const
@@ -470,7 +450,7 @@ double VBM::getFxSS(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid FxSS."));
     }
-    return mData[channel][vector].frequencyParameters->fxSS;
+    return mData[channel].fxSS[vector];
 }
 
 double VBM::getFx1(size_t channel, size_t vector) const
@@ -480,7 +460,7 @@ double VBM::getFx1(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid Fx1."));
     }
-    return mData[channel][vector].frequencyParameters->fx1;
+    return mData[channel].fx1[vector];
 }
 
 double VBM::getFx2(size_t channel, size_t vector) const
@@ -490,7 +470,7 @@ double VBM::getFx2(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid Fx2."));
     }
-    return mData[channel][vector].frequencyParameters->fx2;
+    return mData[channel].fx2[vector];
 }
 
 double VBM::getDeltaTOA0(size_t channel, size_t vector) const
@@ -500,7 +480,7 @@ double VBM::getDeltaTOA0(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid DeltaTOA0."));
     }
-    return mData[channel][vector].toaParameters->deltaTOA0;
+    return mData[channel].deltaTOA0[vector];
 }
 
 double VBM::getTOASS(size_t channel, size_t vector) const
@@ -510,31 +490,171 @@ double VBM::getTOASS(size_t channel, size_t vector) const
     {
         throw except::Exception(Ctxt("Invalid TOA_SS."));
     }
-    return mData[channel][vector].toaParameters->toaSS;
+    return mData[channel].toaSS[vector];
+}
+
+size_t VBM::getNumVectors(size_t channel) const
+{
+    if (channel >= mData.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid channel number: " + str::toString<size_t>(channel)));
+    }
+    return mNumVectors[channel];
+}
+
+bool VBM::isLoaded(size_t channel) const
+{
+    if (channel >= mData.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid channel number: " + str::toString<size_t>(channel)));
+    }
+    return mLoaded[channel] != 0;
+}
+
+const double* VBM::getTxTimes(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    return getColumn(mData[channel].txTime);
+}
+
+const Vector3* VBM::getTxPositions(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    return getColumn(mData[channel].txPos);
+}
+
+const double* VBM::getRcvTimes(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    return getColumn(mData[channel].rcvTime);
+}
+
+const Vector3* VBM::getRcvPositions(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    return getColumn(mData[channel].rcvPos);
+}
+
+const double* VBM::getSRPTimes(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (!mSRPTimeEnabled)
+    {
+        throw except::Exception(Ctxt("Invalid SRP time."));
+    }
+    return getColumn(mData[channel].srpTime);
+}
+
+const Vector3* VBM::getSRPPositions(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    return getColumn(mData[channel].srpPos);
+}
+
+const double* VBM::getTropoSRPs(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (!mTropoSRPEnabled)
+    {
+        throw except::Exception(Ctxt("Invalid TropoSRP."));
+    }
+    return getColumn(mData[channel].tropoSrp);
+}
+
+const double* VBM::getAmpSFs(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (!mAmpSFEnabled)
+    {
+        throw except::Exception(Ctxt("Invalid AmpSF."));
+    }
+    return getColumn(mData[channel].ampSF);
+}
+
+const double* VBM::getFx0s(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::FX)
+    {
+        throw except::Exception(Ctxt("Invalid Fx0."));
+    }
+    return getColumn(mData[channel].fx0);
+}
+
+const double* VBM::getFxSSs(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::FX)
+    {
+        throw except::Exception(Ctxt("Invalid FxSS."));
+    }
+    return getColumn(mData[channel].fxSS);
+}
+
+const double* VBM::getFx1s(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::FX)
+    {
+        throw except::Exception(Ctxt("Invalid Fx1."));
+    }
+    return getColumn(mData[channel].fx1);
+}
+
+const double* VBM::getFx2s(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::FX)
+    {
+        throw except::Exception(Ctxt("Invalid Fx2."));
+    }
+    return getColumn(mData[channel].fx2);
+}
+
+const double* VBM::getDeltaTOA0s(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::TOA)
+    {
+        throw except::Exception(Ctxt("Invalid DeltaTOA0."));
+    }
+    return getColumn(mData[channel].deltaTOA0);
+}
+
+const double* VBM::getTOASSs(size_t channel) const
+{
+    verifyChannelVector(channel, 0);
+    if (mDomainType != DomainType::TOA)
+    {
+        throw except::Exception(Ctxt("Invalid TOA_SS."));
+    }
+    return getColumn(mData[channel].toaSS);
 }
 
 void VBM::setTxTime(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].txTime = value;
+    mData[channel].txTime[vector] = value;
 }
 
 void VBM::setTxPos(const Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].txPos = value;
+    mData[channel].txPos[vector] = value;
 }
 
 void VBM::setRcvTime(double value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvTime = value;
+    mData[channel].rcvTime[vector] = value;
 }
 
 void VBM::setRcvPos(const Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].rcvPos = value;
+    mData[channel].rcvPos[vector] = value;
 }
 
 void VBM::setSRPTime(double value, size_t channel, size_t vector)
@@ -544,13 +664,13 @@ void VBM::setSRPTime(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid SRPTime."));
     }
-    mData[channel][vector].srpTime = value;
+    mData[channel].srpTime[vector] = value;
 }
 
 void VBM::setSRPPos(const Vector3& value, size_t channel, size_t vector)
 {
     verifyChannelVector(channel, vector);
-    mData[channel][vector].srpPos = value;
+    mData[channel].srpPos[vector] = value;
 }
 
 void VBM::setTropoSRP(double value, size_t channel, size_t vector)
@@ -560,7 +680,7 @@ void VBM::setTropoSRP(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid TropoSRP."));
     }
-    mData[channel][vector].tropoSrp = value;
+    mData[channel].tropoSrp[vector] = value;
 }
 
 void VBM::setAmpSF(double value, size_t channel, size_t vector)
@@ -570,7 +690,7 @@ void VBM::setAmpSF(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid AmpSF."));
     }
-    mData[channel][vector].ampSF = value;
+    mData[channel].ampSF[vector] = value;
 }
 
 void VBM::setFx0(double value, size_t channel, size_t vector)
@@ -580,7 +700,7 @@ void VBM::setFx0(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid Fx0."));
     }
-    mData[channel][vector].frequencyParameters->fx0 = value;
+    mData[channel].fx0[vector] = value;
 }
 
 void VBM::setFxSS(double value, size_t channel, size_t vector)
@@ -590,7 +710,7 @@ void VBM::setFxSS(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid FxSS."));
     }
-    mData[channel][vector].frequencyParameters->fxSS = value;
+    mData[channel].fxSS[vector] = value;
 }
 
 void VBM::setFx1(double value, size_t channel, size_t vector)
@@ -600,7 +720,7 @@ void VBM::setFx1(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid Fx1."));
     }
-    mData[channel][vector].frequencyParameters->fx1 = value;
+    mData[channel].fx1[vector] = value;
 }
 
 void VBM::setFx2(double value, size_t channel, size_t vector)
@@ -610,7 +730,7 @@ void VBM::setFx2(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid Fx2."));
     }
-    mData[channel][vector].frequencyParameters->fx2 = value;
+    mData[channel].fx2[vector] = value;
 }
 
 void VBM::setDeltaTOA0(double value, size_t channel, size_t vector)
@@ -620,7 +740,7 @@ void VBM::setDeltaTOA0(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid DeltaTOA0."));
     }
-    mData[channel][vector].toaParameters->deltaTOA0 = value;
+    mData[channel].deltaTOA0[vector] = value;
 }
 
 void VBM::setTOASS(double value, size_t channel, size_t vector)
@@ -630,20 +750,25 @@ void VBM::setTOASS(double value, size_t channel, size_t vector)
     {
         throw except::Exception(Ctxt("Invalid TOA_SS."));
     }
-    mData[channel][vector].toaParameters->toaSS = value;
+    mData[channel].toaSS[vector] = value;
 }
 
 void VBM::clearAmpSF()
 {
     if (mAmpSFEnabled)
     {
+        // Channels read in later would be laid out differently than the
+        // ones already in memory
+        if (std::find(mLoaded.begin(), mLoaded.end(), 0) != mLoaded.end())
+        {
+            throw except::Exception(Ctxt(
+                    "Cannot clear AmpSF until every VBM channel is loaded"));
+        }
+
         // Remove all the data corresponding to ampSF
         for (size_t ii = 0; ii < mData.size(); ++ii)
         {
-            for (size_t jj = 0; jj < mData[ii].size(); ++jj)
-            {
-                mData[ii][jj].ampSF = six::Init::undefined<double>();
-            }
+            std::vector<double>().swap(mData[ii].ampSF);
         }
 
         mAmpSFEnabled = false;
@@ -665,21 +790,13 @@ void VBM::getVBMdata(size_t channel,
                      void* data) const
 {
     verifyChannelVector(channel, 0);
-    const size_t numBytes = getNumBytesVBP();
-    sys::ubyte* ptr = static_cast<sys::ubyte*>(data);
-
-    for (size_t ii = 0;
-         ii < mData[channel].size();
-         ++ii, ptr += numBytes)
-    {
-        mData[channel][ii].getData(ptr);
-    }
+    mData[channel].getData(getNumBytesVBP(), static_cast<sys::ubyte*>(data));
 }
 
 size_t VBM::getVBMsize(size_t channel) const
 {
-    verifyChannelVector(channel, 0);
-    return getNumBytesVBP() * mData[channel].size();
+    verifyRange(channel, 0);
+    return getNumBytesVBP() * mNumVectors[channel];
 }
 
 void VBM::updateVectorParameters(VectorParameters& vp) const
@@ -719,10 +836,55 @@ void VBM::updateVectorParameters(VectorParameters& vp) const
     }
 }
 
+sys::Off_T VBM::readChannel(io::SeekableInputStream& inStream,
+                            size_t channel,
+                            size_t numThreads,
+                            ThreadPool* threadPool,
+                            std::vector<sys::ubyte>& scratch)
+{
+    ChannelData& channelData = mData[channel];
+    channelData.resize(mNumVectors[channel],
+                       mSRPTimeEnabled,
+                       mTropoSRPEnabled,
+                       mAmpSFEnabled,
+                       mDomainType);
+
+    sys::Off_T bytesRead(0);
+    scratch.resize(getVBMsize(channel));
+    if (!scratch.empty())
+    {
+        sys::byte* const buf = reinterpret_cast<sys::byte*>(&scratch[0]);
+        bytesRead = inStream.read(buf, scratch.size());
+        if (bytesRead == io::InputStream::IS_EOF)
+        {
+            std::ostringstream oss;
+            oss << "EOF reached during VBM read for channel " << (channel);
+            throw except::Exception(Ctxt(oss.str()));
+        }
+
+        // Input CPHD is always Big Endian; swap to Little Endian if
+        // necessary
+        if (!(sys::isBigEndianSystem()))
+        {
+            byteSwap(buf,
+                     sizeof(double),
+                     scratch.size() / sizeof(double),
+                     numThreads,
+                     threadPool);
+        }
+
+        channelData.setData(getNumBytesVBP(), &scratch[0]);
+    }
+
+    mLoaded[channel] = true;
+    return bytesRead;
+}
+
 sys::Off_T VBM::load(io::SeekableInputStream& inStream,
                      sys::Off_T startVBM,
                      sys::Off_T sizeVBM,
-                     size_t numThreads)
+                     size_t numThreads,
+                     ThreadPool* threadPool)
 {
     // Allocate the buffers
     size_t numBytesIn(0);
@@ -741,50 +903,42 @@ sys::Off_T VBM::load(io::SeekableInputStream& inStream,
         throw except::Exception(Ctxt(oss.str()));
     }
 
-    const bool swapToLittleEndian = !(sys::isBigEndianSystem());
-
     // Seek to start of VBM
-    size_t totalBytesRead(0);
+    sys::Off_T totalBytesRead(0);
     inStream.seek(startVBM, io::Seekable::START);
     std::vector<sys::ubyte> data;
-    const size_t numBytesPerVector = getNumBytesVBP();
-
     // Read the data for each channel
     for (size_t ii = 0; ii < mData.size(); ++ii)
     {
-        data.resize(getVBMsize(ii));
-        //std::vector<sys::ubyte>& data(mVBMdata[ii]);
-        if (!data.empty())
-        {
-            sys::byte* const buf = reinterpret_cast<sys::byte*>(&data[0]);
-            sys::SSize_T bytesThisRead = inStream.read(buf, data.size());
-            if (bytesThisRead == io::InputStream::IS_EOF)
-            {
-                std::ostringstream oss;
-                oss << "EOF reached during VBM read for channel " << (ii);
-                throw except::Exception(Ctxt(oss.str()));
-            }
-            totalBytesRead += bytesThisRead;
+        totalBytesRead += readChannel(inStream, ii, numThreads, threadPool,
+                                      data);
+    }
 
-            // Input CPHD is always Big Endian; swap to Little Endian if
-            // necessary
-            if (swapToLittleEndian)
-            {
-                byteSwap(buf,
-                         sizeof(double),
-                         data.size() / sizeof(double),
-                         numThreads);
-            }
+    return totalBytesRead;
+}
 
-            sys::byte* ptr = buf;
-            for (size_t jj = 0; jj < mData[ii].size(); ++jj, ptr += numBytesPerVector)
-            {
-                mData[ii][jj].setData(ptr);
-            }
-        }
+sys::Off_T VBM::loadChannel(io::SeekableInputStream& inStream,
+                            sys::Off_T startVBM,
+                            size_t channel,
+                            size_t numThreads,
+                            ThreadPool* threadPool)
+{
+    if (channel >= mData.size())
+    {
+        throw except::Exception(Ctxt(
+                "Invalid channel number: " + str::toString<size_t>(channel)));
     }
 
-    return totalBytesRead;
+    // Channels are stored one after another
+    sys::Off_T offset = startVBM;
+    for (size_t ii = 0; ii < channel; ++ii)
+    {
+        offset += getVBMsize(ii);
+    }
+
+    inStream.seek(offset, io::Seekable::START);
+    std::vector<sys::ubyte> data;
+    return readChannel(inStream, channel, numThreads, threadPool, data);
 }
 
 std::ostream& operator<< (std::ostream& os, const VBM& d)
@@ -804,7 +958,7 @@ std::ostream& operator<< (std::ostream& os, const VBM& d)
 
         for (size_t ii = 0; ii < d.mData.size(); ++ii)
         {
-            if (d.mData[0].empty())
+            if (d.mData[0].size() == 0)
             {
                 os << "[" << ii << "] mData: (empty)\n";
             }
@@ -24,11 +24,11 @@
 #include <sstream>
 
 #include <sys/Conf.h>
-#include <mt/ThreadGroup.h>
 #include <mt/ThreadPlanner.h>
 #include <except/Exception.h>
 #include <io/FileInputStream.h>
 #include <cphd/ByteSwap.h>
+#include <cphd/ThreadPool.h>
 #include <cphd/Utilities.h>
 #include <cphd/Wideband.h>
 
@@ -110,7 +110,8 @@ template <typename InT>
 void promote(const void* input,
              const types::RowCol<size_t>& dims,
              size_t numThreads,
-             std::complex<float>* output)
+             std::complex<float>* output,
+             cphd::ThreadPool* threadPool)
 {
     if (numThreads <= 1)
     {
@@ -119,7 +120,7 @@ void promote(const void* input,
     }
     else
     {
-        mt::ThreadGroup threads;
+        cphd::RunnableGroup threads(threadPool);
         const mt::ThreadPlanner planner(dims.row, numThreads);
 
         size_t threadNum(0);
@@ -135,10 +136,10 @@ void promote(const void* input,
                     numRowsThisThread,
                     dims.col,
                     output));
-            threads.createThread(scaler);
+            threads.add(scaler);
         }
 
-        threads.joinAll();
+        threads.run();
 
     }
 }
@@ -147,18 +148,19 @@ void promote(const void* input,
              size_t elementSize,
              const types::RowCol<size_t>& dims,
              size_t numThreads,
-             std::complex<float>* output)
+             std::complex<float>* output,
+             cphd::ThreadPool* threadPool)
 {
     switch (elementSize)
     {
     case 2:
-        promote<sys::Int8_T>(input, dims, numThreads, output);
+        promote<sys::Int8_T>(input, dims, numThreads, output, threadPool);
         break;
     case 4:
-        promote<sys::Int16_T>(input, dims, numThreads, output);
+        promote<sys::Int16_T>(input, dims, numThreads, output, threadPool);
         break;
     case 8:
-        promote<float>(input, dims, numThreads, output);
+        promote<float>(input, dims, numThreads, output, threadPool);
         break;
     default:
         throw except::Exception(Ctxt(
@@ -170,7 +172,8 @@ void scale(const void* input,
            const types::RowCol<size_t>& dims,
            const double* scaleFactors,
            size_t numThreads,
-           std::complex<float>* output)
+           std::complex<float>* output,
+           cphd::ThreadPool* threadPool)
 {
     if (numThreads <= 1)
     {
@@ -179,7 +182,7 @@ void scale(const void* input,
     }
     else
     {
-        mt::ThreadGroup threads;
+        cphd::RunnableGroup threads(threadPool);
         const mt::ThreadPlanner planner(dims.row, numThreads);
 
         size_t threadNum(0);
@@ -196,10 +199,10 @@ void scale(const void* input,
                     dims.col,
                     scaleFactors,
                     output));
-            threads.createThread(scaler);
+            threads.add(scaler);
         }
 
-        threads.joinAll();
+        threads.run();
     }
 }
 
@@ -208,18 +211,22 @@ void scale(const void* input,
            const types::RowCol<size_t>& dims,
            const double* scaleFactors,
            size_t numThreads,
-           std::complex<float>* output)
+           std::complex<float>* output,
+           cphd::ThreadPool* threadPool)
 {
     switch (elementSize)
     {
     case 2:
-        scale<sys::Int8_T>(input, dims, scaleFactors, numThreads, output);
+        scale<sys::Int8_T>(input, dims, scaleFactors, numThreads, output,
+                             threadPool);
         break;
     case 4:
-        scale<sys::Int16_T>(input, dims, scaleFactors, numThreads, output);
+        scale<sys::Int16_T>(input, dims, scaleFactors, numThreads, output,
+                             threadPool);
         break;
     case 8:
-        scale<float>(input, dims, scaleFactors, numThreads, output);
+        scale<float>(input, dims, scaleFactors, numThreads, output,
+                             threadPool);
         break;
     default:
         throw except::Exception(Ctxt(
@@ -415,7 +422,8 @@ void Wideband::read(size_t channel,
     // Element size is half mElementSize because it's complex
     if (!sys::isBigEndianSystem() && mElementSize > 2)
     {
-        byteSwap(data.data, mElementSize / 2, numPixels * 2, numThreads);
+        byteSwap(data.data, mElementSize / 2, numPixels * 2, numThreads,
+                 mThreadPool.get());
     }
 }
 
@@ -479,6 +487,12 @@ void Wideband::read(size_t channel,
         return;
     }
 
+    // The local promote() and scale() don't know about the pool's size
+    if (mThreadPool.get())
+    {
+        numThreads = mThreadPool->getNumThreads();
+    }
+
     // If the caller provides per-vector scale factors, but they're all 1's,
     // we don't need to actually apply anything
     const bool needToScale(!allOnes(vectorScaleFactors));
@@ -516,13 +530,14 @@ void Wideband::read(size_t channel,
         {
             // Need to endian swap and then scale
             byteSwapAndScale(scratch.data, mElementSize, dims,
-                             &vectorScaleFactors[0], numThreads, data.data);
+                             &vectorScaleFactors[0], numThreads, data.data,
+                             mThreadPool.get());
         }
         else
         {
             // Just need to scale
             scale(scratch.data, mElementSize, dims, &vectorScaleFactors[0],
-                  numThreads, data.data);
+                  numThreads, data.data, mThreadPool.get());
         }
     }
     // We need to convert the output to floating-point data
@@ -535,11 +550,12 @@ void Wideband::read(size_t channel,
         if (!sys::isBigEndianSystem() && mElementSize > 2)
         {
             byteSwapAndPromote(scratch.data, mElementSize, dims, numThreads,
-                    data.data);
+                    data.data, mThreadPool.get());
         }
         else
         {
-            promote(scratch.data, mElementSize, dims, numThreads, data.data);
+            promote(scratch.data, mElementSize, dims, numThreads, data.data,
+                    mThreadPool.get());
         }
     }
     else
@@ -552,7 +568,8 @@ void Wideband::read(size_t channel,
         // Element size is half mElementSize because it's complex
         if (!sys::isBigEndianSystem() && mElementSize > 2)
         {
-            byteSwap(data.data, mElementSize / 2, numPixels * 2, numThreads);
+            byteSwap(data.data, mElementSize / 2, numPixels * 2, numThreads,
+                 mThreadPool.get());
         }
     }
 }
@@ -0,0 +1,245 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <algorithm>
+#include <limits>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include <cphd/WidebandBlockReader.h>
+
+namespace
+{
+// Special buffer indices passed through the queues
+const size_t NO_BUFFER = std::numeric_limits<size_t>::max();
+const size_t END_OF_CHANNEL = NO_BUFFER - 1;
+const size_t READ_FAILED = NO_BUFFER - 2;
+const size_t STOP = NO_BUFFER - 3;
+}
+
+namespace cphd
+{
+class WidebandBlockReader::PrefetchRunnable : public sys::Runnable
+{
+public:
+    PrefetchRunnable(WidebandBlockReader& reader) :
+        mReader(reader)
+    {
+    }
+
+    virtual void run()
+    {
+        mReader.prefetch();
+    }
+
+private:
+    WidebandBlockReader& mReader;
+};
+
+WidebandBlockReader::WidebandBlockReader(CPHDReader& reader,
+                                         size_t channel,
+                                         size_t numVectorsPerBlock,
+                                         size_t numBlocksToPrefetch,
+                                         bool applyAmpSF,
+                                         size_t numThreads) :
+    mWideband(reader.getWideband()),
+    mChannel(channel),
+    mNumVectors(reader.getNumVectors(channel)),
+    mNumSamples(reader.getNumSamples(channel)),
+    mNumVectorsPerBlock(std::min(numVectorsPerBlock, mNumVectors)),
+    mNumThreads(numThreads),
+    mCurrentBuffer(NO_BUFFER),
+    mDone(false)
+{
+    if (numVectorsPerBlock == 0 || numBlocksToPrefetch == 0)
+    {
+        throw except::Exception(Ctxt(
+                "Must read at least one vector per block and prefetch at "
+                "least one block"));
+    }
+
+    if (mNumVectors == 0)
+    {
+        mDone = true;
+        return;
+    }
+
+    if (applyAmpSF)
+    {
+        const double* const ampSF =
+                reader.getVBM(channel).getAmpSFs(channel);
+        mScaleFactors.assign(ampSF, ampSF + mNumVectors);
+    }
+    else
+    {
+        mScaleFactors.assign(mNumVectors, 1.0);
+    }
+
+    // One buffer for the caller plus the ones being prefetched, but there's
+    // no point in having more than there are blocks
+    const size_t numBuffers =
+            std::min(numBlocksToPrefetch + 1, getNumBlocks());
+    const size_t blockSize = mNumVectorsPerBlock * mNumSamples;
+    mBuffers.resize(numBuffers);
+    mFirstVectors.resize(numBuffers);
+    for (size_t ii = 0; ii < numBuffers; ++ii)
+    {
+        mBuffers[ii].resize(blockSize);
+        mFreeBuffers.enqueue(ii);
+    }
+    mScratch.resize(blockSize * reader.getNumBytesPerSample());
+
+    mThread.reset(new sys::Thread(new PrefetchRunnable(*this)));
+    mThread->start();
+}
+
+WidebandBlockReader::~WidebandBlockReader()
+{
+    try
+    {
+        stop();
+    }
+    catch (...)
+    {
+    }
+}
+
+void WidebandBlockReader::stop()
+{
+    if (mThread.get())
+    {
+        // Buffers the caller already handed back may be ahead of this in
+        // the queue, so the background thread may read a block or two more
+        // before it sees it
+        mFreeBuffers.enqueue(STOP);
+        mThread->join();
+        mThread.reset();
+    }
+}
+
+void WidebandBlockReader::prefetch()
+{
+    std::vector<double> scaleFactors;
+
+    for (size_t firstVector = 0;
+         firstVector < mNumVectors;
+         firstVector += mNumVectorsPerBlock)
+    {
+        size_t buffer(NO_BUFFER);
+        mFreeBuffers.dequeue(buffer);
+        if (buffer == STOP)
+        {
+            return;
+        }
+
+        const size_t numVectors =
+                std::min(mNumVectorsPerBlock, mNumVectors - firstVector);
+        scaleFactors.assign(mScaleFactors.begin() + firstVector,
+                            mScaleFactors.begin() + firstVector + numVectors);
+
+        try
+        {
+            mWideband.read(mChannel,
+                           firstVector,
+                           firstVector + numVectors - 1,
+                           0,
+                           Wideband::ALL,
+                           scaleFactors,
+                           mNumThreads,
+                           mem::BufferView<sys::ubyte>(&mScratch[0],
+                                                       mScratch.size()),
+                           mem::BufferView<std::complex<float> >(
+                                   &mBuffers[buffer][0],
+                                   mBuffers[buffer].size()));
+        }
+        catch (const except::Exception& ex)
+        {
+            mError = ex.getMessage();
+            mReadyBuffers.enqueue(READ_FAILED);
+            return;
+        }
+        catch (const std::exception& ex)
+        {
+            mError = ex.what();
+            mReadyBuffers.enqueue(READ_FAILED);
+            return;
+        }
+        catch (...)
+        {
+            mError = "Unknown exception";
+            mReadyBuffers.enqueue(READ_FAILED);
+            return;
+        }
+
+        mFirstVectors[buffer] = firstVector;
+        mReadyBuffers.enqueue(buffer);
+    }
+
+    mReadyBuffers.enqueue(END_OF_CHANNEL);
+}
+
+void WidebandBlockReader::releaseCurrentBuffer()
+{
+    if (mCurrentBuffer != NO_BUFFER)
+    {
+        mFreeBuffers.enqueue(mCurrentBuffer);
+        mCurrentBuffer = NO_BUFFER;
+    }
+}
+
+bool WidebandBlockReader::next(Block& block)
+{
+    releaseCurrentBuffer();
+
+    if (mDone)
+    {
+        return false;
+    }
+
+    size_t buffer(NO_BUFFER);
+    mReadyBuffers.dequeue(buffer);
+
+    if (buffer == END_OF_CHANNEL || buffer == READ_FAILED)
+    {
+        mDone = true;
+
+        // The background thread has exited, so mError is safe to read
+        stop();
+        if (buffer == READ_FAILED)
+        {
+            throw except::Exception(Ctxt(
+                    "Failed to read block of channel " +
+                    str::toString(mChannel) + ": " + mError));
+        }
+        return false;
+    }
+
+    mCurrentBuffer = buffer;
+    block.firstVector = mFirstVectors[buffer];
+    block.numVectors = std::min(mNumVectorsPerBlock,
+                                mNumVectors - block.firstVector);
+    block.numSamples = mNumSamples;
+    block.data = &mBuffers[buffer][0];
+    return true;
+}
+}
@@ -29,6 +29,7 @@
 
 #include <cphd/CPHDReader.h>
 #include <cphd/CPHDWriter.h>
+#include <cphd/WidebandBlockReader.h>
 #include <types/RowCol.h>
 #include <cli/ArgumentParser.h>
 #include <io/TempFile.h>
@@ -248,6 +249,94 @@ TEST_CASE(testScaledFloat)
     const bool scale = true;
     TEST_ASSERT(runTest(scale, writeData));
 }
+
+TEST_CASE(testSharedThreadPool)
+{
+    io::TempFile tempfile;
+    const types::RowCol<size_t> dims(128, 128);
+    const std::vector<std::complex<sys::Int16_T> > writeData =
+            generateData<sys::Int16_T>(dims.area());
+    writeCPHD(tempfile.pathname(), 1, dims, writeData);
+
+    mem::SharedPtr<cphd::ThreadPool> threadPool(new cphd::ThreadPool(3));
+    for (size_t ii = 0; ii < 2; ++ii)
+    {
+        const bool scale = (ii == 1);
+        const std::vector<double> scaleFactors =
+                generateScaleFactors(dims.row, scale);
+
+        cphd::CPHDReader reader(tempfile.pathname(), threadPool);
+        TEST_ASSERT(reader.getWideband().getThreadPool().get() ==
+                    threadPool.get());
+
+        std::vector<std::complex<float> > readData(dims.area());
+        std::vector<sys::ubyte> scratch(dims.area() * 4);
+        reader.getWideband().read(
+                0, 0, cphd::Wideband::ALL, 0, cphd::Wideband::ALL,
+                scaleFactors, 0,
+                mem::BufferView<sys::ubyte>(&scratch[0], scratch.size()),
+                mem::BufferView<std::complex<float> >(&readData[0],
+                                                      readData.size()));
+        TEST_ASSERT(compareVectors(readData, writeData, scaleFactors, scale));
+    }
+}
+
+TEST_CASE(testBlockReader)
+{
+    io::TempFile tempfile;
+    const types::RowCol<size_t> dims(128, 64);
+    const std::vector<std::complex<sys::Int16_T> > writeData =
+            generateData<sys::Int16_T>(dims.area());
+    writeCPHD(tempfile.pathname(), 1, dims, writeData);
+
+    cphd::CPHDReader reader(tempfile.pathname(), 1);
+
+    // Blocks don't divide the channel evenly
+    const size_t numVectorsPerBlock = 30;
+    cphd::WidebandBlockReader blockReader(reader, 0, numVectorsPerBlock, 2,
+                                          false, 2);
+    TEST_ASSERT_EQ(blockReader.getNumBlocks(), 5);
+
+    cphd::WidebandBlockReader::Block block;
+    size_t numVectorsRead = 0;
+    while (blockReader.next(block))
+    {
+        TEST_ASSERT_EQ(block.firstVector, numVectorsRead);
+        TEST_ASSERT_EQ(block.numSamples, dims.col);
+        TEST_ASSERT_EQ(block.numVectors,
+                       std::min(numVectorsPerBlock, dims.row - numVectorsRead));
+
+        const size_t offset = block.firstVector * dims.col;
+        for (size_t ii = 0; ii < block.numVectors * block.numSamples; ++ii)
+        {
+            TEST_ASSERT_EQ(block.data[ii].real(),
+                           writeData[offset + ii].real());
+            TEST_ASSERT_EQ(block.data[ii].imag(),
+                           writeData[offset + ii].imag());
+        }
+        numVectorsRead += block.numVectors;
+    }
+    TEST_ASSERT_EQ(numVectorsRead, dims.row);
+    TEST_ASSERT(!blockReader.next(block));
+
+    // This CPHD has no AmpSF
+    TEST_EXCEPTION(cphd::WidebandBlockReader(reader, 0, 10, 1, true, 1));
+}
+
+TEST_CASE(testBlockReaderEarlyExit)
+{
+    io::TempFile tempfile;
+    const types::RowCol<size_t> dims(100, 16);
+    writeCPHD(tempfile.pathname(), 1, dims,
+              generateData<sys::Int8_T>(dims.area()));
+
+    cphd::CPHDReader reader(tempfile.pathname(), 1);
+    cphd::WidebandBlockReader blockReader(reader, 0, 10, 3, false, 1);
+    cphd::WidebandBlockReader::Block block;
+    TEST_ASSERT(blockReader.next(block));
+    TEST_ASSERT(blockReader.next(block));
+    TEST_ASSERT_EQ(block.firstVector, 10);
+}
 }
 
 int main(int argc, char** argv)
@@ -260,6 +349,9 @@ int main(int argc, char** argv)
         TEST_CHECK(testScaledInt16);
         TEST_CHECK(testUnscaledFloat);
         TEST_CHECK(testScaledFloat);
+        TEST_CHECK(testSharedThreadPool);
+        TEST_CHECK(testBlockReader);
+        TEST_CHECK(testBlockReaderEarlyExit);
         return 0;
     }
     catch (const std::exception& ex)
@@ -20,6 +20,8 @@
  *
  */
 
+#include <sys/Runnable.h>
+#include <mt/ThreadGroup.h>
 #include <cphd/CPHDWriter.h>
 #include <cphd/CPHDReader.h>
 #include <types/RowCol.h>
@@ -319,13 +321,8 @@ void addTwoWayParams(cphd::Metadata& metadata)
     }
 }
 
-void runCPHDTest(const std::string& testName,
-                 cphd::Metadata& metadata)
+void fillRandomVBM(const cphd::Metadata& metadata, cphd::VBM& vbm)
 {
-    metadata.data.numCPHDChannels = NUM_IMAGES;
-    cphd::CPHDWriter writer(metadata, NUM_THREADS);
-
-    cphd::VBM vbm(metadata.data, metadata.vectorParameters);
     for (size_t ii = 0; ii < NUM_IMAGES; ++ii)
     {
         for (size_t jj = 0; jj < metadata.getNumVectors(ii); ++jj)
@@ -361,6 +358,17 @@ void runCPHDTest(const std::string& testName,
             }
         }
     }
+}
+
+void runCPHDTest(const std::string& testName,
+                 cphd::Metadata& metadata)
+{
+    metadata.data.numCPHDChannels = NUM_IMAGES;
+    cphd::CPHDWriter writer(metadata, NUM_THREADS);
+
+    cphd::VBM vbm(metadata.data, metadata.vectorParameters);
+    fillRandomVBM(metadata, vbm);
+
     //std::vector<std::vector<sys::ubyte> >vbm(NUM_IMAGES);
     std::vector<std::vector<std::complex<float> > >data(NUM_IMAGES);
     std::vector<types::RowCol<size_t> > dims(NUM_IMAGES);
@@ -411,6 +419,146 @@ void runCPHDTest(const std::string& testName,
             TEST_ASSERT_EQ(readBuffer[jj], data[ii][jj]);
         }
     }
+
+    // Nothing past the header is read until it's asked for, and then only
+    // the VBM channels that are asked for
+    cphd::CPHDReader lazyReader(FILE_NAME, NUM_THREADS,
+                                mem::SharedPtr<logging::Logger>(),
+                                cphd::CPHDReader::LOAD_HEADER);
+    TEST_ASSERT_EQ(lazyReader.getFileHeader().getVBMsize(),
+                   reader.getFileHeader().getVBMsize());
+    TEST_ASSERT_EQ(metadata, lazyReader.getMetadata());
+
+    const size_t lastChannel = NUM_IMAGES - 1;
+    const cphd::VBM& lazyVBM = lazyReader.getVBM(lastChannel);
+    TEST_ASSERT(lazyVBM.isLoaded(lastChannel));
+    for (size_t ii = 0; ii < lastChannel; ++ii)
+    {
+        TEST_ASSERT(!lazyVBM.isLoaded(ii));
+        TEST_ASSERT_EQ(lazyVBM.getNumVectors(ii), vbm.getNumVectors(ii));
+        TEST_EXCEPTION(lazyVBM.getTxTime(ii, 0));
+    }
+
+    std::vector<sys::ubyte> expectedVBM;
+    vbm.getVBMdata(lastChannel, expectedVBM);
+    lazyVBM.getVBMdata(lastChannel, readVBM);
+    TEST_ASSERT(readVBM == expectedVBM);
+
+    // Asking for the whole VBM fills in the rest
+    TEST_ASSERT_EQ(vbm, lazyReader.getVBM());
+}
+
+// Writes every numThreads'th block of vectors, last block first
+class WriteBlocksRunnable : public sys::Runnable
+{
+public:
+    WriteBlocksRunnable(cphd::CPHDWriter& writer,
+                        const std::vector<std::complex<float> >& data,
+                        size_t channel,
+                        const types::RowCol<size_t>& dims,
+                        size_t numVectorsPerBlock,
+                        size_t threadNum,
+                        size_t numThreads) :
+        mWriter(writer),
+        mData(data),
+        mChannel(channel),
+        mDims(dims),
+        mNumVectorsPerBlock(numVectorsPerBlock),
+        mThreadNum(threadNum),
+        mNumThreads(numThreads)
+    {
+    }
+
+    virtual void run()
+    {
+        const size_t numBlocks =
+                (mDims.row + mNumVectorsPerBlock - 1) / mNumVectorsPerBlock;
+        for (size_t block = numBlocks - mThreadNum;
+             block > 0 && block <= numBlocks;
+             block -= std::min(block, mNumThreads))
+        {
+            const size_t firstVector = (block - 1) * mNumVectorsPerBlock;
+            const size_t numVectors =
+                    std::min(mNumVectorsPerBlock, mDims.row - firstVector);
+            mWriter.writeCPHDData(&mData[firstVector * mDims.col],
+                                  mChannel, firstVector, numVectors);
+        }
+    }
+
+private:
+    cphd::CPHDWriter& mWriter;
+    const std::vector<std::complex<float> >& mData;
+    const size_t mChannel;
+    const types::RowCol<size_t> mDims;
+    const size_t mNumVectorsPerBlock;
+    const size_t mThreadNum;
+    const size_t mNumThreads;
+};
+
+TEST_CASE(testRandomAccessWrite)
+{
+    cphd::Metadata metadata;
+    buildRandomMetadata(metadata);
+    addFXParams(metadata);
+    addTwoWayParams(metadata);
+    metadata.data.numCPHDChannels = NUM_IMAGES;
+    metadata.data.sampleType = cphd::SampleType::RE32F_IM32F;
+
+    // A scratch size that isn't a whole number of samples
+    cphd::CPHDWriter writer(metadata, NUM_THREADS, 1001);
+    cphd::VBM vbm(metadata.data, metadata.vectorParameters);
+    fillRandomVBM(metadata, vbm);
+    writer.openForRandomAccess(FILE_NAME, vbm);
+
+    // Channels last to first, each with several threads writing blocks
+    // out of order
+    const size_t numThreads = 4;
+    std::vector<std::vector<std::complex<float> > > data(NUM_IMAGES);
+    std::vector<types::RowCol<size_t> > dims(NUM_IMAGES);
+    for (size_t ii = NUM_IMAGES; ii > 0; --ii)
+    {
+        const size_t channel = ii - 1;
+        dims[channel] = types::RowCol<size_t>(
+                metadata.getNumVectors(channel),
+                metadata.getNumSamples(channel));
+        data[channel].resize(dims[channel].area());
+        for (size_t jj = 0; jj < data[channel].size(); ++jj)
+        {
+            data[channel][jj] = std::complex<float>(
+                    getRandomReal(), getRandomReal());
+        }
+
+        mt::ThreadGroup threads;
+        for (size_t thread = 0; thread < numThreads; ++thread)
+        {
+            threads.createThread(new WriteBlocksRunnable(
+                    writer, data[channel], channel, dims[channel], 3,
+                    thread, numThreads));
+        }
+        threads.joinAll();
+    }
+    writer.close();
+
+    cphd::CPHDReader reader(FILE_NAME, NUM_THREADS);
+    TEST_ASSERT_EQ(reader.getFileOffset(1, 2, 0), writer.getFileOffset(1, 2));
+    TEST_ASSERT_EQ(vbm, reader.getVBM());
+
+    for (size_t ii = 0; ii < NUM_IMAGES; ++ii)
+    {
+        mem::ScopedArray<sys::ubyte> readData;
+        reader.getWideband().read(ii,
+                                  0, cphd::Wideband::ALL,
+                                  0, cphd::Wideband::ALL,
+                                  NUM_THREADS, readData);
+
+        const std::complex<float>* readBuffer =
+                reinterpret_cast<std::complex<float>* >(readData.get());
+        TEST_ASSERT(std::equal(data[ii].begin(), data[ii].end(),
+                               readBuffer));
+    }
+
+    TEST_EXCEPTION(writer.writeCPHDData(&data[0][0], 0,
+                                        dims[0].row, 1));
 }
 
 TEST_CASE(testWriteFXOneWay)
@@ -461,6 +609,7 @@ int main(int , char** )
     TEST_CHECK(testWriteFXTwoWay);
     TEST_CHECK(testWriteTOAOneWay);
     TEST_CHECK(testWriteTOATwoWay);
+    TEST_CHECK(testRandomAccessWrite);
     sys::OS().remove(FILE_NAME);
     return 0;
 }
@@ -0,0 +1,247 @@
+/* =========================================================================
+ * This file is part of cphd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * cphd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <except/Exception.h>
+#include <sys/Mutex.h>
+#include <sys/OS.h>
+#include <sys/Thread.h>
+#include <mt/CriticalSection.h>
+#include <cphd/ThreadPool.h>
+
+#include "TestCase.h"
+
+namespace
+{
+class SetRunnable : public sys::Runnable
+{
+public:
+    SetRunnable(std::vector<size_t>& values, size_t index) :
+        mValues(values),
+        mIndex(index)
+    {
+    }
+
+    virtual void run()
+    {
+        mValues[mIndex] = mIndex + 1;
+    }
+
+private:
+    std::vector<size_t>& mValues;
+    const size_t mIndex;
+};
+
+class ThrowRunnable : public sys::Runnable
+{
+public:
+    virtual void run()
+    {
+        throw except::Exception(Ctxt("Failed on purpose"));
+    }
+};
+
+// A flag that one thread waits on until another sets it
+class Gate
+{
+public:
+    Gate() :
+        mOpen(false)
+    {
+    }
+
+    void open()
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        mOpen = true;
+    }
+
+    bool isOpen()
+    {
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        return mOpen;
+    }
+
+    // Gives up after about 10 seconds so a broken pool fails the test
+    // instead of hanging it
+    bool waitUntilOpen()
+    {
+        for (size_t ii = 0; ii < 1000; ++ii)
+        {
+            if (isOpen())
+            {
+                return true;
+            }
+            sys::OS().millisleep(10);
+        }
+        return false;
+    }
+
+private:
+    sys::Mutex mMutex;
+    bool mOpen;
+};
+
+class WaitRunnable : public sys::Runnable
+{
+public:
+    WaitRunnable(Gate& gate, bool& opened) :
+        mGate(gate),
+        mOpened(opened)
+    {
+    }
+
+    virtual void run()
+    {
+        mOpened = mGate.waitUntilOpen();
+    }
+
+private:
+    Gate& mGate;
+    bool& mOpened;
+};
+
+// Calls ThreadPool::run() from another thread
+class RunGroupRunnable : public sys::Runnable
+{
+public:
+    RunGroupRunnable(cphd::ThreadPool& pool,
+                     std::vector<sys::Runnable*>& runnables,
+                     Gate& done) :
+        mPool(pool),
+        mRunnables(runnables),
+        mDone(done)
+    {
+    }
+
+    virtual void run()
+    {
+        mPool.run(mRunnables);
+        mDone.open();
+    }
+
+private:
+    cphd::ThreadPool& mPool;
+    std::vector<sys::Runnable*>& mRunnables;
+    Gate& mDone;
+};
+
+TEST_CASE(testRun)
+{
+    cphd::ThreadPool pool(3);
+    TEST_ASSERT_EQ(pool.getNumThreads(), 3);
+
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+        std::vector<size_t> values(20, 0);
+        std::vector<sys::Runnable*> runnables;
+        for (size_t ii = 0; ii < values.size(); ++ii)
+        {
+            runnables.push_back(new SetRunnable(values, ii));
+        }
+
+        pool.run(runnables);
+        TEST_ASSERT(runnables.empty());
+        for (size_t ii = 0; ii < values.size(); ++ii)
+        {
+            TEST_ASSERT_EQ(values[ii], ii + 1);
+        }
+    }
+}
+
+TEST_CASE(testException)
+{
+    cphd::ThreadPool pool(2);
+
+    std::vector<size_t> values(10, 0);
+    std::vector<sys::Runnable*> runnables;
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        runnables.push_back(new SetRunnable(values, ii));
+        if (ii == 4)
+        {
+            runnables.push_back(new ThrowRunnable());
+        }
+    }
+    TEST_EXCEPTION(pool.run(runnables));
+
+    // The rest of the runnables still ran, and the workers survived
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(values[ii], ii + 1);
+    }
+
+    std::fill(values.begin(), values.end(), 0);
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        runnables.push_back(new SetRunnable(values, ii));
+    }
+    pool.run(runnables);
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(values[ii], ii + 1);
+    }
+}
+
+TEST_CASE(testIndependentGroups)
+{
+    // One group is stuck until the other one finishes, which only works
+    // if run() doesn't wait on runnables from other calls
+    cphd::ThreadPool pool(2);
+
+    Gate release;
+    Gate blockedDone;
+    bool opened(false);
+    std::vector<sys::Runnable*> blocked(1, new WaitRunnable(release, opened));
+    sys::Thread thread(new RunGroupRunnable(pool, blocked, blockedDone));
+    thread.start();
+
+    std::vector<size_t> values(5, 0);
+    std::vector<sys::Runnable*> runnables;
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        runnables.push_back(new SetRunnable(values, ii));
+    }
+    pool.run(runnables);
+    const bool finishedFirst = !blockedDone.isOpen();
+
+    release.open();
+    thread.join();
+    for (size_t ii = 0; ii < values.size(); ++ii)
+    {
+        TEST_ASSERT_EQ(values[ii], ii + 1);
+    }
+    TEST_ASSERT(finishedFirst);
+    TEST_ASSERT(opened);
+    TEST_ASSERT(blockedDone.isOpen());
+}
+}
+
+int main(int , char** )
+{
+    TEST_CHECK(testRun);
+    TEST_CHECK(testException);
+    TEST_CHECK(testIndependentGroups);
+    return 0;
+}
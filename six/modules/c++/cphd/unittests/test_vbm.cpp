@@ -289,6 +289,49 @@ TEST_CASE(testDataConstructor)
         }
     }
 }
+
+TEST_CASE(testColumns)
+{
+    cphd::VBM vbm(NUM_CHANNELS,
+                  std::vector<size_t>(NUM_CHANNELS, NUM_VECTORS),
+                  false,
+                  true,
+                  false,
+                  cphd::DomainType::TOA);
+
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+        {
+            vbm.setTxTime(getRandom(), channel, vector);
+            vbm.setTxPos(getRandomVector3(), channel, vector);
+            vbm.setTropoSRP(getRandom(), channel, vector);
+            vbm.setTOASS(getRandom(), channel, vector);
+        }
+    }
+
+    for (size_t channel = 0; channel < NUM_CHANNELS; ++channel)
+    {
+        TEST_ASSERT_EQ(vbm.getNumVectors(channel), NUM_VECTORS);
+        const double* const txTimes = vbm.getTxTimes(channel);
+        const cphd::Vector3* const txPositions = vbm.getTxPositions(channel);
+        const double* const tropoSRPs = vbm.getTropoSRPs(channel);
+        const double* const toaSSs = vbm.getTOASSs(channel);
+        for (size_t vector = 0; vector < NUM_VECTORS; ++vector)
+        {
+            TEST_ASSERT_EQ(txTimes[vector], vbm.getTxTime(channel, vector));
+            TEST_ASSERT_EQ(txPositions[vector], vbm.getTxPos(channel, vector));
+            TEST_ASSERT_EQ(tropoSRPs[vector],
+                           vbm.getTropoSRP(channel, vector));
+            TEST_ASSERT_EQ(toaSSs[vector], vbm.getTOASS(channel, vector));
+        }
+
+        TEST_EXCEPTION(vbm.getSRPTimes(channel));
+        TEST_EXCEPTION(vbm.getAmpSFs(channel));
+        TEST_EXCEPTION(vbm.getFx0s(channel));
+    }
+    TEST_EXCEPTION(vbm.getTxTimes(NUM_CHANNELS));
+}
 }
 
 int main(int , char** )
@@ -299,6 +342,7 @@ int main(int , char** )
     TEST_CHECK(testVbmThrow);
     TEST_CHECK(testVbmCopy);
     TEST_CHECK(testDataConstructor);
+    TEST_CHECK(testColumns);
     return 0;
 }
 
@@ -204,6 +204,109 @@ public:
                          double heightThreshold = 1.0,
                          size_t maxNumIters = 3) const;
 
+    /*!
+     * Batch version of sceneToImage().  The scene points are passed as
+     * separate arrays of ECEF x, y, and z coordinates.  Rather than
+     * converging one point at a time, each iteration is applied to every
+     * unconverged point of a block so that the TimeCOA and ARP polynomials
+     * are evaluated over the whole block at once.  The points are split
+     * across 'numThreads' threads.  Results are identical to calling
+     * sceneToImage() on each point.
+     *
+     * \param x Scene point ECEF x coordinates
+     * \param y Scene point ECEF y coordinates
+     * \param z Scene point ECEF z coordinates
+     * \param numPoints Number of scene points
+     * \param delta Delta values to apply for the adjustable parameters
+     * \param numThreads Number of threads to use
+     * \param[out] rows Image grid point rows (meters)
+     * \param[out] cols Image grid point columns (meters)
+     * \param[out] timeCOAs Optional timeCOA of each point.  Not set if NULL.
+     * \param warmStart If true, each block of points starts iterating from
+     * the offset at which the previous block's last point converged rather
+     * than from the scene points themselves.  For neighboring points this
+     * saves iterations; results then agree with sceneToImage() to within
+     * its convergence tolerance rather than exactly.
+     *
+     * \throws except::Exception if any point fails to converge
+     */
+    void sceneToImage(const double* x,
+                      const double* y,
+                      const double* z,
+                      size_t numPoints,
+                      const AdjustableParams& delta,
+                      size_t numThreads,
+                      double* rows,
+                      double* cols,
+                      double* timeCOAs = NULL,
+                      bool warmStart = false) const;
+
+    /*!
+     * Batch version of imageToScene() onto a ground plane.  The image grid
+     * points are passed as separate arrays of rows and columns (meters).
+     * Results are identical to calling imageToScene() on each point.
+     *
+     * \param rows Image grid point rows (meters)
+     * \param cols Image grid point columns (meters)
+     * \param numPoints Number of image grid points
+     * \param groundRefPoint A ground plane reference point
+     * \param groundPlaneNormal The ground plane unit normal
+     * \param delta Delta values to apply for the adjustable parameters
+     * \param numThreads Number of threads to use
+     * \param[out] x Scene point ECEF x coordinates
+     * \param[out] y Scene point ECEF y coordinates
+     * \param[out] z Scene point ECEF z coordinates
+     * \param[out] timeCOAs Optional timeCOA of each point.  Not set if NULL.
+     */
+    void imageToScene(const double* rows,
+                      const double* cols,
+                      size_t numPoints,
+                      const Vector3& groundRefPoint,
+                      const Vector3& groundPlaneNormal,
+                      const AdjustableParams& delta,
+                      size_t numThreads,
+                      double* x,
+                      double* y,
+                      double* z,
+                      double* timeCOAs = NULL) const;
+
+    /*!
+     * Batch version of imageToScene() onto a constant height surface.
+     * The geodetic ground plane at the SCP is only computed once for all
+     * the points.  Results are identical to calling imageToScene() on each
+     * point.
+     *
+     * \param rows Image grid point rows (meters)
+     * \param cols Image grid point columns (meters)
+     * \param numPoints Number of image grid points
+     * \param height Surface height (meters) above the WGS-84 reference
+     * ellipsoid
+     * \param delta Delta values to apply for the adjustable parameters
+     * \param numThreads Number of threads to use
+     * \param[out] x Scene point ECEF x coordinates
+     * \param[out] y Scene point ECEF y coordinates
+     * \param[out] z Scene point ECEF z coordinates
+     * \param heightThreshold See imageToScene()
+     * \param maxNumIters See imageToScene()
+     * \param warmStart If true, each point starts from the ground plane
+     * that the previous point converged to rather than from the SCP's.
+     * For neighboring points this usually meets 'heightThreshold' on the
+     * first iteration; results then agree with imageToScene() to within
+     * 'heightThreshold' rather than exactly.
+     */
+    void imageToScene(const double* rows,
+                      const double* cols,
+                      size_t numPoints,
+                      double height,
+                      const AdjustableParams& delta,
+                      size_t numThreads,
+                      double* x,
+                      double* y,
+                      double* z,
+                      double heightThreshold = 1.0,
+                      size_t maxNumIters = 3,
+                      bool warmStart = false) const;
+
     math::linear::MatrixMxN<2, 2> slantToImagePartials(
             const types::RowCol<double>& imageGridPoint,
             double delta = 0.0001) const;
@@ -280,6 +383,35 @@ public:
             const Vector3& scenePoint,
             double delta = 0.0001) const;
 
+    /*!
+     * Computes the partials of sceneToImage() with respect to both the
+     * scene point and the adjustable parameters without any further
+     * iterative projections.  The scene point lies on the R/Rdot contour
+     * of its image grid point, so the partials come from implicitly
+     * differentiating the contour equations.  The dependence on the scene
+     * point and the adjustable parameters is analytic; the dependence on
+     * the image grid point (through the TimeCOA, ARP, and grid specific
+     * contour polynomials) is found by central differences of the contour,
+     * which is cheap since nothing is projected.
+     *
+     * \param scenePoint A scene (ground) point in 3-space
+     * \param imageGridPoint The image grid point that scenePoint projects
+     * to via sceneToImage()
+     * \param[out] imagePartials Partials with respect to the scene point,
+     * as in sceneToImagePartials()
+     * \param[out] sensorPartials Partials with respect to the adjustable
+     * parameters, as in sceneToImageSensorPartials()
+     * \param delta Image grid step used to difference the contour.  The
+     * contour is smooth over many meters, and a step this large keeps the
+     * differences clear of roundoff in the (very large) ranges.
+     */
+    void sceneToImageAnalyticPartials(
+            const Vector3& scenePoint,
+            const types::RowCol<double>& imageGridPoint,
+            math::linear::MatrixMxN<2, 3>& imagePartials,
+            math::linear::MatrixMxN<2, 7>& sensorPartials,
+            double delta = 1.0) const;
+
     /*!
      * Provides sensor error covariance matrix with tropo and iono errors
      * rolled in
@@ -351,6 +483,47 @@ protected:
                                 Vector3& arpCOA,
                                 Vector3& velCOA) const;
 
+    // True unless the adjustable parameters and 'delta' are all 0, in which
+    // case imageToSceneAdjustment() is a no-op and can be skipped
+    bool needsAdjustment(const AdjustableParams& delta) const;
+
+    // Evaluates the TimeCOAPoly at each image grid point and then the
+    // ARPPoly and ARPVelPoly at each of those times
+    void computeCOAs(const double* rows,
+                     const double* cols,
+                     size_t numPoints,
+                     double* timeCOAs,
+                     Vector3* arpCOAs,
+                     Vector3* velCOAs) const;
+
+    // Steps 2 - 7 of imageToScene() onto a constant height surface, starting
+    // from the R/Rdot contour and the given ground plane (normally the
+    // SCP's geodetic ground plane).  If non-NULL, 'lastGroundPlaneNormal' and
+    // 'lastGroundRefPoint' are set to the ground plane the iteration would
+    // have moved to next, which is a good starting plane for neighboring
+    // points.
+    Vector3 contourToHeight(double r,
+                            double rDot,
+                            const Vector3& arpCOA,
+                            const Vector3& velCOA,
+                            double height,
+                            const Vector3& scpGroundPlaneNormal,
+                            const Vector3& scpGroundRefPoint,
+                            double heightThreshold,
+                            size_t maxNumIters,
+                            Vector3* lastGroundPlaneNormal = NULL,
+                            Vector3* lastGroundRefPoint = NULL) const;
+
+    // The R and Rdot of the line of sight from the (adjusted) ARP at
+    // imageGridPoint's timeCOA to scenePoint, minus the R/Rdot contour at
+    // imageGridPoint.  Both are 0 when scenePoint projects to
+    // imageGridPoint.
+    void contourResidual(const Vector3& scenePoint,
+                         const types::RowCol<double>& imageGridPoint,
+                         bool adjust,
+                         double* rResidual,
+                         double* rDotResidual) const;
+
 protected:
     Vector3 mSlantPlaneNormal;
     Vector3 mImagePlaneNormal;
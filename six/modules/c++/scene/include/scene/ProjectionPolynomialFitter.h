@@ -318,12 +318,21 @@ public:
     }
 
 private:
+    // Records output plane sample (row, col) and its ECEF location
+    void sampleOutputPlane(const GridECEFTransform& gridTransform,
+                           const types::RowCol<double>& outPixelStart,
+                           const types::RowCol<double>& currentOffset,
+                           size_t row,
+                           size_t col,
+                           std::vector<double>& x,
+                           std::vector<double>& y,
+                           std::vector<double>& z);
+
+    // Projects all of the samples' ECEF locations into the slant plane
     void projectToSlantPlane(const ProjectionModel& projModel,
-                             const GridECEFTransform& gridTransform,
-                             const types::RowCol<double>& outPixelStart,
-                             const types::RowCol<double>& currentOffset,
-                             size_t row,
-                             size_t col);
+                             const std::vector<double>& x,
+                             const std::vector<double>& y,
+                             const std::vector<double>& z);
 
     void getSlantPlaneSamples(
             const types::RowCol<size_t>& inPixelStart,
@@ -20,8 +20,14 @@
  *
  */
 
+#include <algorithm>
 #include <limits>
+#include <memory>
+#include <vector>
 
+#include <sys/Runnable.h>
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
 #include <math/Utilities.h>
 #include "scene/ProjectionModel.h"
 #include "scene/ECEFToLLATransform.h"
@@ -59,6 +65,189 @@ PolyType verboseDerivative(const PolyType& polynomial, const std::string& name)
     }
     return polynomial.derivative();
 }
+
+// Number of points the batch projections work on at once.  Small enough
+// that the per-block scratch stays in cache.
+const size_t BLOCK_SIZE = 256;
+
+// Evaluates 'poly' at each of 'times'.  The terms are accumulated in the
+// same order as OneD::operator() so results are identical, but each term is
+// applied to the whole block of points before moving on to the next one.
+void evaluateBlock(const math::poly::OneD<scene::Vector3>& poly,
+                   const double* times,
+                   size_t numPoints,
+                   double* powers,
+                   scene::Vector3* values)
+{
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        values[ii] = 0.0;
+        powers[ii] = 1.0;
+    }
+
+    const std::vector<scene::Vector3>& coeffs = poly.coeffs();
+    for (size_t term = 0; term < coeffs.size(); ++term)
+    {
+        const double c0 = coeffs[term][0];
+        const double c1 = coeffs[term][1];
+        const double c2 = coeffs[term][2];
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            const double atPwr = powers[ii];
+            scene::Vector3& value(values[ii]);
+            value[0] += c0 * atPwr;
+            value[1] += c1 * atPwr;
+            value[2] += c2 * atPwr;
+            powers[ii] = atPwr * times[ii];
+        }
+    }
+}
+
+class SceneToImageRunnable : public sys::Runnable
+{
+public:
+    SceneToImageRunnable(const scene::ProjectionModel& model,
+                         const double* x,
+                         const double* y,
+                         const double* z,
+                         size_t numPoints,
+                         const scene::AdjustableParams& delta,
+                         double* rows,
+                         double* cols,
+                         double* timeCOAs,
+                         bool warmStart) :
+        mModel(model),
+        mX(x),
+        mY(y),
+        mZ(z),
+        mNumPoints(numPoints),
+        mDelta(delta),
+        mRows(rows),
+        mCols(cols),
+        mTimeCOAs(timeCOAs),
+        mWarmStart(warmStart)
+    {
+    }
+
+    virtual void run()
+    {
+        mModel.sceneToImage(mX, mY, mZ, mNumPoints, mDelta, 1,
+                            mRows, mCols, mTimeCOAs, mWarmStart);
+    }
+
+private:
+    const scene::ProjectionModel& mModel;
+    const double* const mX;
+    const double* const mY;
+    const double* const mZ;
+    const size_t mNumPoints;
+    const scene::AdjustableParams& mDelta;
+    double* const mRows;
+    double* const mCols;
+    double* const mTimeCOAs;
+    const bool mWarmStart;
+};
+
+class ImageToGroundPlaneRunnable : public sys::Runnable
+{
+public:
+    ImageToGroundPlaneRunnable(const scene::ProjectionModel& model,
+                               const double* rows,
+                               const double* cols,
+                               size_t numPoints,
+                               const scene::Vector3& groundRefPoint,
+                               const scene::Vector3& groundPlaneNormal,
+                               const scene::AdjustableParams& delta,
+                               double* x,
+                               double* y,
+                               double* z,
+                               double* timeCOAs) :
+        mModel(model),
+        mRows(rows),
+        mCols(cols),
+        mNumPoints(numPoints),
+        mGroundRefPoint(groundRefPoint),
+        mGroundPlaneNormal(groundPlaneNormal),
+        mDelta(delta),
+        mX(x),
+        mY(y),
+        mZ(z),
+        mTimeCOAs(timeCOAs)
+    {
+    }
+
+    virtual void run()
+    {
+        mModel.imageToScene(mRows, mCols, mNumPoints,
+                            mGroundRefPoint, mGroundPlaneNormal, mDelta, 1,
+                            mX, mY, mZ, mTimeCOAs);
+    }
+
+private:
+    const scene::ProjectionModel& mModel;
+    const double* const mRows;
+    const double* const mCols;
+    const size_t mNumPoints;
+    const scene::Vector3& mGroundRefPoint;
+    const scene::Vector3& mGroundPlaneNormal;
+    const scene::AdjustableParams& mDelta;
+    double* const mX;
+    double* const mY;
+    double* const mZ;
+    double* const mTimeCOAs;
+};
+
+class ImageToHeightRunnable : public sys::Runnable
+{
+public:
+    ImageToHeightRunnable(const scene::ProjectionModel& model,
+                          const double* rows,
+                          const double* cols,
+                          size_t numPoints,
+                          double height,
+                          const scene::AdjustableParams& delta,
+                          double* x,
+                          double* y,
+                          double* z,
+                          double heightThreshold,
+                          size_t maxNumIters,
+                          bool warmStart) :
+        mModel(model),
+        mRows(rows),
+        mCols(cols),
+        mNumPoints(numPoints),
+        mHeight(height),
+        mDelta(delta),
+        mX(x),
+        mY(y),
+        mZ(z),
+        mHeightThreshold(heightThreshold),
+        mMaxNumIters(maxNumIters),
+        mWarmStart(warmStart)
+    {
+    }
+
+    virtual void run()
+    {
+        mModel.imageToScene(mRows, mCols, mNumPoints, mHeight, mDelta, 1,
+                            mX, mY, mZ, mHeightThreshold, mMaxNumIters,
+                            mWarmStart);
+    }
+
+private:
+    const scene::ProjectionModel& mModel;
+    const double* const mRows;
+    const double* const mCols;
+    const size_t mNumPoints;
+    const double mHeight;
+    const scene::AdjustableParams& mDelta;
+    double* const mX;
+    double* const mY;
+    double* const mZ;
+    const double mHeightThreshold;
+    const size_t mMaxNumIters;
+    const bool mWarmStart;
+};
 }
 
 namespace scene
@@ -274,9 +463,9 @@ Vector3 ProjectionModel::imageToScene(
     //    section 5.1 for details)
     const ECEFToLLATransform ecefToLatLon;
     const LatLonAlt scpLatLon = ecefToLatLon.transform(mSCP);
-    Vector3 groundPlaneNormal = computeUnitVector(scpLatLon);
+    const Vector3 groundPlaneNormal = computeUnitVector(scpLatLon);
 
-    Vector3 groundRefPoint =
+    const Vector3 groundRefPoint =
             mSCP + (height - scpLatLon.getAlt()) * groundPlaneNormal;
 
     // Compute contour just once
@@ -292,6 +481,28 @@ Vector3 ProjectionModel::imageToScene(
     // Adjustable parameters do not affect Rdot
     imageToSceneAdjustment(delta, timeCOA, r, arpCOA, velCOA);
 
+    return contourToHeight(r, rDot, arpCOA, velCOA, height,
+                           groundPlaneNormal, groundRefPoint,
+                           heightThreshold, maxNumIters);
+}
+
+Vector3 ProjectionModel::contourToHeight(
+        double r,
+        double rDot,
+        const Vector3& arpCOA,
+        const Vector3& velCOA,
+        double height,
+        const Vector3& scpGroundPlaneNormal,
+        const Vector3& scpGroundRefPoint,
+        double heightThreshold,
+        size_t maxNumIters,
+        Vector3* lastGroundPlaneNormal,
+        Vector3* lastGroundRefPoint) const
+{
+    const ECEFToLLATransform ecefToLatLon;
+    Vector3 groundPlaneNormal(scpGroundPlaneNormal);
+    Vector3 groundRefPoint(scpGroundRefPoint);
+
     Vector3 gppECEF;
     Vector3 uUP;
     double deltaHeight(std::numeric_limits<double>::max());
@@ -333,6 +544,15 @@ Vector3 ProjectionModel::imageToScene(
         groundRefPoint = gppECEF - deltaHeight * uUP;
     }
 
+    if (lastGroundPlaneNormal)
+    {
+        *lastGroundPlaneNormal = uUP;
+    }
+    if (lastGroundRefPoint)
+    {
+        *lastGroundRefPoint = gppECEF - deltaHeight * uUP;
+    }
+
     // 5. Compute the unit slant plane normal vector that's tangent to the
     //    R/Rdot contour at the GPP.  This points away from the center of the
     //    earth and in a direction of increasing HAE at the GPP.
@@ -409,6 +629,366 @@ void ProjectionModel::imageToSceneAdjustment(const AdjustableParams& delta,
             delta[AdjustableParams::RANGE_BIAS];
 }
 
+bool ProjectionModel::needsAdjustment(const AdjustableParams& delta) const
+{
+    // An unknown frame type must still make it to imageToSceneAdjustment()
+    // so that it throws
+    if (mErrors.mFrameType.mValue != FrameType::RIC_ECF &&
+        mErrors.mFrameType.mValue != FrameType::RIC_ECI &&
+        mErrors.mFrameType.mValue != FrameType::ECF)
+    {
+        return true;
+    }
+
+    for (size_t ii = 0; ii < AdjustableParams::NUM_PARAMS; ++ii)
+    {
+        if (mAdjustableParams.mParams[ii] != 0.0 || delta.mParams[ii] != 0.0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ProjectionModel::computeCOAs(const double* rows,
+                                  const double* cols,
+                                  size_t numPoints,
+                                  double* timeCOAs,
+                                  Vector3* arpCOAs,
+                                  Vector3* velCOAs) const
+{
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        timeCOAs[ii] = mTimeCOAPoly(rows[ii], cols[ii]);
+    }
+
+    double powers[BLOCK_SIZE];
+    for (size_t ii = 0; ii < numPoints; ii += BLOCK_SIZE)
+    {
+        const size_t numThisBlock = std::min(BLOCK_SIZE, numPoints - ii);
+        evaluateBlock(mARPPoly, timeCOAs + ii, numThisBlock, powers,
+                      arpCOAs + ii);
+        evaluateBlock(mARPVelPoly, timeCOAs + ii, numThisBlock, powers,
+                      velCOAs + ii);
+    }
+}
+
+void ProjectionModel::sceneToImage(const double* x,
+                                   const double* y,
+                                   const double* z,
+                                   size_t numPoints,
+                                   const AdjustableParams& delta,
+                                   size_t numThreads,
+                                   double* rows,
+                                   double* cols,
+                                   double* timeCOAs,
+                                   bool warmStart) const
+{
+    if (numThreads > 1 && numPoints > BLOCK_SIZE)
+    {
+        const mt::ThreadPlanner planner(numPoints, numThreads);
+        mt::ThreadGroup threads;
+        size_t threadNum(0);
+        size_t startPoint(0);
+        size_t numPointsThisThread(0);
+        while (planner.getThreadInfo(threadNum++, startPoint,
+                                     numPointsThisThread))
+        {
+            threads.createThread(new SceneToImageRunnable(
+                    *this,
+                    x + startPoint, y + startPoint, z + startPoint,
+                    numPointsThisThread,
+                    delta,
+                    rows + startPoint, cols + startPoint,
+                    timeCOAs ? timeCOAs + startPoint : NULL,
+                    warmStart));
+        }
+        threads.joinAll();
+        return;
+    }
+
+    const bool adjust = needsAdjustment(delta);
+
+    // Per block state.  'active' holds the indices of the points that have
+    // not converged yet, and the grid point and COA arrays are packed to
+    // match it.
+    std::vector<Vector3> scenePoints(BLOCK_SIZE);
+    std::vector<Vector3> groundPlaneNormals(BLOCK_SIZE);
+    std::vector<Vector3> groundPlanePoints(BLOCK_SIZE);
+    std::vector<size_t> active(BLOCK_SIZE);
+    std::vector<double> activeRows(BLOCK_SIZE);
+    std::vector<double> activeCols(BLOCK_SIZE);
+    std::vector<double> activeTimes(BLOCK_SIZE);
+    std::vector<Vector3> activeARPs(BLOCK_SIZE);
+    std::vector<Vector3> activeVels(BLOCK_SIZE);
+
+    // Where the ground plane point ended up relative to its scene point for
+    // the last point of the previous block
+    Vector3 warmOffset(0.0);
+
+    for (size_t first = 0; first < numPoints; first += BLOCK_SIZE)
+    {
+        const size_t numThisBlock = std::min(BLOCK_SIZE, numPoints - first);
+        for (size_t ii = 0; ii < numThisBlock; ++ii)
+        {
+            // For each scenePoint, we will compute the spherical earth
+            // unit ground plane normal (uGPN) and set the initial ground
+            // plane position to the scenePoint
+            Vector3& scenePoint(scenePoints[ii]);
+            scenePoint[0] = x[first + ii];
+            scenePoint[1] = y[first + ii];
+            scenePoint[2] = z[first + ii];
+            groundPlaneNormals[ii] = scenePoint;
+            groundPlaneNormals[ii].normalize();
+            groundPlanePoints[ii] = scenePoint;
+            if (warmStart)
+            {
+                groundPlanePoints[ii] += warmOffset;
+            }
+            active[ii] = ii;
+        }
+
+        size_t numActive = numThisBlock;
+        for (size_t iter = 0; iter < MAX_ITER && numActive > 0; ++iter)
+        {
+            // Project each ground plane point to the image plane
+            for (size_t jj = 0; jj < numActive; ++jj)
+            {
+                const Vector3& groundPlanePoint(groundPlanePoints[active[jj]]);
+                const double dist = (mSCP - groundPlanePoint).dot(
+                        mImagePlaneNormal) * mScaleFactor;
+                const types::RowCol<double> imageGridPoint =
+                        computeImageCoordinates(
+                                groundPlanePoint + mSlantPlaneNormal * dist);
+                activeRows[jj] = imageGridPoint.row;
+                activeCols[jj] = imageGridPoint.col;
+            }
+
+            computeCOAs(&activeRows[0], &activeCols[0], numActive,
+                        &activeTimes[0], &activeARPs[0], &activeVels[0]);
+
+            // Project back to the ground and keep the points that haven't
+            // converged yet
+            size_t numStillActive = 0;
+            for (size_t jj = 0; jj < numActive; ++jj)
+            {
+                const size_t ii = active[jj];
+                const types::RowCol<double> imageGridPoint(activeRows[jj],
+                                                           activeCols[jj]);
+                double r;
+                double rDot;
+                computeContour(activeARPs[jj], activeVels[jj],
+                               activeTimes[jj], imageGridPoint, &r, &rDot);
+                if (adjust)
+                {
+                    imageToSceneAdjustment(delta, activeTimes[jj], r,
+                                           activeARPs[jj], activeVels[jj]);
+                }
+
+                const Vector3 diff = scenePoints[ii] - contourToGroundPlane(
+                        r, rDot, activeARPs[jj], activeVels[jj],
+                        groundPlaneNormals[ii], scenePoints[ii]);
+
+                if (diff.norm() < DELTA_GP_MAX)
+                {
+                    rows[first + ii] = imageGridPoint.row;
+                    cols[first + ii] = imageGridPoint.col;
+                    if (timeCOAs)
+                    {
+                        timeCOAs[first + ii] = activeTimes[jj];
+                    }
+                }
+                else
+                {
+                    groundPlanePoints[ii] += diff;
+                    active[numStillActive++] = ii;
+                }
+            }
+            numActive = numStillActive;
+        }
+
+        if (numActive > 0)
+        {
+            throw except::Exception(Ctxt("Point failed to converge"));
+        }
+
+        warmOffset = groundPlanePoints[numThisBlock - 1] -
+                scenePoints[numThisBlock - 1];
+    }
+}
+
+void ProjectionModel::imageToScene(const double* rows,
+                                   const double* cols,
+                                   size_t numPoints,
+                                   const Vector3& groundRefPoint,
+                                   const Vector3& groundPlaneNormal,
+                                   const AdjustableParams& delta,
+                                   size_t numThreads,
+                                   double* x,
+                                   double* y,
+                                   double* z,
+                                   double* timeCOAs) const
+{
+    if (numThreads > 1 && numPoints > BLOCK_SIZE)
+    {
+        const mt::ThreadPlanner planner(numPoints, numThreads);
+        mt::ThreadGroup threads;
+        size_t threadNum(0);
+        size_t startPoint(0);
+        size_t numPointsThisThread(0);
+        while (planner.getThreadInfo(threadNum++, startPoint,
+                                     numPointsThisThread))
+        {
+            threads.createThread(new ImageToGroundPlaneRunnable(
+                    *this,
+                    rows + startPoint, cols + startPoint,
+                    numPointsThisThread,
+                    groundRefPoint, groundPlaneNormal, delta,
+                    x + startPoint, y + startPoint, z + startPoint,
+                    timeCOAs ? timeCOAs + startPoint : NULL));
+        }
+        threads.joinAll();
+        return;
+    }
+
+    const bool adjust = needsAdjustment(delta);
+    double times[BLOCK_SIZE];
+    std::vector<Vector3> arpCOAs(BLOCK_SIZE);
+    std::vector<Vector3> velCOAs(BLOCK_SIZE);
+
+    for (size_t first = 0; first < numPoints; first += BLOCK_SIZE)
+    {
+        const size_t numThisBlock = std::min(BLOCK_SIZE, numPoints - first);
+        computeCOAs(rows + first, cols + first, numThisBlock,
+                    times, &arpCOAs[0], &velCOAs[0]);
+
+        for (size_t ii = 0; ii < numThisBlock; ++ii)
+        {
+            double r;
+            double rDot;
+            computeContour(arpCOAs[ii], velCOAs[ii], times[ii],
+                           types::RowCol<double>(rows[first + ii],
+                                                 cols[first + ii]),
+                           &r, &rDot);
+            if (adjust)
+            {
+                imageToSceneAdjustment(delta, times[ii], r,
+                                       arpCOAs[ii], velCOAs[ii]);
+            }
+
+            const Vector3 scenePoint =
+                    contourToGroundPlane(r, rDot, arpCOAs[ii], velCOAs[ii],
+                                         groundPlaneNormal, groundRefPoint);
+            x[first + ii] = scenePoint[0];
+            y[first + ii] = scenePoint[1];
+            z[first + ii] = scenePoint[2];
+            if (timeCOAs)
+            {
+                timeCOAs[first + ii] = times[ii];
+            }
+        }
+    }
+}
+
+void ProjectionModel::imageToScene(const double* rows,
+                                   const double* cols,
+                                   size_t numPoints,
+                                   double height,
+                                   const AdjustableParams& delta,
+                                   size_t numThreads,
+                                   double* x,
+                                   double* y,
+                                   double* z,
+                                   double heightThreshold,
+                                   size_t maxNumIters,
+                                   bool warmStart) const
+{
+    // Sanity checks
+    if (heightThreshold <= 0)
+    {
+        throw except::Exception(Ctxt("Height threshold must be positive"));
+    }
+
+    if (maxNumIters < 1)
+    {
+        throw except::Exception(Ctxt(
+                "Max number of iterations must be positive"));
+    }
+
+    if (numThreads > 1 && numPoints > BLOCK_SIZE)
+    {
+        const mt::ThreadPlanner planner(numPoints, numThreads);
+        mt::ThreadGroup threads;
+        size_t threadNum(0);
+        size_t startPoint(0);
+        size_t numPointsThisThread(0);
+        while (planner.getThreadInfo(threadNum++, startPoint,
+                                     numPointsThisThread))
+        {
+            threads.createThread(new ImageToHeightRunnable(
+                    *this,
+                    rows + startPoint, cols + startPoint,
+                    numPointsThisThread,
+                    height, delta,
+                    x + startPoint, y + startPoint, z + startPoint,
+                    heightThreshold, maxNumIters, warmStart));
+        }
+        threads.joinAll();
+        return;
+    }
+
+    // The geodetic ground plane at the SCP is the same for every point
+    const ECEFToLLATransform ecefToLatLon;
+    const LatLonAlt scpLatLon = ecefToLatLon.transform(mSCP);
+    const Vector3 groundPlaneNormal = computeUnitVector(scpLatLon);
+    const Vector3 groundRefPoint =
+            mSCP + (height - scpLatLon.getAlt()) * groundPlaneNormal;
+
+    // With a warm start, these follow along from point to point
+    Vector3 startGroundPlaneNormal(groundPlaneNormal);
+    Vector3 startGroundRefPoint(groundRefPoint);
+
+    const bool adjust = needsAdjustment(delta);
+    double times[BLOCK_SIZE];
+    std::vector<Vector3> arpCOAs(BLOCK_SIZE);
+    std::vector<Vector3> velCOAs(BLOCK_SIZE);
+
+    for (size_t first = 0; first < numPoints; first += BLOCK_SIZE)
+    {
+        const size_t numThisBlock = std::min(BLOCK_SIZE, numPoints - first);
+        computeCOAs(rows + first, cols + first, numThisBlock,
+                    times, &arpCOAs[0], &velCOAs[0]);
+
+        for (size_t ii = 0; ii < numThisBlock; ++ii)
+        {
+            double r;
+            double rDot;
+            computeContour(arpCOAs[ii], velCOAs[ii], times[ii],
+                           types::RowCol<double>(rows[first + ii],
+                                                 cols[first + ii]),
+                           &r, &rDot);
+            if (adjust)
+            {
+                imageToSceneAdjustment(delta, times[ii], r,
+                                       arpCOAs[ii], velCOAs[ii]);
+            }
+
+            const Vector3 scenePoint =
+                    contourToHeight(r, rDot, arpCOAs[ii], velCOAs[ii],
+                                    height,
+                                    startGroundPlaneNormal,
+                                    startGroundRefPoint,
+                                    heightThreshold, maxNumIters,
+                                    warmStart ? &startGroundPlaneNormal : NULL,
+                                    warmStart ? &startGroundRefPoint : NULL);
+            x[first + ii] = scenePoint[0];
+            y[first + ii] = scenePoint[1];
+            z[first + ii] = scenePoint[2];
+        }
+    }
+}
+
 math::linear::MatrixMxN<3, 3> ProjectionModel::getRICtoECEFTransformMatrix(
         double earthInitialSpin,
         double timeCOA) const
@@ -618,6 +1198,139 @@ math::linear::MatrixMxN<2, 3> ProjectionModel::sceneToImagePartials(
     return sceneToImagePartials(scenePoint, imagePt, delta);
 }
 
+void ProjectionModel::contourResidual(
+        const Vector3& scenePoint,
+        const types::RowCol<double>& imageGridPoint,
+        bool adjust,
+        double* rResidual,
+        double* rDotResidual) const
+{
+    const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
+                                        imageGridPoint.col);
+    Vector3 arpCOA = mARPPoly(timeCOA);
+    Vector3 velCOA = mARPVelPoly(timeCOA);
+
+    double r;
+    double rDot;
+    computeContour(arpCOA, velCOA, timeCOA, imageGridPoint, &r, &rDot);
+    if (adjust)
+    {
+        imageToSceneAdjustment(AdjustableParams(), timeCOA, r,
+                               arpCOA, velCOA);
+    }
+
+    const Vector3 lineOfSight = arpCOA - scenePoint;
+    const double range = lineOfSight.norm();
+    *rResidual = range - r;
+    *rDotResidual = velCOA.dot(lineOfSight) / range - rDot;
+}
+
+void ProjectionModel::sceneToImageAnalyticPartials(
+        const Vector3& scenePoint,
+        const types::RowCol<double>& imageGridPoint,
+        math::linear::MatrixMxN<2, 3>& imagePartials,
+        math::linear::MatrixMxN<2, 7>& sensorPartials,
+        double delta) const
+{
+    const bool adjust = needsAdjustment(AdjustableParams());
+
+    // Partials of the contour residual with respect to the image grid point
+    math::linear::MatrixMxN<2, 2> gridPartials(0.0);
+    for (size_t idx = 0; idx < 2; ++idx)
+    {
+        types::RowCol<double> plus(imageGridPoint);
+        types::RowCol<double> minus(imageGridPoint);
+        if (idx == 0)
+        {
+            plus.row += delta;
+            minus.row -= delta;
+        }
+        else
+        {
+            plus.col += delta;
+            minus.col -= delta;
+        }
+
+        double rPlus;
+        double rDotPlus;
+        double rMinus;
+        double rDotMinus;
+        contourResidual(scenePoint, plus, adjust, &rPlus, &rDotPlus);
+        contourResidual(scenePoint, minus, adjust, &rMinus, &rDotMinus);
+        gridPartials(0, idx) = (rPlus - rMinus) / (2.0 * delta);
+        gridPartials(1, idx) = (rDotPlus - rDotMinus) / (2.0 * delta);
+    }
+
+    // The residual stays 0 as the scene point or adjustable parameters
+    // move, so the image grid point moves by -gridPartials^-1 times the
+    // residual's partials with respect to them
+    const math::linear::MatrixMxN<2, 2> gridPartialsInv =
+            math::linear::inverse(gridPartials) * -1.0;
+
+    const double timeCOA = mTimeCOAPoly(imageGridPoint.row,
+                                        imageGridPoint.col);
+    Vector3 arpCOA = mARPPoly(timeCOA);
+    Vector3 velCOA = mARPVelPoly(timeCOA);
+    if (adjust)
+    {
+        double r(0.0);
+        imageToSceneAdjustment(AdjustableParams(), timeCOA, r,
+                               arpCOA, velCOA);
+    }
+
+    // R = |ARP - P| and Rdot = V . (ARP - P) / R, so with u the unit line of
+    // sight from P to the ARP, dR/dARP = u and dRdot/dARP = (V - (V.u)u) / R
+    Vector3 lineOfSight = arpCOA - scenePoint;
+    const double range = lineOfSight.norm();
+    lineOfSight = lineOfSight / range;
+    const Vector3 rDotPerARP =
+            (velCOA - lineOfSight * velCOA.dot(lineOfSight)) / range;
+
+    // The scene point enters with the opposite sign of the ARP
+    math::linear::MatrixMxN<2, 3> residualPerScene;
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        residualPerScene(0, ii) = -lineOfSight[ii];
+        residualPerScene(1, ii) = -rDotPerARP[ii];
+    }
+    imagePartials = gridPartialsInv * residualPerScene;
+
+    // The ARP and velocity adjustments are rotated into ECEF first (see
+    // imageToSceneAdjustment()).  The range bias adds to R.
+    math::linear::MatrixMxN<3, 3> toECEF;
+    switch (mErrors.mFrameType.mValue)
+    {
+    case FrameType::RIC_ECF:
+        toECEF = getRICtoECEFTransformMatrix(0.0, timeCOA);
+        break;
+    case FrameType::RIC_ECI:
+        toECEF = getRICtoECEFTransformMatrix(EARTH_ROTATION_RATE, timeCOA);
+        break;
+    case FrameType::ECF:
+        toECEF = math::linear::identityMatrix<3, double>();
+        break;
+    default:
+        throw except::Exception(Ctxt(
+                "Reference Frame for error parameters undefined"));
+    }
+
+    math::linear::MatrixMxN<2, 7> residualPerParam(0.0);
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        for (size_t jj = 0; jj < 3; ++jj)
+        {
+            residualPerParam(0, AdjustableParams::ARP_RADIAL + ii) +=
+                    lineOfSight[jj] * toECEF(jj, ii);
+            residualPerParam(1, AdjustableParams::ARP_RADIAL + ii) +=
+                    rDotPerARP[jj] * toECEF(jj, ii);
+            residualPerParam(1, AdjustableParams::ARP_VEL_RADIAL + ii) +=
+                    lineOfSight[jj] * toECEF(jj, ii);
+        }
+    }
+    residualPerParam(0, AdjustableParams::RANGE_BIAS) = -1.0;
+    sensorPartials = gridPartialsInv * residualPerParam;
+}
+
 math::linear::MatrixMxN<7, 7> ProjectionModel::getErrorCovariance(
         const Vector3& scenePoint,
         double timeCOA) const
@@ -728,6 +1441,15 @@ math::linear::MatrixMxN<2, 2> ProjectionModel::getUnmodeledErrorCovariance(
     // it is necessary to propagate the slant plane error to the image plane
     const math::linear::MatrixMxN<2, 2>
             unmodeledCovar(mErrors.mUnmodeledErrorCovar);
+
+    // Propagating no error gives no error.  This skips the two scene to
+    // image projections that slantToImagePartials() needs.
+    if (unmodeledCovar(0, 0) == 0.0 && unmodeledCovar(0, 1) == 0.0 &&
+        unmodeledCovar(1, 0) == 0.0 && unmodeledCovar(1, 1) == 0.0)
+    {
+        return unmodeledCovar;
+    }
+
     const math::linear::MatrixMxN<2,2> slantToImageJacobian =
             slantToImagePartials(imageGridPoint);
 
@@ -71,6 +71,9 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
         static_cast<double>(outExtent.col - 1) / (mNumPoints1D - 1));
 
     types::RowCol<double> currentOffset(outPixelStart);
+    std::vector<double> x(mNumPoints1D * mNumPoints1D);
+    std::vector<double> y(x.size());
+    std::vector<double> z(x.size());
 
     for (size_t ii = 0;
          ii < mNumPoints1D;
@@ -82,10 +85,12 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
              jj < mNumPoints1D;
              ++jj, currentOffset.col += skip.col)
         {
-            projectToSlantPlane(projModel, gridTransform, outPixelStart,
-                                currentOffset, ii, jj);
+            sampleOutputPlane(gridTransform, outPixelStart, currentOffset,
+                              ii, jj, x, y, z);
         }
     }
+
+    projectToSlantPlane(projModel, x, y, z);
 }
 
 ProjectionPolynomialFitter::ProjectionPolynomialFitter(
@@ -190,6 +195,10 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
          static_cast<double>(newExtentRow - 1) / 
          static_cast<double>(numPoints1D - 1);
 
+    std::vector<double> x(mNumPoints1D * mNumPoints1D);
+    std::vector<double> y(x.size());
+    std::vector<double> z(x.size());
+
     double currentOffsetRow = static_cast<double>(newStartRow);
     for (size_t ii = 0; ii < numPoints1D; ++ii, currentOffsetRow += newDeltaRow)
     {
@@ -217,19 +226,23 @@ ProjectionPolynomialFitter::ProjectionPolynomialFitter(
         for (size_t jj = 0; jj < numPoints1D; ++jj, currentCol += newDeltaCol)
         {
             const types::RowCol<double> currentOffset(currentRow, currentCol);
-            projectToSlantPlane(projModel, gridTransform, outPixelStart,
-                currentOffset, ii, jj);
+            sampleOutputPlane(gridTransform, outPixelStart, currentOffset,
+                              ii, jj, x, y, z);
         }
     }
+
+    projectToSlantPlane(projModel, x, y, z);
 }
 
-void ProjectionPolynomialFitter::projectToSlantPlane(
-    const ProjectionModel& projModel,
+void ProjectionPolynomialFitter::sampleOutputPlane(
     const GridECEFTransform& gridTransform,
     const types::RowCol<double>& outPixelStart,
     const types::RowCol<double>& currentOffset,
     size_t row,
-    size_t col)
+    size_t col,
+    std::vector<double>& x,
+    std::vector<double>& y,
+    std::vector<double>& z)
 {
     // Get the coordinate relative to the outPixelStart.
     mOutputPlaneRows(row, col) = currentOffset.row - outPixelStart.row;
@@ -239,11 +252,39 @@ void ProjectionPolynomialFitter::projectToSlantPlane(
     const scene::Vector3 ecef =
         gridTransform.rowColToECEF(currentOffset);
 
-    // Project ECEF coordinate into the slant plane and get meters from
-    // the slant plane scene center point.
-    double timeCOA(0.0);
-    mSceneCoordinates(row, col) = projModel.sceneToImage(ecef, &timeCOA);
-    mTimeCOA(row, col) = timeCOA;
+    const size_t idx = row * mNumPoints1D + col;
+    x[idx] = ecef[0];
+    y[idx] = ecef[1];
+    z[idx] = ecef[2];
+}
+
+void ProjectionPolynomialFitter::projectToSlantPlane(
+    const ProjectionModel& projModel,
+    const std::vector<double>& x,
+    const std::vector<double>& y,
+    const std::vector<double>& z)
+{
+    // Project the ECEF coordinates into the slant plane and get meters from
+    // the slant plane scene center point.  These are projected as one batch
+    // so the TimeCOA and ARP polynomials are evaluated over all of them at
+    // once.
+    const size_t numPoints = x.size();
+    std::vector<double> rows(numPoints);
+    std::vector<double> cols(numPoints);
+    std::vector<double> timeCOAs(numPoints);
+    projModel.sceneToImage(&x[0], &y[0], &z[0], numPoints,
+                           AdjustableParams(), 1,
+                           &rows[0], &cols[0], &timeCOAs[0]);
+
+    for (size_t row = 0, idx = 0; row < mNumPoints1D; ++row)
+    {
+        for (size_t col = 0; col < mNumPoints1D; ++col, ++idx)
+        {
+            mSceneCoordinates(row, col) =
+                    types::RowCol<double>(rows[idx], cols[idx]);
+            mTimeCOA(row, col) = timeCOAs[idx];
+        }
+    }
 }
 
 void ProjectionPolynomialFitter::getSlantPlaneSamples(
@@ -84,6 +84,12 @@ UByte* ConvertingReadControl::interleaved(Region& region, size_t imageNumber)
         throw except::Exception(Ctxt("Please load ConvertingReadControl "
                 "before calling interleaved()"));
     }
+    if (region.isDecimated())
+    {
+        throw except::Exception(Ctxt(
+                "Decimated reads are not supported by ConvertingReadControl"));
+    }
+
     const Data* data = mContainer->getData(imageNumber);
     if (region.getNumRows() == -1)
     {
@@ -39,6 +39,11 @@ namespace sicd
  * Reads in an AOI from a SICD and creates a cropped SICD, updating the
  * metadata as appropriate to reflect this
  *
+ * The AOI is streamed from the input to the output a chunk of rows at a
+ * time, read with a thread per CPU, so it's never all in memory at once.
+ * Uncompressed, unblocked pixels are copied as they're stored without being
+ * byte swapped.  The other overloads do the same.
+ *
  * \param inPathname Input SICD pathname
  * \param schemaPaths Schema paths to use for reading and writing
  * \param aoiOffset Upper left corner of AOI
@@ -54,6 +59,8 @@ void cropSICD(const std::string& inPathname,
 /*
  * Same as above but allow an already-opened reader to be used.
  * NITFReadControl::load() must be called prior to calling this function.
+ * The AOI is read with the reader's NITFReadControl::OPT_NUM_READ_THREADS
+ * threads.
  */
 void cropSICD(six::NITFReadControl& reader,
               const std::vector<std::string>& schemaPaths,
@@ -0,0 +1,188 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SIX_SICD_MAPPED_SICD_READER_H__
+#define __SIX_SICD_MAPPED_SICD_READER_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <complex>
+
+#include <sys/Conf.h>
+#include <types/RowCol.h>
+#include <six/sicd/ComplexData.h>
+
+namespace six
+{
+namespace sicd
+{
+/*!
+ * \class MappedSICDReader
+ * \brief Memory maps an uncompressed SICD and provides views directly into
+ * the pixel data of each image segment.  No pixel data is read until the
+ * caller touches it, and then only the pages touched are faulted in, so this
+ * is well suited for pulling many small chips out of a large SICD.
+ *
+ * The pixels are left exactly as they are on disk: big endian I/Q pairs
+ * of the SICD's pixel type.  Use needsByteSwap() to determine whether the
+ * caller must swap them before use.
+ *
+ * This class is not copyable.
+ */
+class MappedSICDReader
+{
+public:
+    /*!
+     * \struct SegmentView
+     * \brief A strided view over the pixels of one image segment
+     */
+    struct SegmentView
+    {
+        //! The first pixel of the segment
+        const sys::ubyte* data;
+
+        //! First row of the segment in the full image
+        size_t firstRow;
+
+        //! Number of rows in the segment
+        size_t numRows;
+
+        //! Number of columns in the segment
+        size_t numCols;
+
+        //! Number of bytes from the start of one row to the next
+        size_t rowStride;
+
+        //! Number of bytes in one (I, Q) pixel
+        size_t numBytesPerPixel;
+
+        /*!
+         * \param row Row relative to the start of the segment
+         *
+         * \return The first pixel of the row
+         */
+        const sys::ubyte* getRow(size_t row) const
+        {
+            return data + row * rowStride;
+        }
+    };
+
+    /*!
+     * Loads the SICD's metadata and maps the file
+     *
+     * \param pathname SICD NITF pathname
+     * \param schemaPaths Directories or files of schema locations
+     *
+     * \throws except::Exception if the file is not a SICD or any of its
+     * image segments are compressed or blocked
+     */
+    MappedSICDReader(const std::string& pathname,
+                     const std::vector<std::string>& schemaPaths);
+
+    //! Unmaps the file
+    ~MappedSICDReader();
+
+    //! \return The SICD metadata
+    const ComplexData& getComplexData() const
+    {
+        return *mComplexData;
+    }
+
+    //! \return True if the mapped pixels are in non-native byte order
+    static bool needsByteSwap()
+    {
+        return !sys::isBigEndianSystem();
+    }
+
+    //! \return The number of image segments
+    size_t getNumSegments() const
+    {
+        return mSegments.size();
+    }
+
+    //! \return A view of image segment 'segment'
+    const SegmentView& getSegment(size_t segment) const;
+
+    /*!
+     * \param row Row in the full image
+     *
+     * \return The first pixel of the row
+     */
+    const sys::ubyte* getRow(size_t row) const;
+
+    /*!
+     * \param row Row in the full image
+     * \param col Column in the full image
+     *
+     * \return The pixel at (row, col)
+     */
+    const sys::ubyte* getPixel(size_t row, size_t col) const
+    {
+        return getRow(row) + col * mComplexData->getNumBytesPerPixel();
+    }
+
+    /*!
+     * Copies a region of the image into 'buffer' as complex<float>.
+     * RE16I_IM16I pixels are swapped and promoted in a single pass
+     * straight out of the mapped file.
+     *
+     * \param offset The first row and column of the region
+     * \param extent The number of rows and columns in the region
+     * \param[out] buffer Output pixels.  Must be at least extent.area()
+     * pixels.
+     *
+     * \throws except::Exception if the region is out of bounds or the
+     * pixel type is not complex float32 or complex int16
+     */
+    void getWidebandData(const types::RowCol<size_t>& offset,
+                         const types::RowCol<size_t>& extent,
+                         std::complex<float>* buffer) const;
+
+private:
+    // Noncopyable
+    MappedSICDReader(const MappedSICDReader& );
+    const MappedSICDReader& operator=(const MappedSICDReader& );
+
+    void map(const std::string& pathname);
+
+    void unmap();
+
+private:
+    std::auto_ptr<ComplexData> mComplexData;
+    std::vector<SegmentView> mSegments;
+
+    sys::ubyte* mAddress;
+    size_t mLength;
+
+#ifdef WIN32
+    void* mFileHandle;
+    void* mMappingHandle;
+#else
+    int mFileDescriptor;
+#endif
+};
+}
+}
+
+#endif
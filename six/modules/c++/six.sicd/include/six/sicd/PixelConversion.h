@@ -0,0 +1,52 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef __SIX_SICD_PIXEL_CONVERSION_H__
+#define __SIX_SICD_PIXEL_CONVERSION_H__
+
+#include <stddef.h>
+#include <complex>
+
+namespace six
+{
+namespace sicd
+{
+/*
+ * Promotes RE16I_IM16I pixels to complex<float>, optionally byte swapping
+ * each component along the way.  The swap and the widening happen in one
+ * pass, and the loop is written so that the compiler can vectorize it.
+ *
+ * \param input Pixels to convert.  Need not be aligned.
+ * \param numPixels Number of (I, Q) pixels in 'input'
+ * \param byteSwap If true, each component of 'input' is byte swapped before
+ * it is promoted (e.g. when 'input' holds raw big endian NITF data on a
+ * little endian system)
+ * \param[out] output Promoted pixels.  Must not overlap 'input'.
+ */
+void promotePixels(const void* input,
+                   size_t numPixels,
+                   bool byteSwap,
+                   std::complex<float>* output);
+}
+}
+
+#endif
@@ -22,8 +22,10 @@
 #ifndef __SIX_SICD_MESH_H__
 #define __SIX_SICD_MESH_H__
 
+#include <io/SeekableStreams.h>
 #include <mem/ScopedCopyablePtr.h>
 #include <six/Mesh.h>
+#include <six/Types.h>
 
 namespace six
 {
@@ -43,6 +45,9 @@ struct SICDMeshes
 
     //! Type ID for SICD noise mesh
     static const char NOISE_MESH_ID[];
+
+    //! Type ID for SICD slant plane pixel to ECEF projection mesh
+    static const char PROJECTION_MESH_ID[];
 };
 
 /*!
@@ -112,6 +117,34 @@ public:
      */
     virtual void deserialize(const sys::byte*& values);
 
+    /*!
+     * Serializes the mesh to a stream without building it up in memory
+     * \param stream The stream to write to.
+     */
+    virtual void serialize(io::OutputStream& stream) const;
+
+    /*!
+     * Deserializes from a stream to a mesh.
+     * \param stream The stream to read from.
+     */
+    virtual void deserialize(io::InputStream& stream);
+
+    /*!
+     * Deserializes just a window of a serialized mesh, seeking past the
+     * rest of it.  The mesh's dimensions become those of the window.
+     * \param stream Stream positioned at the start of the serialized mesh.
+     *  On return, it's positioned just past the end of it.
+     * \param offset The first mesh row and column of the window
+     * \param windowDims The dimensions of the window
+     * \return The dimensions of the whole serialized mesh
+     *
+     * \throws except::Exception if the window doesn't fit in the mesh
+     */
+    virtual types::RowCol<size_t>
+    deserializeWindow(io::SeekableInputStream& stream,
+                      const types::RowCol<size_t>& offset,
+                      const types::RowCol<size_t>& windowDims);
+
 protected:
     const bool mSwapBytes;
     std::string mName;
@@ -190,11 +223,179 @@ public:
      */
     virtual void deserialize(const sys::byte*& values);
 
+    /*!
+     * Serializes the mesh to a stream without building it up in memory
+     * \param stream The stream to write to.
+     */
+    virtual void serialize(io::OutputStream& stream) const;
+
+    /*!
+     * Deserializes from a stream to a mesh.
+     * \param stream The stream to read from.
+     */
+    virtual void deserialize(io::InputStream& stream);
+
+    /*!
+     * Deserializes just a window of a serialized mesh, seeking past the
+     * rest of it.  The mesh's dimensions become those of the window.
+     * \param stream Stream positioned at the start of the serialized mesh.
+     *  On return, it's positioned just past the end of it.
+     * \param offset The first mesh row and column of the window
+     * \param windowDims The dimensions of the window
+     * \return The dimensions of the whole serialized mesh
+     *
+     * \throws except::Exception if the window doesn't fit in the mesh
+     */
+    virtual types::RowCol<size_t>
+    deserializeWindow(io::SeekableInputStream& stream,
+                      const types::RowCol<size_t>& offset,
+                      const types::RowCol<size_t>& windowDims);
+
 protected:
     std::vector<double> mMainBeamNoise;
     std::vector<double> mAzimuthAmbiguityNoise;
     std::vector<double> mCombinedNoise;
 };
+
+/*!
+ * \class ProjectionMesh
+ * \brief Exact ECEF projections of a regular grid of slant plane pixels.
+ *
+ * Node (ii, jj) of the mesh is the projection of slant plane pixel
+ * (ii * spacing.row, jj * spacing.col).  Positions of other pixels are
+ * bilinearly interpolated from the four surrounding nodes, which is far
+ * cheaper than running the iterative R/Rdot projection for every pixel.
+ */
+class ProjectionMesh : public Mesh
+{
+public:
+    /*!
+     * ProjectionMesh constructor. Mesh data is uninitialized.
+     * \param name Name of the mesh
+     */
+    ProjectionMesh(const std::string& name);
+
+    /*!
+     * ProjectionMesh constructor. Mesh data is initialized.
+     * \param name Name of the mesh.
+     * \param meshDims The mesh dimensions.
+     * \param spacing Slant plane pixels between mesh nodes in each
+     * direction.
+     * \param x The ECEF x-coordinates for the mesh.
+     * \param y The ECEF y-coordinates for the mesh.
+     * \param z The ECEF z-coordinates for the mesh.
+     *
+     * \throws except::Exception if validate() fails
+     */
+    ProjectionMesh(const std::string& name,
+                   const types::RowCol<size_t>& meshDims,
+                   const types::RowCol<double>& spacing,
+                   const std::vector<double>& x,
+                   const std::vector<double>& y,
+                   const std::vector<double>& z);
+
+    //! \return The mesh name
+    std::string getName() const
+    {
+        return mName;
+    }
+
+    //! \return The mesh dimensions
+    types::RowCol<size_t> getMeshDims() const
+    {
+        return mMeshDims;
+    }
+
+    //! \return Slant plane pixels between mesh nodes
+    types::RowCol<double> getSpacing() const
+    {
+        return mSpacing;
+    }
+
+    //! \return The flattened ECEF x-coordinates of the mesh
+    const std::vector<double>& getX() const
+    {
+        return mX;
+    }
+
+    //! \return The flattened ECEF y-coordinates of the mesh
+    const std::vector<double>& getY() const
+    {
+        return mY;
+    }
+
+    //! \return The flattened ECEF z-coordinates of the mesh
+    const std::vector<double>& getZ() const
+    {
+        return mZ;
+    }
+
+    /*!
+     * Bilinearly interpolates the ECEF position of a slant plane pixel.
+     * Pixels beyond the edge of the mesh are extrapolated from the nearest
+     * cell.
+     *
+     * \param pixel Slant plane pixel
+     *
+     * \return The interpolated ECEF position
+     *
+     * \throws except::Exception if the mesh is smaller than 2 x 2
+     */
+    Vector3 interpolate(const types::RowCol<double>& pixel) const;
+
+    /*!
+     * Checks that the mesh can be interpolated from
+     *
+     * \throws except::Exception if the mesh is smaller than 2 x 2, the
+     * spacing isn't positive, or there isn't one coordinate of each kind
+     * per node
+     */
+    void validate() const;
+
+    //! \return The vector of Field descriptors (file name, type)
+    virtual std::vector<Mesh::Field> getFields() const;
+
+    /*!
+     * Serializes the mesh to binary
+     * \param[out] values The serialized data.
+     */
+    virtual void serialize(std::vector<sys::byte>& values) const;
+
+    /*!
+     * Deserializes from binary to a mesh.
+     * \param values Data to deserialize.
+     *
+     * \throws except::Exception if the data isn't a valid mesh
+     */
+    virtual void deserialize(const sys::byte*& values);
+
+    /*!
+     * Serializes the mesh to a stream without building it up in memory
+     * \param stream The stream to write to.
+     */
+    virtual void serialize(io::OutputStream& stream) const;
+
+    /*!
+     * Deserializes from a stream to a mesh.
+     * \param stream The stream to read from.
+     *
+     * \throws except::Exception if the data isn't a valid mesh
+     */
+    virtual void deserialize(io::InputStream& stream);
+
+protected:
+    // Checks the dimensions and spacing, which are read before the
+    // coordinates
+    void validateLayout() const;
+
+    const bool mSwapBytes;
+    std::string mName;
+    types::RowCol<size_t> mMeshDims;
+    types::RowCol<double> mSpacing;
+    std::vector<double> mX;
+    std::vector<double> mY;
+    std::vector<double> mZ;
+};
 }
 }
 #endif
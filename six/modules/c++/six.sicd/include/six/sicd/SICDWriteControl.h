@@ -23,8 +23,10 @@
 #ifndef __SIX_SICD_WRITE_CONTROL_H__
 #define __SIX_SICD_WRITE_CONTROL_H__
 
+#include <string>
 #include <vector>
 
+#include <sys/Mutex.h>
 #include <types/RowCol.h>
 #include <six/NITFWriteControl.h>
 #include <six/sicd/ComplexData.h>
@@ -57,6 +59,9 @@ public:
     SICDWriteControl(const std::string& outputPathname,
                      const std::vector<std::string>& schemaPaths);
 
+    //! Closes the file if close() hasn't been called
+    ~SICDWriteControl();
+
     using NITFWriteControl::initialize;
 
     /*!
@@ -99,6 +104,30 @@ public:
               const types::RowCol<size_t>& dims,
               bool restoreData = true);
 
+    /*!
+     * Thread-safe counterpart to save() for producers that generate tiles
+     * concurrently.  Any number of threads may call this at once with
+     * non-overlapping tiles.  Pixels are written with positioned writes
+     * so there's no shared file pointer to serialize on, and when byte
+     * swapping is needed it's done into a scratch buffer so the caller's
+     * data is never modified.  Tiles that span the full image width are
+     * written with one call per image segment rather than one per row.
+     *
+     * The first call writes the headers.  Don't mix calls to this with
+     * calls to save() while tiles are being written.
+     *
+     * \param imageData The image data pixels to write.  The underlying type
+     *     will be complex short or complex float based on the complex data
+     *     sent in during initialize()
+     * \param offset The global offset in pixels as to where these pixels are
+     *     in the image
+     * \param dims The dimensions of the image data pixels.  Nothing is
+     *     written if either one is 0.
+     */
+    void saveTile(const void* imageData,
+                  const types::RowCol<size_t>& offset,
+                  const types::RowCol<size_t>& dims);
+
     /*!
      * Closes the underlying IO interface.  This will occur implicitly in the
      * destructor if it's not called.
@@ -110,13 +139,29 @@ private:
 
     void write(const std::vector<sys::byte>& data);
 
+    // Writes the headers if need be and opens the file for positioned
+    // writes
+    void prepareTileWrites();
+
+    void writeAt(nitf::Off fileOffset, const void* data, size_t numBytes);
+
+    void closeTileFile();
+
 private:
-    std::auto_ptr<nitf::IOInterface> mIO;
+    std::auto_ptr<nitf::BufferedWriter> mIO;
+    const std::string mPathname;
     const std::vector<std::string> mSchemaPaths;
 
     std::vector<nitf::Off> mImageDataStart;
     std::vector<NITFSegmentInfo> mImageSegmentInfo;
     bool mHaveWrittenHeaders;
+
+    sys::Mutex mTileMutex;
+#ifdef WIN32
+    void* mTileFileHandle;
+#else
+    int mTileFileDescriptor;
+#endif
 };
 }
 }
@@ -26,12 +26,14 @@
 #include <string>
 #include <vector>
 
+#include <mem/SharedPtr.h>
 #include <types/RowCol.h>
 #include <scene/Types.h>
 #include <scene/LLAToECEFTransform.h>
 #include <scene/SceneGeometry.h>
 #include <scene/ProjectionModel.h>
 #include <six/sicd/ComplexData.h>
+#include <six/sicd/SICDMesh.h>
 
 namespace six
 {
@@ -81,11 +83,74 @@ public:
      */
     scene::LatLon toLatLon(const types::RowCol<double>& pixel) const;
 
+    //! Default limit on the number of nodes buildMesh() may use
+    static const size_t DEFAULT_MAX_MESH_NODES = 250000;
+
+    /*!
+     *  \fn buildMesh
+     *
+     *  Projects a mesh of pixels spanning the image exactly, after which
+     *  toECEF(), toLLA() and toLatLon() bilinearly interpolate from the
+     *  mesh rather than projecting every pixel.  Starting at
+     *  'initialSpacing' pixels between nodes, the spacing is halved until
+     *  the interpolation error is no more than 'maxError' meters.  The error
+     *  is measured at the center of every mesh cell, at the midpoints of
+     *  its edges, and partway toward each of its corners.
+     *
+     *  \param initialSpacing - Starting pixels between mesh nodes
+     *  \param maxError       - Maximum interpolation error (meters)
+     *  \param numThreads     - Number of threads to project with
+     *  \param maxMeshNodes   - Maximum number of nodes in the mesh
+     *  \return               - The mesh, which may be serialized and
+     *                          given to setMesh() in a later run
+     *
+     *  \throws except::Exception if 'maxError' can't be met before the
+     *          spacing reaches one pixel or the mesh would need more than
+     *          'maxMeshNodes' nodes.  The message gives the smallest error
+     *          that was reached.
+     */
+    mem::SharedPtr<const ProjectionMesh>
+    buildMesh(const types::RowCol<double>& initialSpacing,
+              double maxError,
+              size_t numThreads = 1,
+              size_t maxMeshNodes = DEFAULT_MAX_MESH_NODES);
+
+    /*!
+     *  \fn setMesh
+     *  \param mesh - Mesh to interpolate from, such as one previously
+     *                returned by buildMesh().  If NULL, every pixel is
+     *                projected exactly.
+     *
+     *  \throws except::Exception if the mesh isn't valid or doesn't span
+     *          the image
+     */
+    void setMesh(mem::SharedPtr<const ProjectionMesh> mesh);
+
+    //! \return The mesh being interpolated from, if any
+    mem::SharedPtr<const ProjectionMesh> getMesh() const
+    {
+        return mMesh;
+    }
+
+private:
+    // \return The largest interpolation error of 'mesh' over the points
+    // sampled along its cell edges and inside its cells
+    double getMeshError(const ProjectionMesh& mesh,
+                        size_t numThreads) const;
+
+    void projectPixels(const std::vector<double>& rows,
+                       const std::vector<double>& cols,
+                       size_t numThreads,
+                       std::vector<double>& x,
+                       std::vector<double>& y,
+                       std::vector<double>& z) const;
+
 private:
     const scene::SceneGeometry mGeom;
     const scene::ProjectionModel& mProjection;
     const six::sicd::ComplexData mSicdData;
     scene::Vector3 mGroundPlaneNormal;
+    mem::SharedPtr<const ProjectionMesh> mMesh;
 };
 
 }
@@ -38,6 +38,33 @@ namespace six
 {
 namespace sicd
 {
+/*!
+ * \class WidebandBlockProcessor
+ * \brief Hook for operating on wideband data while the rest of the image
+ * is still being read.  See the pipelined Utilities::getWidebandData().
+ */
+class WidebandBlockProcessor
+{
+public:
+    virtual ~WidebandBlockProcessor()
+    {
+    }
+
+    /*!
+     * Called once for each block of rows after it has been converted to
+     * complex<float>.  This is called from worker threads, concurrently for
+     * different blocks, so it must be thread safe.
+     *
+     * \param offset The first row and column of the block in the image
+     * \param extent The number of rows and columns in the block
+     * \param block The block's pixels (these live in the caller's output
+     * buffer and may be modified in place)
+     */
+    virtual void operator()(const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& extent,
+                            std::complex<float>* block) = 0;
+};
+
 class Utilities
 {
 public:
@@ -224,6 +251,94 @@ public:
                                 const types::RowCol<size_t>& extent,
                                 std::complex<float>* buffer);
 
+    /*
+     * Same as above, but RE16I_IM16I data is staged through 'scratch'
+     * rather than a temporary buffer allocated on every call.  Pass the
+     * same vector across calls to avoid reallocating it.
+     *
+     * \param reader A loaded NITFReadControl associated with the SICD
+     * \param complexData complexData associated with the SICD
+     * \param offset The starting row and column in the region
+     * \param extent The number of rows and columns in the region
+     * \param scratch Staging buffer for RE16I_IM16I reads.  This is only
+     *   grown, never shrunk.
+     * \param buffer A pointer to the buffer to load data into.  Must be
+     *   at least extent.area() pixels
+     *
+     * \throws except::Exception if the pixel type of the SICD is not a
+     *           complex float32 or complex int16, or
+     *         if the buffer pointer is null
+     */
+    static void getWidebandData(
+            NITFReadControl& reader,
+            const ComplexData& complexData,
+            const types::RowCol<size_t>& offset,
+            const types::RowCol<size_t>& extent,
+            std::vector<std::complex<sys::Int16_T> >& scratch,
+            std::complex<float>* buffer);
+
+    /*
+     * Pipelined version of the above.  The image is read a swath (~32 MB by
+     * default) at a time; while one swath is being read, worker threads
+     * convert the previous one to complex<float> and pass it to
+     * 'processor'.  Wall clock time is then roughly the larger of the read
+     * and conversion times rather than their sum.
+     *
+     * \param reader A loaded NITFReadControl associated with the SICD
+     * \param complexData complexData associated with the SICD
+     * \param offset The starting row and column in the region
+     * \param extent The number of rows and columns in the region
+     * \param numThreads Number of threads to convert each swath with
+     * \param buffer A pointer to the buffer to load data into.  Must be
+     *   at least extent.area() pixels
+     * \param processor Optional callback to run on each converted block.
+     *   Blocks never span more than one swath.
+     * \param numRowsPerSwath Number of rows to read at a time.  If 0, enough
+     *   rows for about 32 MB are read at a time.
+     *
+     * \throws except::Exception if the pixel type of the SICD is not a
+     *           complex float32 or complex int16, or
+     *         if the buffer pointer is null
+     */
+    static void getWidebandData(NITFReadControl& reader,
+                                const ComplexData& complexData,
+                                const types::RowCol<size_t>& offset,
+                                const types::RowCol<size_t>& extent,
+                                size_t numThreads,
+                                std::complex<float>* buffer,
+                                WidebandBlockProcessor* processor = NULL,
+                                size_t numRowsPerSwath = 0);
+
+    /*
+     * Reads a decimated version of a region, e.g. for a quick-look or
+     * overview.  Each decimation.row x decimation.col window of the region
+     * is reduced to a single pixel as it's read, so the full resolution
+     * region is never held in memory.
+     *
+     * \param reader A loaded NITFReadControl associated with the SICD
+     * \param complexData complexData associated with the SICD
+     * \param offset The starting row and column in the region
+     * \param extent The number of full resolution rows and columns in the
+     *   region
+     * \param decimation The row and column decimation factors
+     * \param method How each window is reduced.  MAX_MAGNITUDE keeps the
+     *   pixel with the largest magnitude.
+     * \param buffer A pointer to the buffer to load data into.  Must be at
+     *   least ceil(extent.row / decimation.row) *
+     *   ceil(extent.col / decimation.col) pixels
+     *
+     * \throws except::Exception if the pixel type of the SICD is not a
+     *           complex float32 or complex int16, or
+     *         if the buffer pointer is null
+     */
+    static void getWidebandData(NITFReadControl& reader,
+                                const ComplexData& complexData,
+                                const types::RowCol<size_t>& offset,
+                                const types::RowCol<size_t>& extent,
+                                const types::RowCol<size_t>& decimation,
+                                Region::DownsampleMethod method,
+                                std::complex<float>* buffer);
+
     /*
      * Given a loaded NITFReadControl and a ComplexData object, this
      * function loads the wideband data associated with the reader
@@ -420,6 +535,36 @@ public:
      */
     static std::auto_ptr<NoiseMesh> getNoiseMesh(NITFReadControl& reader);
 
+    /*
+     * Given a reference to a loaded NITFReadControl, this function
+     * reads just a window of the SICD's noise mesh.  The rest of the DES
+     * is seeked past rather than read.
+     * \param reader A NITFReadControl loaded with the desired SICD
+     * \param offset The first mesh row and column of the window
+     * \param windowDims The dimensions of the window
+     * \return Noise Mesh holding just the window
+     * \throws except::Exception if the provided reader is not a SICD, has
+     * no noise mesh, or the window doesn't fit in the mesh
+     *
+     */
+    static std::auto_ptr<NoiseMesh>
+    getNoiseMesh(NITFReadControl& reader,
+                 const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& windowDims);
+
+    /*
+     * Given a reference to a loaded NITFReadControl, this function
+     * parses the SICD's DES and returns a ProjectionMesh if present.
+     * See SlantPlanePixelTransformer::buildMesh().
+     * \param reader A NITFReadControl loaded with the desired SICD
+     * \return Projection Mesh associated with the SICD NITF
+     * \throws except::Exception if the provided reader is not a SICD or
+     * has no projection mesh
+     *
+     */
+    static std::auto_ptr<ProjectionMesh>
+    getProjectionMesh(NITFReadControl& reader);
+
     /*
      * Given a reference to a loaded NITFReadControl, this function
      * parses the SICD's DES and returns fitted projection polynomials
@@ -554,11 +699,13 @@ public:
      * \param complexData Complex metadata.
      * \param spPixels Slant plane pixel coordinates.
      * \param opPixels Output plane pixel coordinates.
+     * \param numThreads Number of threads to project with.
      */
     static void projectPixelsToOutputPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double> >& spPixels,
-        std::vector<types::RowCol<double> >& opPixels);
+        std::vector<types::RowCol<double> >& opPixels,
+        size_t numThreads = 1);
 
     /*!
      * Project slant plane valid data polygon pixel locations to output
@@ -575,11 +722,13 @@ public:
      * \param complexData Complex metadata.
      * \param opPixels Output plane pixel coordinates.
      * \param spPixels Slant plane pixel coordinates.
+     * \param numThreads Number of threads to project with.
      */
     static void projectPixelsToSlantPlane(
         const six::sicd::ComplexData& complexData,
         const std::vector<types::RowCol<double> >& opPixels,
-        std::vector<types::RowCol<double> >& spPixels);
+        std::vector<types::RowCol<double> >& spPixels,
+        size_t numThreads = 1);
 };
 }
 }
@@ -24,9 +24,10 @@
 #include <algorithm>
 
 #include <sys/Conf.h>
+#include <sys/OS.h>
 #include <except/Exception.h>
 #include <str/Convert.h>
-#include <mem/ScopedArray.h>
+#include <six/NITFRegionInputStream.h>
 #include <six/NITFWriteControl.h>
 #include <six/sicd/CropUtils.h>
 #include <six/sicd/Utilities.h>
@@ -106,33 +107,45 @@ void cropSICD(six::NITFReadControl& reader,
         throw except::Exception(Ctxt("AOI must be non-empty"));
     }
 
-    // Read in the AOI
-    const size_t numBytesPerPixel(data.getNumBytesPerPixel());
-    const size_t numBytes(origDims.row * origDims.col * numBytesPerPixel);
-    const mem::ScopedArray<sys::ubyte> buffer(new sys::ubyte[numBytes]);
-
-    six::Region region;
-    region.setStartRow(aoiOffset.row);
-    region.setStartCol(aoiOffset.col);
-    region.setNumRows(aoiDims.row);
-    region.setNumCols(aoiDims.col);
-    region.setBuffer(buffer.get());
-    reader.interleaved(region, 0);
-
     six::sicd::ComplexData* const aoiData = updateMetadata(
             data, geom,  projection,
             aoiOffset, aoiDims);
     std::auto_ptr<six::Data> scopedData(aoiData);
 
+    // Stream the AOI from the input to the output a chunk of rows at a
+    // time.  When possible, the pixels are copied as they're stored rather
+    // than being swapped to native byte order and back.
+    const bool raw = reader.canReadRaw(0);
+    six::NITFRegionInputStream aoi(reader, 0, aoiOffset, aoiDims,
+                                   data.getNumBytesPerPixel(), raw);
+
     // Write the AOI SICD out
     mem::SharedPtr<six::Container> container(new six::Container(
             six::DataType::COMPLEX));
     container->addData(scopedData);
-    six::NITFWriteControl writer(container);
-    six::BufferList images(1, buffer.get());
+    six::Options options;
+    if (raw)
+    {
+        options.setParameter(six::WriteControl::OPT_BYTE_SWAP,
+                             six::Parameter(static_cast<int>(
+                                     six::ByteSwapping::SWAP_OFF)));
+    }
+    six::NITFWriteControl writer(options, container);
+    six::SourceList images(1, &aoi);
     writer.save(images, outPathname, schemaPaths);
 }
 
+// Reads with a thread per CPU
+void loadForCrop(six::NITFReadControl& reader,
+                 const std::string& pathname,
+                 const std::vector<std::string>& schemaPaths)
+{
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_NUM_READ_THREADS,
+            six::Parameter(sys::OS().getNumCPUs()));
+    reader.load(pathname, schemaPaths);
+}
+
 }
 
 namespace six
@@ -169,7 +182,7 @@ void cropSICD(const std::string& inPathname,
               const std::string& outPathname)
 {
     six::NITFReadControl reader;
-    reader.load(inPathname, schemaPaths);
+    loadForCrop(reader, inPathname, schemaPaths);
     cropSICD(reader, schemaPaths, aoiOffset, aoiDims, outPathname);
 }
 
@@ -211,7 +224,7 @@ void cropSICD(const std::string& inPathname,
               bool trimCornersIfNeeded)
 {
     six::NITFReadControl reader;
-    reader.load(inPathname, schemaPaths);
+    loadForCrop(reader, inPathname, schemaPaths);
     cropSICD(reader, schemaPaths, corners, outPathname, trimCornersIfNeeded);
 }
 
@@ -321,7 +334,7 @@ void cropSICD(const std::string& inPathname,
               bool trimCornersIfNeeded)
 {
     six::NITFReadControl reader;
-    reader.load(inPathname, schemaPaths);
+    loadForCrop(reader, inPathname, schemaPaths);
     cropSICD(reader, schemaPaths, corners, outPathname, trimCornersIfNeeded);
 }
 
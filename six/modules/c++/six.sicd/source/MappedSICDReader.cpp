@@ -0,0 +1,333 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <sys/Conf.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <except/Exception.h>
+#include <str/Manip.h>
+#include <six/NITFReadControl.h>
+#include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/PixelConversion.h>
+#include <six/sicd/Utilities.h>
+#include <six/sicd/MappedSICDReader.h>
+
+namespace
+{
+void checkMappable(nitf::ImageSubheader& subheader, size_t segment)
+{
+    std::string compression = subheader.getImageCompression().toString();
+    str::trim(compression);
+    if (compression != "NC")
+    {
+        throw except::Exception(Ctxt(
+                "Image segment " + str::toString(segment) +
+                " has compression '" + compression +
+                "' - only uncompressed SICDs can be mapped"));
+    }
+
+    const size_t numBlocksPerRow =
+            static_cast<nitf::Uint32>(subheader.getNumBlocksPerRow());
+    const size_t numBlocksPerCol =
+            static_cast<nitf::Uint32>(subheader.getNumBlocksPerCol());
+    if (numBlocksPerRow != 1 || numBlocksPerCol != 1)
+    {
+        throw except::Exception(Ctxt(
+                "Image segment " + str::toString(segment) +
+                " is blocked - only unblocked SICDs can be mapped"));
+    }
+
+    // The pixels of a single block are contiguous as long as the bands are
+    // pixel interleaved
+    std::string imode = subheader.getImageMode().toString();
+    str::trim(imode);
+    const size_t numBands =
+            static_cast<nitf::Uint32>(subheader.getNumImageBands());
+    if (imode != "P" && numBands != 1)
+    {
+        throw except::Exception(Ctxt(
+                "Image segment " + str::toString(segment) +
+                " has image mode '" + imode +
+                "' - only pixel interleaved SICDs can be mapped"));
+    }
+}
+}
+
+namespace six
+{
+namespace sicd
+{
+MappedSICDReader::MappedSICDReader(
+        const std::string& pathname,
+        const std::vector<std::string>& schemaPaths) :
+    mAddress(NULL),
+    mLength(0),
+#ifdef WIN32
+    mFileHandle(INVALID_HANDLE_VALUE),
+    mMappingHandle(NULL)
+#else
+    mFileDescriptor(-1)
+#endif
+{
+    six::XMLControlRegistry xmlRegistry;
+    xmlRegistry.addCreator(six::DataType::COMPLEX,
+            new six::XMLControlCreatorT<
+                    six::sicd::ComplexXMLControl>());
+
+    six::NITFReadControl reader;
+    reader.setXMLControlRegistry(&xmlRegistry);
+    reader.load(pathname, schemaPaths);
+    mComplexData = Utilities::getComplexData(reader);
+
+    // Every image segment in a SICD is part of the one image, in order
+    const size_t numBytesPerPixel = mComplexData->getNumBytesPerPixel();
+    std::vector<size_t> offsets;
+    nitf::List images = reader.getRecord().getImages();
+    nitf::ListIterator imageIter = images.begin();
+    size_t firstRow = 0;
+    for (size_t ii = 0; imageIter != images.end(); ++imageIter, ++ii)
+    {
+        nitf::ImageSegment segment = static_cast<nitf::ImageSegment>(
+                *imageIter);
+        nitf::ImageSubheader subheader = segment.getSubheader();
+        checkMappable(subheader, ii);
+
+        SegmentView view;
+        view.data = NULL;
+        view.firstRow = firstRow;
+        view.numRows = static_cast<nitf::Uint32>(subheader.getNumRows());
+        view.numCols = static_cast<nitf::Uint32>(subheader.getNumCols());
+        view.numBytesPerPixel = numBytesPerPixel;
+        view.rowStride = view.numCols * numBytesPerPixel;
+
+        mSegments.push_back(view);
+        offsets.push_back(static_cast<size_t>(segment.getImageOffset()));
+        firstRow += view.numRows;
+    }
+
+    map(pathname);
+
+    for (size_t ii = 0; ii < mSegments.size(); ++ii)
+    {
+        SegmentView& view(mSegments[ii]);
+        if (offsets[ii] + view.numRows * view.rowStride > mLength)
+        {
+            unmap();
+            throw except::Exception(Ctxt(
+                    "Image segment " + str::toString(ii) +
+                    " extends past the end of " + pathname));
+        }
+        view.data = mAddress + offsets[ii];
+    }
+
+    // This tells the reader that it doesn't
+    // own an XMLControlRegistry
+    reader.setXMLControlRegistry(NULL);
+}
+
+MappedSICDReader::~MappedSICDReader()
+{
+    unmap();
+}
+
+const MappedSICDReader::SegmentView&
+MappedSICDReader::getSegment(size_t segment) const
+{
+    if (segment >= mSegments.size())
+    {
+        throw except::Exception(Ctxt(
+                "Image segment " + str::toString(segment) +
+                " is out of bounds"));
+    }
+
+    return mSegments[segment];
+}
+
+const sys::ubyte* MappedSICDReader::getRow(size_t row) const
+{
+    for (size_t ii = 0; ii < mSegments.size(); ++ii)
+    {
+        const SegmentView& view(mSegments[ii]);
+        if (row < view.firstRow + view.numRows)
+        {
+            return view.getRow(row - view.firstRow);
+        }
+    }
+
+    throw except::Exception(Ctxt(
+            "Row " + str::toString(row) + " is out of bounds"));
+}
+
+void MappedSICDReader::getWidebandData(
+        const types::RowCol<size_t>& offset,
+        const types::RowCol<size_t>& extent,
+        std::complex<float>* buffer) const
+{
+    if (offset.row + extent.row > mComplexData->getNumRows() ||
+        offset.col + extent.col > mComplexData->getNumCols())
+    {
+        throw except::Exception(Ctxt("Region is out of bounds"));
+    }
+
+    const PixelType pixelType = mComplexData->getPixelType();
+    if (pixelType != PixelType::RE16I_IM16I &&
+        pixelType != PixelType::RE32F_IM32F)
+    {
+        throw except::Exception(Ctxt(
+                "Pixel type " + pixelType.toString() + " of " +
+                mComplexData->getName() + " is not supported; only " +
+                "RE16I_IM16I and RE32F_IM32F can be read"));
+    }
+
+    const bool swap = needsByteSwap();
+    for (size_t row = 0; row < extent.row; ++row)
+    {
+        const sys::ubyte* const input =
+                getPixel(offset.row + row, offset.col);
+        std::complex<float>* const output = buffer + row * extent.col;
+
+        if (pixelType == PixelType::RE16I_IM16I)
+        {
+            promotePixels(input, extent.col, swap, output);
+        }
+        else
+        {
+            ::memcpy(output, input, extent.col * sizeof(std::complex<float>));
+            if (swap)
+            {
+                sys::byteSwap(output, sizeof(float), extent.col * 2);
+            }
+        }
+    }
+}
+
+#ifdef WIN32
+void MappedSICDReader::map(const std::string& pathname)
+{
+    mFileHandle = ::CreateFile(pathname.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               NULL,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL,
+                               NULL);
+    if (mFileHandle == INVALID_HANDLE_VALUE)
+    {
+        throw except::Exception(Ctxt("Unable to open " + pathname));
+    }
+
+    LARGE_INTEGER size;
+    if (!::GetFileSizeEx(mFileHandle, &size))
+    {
+        unmap();
+        throw except::Exception(Ctxt("Unable to get size of " + pathname));
+    }
+    mLength = static_cast<size_t>(size.QuadPart);
+
+    mMappingHandle = ::CreateFileMapping(mFileHandle, NULL, PAGE_READONLY,
+                                         0, 0, NULL);
+    if (mMappingHandle == NULL)
+    {
+        unmap();
+        throw except::Exception(Ctxt("Unable to map " + pathname));
+    }
+
+    mAddress = static_cast<sys::ubyte*>(
+            ::MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (mAddress == NULL)
+    {
+        unmap();
+        throw except::Exception(Ctxt("Unable to map " + pathname));
+    }
+}
+
+void MappedSICDReader::unmap()
+{
+    if (mAddress)
+    {
+        ::UnmapViewOfFile(mAddress);
+        mAddress = NULL;
+    }
+    if (mMappingHandle)
+    {
+        ::CloseHandle(mMappingHandle);
+        mMappingHandle = NULL;
+    }
+    if (mFileHandle != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(mFileHandle);
+        mFileHandle = INVALID_HANDLE_VALUE;
+    }
+}
+#else
+void MappedSICDReader::map(const std::string& pathname)
+{
+    mFileDescriptor = ::open(pathname.c_str(), O_RDONLY);
+    if (mFileDescriptor < 0)
+    {
+        throw except::Exception(Ctxt("Unable to open " + pathname));
+    }
+
+    struct stat info;
+    if (::fstat(mFileDescriptor, &info) != 0)
+    {
+        unmap();
+        throw except::Exception(Ctxt("Unable to get size of " + pathname));
+    }
+    mLength = static_cast<size_t>(info.st_size);
+
+    void* const address = ::mmap(NULL, mLength, PROT_READ, MAP_SHARED,
+                                 mFileDescriptor, 0);
+    if (address == MAP_FAILED)
+    {
+        unmap();
+        throw except::Exception(Ctxt("Unable to map " + pathname));
+    }
+    mAddress = static_cast<sys::ubyte*>(address);
+}
+
+void MappedSICDReader::unmap()
+{
+    if (mAddress)
+    {
+        ::munmap(mAddress, mLength);
+        mAddress = NULL;
+    }
+    if (mFileDescriptor >= 0)
+    {
+        ::close(mFileDescriptor);
+        mFileDescriptor = -1;
+    }
+}
+#endif
+}
+}
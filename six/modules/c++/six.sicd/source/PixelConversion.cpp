@@ -0,0 +1,78 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+
+#include <sys/Conf.h>
+#include <six/sicd/PixelConversion.h>
+
+namespace
+{
+// Keeping the swap and non-swap loops separate (and free of any branches)
+// lets the compiler vectorize each of them
+void promote(const sys::ubyte* input, size_t numElements, float* output)
+{
+    for (size_t ii = 0; ii < numElements; ++ii)
+    {
+        sys::Int16_T value;
+        ::memcpy(&value, input + ii * sizeof(value), sizeof(value));
+        output[ii] = value;
+    }
+}
+
+void swapAndPromote(const sys::ubyte* input, size_t numElements, float* output)
+{
+    for (size_t ii = 0; ii < numElements; ++ii)
+    {
+        sys::Uint16_T value;
+        ::memcpy(&value, input + ii * sizeof(value), sizeof(value));
+        value = static_cast<sys::Uint16_T>((value >> 8) | (value << 8));
+        output[ii] = static_cast<sys::Int16_T>(value);
+    }
+}
+}
+
+namespace six
+{
+namespace sicd
+{
+void promotePixels(const void* input,
+                   size_t numPixels,
+                   bool byteSwap,
+                   std::complex<float>* output)
+{
+    // One for the real component, one for imaginary of each pixel
+    const size_t numElements = numPixels * 2;
+    const sys::ubyte* const inputPtr = static_cast<const sys::ubyte*>(input);
+    float* const outputPtr = reinterpret_cast<float*>(output);
+
+    if (byteSwap)
+    {
+        swapAndPromote(inputPtr, numElements, outputPtr);
+    }
+    else
+    {
+        promote(inputPtr, numElements, outputPtr);
+    }
+}
+}
+}
@@ -19,6 +19,12 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
 #include <six/sicd/SICDMesh.h>
 #include <six/Serialize.h>
 
@@ -29,6 +35,7 @@ namespace sicd
 const char SICDMeshes::SLANT_PLANE_MESH_ID[] = "Slant_Plane_Mesh";
 const char SICDMeshes::OUTPUT_PLANE_MESH_ID[] = "Output_Plane_Mesh";
 const char SICDMeshes::NOISE_MESH_ID[] = "Noise_Mesh";
+const char SICDMeshes::PROJECTION_MESH_ID[] = "Projection_Mesh";
 
 PlanarCoordinateMesh::PlanarCoordinateMesh(const std::string& name):
     mSwapBytes(!sys::isBigEndianSystem()),
@@ -81,6 +88,38 @@ void PlanarCoordinateMesh::deserialize(const sys::byte*& values)
     six::deserialize(values, mSwapBytes, mY);
 }
 
+void PlanarCoordinateMesh::serialize(io::OutputStream& stream) const
+{
+    six::serialize(mMeshDims.row, mSwapBytes, stream);
+    six::serialize(mMeshDims.col, mSwapBytes, stream);
+    six::serialize(mX, mSwapBytes, stream);
+    six::serialize(mY, mSwapBytes, stream);
+}
+
+void PlanarCoordinateMesh::deserialize(io::InputStream& stream)
+{
+    six::deserialize(stream, mSwapBytes, mMeshDims.row);
+    six::deserialize(stream, mSwapBytes, mMeshDims.col);
+    six::deserialize(stream, mSwapBytes, mX);
+    six::deserialize(stream, mSwapBytes, mY);
+}
+
+types::RowCol<size_t> PlanarCoordinateMesh::deserializeWindow(
+        io::SeekableInputStream& stream,
+        const types::RowCol<size_t>& offset,
+        const types::RowCol<size_t>& windowDims)
+{
+    types::RowCol<size_t> meshDims;
+    six::deserialize(stream, mSwapBytes, meshDims.row);
+    six::deserialize(stream, mSwapBytes, meshDims.col);
+    six::deserializeWindow(stream, mSwapBytes, meshDims, offset, windowDims,
+                           mX);
+    six::deserializeWindow(stream, mSwapBytes, meshDims, offset, windowDims,
+                           mY);
+    mMeshDims = windowDims;
+    return meshDims;
+}
+
 std::vector<Mesh::Field> NoiseMesh::getFields() const
 {
     std::vector<Mesh::Field> fields = PlanarCoordinateMesh::getFields();
@@ -137,5 +176,215 @@ void NoiseMesh::deserialize(const sys::byte*& values)
     six::deserialize(values, mSwapBytes, mAzimuthAmbiguityNoise);
     six::deserialize(values, mSwapBytes, mCombinedNoise);
 }
+
+void NoiseMesh::serialize(io::OutputStream& stream) const
+{
+    PlanarCoordinateMesh::serialize(stream);
+
+    six::serialize(mMainBeamNoise, mSwapBytes, stream);
+    six::serialize(mAzimuthAmbiguityNoise, mSwapBytes, stream);
+    six::serialize(mCombinedNoise, mSwapBytes, stream);
+}
+
+void NoiseMesh::deserialize(io::InputStream& stream)
+{
+    PlanarCoordinateMesh::deserialize(stream);
+
+    six::deserialize(stream, mSwapBytes, mMainBeamNoise);
+    six::deserialize(stream, mSwapBytes, mAzimuthAmbiguityNoise);
+    six::deserialize(stream, mSwapBytes, mCombinedNoise);
+}
+
+types::RowCol<size_t> NoiseMesh::deserializeWindow(
+        io::SeekableInputStream& stream,
+        const types::RowCol<size_t>& offset,
+        const types::RowCol<size_t>& windowDims)
+{
+    const types::RowCol<size_t> meshDims =
+            PlanarCoordinateMesh::deserializeWindow(stream, offset,
+                                                    windowDims);
+
+    six::deserializeWindow(stream, mSwapBytes, meshDims, offset, windowDims,
+                           mMainBeamNoise);
+    six::deserializeWindow(stream, mSwapBytes, meshDims, offset, windowDims,
+                           mAzimuthAmbiguityNoise);
+    six::deserializeWindow(stream, mSwapBytes, meshDims, offset, windowDims,
+                           mCombinedNoise);
+    return meshDims;
+}
+
+ProjectionMesh::ProjectionMesh(const std::string& name):
+    mSwapBytes(!sys::isBigEndianSystem()),
+    mName(name)
+{
+}
+
+ProjectionMesh::ProjectionMesh(const std::string& name,
+                               const types::RowCol<size_t>& meshDims,
+                               const types::RowCol<double>& spacing,
+                               const std::vector<double>& x,
+                               const std::vector<double>& y,
+                               const std::vector<double>& z):
+    mSwapBytes(!sys::isBigEndianSystem()),
+    mName(name),
+    mMeshDims(meshDims),
+    mSpacing(spacing),
+    mX(x),
+    mY(y),
+    mZ(z)
+{
+    validate();
+}
+
+void ProjectionMesh::validateLayout() const
+{
+    if (mMeshDims.row < 2 || mMeshDims.col < 2)
+    {
+        throw except::Exception(Ctxt(
+                "Projection mesh must be at least 2 x 2, not " +
+                str::toString(mMeshDims.row) + " x " +
+                str::toString(mMeshDims.col)));
+    }
+    if (mMeshDims.row > std::numeric_limits<size_t>::max() / mMeshDims.col)
+    {
+        throw except::Exception(Ctxt("Projection mesh is too large"));
+    }
+
+    // Written this way so that NaN fails too
+    if (!(mSpacing.row > 0.0 && mSpacing.col > 0.0) ||
+        !(mSpacing.row <= std::numeric_limits<double>::max() &&
+          mSpacing.col <= std::numeric_limits<double>::max()))
+    {
+        throw except::Exception(Ctxt(
+                "Projection mesh spacing must be positive and finite"));
+    }
+}
+
+void ProjectionMesh::validate() const
+{
+    validateLayout();
+
+    const size_t numNodes = mMeshDims.area();
+    if (mX.size() != numNodes || mY.size() != numNodes ||
+        mZ.size() != numNodes)
+    {
+        throw except::Exception(Ctxt(
+                "Projection mesh of " + str::toString(numNodes) +
+                " nodes has " + str::toString(mX.size()) + ", " +
+                str::toString(mY.size()) + " and " +
+                str::toString(mZ.size()) + " x, y and z coordinates"));
+    }
+}
+
+Vector3 ProjectionMesh::interpolate(const types::RowCol<double>& pixel) const
+{
+    if (mMeshDims.row < 2 || mMeshDims.col < 2)
+    {
+        throw except::Exception(Ctxt(
+                "Projection mesh must be at least 2 x 2 to interpolate"));
+    }
+
+    // Find the cell, clamping so that pixels past the edges extrapolate
+    const types::RowCol<double> meshPos(pixel.row / mSpacing.row,
+                                        pixel.col / mSpacing.col);
+    const double maxRow = static_cast<double>(mMeshDims.row - 2);
+    const double maxCol = static_cast<double>(mMeshDims.col - 2);
+    const double row0 = std::max(0.0, std::min(maxRow,
+                                               std::floor(meshPos.row)));
+    const double col0 = std::max(0.0, std::min(maxCol,
+                                               std::floor(meshPos.col)));
+    const double rowFrac = meshPos.row - row0;
+    const double colFrac = meshPos.col - col0;
+
+    const size_t idx00 = static_cast<size_t>(row0) * mMeshDims.col +
+            static_cast<size_t>(col0);
+    const size_t idx01 = idx00 + 1;
+    const size_t idx10 = idx00 + mMeshDims.col;
+    const size_t idx11 = idx10 + 1;
+
+    const double w00 = (1.0 - rowFrac) * (1.0 - colFrac);
+    const double w01 = (1.0 - rowFrac) * colFrac;
+    const double w10 = rowFrac * (1.0 - colFrac);
+    const double w11 = rowFrac * colFrac;
+
+    Vector3 ecef;
+    ecef[0] = w00 * mX[idx00] + w01 * mX[idx01] +
+            w10 * mX[idx10] + w11 * mX[idx11];
+    ecef[1] = w00 * mY[idx00] + w01 * mY[idx01] +
+            w10 * mY[idx10] + w11 * mY[idx11];
+    ecef[2] = w00 * mZ[idx00] + w01 * mZ[idx01] +
+            w10 * mZ[idx10] + w11 * mZ[idx11];
+    return ecef;
+}
+
+std::vector<Mesh::Field> ProjectionMesh::getFields() const
+{
+    std::vector<Mesh::Field> fields;
+    Field f;
+
+    f.name = "ECEF x";
+    f.type = "double";
+    fields.push_back(f);
+
+    f.name = "ECEF y";
+    f.type = "double";
+    fields.push_back(f);
+
+    f.name = "ECEF z";
+    f.type = "double";
+    fields.push_back(f);
+
+    return fields;
+}
+
+void ProjectionMesh::serialize(std::vector<sys::byte>& values) const
+{
+    six::serialize(mMeshDims.row, mSwapBytes, values);
+    six::serialize(mMeshDims.col, mSwapBytes, values);
+    six::serialize(mSpacing.row, mSwapBytes, values);
+    six::serialize(mSpacing.col, mSwapBytes, values);
+    six::serialize(mX, mSwapBytes, values);
+    six::serialize(mY, mSwapBytes, values);
+    six::serialize(mZ, mSwapBytes, values);
+}
+
+void ProjectionMesh::deserialize(const sys::byte*& values)
+{
+    six::deserialize(values, mSwapBytes, mMeshDims.row);
+    six::deserialize(values, mSwapBytes, mMeshDims.col);
+    six::deserialize(values, mSwapBytes, mSpacing.row);
+    six::deserialize(values, mSwapBytes, mSpacing.col);
+    validateLayout();
+
+    six::deserialize(values, mSwapBytes, mX);
+    six::deserialize(values, mSwapBytes, mY);
+    six::deserialize(values, mSwapBytes, mZ);
+    validate();
+}
+
+void ProjectionMesh::serialize(io::OutputStream& stream) const
+{
+    six::serialize(mMeshDims.row, mSwapBytes, stream);
+    six::serialize(mMeshDims.col, mSwapBytes, stream);
+    six::serialize(mSpacing.row, mSwapBytes, stream);
+    six::serialize(mSpacing.col, mSwapBytes, stream);
+    six::serialize(mX, mSwapBytes, stream);
+    six::serialize(mY, mSwapBytes, stream);
+    six::serialize(mZ, mSwapBytes, stream);
+}
+
+void ProjectionMesh::deserialize(io::InputStream& stream)
+{
+    six::deserialize(stream, mSwapBytes, mMeshDims.row);
+    six::deserialize(stream, mSwapBytes, mMeshDims.col);
+    six::deserialize(stream, mSwapBytes, mSpacing.row);
+    six::deserialize(stream, mSwapBytes, mSpacing.col);
+    validateLayout();
+
+    six::deserialize(stream, mSwapBytes, mX);
+    six::deserialize(stream, mSwapBytes, mY);
+    six::deserialize(stream, mSwapBytes, mZ);
+    validate();
+}
 }
 }
@@ -20,9 +20,30 @@
  *
  */
 
+#include <algorithm>
+
+#include <sys/Conf.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <except/Exception.h>
+#include <mt/CriticalSection.h>
+#include <str/Convert.h>
 #include <six/sicd/SICDByteProvider.h>
 #include <six/sicd/SICDWriteControl.h>
 
+namespace
+{
+// Upper bound on the scratch buffer saveTile() swaps into
+const size_t TILE_SCRATCH_SIZE = 4 * 1024 * 1024;
+}
+
 namespace six
 {
 namespace sicd
@@ -31,11 +52,22 @@ SICDWriteControl::SICDWriteControl(const std::string& outputPathname,
                                    const std::vector<std::string>& schemaPaths) :
     mIO(new nitf::BufferedWriter(outputPathname,
                                  NITFHeaderCreator::DEFAULT_BUFFER_SIZE)),
+    mPathname(outputPathname),
     mSchemaPaths(schemaPaths),
-    mHaveWrittenHeaders(false)
+    mHaveWrittenHeaders(false),
+#ifdef WIN32
+    mTileFileHandle(INVALID_HANDLE_VALUE)
+#else
+    mTileFileDescriptor(-1)
+#endif
 {
 }
 
+SICDWriteControl::~SICDWriteControl()
+{
+    closeTileFile();
+}
+
 void SICDWriteControl::initialize(const ComplexData& data)
 {
     mem::SharedPtr<Container> container(new Container(DataType::COMPLEX));
@@ -182,8 +214,212 @@ void SICDWriteControl::save(void* imageData,
     }
 }
 
+void SICDWriteControl::saveTile(const void* imageData,
+                                const types::RowCol<size_t>& offset,
+                                const types::RowCol<size_t>& dims)
+{
+    prepareTileWrites();
+
+    // Nothing to write, and an empty row would leave no room to size the
+    // swap chunks by
+    if (dims.row == 0 || dims.col == 0)
+    {
+        return;
+    }
+
+    const six::Data* const data = getContainer()->getData(0);
+    static const size_t NUM_BANDS = 2;
+    const size_t numBytesPerPixel = data->getNumBytesPerPixel();
+    const size_t numBytesPerSample = numBytesPerPixel / NUM_BANDS;
+    const size_t globalNumCols = data->getNumCols();
+    const size_t numBytesPerRow = dims.col * numBytesPerPixel;
+    const size_t rowSeekStride = globalNumCols * numBytesPerPixel;
+    const bool fullRows = (dims.col == globalNumCols);
+    const bool doByteSwap = shouldByteSwap();
+
+    // Rows are swapped a chunk at a time into scratch rather than in place
+    const size_t numRowsPerChunk = doByteSwap ?
+            std::max<size_t>(1, TILE_SCRATCH_SIZE / numBytesPerRow) :
+            dims.row;
+    std::vector<sys::ubyte> scratch;
+
+    for (size_t seg = 0; seg < mImageSegmentInfo.size(); ++seg)
+    {
+        const NITFSegmentInfo& imageSegmentInfo(mImageSegmentInfo[seg]);
+        size_t startGlobalRowToWrite;
+        size_t numRowsToWrite;
+        if (!imageSegmentInfo.isInRange(offset.row, dims.row,
+                                        startGlobalRowToWrite,
+                                        numRowsToWrite))
+        {
+            continue;
+        }
+
+        const sys::ubyte* const imageDataPtr =
+                static_cast<const sys::ubyte*>(imageData) +
+                (startGlobalRowToWrite - offset.row) * numBytesPerRow;
+        const size_t startRowInSegToWrite =
+                startGlobalRowToWrite - imageSegmentInfo.firstRow;
+        const nitf::Off byteOffset = mImageDataStart[seg] +
+                (startRowInSegToWrite * globalNumCols + offset.col) *
+                numBytesPerPixel;
+
+        for (size_t row = 0; row < numRowsToWrite; row += numRowsPerChunk)
+        {
+            const size_t numRows =
+                    std::min(numRowsPerChunk, numRowsToWrite - row);
+            const sys::ubyte* chunk = imageDataPtr + row * numBytesPerRow;
+            if (doByteSwap)
+            {
+                scratch.resize(numRows * numBytesPerRow);
+                sys::byteSwap(chunk,
+                              static_cast<unsigned short>(numBytesPerSample),
+                              numRows * dims.col * NUM_BANDS,
+                              &scratch[0]);
+                chunk = &scratch[0];
+            }
+
+            if (fullRows)
+            {
+                // Rows are contiguous on disk - one write
+                writeAt(byteOffset + row * rowSeekStride, chunk,
+                        numRows * numBytesPerRow);
+            }
+            else
+            {
+                for (size_t ii = 0; ii < numRows; ++ii)
+                {
+                    writeAt(byteOffset + (row + ii) * rowSeekStride,
+                            chunk + ii * numBytesPerRow,
+                            numBytesPerRow);
+                }
+            }
+        }
+    }
+}
+
+void SICDWriteControl::prepareTileWrites()
+{
+    mt::CriticalSection<sys::Mutex> lock(&mTileMutex);
+
+#ifdef WIN32
+    if (mTileFileHandle != INVALID_HANDLE_VALUE)
+#else
+    if (mTileFileDescriptor >= 0)
+#endif
+    {
+        return;
+    }
+
+    if (getContainer().get() == NULL)
+    {
+        throw except::Exception(Ctxt(
+                "initialize() must be called prior to calling saveTile()"));
+    }
+
+    if (!mHaveWrittenHeaders)
+    {
+        writeHeaders();
+        mHaveWrittenHeaders = true;
+    }
+
+    // Anything still buffered has to land before we go around the writer
+    mIO->flushBuffer();
+
+#ifdef WIN32
+    mTileFileHandle = ::CreateFile(mPathname.c_str(),
+                                   GENERIC_WRITE,
+                                   FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                   NULL,
+                                   OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL,
+                                   NULL);
+    if (mTileFileHandle == INVALID_HANDLE_VALUE)
+#else
+    mTileFileDescriptor = ::open(mPathname.c_str(), O_WRONLY);
+    if (mTileFileDescriptor < 0)
+#endif
+    {
+        throw except::Exception(Ctxt(
+                "Unable to open " + mPathname + " for tile writes"));
+    }
+}
+
+#ifdef WIN32
+void SICDWriteControl::writeAt(nitf::Off fileOffset,
+                               const void* data,
+                               size_t numBytes)
+{
+    const char* ptr = static_cast<const char*>(data);
+    while (numBytes > 0)
+    {
+        const DWORD numBytesThisWrite = static_cast<DWORD>(
+                std::min<size_t>(numBytes, 0x40000000));
+        OVERLAPPED overlapped = {0};
+        overlapped.Offset = static_cast<DWORD>(fileOffset & 0xFFFFFFFF);
+        overlapped.OffsetHigh = static_cast<DWORD>(fileOffset >> 32);
+
+        DWORD numBytesWritten = 0;
+        if (!::WriteFile(mTileFileHandle, ptr, numBytesThisWrite,
+                         &numBytesWritten, &overlapped))
+        {
+            throw except::Exception(Ctxt(
+                    "Unable to write to " + mPathname));
+        }
+
+        ptr += numBytesWritten;
+        fileOffset += numBytesWritten;
+        numBytes -= numBytesWritten;
+    }
+}
+
+void SICDWriteControl::closeTileFile()
+{
+    if (mTileFileHandle != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(mTileFileHandle);
+        mTileFileHandle = INVALID_HANDLE_VALUE;
+    }
+}
+#else
+void SICDWriteControl::writeAt(nitf::Off fileOffset,
+                               const void* data,
+                               size_t numBytes)
+{
+    const char* ptr = static_cast<const char*>(data);
+    while (numBytes > 0)
+    {
+        const ssize_t numBytesWritten = ::pwrite(mTileFileDescriptor, ptr,
+                                                 numBytes, fileOffset);
+        if (numBytesWritten < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw except::Exception(Ctxt(
+                    "Unable to write to " + mPathname));
+        }
+
+        ptr += numBytesWritten;
+        fileOffset += numBytesWritten;
+        numBytes -= numBytesWritten;
+    }
+}
+
+void SICDWriteControl::closeTileFile()
+{
+    if (mTileFileDescriptor >= 0)
+    {
+        ::close(mTileFileDescriptor);
+        mTileFileDescriptor = -1;
+    }
+}
+#endif
+
 void SICDWriteControl::close()
 {
+    closeTileFile();
     mIO->close();
 }
 }
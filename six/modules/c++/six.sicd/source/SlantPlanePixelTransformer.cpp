@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <algorithm>
+#include <cmath>
 
 #include <sys/Conf.h>
 #include <except/Exception.h>
@@ -49,6 +50,11 @@ SlantPlanePixelTransformer::SlantPlanePixelTransformer(
 scene::Vector3 SlantPlanePixelTransformer::toECEF(
     const types::RowCol<double>& pixel) const
 {
+    if (mMesh.get())
+    {
+        return mMesh->interpolate(pixel);
+    }
+
     //! convert slant pixel to meters from scene center
     const types::RowCol<double> imagePt(mSicdData.pixelToImagePoint(pixel));
 
@@ -75,5 +81,209 @@ scene::LatLon SlantPlanePixelTransformer::toLatLon(
     return scene::LatLon(lla.getLat(), lla.getLon());
 }
 
+const size_t SlantPlanePixelTransformer::DEFAULT_MAX_MESH_NODES;
+
+mem::SharedPtr<const ProjectionMesh> SlantPlanePixelTransformer::buildMesh(
+    const types::RowCol<double>& initialSpacing,
+    double maxError,
+    size_t numThreads,
+    size_t maxMeshNodes)
+{
+    if (initialSpacing.row <= 0.0 || initialSpacing.col <= 0.0)
+    {
+        throw except::Exception(Ctxt("Mesh spacing must be positive"));
+    }
+
+    const types::RowCol<double> lastPixel(
+        static_cast<double>(mSicdData.getNumRows()) - 1.0,
+        static_cast<double>(mSicdData.getNumCols()) - 1.0);
+
+    types::RowCol<double> spacing(initialSpacing);
+    std::string achieved;
+    while (true)
+    {
+        //! nodes are spaced evenly from the first pixel to at least the last
+        const types::RowCol<size_t> meshDims(
+            std::max<size_t>(2, static_cast<size_t>(
+                std::ceil(lastPixel.row / spacing.row)) + 1),
+            std::max<size_t>(2, static_cast<size_t>(
+                std::ceil(lastPixel.col / spacing.col)) + 1));
+        if (meshDims.row > maxMeshNodes / meshDims.col)
+        {
+            throw except::Exception(Ctxt(
+                "A projection mesh with " + str::toString(spacing.row) +
+                " x " + str::toString(spacing.col) +
+                " pixel spacing would have more than " +
+                str::toString(maxMeshNodes) + " nodes" + achieved));
+        }
+
+        std::vector<double> rows;
+        std::vector<double> cols;
+        for (size_t row = 0; row < meshDims.row; ++row)
+        {
+            for (size_t col = 0; col < meshDims.col; ++col)
+            {
+                rows.push_back(row * spacing.row);
+                cols.push_back(col * spacing.col);
+            }
+        }
+
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        projectPixels(rows, cols, numThreads, x, y, z);
+
+        mem::SharedPtr<const ProjectionMesh> mesh(new ProjectionMesh(
+            SICDMeshes::PROJECTION_MESH_ID, meshDims, spacing, x, y, z));
+
+        const double error = getMeshError(*mesh, numThreads);
+        if (error <= maxError)
+        {
+            mMesh = mesh;
+            return mesh;
+        }
+
+        achieved = "; the interpolation error with " +
+                str::toString(spacing.row) + " x " +
+                str::toString(spacing.col) + " pixel spacing was " +
+                str::toString(error) + " meters";
+        if (spacing.row <= 1.0 && spacing.col <= 1.0)
+        {
+            throw except::Exception(Ctxt(
+                "Couldn't build a projection mesh within " +
+                str::toString(maxError) + " meters" + achieved));
+        }
+
+        spacing.row = std::max(1.0, spacing.row / 2);
+        spacing.col = std::max(1.0, spacing.col / 2);
+    }
+}
+
+void SlantPlanePixelTransformer::setMesh(
+    mem::SharedPtr<const ProjectionMesh> mesh)
+{
+    if (mesh.get())
+    {
+        mesh->validate();
+
+        //! otherwise the far edges of the image would be extrapolated
+        const types::RowCol<size_t> meshDims(mesh->getMeshDims());
+        const types::RowCol<double> spacing(mesh->getSpacing());
+        if ((meshDims.row - 1) * spacing.row <
+                static_cast<double>(mSicdData.getNumRows()) - 1.0 ||
+            (meshDims.col - 1) * spacing.col <
+                static_cast<double>(mSicdData.getNumCols()) - 1.0)
+        {
+            throw except::Exception(Ctxt(
+                "Projection mesh doesn't span the image"));
+        }
+    }
+
+    mMesh = mesh;
+}
+
+double SlantPlanePixelTransformer::getMeshError(
+    const ProjectionMesh& mesh,
+    size_t numThreads) const
+{
+    //! Within each cell, the error is measured at the center and partway
+    //! toward each corner (the corners themselves are nodes, so they're
+    //! exact).  It's also measured at the midpoint of every edge.
+    static const double CELL_POINTS[5][2] = {
+        {0.5, 0.5}, {0.25, 0.25}, {0.25, 0.75}, {0.75, 0.25}, {0.75, 0.75}};
+
+    //! points are projected a batch of node rows at a time to bound memory
+    static const size_t BATCH_SIZE = 65536;
+
+    const types::RowCol<size_t> meshDims(mesh.getMeshDims());
+    const types::RowCol<double> spacing(mesh.getSpacing());
+
+    double error = 0.0;
+    std::vector<double> rows;
+    std::vector<double> cols;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    for (size_t row = 0; row < meshDims.row; ++row)
+    {
+        const bool lastRow = (row + 1 == meshDims.row);
+        for (size_t col = 0; col < meshDims.col; ++col)
+        {
+            const bool lastCol = (col + 1 == meshDims.col);
+            if (!lastCol)
+            {
+                rows.push_back(row * spacing.row);
+                cols.push_back((col + 0.5) * spacing.col);
+            }
+            if (!lastRow)
+            {
+                rows.push_back((row + 0.5) * spacing.row);
+                cols.push_back(col * spacing.col);
+            }
+            if (!lastRow && !lastCol)
+            {
+                for (size_t ii = 0; ii < 5; ++ii)
+                {
+                    rows.push_back((row + CELL_POINTS[ii][0]) * spacing.row);
+                    cols.push_back((col + CELL_POINTS[ii][1]) * spacing.col);
+                }
+            }
+        }
+
+        if (rows.size() >= BATCH_SIZE || lastRow)
+        {
+            projectPixels(rows, cols, numThreads, x, y, z);
+            for (size_t ii = 0; ii < rows.size(); ++ii)
+            {
+                scene::Vector3 diff = mesh.interpolate(
+                    types::RowCol<double>(rows[ii], cols[ii]));
+                diff[0] -= x[ii];
+                diff[1] -= y[ii];
+                diff[2] -= z[ii];
+                error = std::max(error, diff.norm());
+            }
+            rows.clear();
+            cols.clear();
+        }
+    }
+
+    return error;
+}
+
+void SlantPlanePixelTransformer::projectPixels(
+    const std::vector<double>& rows,
+    const std::vector<double>& cols,
+    size_t numThreads,
+    std::vector<double>& x,
+    std::vector<double>& y,
+    std::vector<double>& z) const
+{
+    //! convert slant pixels to meters from scene center
+    const size_t numPixels = rows.size();
+    std::vector<double> imageRows(numPixels);
+    std::vector<double> imageCols(numPixels);
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        const types::RowCol<double> imagePt(mSicdData.pixelToImagePoint(
+            types::RowCol<double>(rows[ii], cols[ii])));
+        imageRows[ii] = imagePt.row;
+        imageCols[ii] = imagePt.col;
+    }
+
+    //! project into ground plane -- ecef coords
+    x.resize(numPixels);
+    y.resize(numPixels);
+    z.resize(numPixels);
+    if (numPixels > 0)
+    {
+        mProjection.imageToScene(&imageRows[0], &imageCols[0], numPixels,
+                                 mGeom.getReferencePosition(),
+                                 mGroundPlaneNormal,
+                                 scene::AdjustableParams(),
+                                 numThreads,
+                                 &x[0], &y[0], &z[0]);
+    }
+}
+
 }
 }
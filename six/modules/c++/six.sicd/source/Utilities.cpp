@@ -19,19 +19,24 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
 #include <map>
 
 #include <sys/Conf.h>
 #include <except/Exception.h>
-#include <mem/ScopedAlignedArray.h>
 #include <types/RowCol.h>
 #include <math/poly/Fit.h>
 #include <math/Utilities.h>
 #include <io/StringStream.h>
 #include <str/Manip.h>
+#include <sys/Runnable.h>
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
+#include <six/Adapters.h>
 #include <six/Utilities.h>
 #include <six/NITFReadControl.h>
 #include <six/sicd/ComplexXMLControl.h>
+#include <six/sicd/PixelConversion.h>
 #include <six/sicd/SICDMesh.h>
 #include <six/sicd/Utilities.h>
 
@@ -66,20 +71,25 @@ void readAndConvertSICD(six::NITFReadControl& reader,
                         size_t imageNumber,
                         const types::RowCol<size_t>& offset,
                         const types::RowCol<size_t>& extent,
+                        std::vector<std::complex<sys::Int16_T> >& scratch,
                         std::complex<float>* buffer)
 {
-
-
-    // One for the real component, one for imaginary of each pixel
-    const size_t elementsPerRow = extent.col * 2;
+    if (extent.area() == 0)
+    {
+        return;
+    }
 
     // Get at least 32MB per read
-    const size_t rowsAtATime =
-            (32000000 / (elementsPerRow * sizeof(short))) + 1;
+    const size_t rowsAtATime = std::min<size_t>(
+            (32000000 / (extent.col * sizeof(std::complex<sys::Int16_T>))) + 1,
+            extent.row);
 
-    // Allocate temp buffer
-    std::vector<short> tempVector(elementsPerRow * rowsAtATime);
-    short* const tempBuffer = &tempVector[0];
+    // Only grow the scratch buffer - callers reuse it across calls
+    if (scratch.size() < rowsAtATime * extent.col)
+    {
+        scratch.resize(rowsAtATime * extent.col);
+    }
+    std::complex<sys::Int16_T>* const tempBuffer = &scratch[0];
 
     const size_t endRow = offset.row + extent.row;
 
@@ -100,16 +110,159 @@ void readAndConvertSICD(six::NITFReadControl& reader,
         six::Region region = buildRegion(swathOffset, swathExtent, tempBuffer);
         reader.interleaved(region, imageNumber);
 
-        // Take each Int16 out of the temp buffer and put it into the real
-        // buffer as a Float32
-        float* const bufferPtr = reinterpret_cast<float*>(buffer) +
-                ((row - offset.row) * elementsPerRow);
+        // The NITF reader has already swapped to native byte order, so
+        // this is just a promotion to complex<float>
+        six::sicd::promotePixels(tempBuffer,
+                                 rowsToRead * extent.col,
+                                 false,
+                                 buffer + (row - offset.row) * extent.col);
+    }
+}
+
+// Converts (if 'input' is non-NULL) and processes a range of rows of one
+// swath
+class ConvertSwathRunnable : public sys::Runnable
+{
+public:
+    ConvertSwathRunnable(const std::complex<sys::Int16_T>* input,
+                         const types::RowCol<size_t>& offset,
+                         const types::RowCol<size_t>& extent,
+                         std::complex<float>* output,
+                         six::sicd::WidebandBlockProcessor* processor) :
+        mInput(input),
+        mOffset(offset),
+        mExtent(extent),
+        mOutput(output),
+        mProcessor(processor)
+    {
+    }
+
+    virtual void run()
+    {
+        if (mInput)
+        {
+            six::sicd::promotePixels(mInput, mExtent.area(), false, mOutput);
+        }
+
+        if (mProcessor)
+        {
+            (*mProcessor)(mOffset, mExtent, mOutput);
+        }
+    }
+
+private:
+    const std::complex<sys::Int16_T>* const mInput;
+    const types::RowCol<size_t> mOffset;
+    const types::RowCol<size_t> mExtent;
+    std::complex<float>* const mOutput;
+    six::sicd::WidebandBlockProcessor* const mProcessor;
+};
+
+// Splits the swath across the threads in 'threads' and starts them
+void startConvertingSwath(const std::complex<sys::Int16_T>* input,
+                          const types::RowCol<size_t>& offset,
+                          const types::RowCol<size_t>& extent,
+                          size_t numThreads,
+                          std::complex<float>* output,
+                          six::sicd::WidebandBlockProcessor* processor,
+                          mt::ThreadGroup& threads)
+{
+    const mt::ThreadPlanner planner(extent.row, numThreads);
+
+    size_t threadNum(0);
+    size_t startRow(0);
+    size_t numRowsThisThread(0);
+    while (planner.getThreadInfo(threadNum++, startRow, numRowsThisThread))
+    {
+        const size_t startIndex = startRow * extent.col;
+        std::auto_ptr<sys::Runnable> runnable(new ConvertSwathRunnable(
+                input ? input + startIndex : NULL,
+                types::RowCol<size_t>(offset.row + startRow, offset.col),
+                types::RowCol<size_t>(numRowsThisThread, extent.col),
+                output + startIndex,
+                processor));
+        threads.createThread(runnable);
+    }
+}
+
+// Double-buffered version of readAndConvertSICD(): the next swath is read
+// while the threads are still converting the previous one.  If 'convert' is
+// false, the data is already complex<float> and is read straight into
+// 'buffer', in which case only the processing is overlapped with the reads.
+void readAndConvertSICDPipelined(six::NITFReadControl& reader,
+                                 size_t imageNumber,
+                                 bool convert,
+                                 const types::RowCol<size_t>& offset,
+                                 const types::RowCol<size_t>& extent,
+                                 size_t numThreads,
+                                 std::complex<float>* buffer,
+                                 six::sicd::WidebandBlockProcessor* processor,
+                                 size_t numRowsPerSwath)
+{
+    if (extent.area() == 0)
+    {
+        return;
+    }
+
+    // Unless told otherwise, get at least 32MB per read
+    if (numRowsPerSwath == 0)
+    {
+        numRowsPerSwath = (32000000 /
+                (extent.col * sizeof(std::complex<sys::Int16_T>))) + 1;
+    }
+    const size_t rowsAtATime = std::min(numRowsPerSwath, extent.row);
+
+    std::vector<std::complex<sys::Int16_T> > scratch[2];
+    if (convert)
+    {
+        scratch[0].resize(rowsAtATime * extent.col);
+        scratch[1].resize(rowsAtATime * extent.col);
+    }
+
+    const size_t endRow = offset.row + extent.row;
+    std::auto_ptr<mt::ThreadGroup> threads;
+
+    for (size_t row = offset.row, rowsToRead = rowsAtATime, swath = 0;
+         row < endRow;
+         row += rowsToRead, ++swath)
+    {
+        // If we would read beyond the input buffer, don't
+        if (row + rowsToRead > endRow)
+        {
+            rowsToRead = endRow - row;
+        }
+
+        std::complex<float>* const output =
+                buffer + (row - offset.row) * extent.col;
+        std::complex<sys::Int16_T>* const input =
+                convert ? &scratch[swath % 2][0] : NULL;
+
+        // Read while the previous swath is being converted
+        const types::RowCol<size_t> swathOffset(row, offset.col);
+        const types::RowCol<size_t> swathExtent(rowsToRead, extent.col);
+        six::Region region = convert ?
+                buildRegion(swathOffset, swathExtent, input) :
+                buildRegion(swathOffset, swathExtent, output);
+        reader.interleaved(region, imageNumber);
 
-        for (size_t index = 0; index < elementsPerRow * rowsToRead; index++)
+        // The previous swath has to be done with its buffer before the next
+        // read can reuse it
+        if (threads.get())
         {
-            bufferPtr[index] = tempBuffer[index];
+            threads->joinAll();
         }
+
+        threads.reset(new mt::ThreadGroup());
+        startConvertingSwath(input,
+                             swathOffset,
+                             swathExtent,
+                             numThreads,
+                             output,
+                             processor,
+                             *threads);
     }
+
+    threads->joinAll();
 }
 
 six::Poly2D getXYtoRowColTransform(double center,
@@ -148,27 +301,17 @@ std::map<std::string, size_t> getAdditionalDesMap(six::NITFReadControl& reader)
     return nameToDesIndex;
 }
 
-void getDesBuffer(six::NITFReadControl& reader,
-                  size_t desIndex,
-                  mem::ScopedAlignedArray<sys::byte>& buffer)
+nitf::SegmentReader getDesReader(six::NITFReadControl& reader,
+                                 size_t desIndex)
 {
     nitf::List des = reader.getRecord().getDataExtensions();
-    
+
     if (desIndex >= des.getSize())
     {
         throw except::Exception(Ctxt("DES index out of range."));
     }
 
-    // Pull out the DE segment and its reader
-    nitf::DESegment segment =
-        static_cast<nitf::DESegment>(des[desIndex]);
-    nitf::DESubheader subheader = segment.getSubheader();
-    nitf::SegmentReader deReader = reader.getReader().newDEReader(desIndex);
-
-    // Read the DE segment buffer
-    const size_t bufferSize = subheader.getDataLength();
-    buffer.reset(bufferSize);
-    deReader.read(buffer.get(), bufferSize);
+    return reader.getReader().newDEReader(desIndex);
 }
 }
 
@@ -560,6 +703,18 @@ void Utilities::getWidebandData(NITFReadControl& reader,
                                 const types::RowCol<size_t>& offset,
                                 const types::RowCol<size_t>& extent,
                                 std::complex<float>* buffer)
+{
+    std::vector<std::complex<sys::Int16_T> > scratch;
+    getWidebandData(reader, complexData, offset, extent, scratch, buffer);
+}
+
+void Utilities::getWidebandData(
+        NITFReadControl& reader,
+        const ComplexData& complexData,
+        const types::RowCol<size_t>& offset,
+        const types::RowCol<size_t>& extent,
+        std::vector<std::complex<sys::Int16_T> >& scratch,
+        std::complex<float>* buffer)
 {
     const PixelType pixelType = complexData.getPixelType();
     const size_t imageNumber = 0;
@@ -588,6 +743,7 @@ void Utilities::getWidebandData(NITFReadControl& reader,
                            imageNumber,
                            offset,
                            extent,
+                           scratch,
                            buffer);
     }
     else
@@ -597,6 +753,100 @@ void Utilities::getWidebandData(NITFReadControl& reader,
     }
 
 }
+void Utilities::getWidebandData(NITFReadControl& reader,
+                                const ComplexData& complexData,
+                                const types::RowCol<size_t>& offset,
+                                const types::RowCol<size_t>& extent,
+                                size_t numThreads,
+                                std::complex<float>* buffer,
+                                WidebandBlockProcessor* processor,
+                                size_t numRowsPerSwath)
+{
+    const PixelType pixelType = complexData.getPixelType();
+    const size_t imageNumber = 0;
+
+    if (buffer == NULL)
+    {
+        throw except::Exception(Ctxt("Null buffer provided to getWidebandData"
+                    + std::string(" when a ")
+                    + str::toString(sizeof(std::complex<float>) *
+                                    extent.area())
+                    + std::string(" byte buffer was expected")));
+    }
+
+    if (pixelType != PixelType::RE32F_IM32F &&
+        pixelType != PixelType::RE16I_IM16I)
+    {
+        throw except::Exception(Ctxt(
+                complexData.getName() + " has an unknown pixel type"));
+    }
+
+    if (pixelType == PixelType::RE32F_IM32F && processor == NULL)
+    {
+        // Nothing to overlap the read with
+        six::Region region = buildRegion(offset, extent, buffer);
+        reader.interleaved(region, imageNumber);
+        return;
+    }
+
+    readAndConvertSICDPipelined(reader,
+                                imageNumber,
+                                pixelType == PixelType::RE16I_IM16I,
+                                offset,
+                                extent,
+                                std::max<size_t>(numThreads, 1),
+                                buffer,
+                                processor,
+                                numRowsPerSwath);
+}
+
+void Utilities::getWidebandData(NITFReadControl& reader,
+                                const ComplexData& complexData,
+                                const types::RowCol<size_t>& offset,
+                                const types::RowCol<size_t>& extent,
+                                const types::RowCol<size_t>& decimation,
+                                Region::DownsampleMethod method,
+                                std::complex<float>* buffer)
+{
+    const PixelType pixelType = complexData.getPixelType();
+    const size_t imageNumber = 0;
+
+    six::Region region = buildRegion(offset, extent, buffer);
+    region.setDecimation(decimation.row, decimation.col);
+    region.setDownsampleMethod(method);
+    const size_t numPixels = region.getNumDecimatedRows() *
+            region.getNumDecimatedCols();
+
+    if (buffer == NULL)
+    {
+        throw except::Exception(Ctxt("Null buffer provided to getWidebandData"
+                    + std::string(" when a ")
+                    + str::toString(sizeof(std::complex<float>) * numPixels)
+                    + std::string(" byte buffer was expected")));
+    }
+
+    if (pixelType == PixelType::RE32F_IM32F)
+    {
+        reader.interleaved(region, imageNumber);
+    }
+    else if (pixelType == PixelType::RE16I_IM16I)
+    {
+        // Only the decimated pixels are staged here
+        std::vector<std::complex<sys::Int16_T> > scratch(numPixels);
+        if (numPixels > 0)
+        {
+            region.setBuffer(reinterpret_cast<six::UByte*>(&scratch[0]));
+            reader.interleaved(region, imageNumber);
+            promotePixels(&scratch[0], numPixels, false, buffer);
+        }
+    }
+    else
+    {
+        throw except::Exception(Ctxt(
+                complexData.getName() + " has an unknown pixel type"));
+    }
+}
+
 void Utilities::getWidebandData(NITFReadControl& reader,
                                 const ComplexData& complexData,
                                 std::complex<float>* buffer)
@@ -932,15 +1182,60 @@ std::auto_ptr<NoiseMesh> Utilities::getNoiseMesh(NITFReadControl& reader)
 
     // Extract the noise mesh
     std::auto_ptr<NoiseMesh> noiseMesh(new NoiseMesh(SICDMeshes::NOISE_MESH_ID));
-    mem::ScopedAlignedArray<sys::byte> buffer;
-    getDesBuffer(
-        reader, nameToDesIndex.at(SICDMeshes::NOISE_MESH_ID), buffer);
-    const sys::byte* bufferData = buffer.get();
-    noiseMesh->deserialize(bufferData);
+    nitf::SegmentReader deReader = getDesReader(
+        reader, nameToDesIndex.at(SICDMeshes::NOISE_MESH_ID));
+    SegmentInputStreamAdapter stream(deReader);
+    noiseMesh->deserialize(stream);
+
+    return noiseMesh;
+}
+
+std::auto_ptr<NoiseMesh>
+Utilities::getNoiseMesh(NITFReadControl& reader,
+                        const types::RowCol<size_t>& offset,
+                        const types::RowCol<size_t>& windowDims)
+{
+    const std::map<std::string, size_t> nameToDesIndex =
+        getAdditionalDesMap(reader);
+
+    if (nameToDesIndex.find(SICDMeshes::NOISE_MESH_ID) == nameToDesIndex.end())
+    {
+        throw except::Exception(Ctxt("Noise mesh information not present"));
+    }
+
+    // Only the window is read out of the DES
+    std::auto_ptr<NoiseMesh> noiseMesh(new NoiseMesh(SICDMeshes::NOISE_MESH_ID));
+    nitf::SegmentReader deReader = getDesReader(
+        reader, nameToDesIndex.at(SICDMeshes::NOISE_MESH_ID));
+    SegmentInputStreamAdapter stream(deReader);
+    noiseMesh->deserializeWindow(stream, offset, windowDims);
 
     return noiseMesh;
 }
 
+std::auto_ptr<ProjectionMesh>
+Utilities::getProjectionMesh(NITFReadControl& reader)
+{
+    const std::map<std::string, size_t> nameToDesIndex =
+        getAdditionalDesMap(reader);
+
+    if (nameToDesIndex.find(SICDMeshes::PROJECTION_MESH_ID) ==
+        nameToDesIndex.end())
+    {
+        throw except::Exception(Ctxt(
+            "Projection mesh information not present"));
+    }
+
+    std::auto_ptr<ProjectionMesh> projectionMesh(
+        new ProjectionMesh(SICDMeshes::PROJECTION_MESH_ID));
+    nitf::SegmentReader deReader = getDesReader(
+        reader, nameToDesIndex.at(SICDMeshes::PROJECTION_MESH_ID));
+    SegmentInputStreamAdapter stream(deReader);
+    projectionMesh->deserialize(stream);
+
+    return projectionMesh;
+}
+
 void Utilities::getProjectionPolys(NITFReadControl& reader,
                                    size_t orderX,
                                    size_t orderY,
@@ -970,22 +1265,19 @@ void Utilities::getProjectionPolys(NITFReadControl& reader,
             "AreaPlane information must be populated to use projection mesh"));
     }
 
-    mem::ScopedAlignedArray<sys::byte> buffer;
-    const sys::byte* bufferData;
-
-    // Extract the slant plane mesh buffer and deserialize
+    // Deserialize the slant plane mesh
     PlanarCoordinateMesh slantMesh(SICDMeshes::SLANT_PLANE_MESH_ID);
-    getDesBuffer(
-        reader, nameToDesIndex.at(SICDMeshes::SLANT_PLANE_MESH_ID), buffer);
-    bufferData = buffer.get();
-    slantMesh.deserialize(bufferData);
+    nitf::SegmentReader slantReader = getDesReader(
+        reader, nameToDesIndex.at(SICDMeshes::SLANT_PLANE_MESH_ID));
+    SegmentInputStreamAdapter slantStream(slantReader);
+    slantMesh.deserialize(slantStream);
 
-    // Extract the output plane mesh buffer and deserialize
+    // Deserialize the output plane mesh
     PlanarCoordinateMesh outputMesh(SICDMeshes::OUTPUT_PLANE_MESH_ID);
-    getDesBuffer(
-        reader, nameToDesIndex.at(SICDMeshes::OUTPUT_PLANE_MESH_ID), buffer);
-    bufferData = buffer.get();
-    outputMesh.deserialize(bufferData);
+    nitf::SegmentReader outputReader = getDesReader(
+        reader, nameToDesIndex.at(SICDMeshes::OUTPUT_PLANE_MESH_ID));
+    SegmentInputStreamAdapter outputStream(outputReader);
+    outputMesh.deserialize(outputStream);
 
     const types::RowCol<double> outputSampleSpacing(
         complexData->radarCollection->area->plane->xDirection->spacing,
@@ -1117,7 +1409,8 @@ void Utilities::fitXYProjectionPolys(
 void Utilities::projectPixelsToOutputPlane(
     const six::sicd::ComplexData& complexData,
     const std::vector<types::RowCol<double> >& spPixels,
-    std::vector<types::RowCol<double> >& opPixels)
+    std::vector<types::RowCol<double> >& opPixels,
+    size_t numThreads)
 {
     std::auto_ptr<scene::SceneGeometry> geometry;
     std::auto_ptr<scene::ProjectionModel> projectionModel;
@@ -1135,18 +1428,37 @@ void Utilities::projectPixelsToOutputPlane(
     const six::Vector3 opORPECEF = areaPlane.referencePoint.ecef;
     const six::Vector3 opZ = Utilities::getGroundPlaneNormal(complexData);
 
-    // Project slant plane pixels to output plane pixels.
-    opPixels.resize(spPixels.size());
-    for (size_t ii = 0; ii < spPixels.size(); ++ii)
+    // Project slant plane pixels to output plane ECEF.
+    const size_t numPixels = spPixels.size();
+    std::vector<double> spX(numPixels);
+    std::vector<double> spY(numPixels);
+    for (size_t ii = 0; ii < numPixels; ++ii)
     {
         const types::RowCol<double> spXY(
             complexData.pixelToImagePoint(spPixels[ii]));
+        spX[ii] = spXY.row;
+        spY[ii] = spXY.col;
+    }
 
-        // Convert to output plane ECEF.
-        const six::Vector3 opECEF =
-            projectionModel->imageToScene(spXY, opORPECEF, opZ);
+    std::vector<double> opECEFX(numPixels);
+    std::vector<double> opECEFY(numPixels);
+    std::vector<double> opECEFZ(numPixels);
+    if (numPixels > 0)
+    {
+        projectionModel->imageToScene(&spX[0], &spY[0], numPixels,
+                                      opORPECEF, opZ,
+                                      scene::AdjustableParams(), numThreads,
+                                      &opECEFX[0], &opECEFY[0], &opECEFZ[0]);
+    }
 
+    opPixels.resize(numPixels);
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
         // Convert ECEF to output distance to the output plane ORP.
+        six::Vector3 opECEF;
+        opECEF[0] = opECEFX[ii];
+        opECEF[1] = opECEFY[ii];
+        opECEF[2] = opECEFZ[ii];
         const six::Vector3 diffECEF = opECEF - opORPECEF;
         const double opX = diffECEF.dot(areaPlane.xDirection->unitVector);
         const double opY = diffECEF.dot(areaPlane.yDirection->unitVector);
@@ -1156,7 +1468,6 @@ void Utilities::projectPixelsToOutputPlane(
             opX / opSampleSpacing.row + opCenterPixel.row,
             opY / opSampleSpacing.col + opCenterPixel.col);
     }
-   
 }
 
 void Utilities::projectValidDataPolygonToOutputPlane(
@@ -1193,7 +1504,8 @@ void Utilities::projectValidDataPolygonToOutputPlane(
 void Utilities::projectPixelsToSlantPlane(
     const six::sicd::ComplexData& complexData,
     const std::vector<types::RowCol<double> >& opPixels,
-    std::vector<types::RowCol<double> >& spPixels)
+    std::vector<types::RowCol<double> >& spPixels,
+    size_t numThreads)
 {
     std::auto_ptr<scene::SceneGeometry> geometry;
     std::auto_ptr<scene::ProjectionModel> projectionModel;
@@ -1220,20 +1532,35 @@ void Utilities::projectPixelsToSlantPlane(
         spSCP.row - spOrigOffset.row,
         spSCP.col - spOrigOffset.col);
     
-    // Project output plane pixels to slant plane pixels.
-    spPixels.resize(opPixels.size());
-    for (size_t ii = 0; ii < opPixels.size(); ++ii)
+    // Convert output plane pixels to ECEF.
+    const size_t numPixels = opPixels.size();
+    std::vector<double> ecefX(numPixels);
+    std::vector<double> ecefY(numPixels);
+    std::vector<double> ecefZ(numPixels);
+    for (size_t ii = 0; ii < numPixels; ++ii)
     {
-        // Convert output plane pixel to ECEF.
         const scene::Vector3 ecef = ecefTransform.rowColToECEF(opPixels[ii]);
-        
-        // Convert ECEF to slant plane distance from SCP.
-        double timeCOA = 0.0;
-        const types::RowCol<double> spXY =
-            projectionModel->sceneToImage(ecef, &timeCOA);
-
-        // Convert to slant plane pixel.
-        spPixels[ii] = (spXY / spSampleSpacing + spOffset);
+        ecefX[ii] = ecef[0];
+        ecefY[ii] = ecef[1];
+        ecefZ[ii] = ecef[2];
+    }
+
+    // Convert ECEF to slant plane distance from SCP.
+    std::vector<double> spX(numPixels);
+    std::vector<double> spY(numPixels);
+    if (numPixels > 0)
+    {
+        projectionModel->sceneToImage(&ecefX[0], &ecefY[0], &ecefZ[0],
+                                      numPixels, scene::AdjustableParams(),
+                                      numThreads, &spX[0], &spY[0]);
+    }
+
+    // Convert to slant plane pixels.
+    spPixels.resize(numPixels);
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        spPixels[ii] = (types::RowCol<double>(spX[ii], spY[ii]) /
+                spSampleSpacing + spOffset);
     }
 }
 }
@@ -30,6 +30,7 @@
 
 #include <import/six.h>
 #include <import/io.h>
+#include <import/mt.h>
 #include <logging/Setup.h>
 #include <scene/Utilities.h>
 
@@ -57,6 +58,33 @@ void subsetData(const T* orig,
     }
 }
 
+// Writes one tile via SICDWriteControl::saveTile()
+class SaveTileRunnable : public sys::Runnable
+{
+public:
+    SaveTileRunnable(six::sicd::SICDWriteControl& writer,
+                     const void* imageData,
+                     const types::RowCol<size_t>& offset,
+                     const types::RowCol<size_t>& dims) :
+        mWriter(writer),
+        mImageData(imageData),
+        mOffset(offset),
+        mDims(dims)
+    {
+    }
+
+    virtual void run()
+    {
+        mWriter.saveTile(mImageData, mOffset, mDims);
+    }
+
+private:
+    six::sicd::SICDWriteControl& mWriter;
+    const void* const mImageData;
+    const types::RowCol<size_t> mOffset;
+    const types::RowCol<size_t> mDims;
+};
+
 // Main test class
 template <typename DataTypeT>
 class Tester
@@ -101,6 +129,9 @@ public:
     // Writes where some rows are written out with only some of the cols
     void testMultipleWritesOfPartialRows();
 
+    // Tiles written concurrently from several threads via saveTile()
+    void testConcurrentTiles();
+
 private:
     void normalWrite();
 
@@ -289,6 +320,75 @@ void Tester<DataTypeT>::testMultipleWritesOfPartialRows()
     compare("Multiple writes of partial rows");
 }
 
+template <typename DataTypeT>
+void Tester<DataTypeT>::testConcurrentTiles()
+{
+    const EnsureFileCleanup ensureFileCleanup(mTestPathname);
+
+    six::Options options;
+    setMaxProductSize(options);
+
+    six::sicd::SICDWriteControl sicdWriter(mTestPathname, mSchemaPaths);
+    sicdWriter.initialize(options, mContainer);
+
+    // Rows [0, 50) are written as full-width tiles and the rest as a
+    // 2x3 grid of partial-width tiles
+    std::vector<types::RowCol<size_t> > offsets;
+    std::vector<types::RowCol<size_t> > dims;
+    offsets.push_back(types::RowCol<size_t>(0, 0));
+    dims.push_back(types::RowCol<size_t>(25, mDims.col));
+    offsets.push_back(types::RowCol<size_t>(25, 0));
+    dims.push_back(types::RowCol<size_t>(25, mDims.col));
+
+    const size_t rowSplits[] = {50, 90, mDims.row};
+    const size_t colSplits[] = {0, 100, 333, mDims.col};
+    for (size_t ii = 0; ii < 2; ++ii)
+    {
+        for (size_t jj = 0; jj < 3; ++jj)
+        {
+            offsets.push_back(types::RowCol<size_t>(rowSplits[ii],
+                                                    colSplits[jj]));
+            dims.push_back(types::RowCol<size_t>(
+                    rowSplits[ii + 1] - rowSplits[ii],
+                    colSplits[jj + 1] - colSplits[jj]));
+        }
+    }
+
+    std::vector<std::vector<std::complex<DataTypeT> > > tiles(offsets.size());
+    for (size_t ii = 0; ii < tiles.size(); ++ii)
+    {
+        subsetData(mImagePtr, mDims.col, offsets[ii], dims[ii], tiles[ii]);
+    }
+    const std::vector<std::vector<std::complex<DataTypeT> > > origTiles(tiles);
+
+    mt::ThreadGroup threads;
+    for (size_t ii = 0; ii < tiles.size(); ++ii)
+    {
+        threads.createThread(new SaveTileRunnable(sicdWriter,
+                                                  &tiles[ii][0],
+                                                  offsets[ii],
+                                                  dims[ii]));
+    }
+    threads.joinAll();
+
+    // Empty tiles don't write anything
+    sicdWriter.saveTile(mImagePtr, types::RowCol<size_t>(10, 20),
+                        types::RowCol<size_t>(5, 0));
+    sicdWriter.saveTile(mImagePtr, types::RowCol<size_t>(10, 0),
+                        types::RowCol<size_t>(0, mDims.col));
+
+    sicdWriter.close();
+
+    compare("Concurrent tile writes");
+
+    // saveTile() should never swap the caller's data in place
+    if (tiles != origTiles)
+    {
+        std::cerr << "Concurrent tile writes modified the input tiles\n";
+        mSuccess = false;
+    }
+}
+
 template <typename DataTypeT>
 bool doTests(const std::vector<std::string>& schemaPaths,
              bool setMaxProductSize,
@@ -308,6 +408,7 @@ bool doTests(const std::vector<std::string>& schemaPaths,
     tester.testSingleWrite();
     tester.testMultipleWritesOfFullRows();
     tester.testMultipleWritesOfPartialRows();
+    tester.testConcurrentTiles();
 
     return tester.success();
 }
@@ -0,0 +1,281 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <vector>
+
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+std::auto_ptr<six::sicd::ComplexData> createData()
+{
+    // The fake data's grid unit vectors are all zero, which leaves the
+    // image plane undefined.  Put the image plane in the slant plane at
+    // the start of the collect so scene to image projections converge.
+    std::auto_ptr<six::sicd::ComplexData> data =
+            six::sicd::Utilities::createFakeComplexData();
+    data->grid->type = six::ComplexImageGridType::PLANE;
+
+    const scene::Vector3 arp = data->position->arpPoly(0.0);
+    const scene::Vector3 vel = data->position->arpPoly.derivative()(0.0);
+    scene::Vector3 rowVector = data->geoData->scp.ecf - arp;
+    rowVector.normalize();
+    scene::Vector3 colVector = vel - rowVector * vel.dot(rowVector);
+    colVector.normalize();
+
+    data->grid->row->unitVector = rowVector;
+    data->grid->col->unitVector = colVector;
+    return data;
+}
+
+struct TestHelper
+{
+    TestHelper() :
+        mData(createData()),
+        mGeometry(six::sicd::Utilities::getSceneGeometry(mData.get())),
+        mModel(six::sicd::Utilities::getProjectionModel(mData.get(),
+                                                         mGeometry.get()))
+    {
+        // Enough points to span several blocks and threads
+        for (double row = -500; row <= 500; row += 50)
+        {
+            for (double col = -400; col <= 400; col += 40)
+            {
+                mRows.push_back(row);
+                mCols.push_back(col);
+            }
+        }
+    }
+
+    size_t getNumPoints() const
+    {
+        return mRows.size();
+    }
+
+    const std::auto_ptr<six::sicd::ComplexData> mData;
+    const std::auto_ptr<scene::SceneGeometry> mGeometry;
+    const std::auto_ptr<scene::ProjectionModel> mModel;
+    std::vector<double> mRows;
+    std::vector<double> mCols;
+};
+
+TEST_CASE(testImageToHeight)
+{
+    const TestHelper helper;
+    const size_t numPoints = helper.getNumPoints();
+    const size_t numThreads[] = {1, 3};
+    for (size_t tt = 0; tt < sizeof(numThreads) / sizeof(numThreads[0]); ++tt)
+    {
+        std::vector<double> x(numPoints);
+        std::vector<double> y(numPoints);
+        std::vector<double> z(numPoints);
+        helper.mModel->imageToScene(&helper.mRows[0], &helper.mCols[0],
+                                    numPoints, 100.0,
+                                    scene::AdjustableParams(), numThreads[tt],
+                                    &x[0], &y[0], &z[0]);
+
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            const scene::Vector3 expected = helper.mModel->imageToScene(
+                    types::RowCol<double>(helper.mRows[ii],
+                                          helper.mCols[ii]),
+                    100.0);
+            TEST_ASSERT_EQ(x[ii], expected[0]);
+            TEST_ASSERT_EQ(y[ii], expected[1]);
+            TEST_ASSERT_EQ(z[ii], expected[2]);
+        }
+    }
+}
+
+TEST_CASE(testImageToGroundPlane)
+{
+    const TestHelper helper;
+    const size_t numPoints = helper.getNumPoints();
+    const scene::Vector3 groundRefPoint = helper.mData->geoData->scp.ecf;
+    scene::Vector3 groundPlaneNormal = groundRefPoint;
+    groundPlaneNormal.normalize();
+
+    scene::AdjustableParams delta;
+    delta.mParams[scene::AdjustableParams::ARP_RADIAL] = 2.0;
+    delta.mParams[scene::AdjustableParams::RANGE_BIAS] = 0.5;
+
+    std::vector<double> x(numPoints);
+    std::vector<double> y(numPoints);
+    std::vector<double> z(numPoints);
+    std::vector<double> timeCOAs(numPoints);
+    helper.mModel->imageToScene(&helper.mRows[0], &helper.mCols[0],
+                                numPoints, groundRefPoint, groundPlaneNormal,
+                                delta, 2, &x[0], &y[0], &z[0], &timeCOAs[0]);
+
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        double timeCOA;
+        const scene::Vector3 expected = helper.mModel->imageToScene(
+                types::RowCol<double>(helper.mRows[ii], helper.mCols[ii]),
+                groundRefPoint, groundPlaneNormal, delta, &timeCOA);
+        TEST_ASSERT_EQ(x[ii], expected[0]);
+        TEST_ASSERT_EQ(y[ii], expected[1]);
+        TEST_ASSERT_EQ(z[ii], expected[2]);
+        TEST_ASSERT_EQ(timeCOAs[ii], timeCOA);
+    }
+}
+
+TEST_CASE(testSceneToImage)
+{
+    const TestHelper helper;
+    const size_t numPoints = helper.getNumPoints();
+    std::vector<double> x(numPoints);
+    std::vector<double> y(numPoints);
+    std::vector<double> z(numPoints);
+    helper.mModel->imageToScene(&helper.mRows[0], &helper.mCols[0],
+                                numPoints, 0.0, scene::AdjustableParams(), 1,
+                                &x[0], &y[0], &z[0]);
+
+    std::vector<double> rows(numPoints);
+    std::vector<double> cols(numPoints);
+    std::vector<double> timeCOAs(numPoints);
+    helper.mModel->sceneToImage(&x[0], &y[0], &z[0], numPoints,
+                                scene::AdjustableParams(), 4,
+                                &rows[0], &cols[0], &timeCOAs[0]);
+
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        scene::Vector3 scenePoint;
+        scenePoint[0] = x[ii];
+        scenePoint[1] = y[ii];
+        scenePoint[2] = z[ii];
+
+        double timeCOA;
+        const types::RowCol<double> expected =
+                helper.mModel->sceneToImage(scenePoint, &timeCOA);
+        TEST_ASSERT_EQ(rows[ii], expected.row);
+        TEST_ASSERT_EQ(cols[ii], expected.col);
+        TEST_ASSERT_EQ(timeCOAs[ii], timeCOA);
+
+        // And we should have made it back to where we started
+        TEST_ASSERT_ALMOST_EQ_EPS(rows[ii], helper.mRows[ii], 1e-2);
+        TEST_ASSERT_ALMOST_EQ_EPS(cols[ii], helper.mCols[ii], 1e-2);
+    }
+}
+
+TEST_CASE(testWarmStart)
+{
+    const TestHelper helper;
+    const size_t numPoints = helper.getNumPoints();
+    std::vector<double> x(numPoints);
+    std::vector<double> y(numPoints);
+    std::vector<double> z(numPoints);
+    std::vector<double> warmX(numPoints);
+    std::vector<double> warmY(numPoints);
+    std::vector<double> warmZ(numPoints);
+    helper.mModel->imageToScene(&helper.mRows[0], &helper.mCols[0],
+                                numPoints, 100.0, scene::AdjustableParams(), 1,
+                                &x[0], &y[0], &z[0]);
+    helper.mModel->imageToScene(&helper.mRows[0], &helper.mCols[0],
+                                numPoints, 100.0, scene::AdjustableParams(), 2,
+                                &warmX[0], &warmY[0], &warmZ[0],
+                                1.0, 3, true);
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        TEST_ASSERT_ALMOST_EQ_EPS(warmX[ii], x[ii], 1e-2);
+        TEST_ASSERT_ALMOST_EQ_EPS(warmY[ii], y[ii], 1e-2);
+        TEST_ASSERT_ALMOST_EQ_EPS(warmZ[ii], z[ii], 1e-2);
+    }
+
+    std::vector<double> rows(numPoints);
+    std::vector<double> cols(numPoints);
+    std::vector<double> warmRows(numPoints);
+    std::vector<double> warmCols(numPoints);
+    helper.mModel->sceneToImage(&x[0], &y[0], &z[0], numPoints,
+                                scene::AdjustableParams(), 1,
+                                &rows[0], &cols[0]);
+    helper.mModel->sceneToImage(&x[0], &y[0], &z[0], numPoints,
+                                scene::AdjustableParams(), 2,
+                                &warmRows[0], &warmCols[0], NULL, true);
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        TEST_ASSERT_ALMOST_EQ_EPS(warmRows[ii], rows[ii], 1e-5);
+        TEST_ASSERT_ALMOST_EQ_EPS(warmCols[ii], cols[ii], 1e-5);
+    }
+}
+
+TEST_CASE(testAnalyticPartials)
+{
+    const TestHelper helper;
+    scene::AdjustableParams& params = helper.mModel->getAdjustableParams();
+    params.mParams[scene::AdjustableParams::ARP_IN_TRACK] = 3.0;
+    params.mParams[scene::AdjustableParams::ARP_VEL_RADIAL] = 0.1;
+    params.mParams[scene::AdjustableParams::RANGE_BIAS] = 1.5;
+
+    for (size_t ii = 0; ii < helper.getNumPoints(); ii += 37)
+    {
+        const scene::Vector3 scenePoint = helper.mModel->imageToScene(
+                types::RowCol<double>(helper.mRows[ii], helper.mCols[ii]),
+                50.0);
+        const types::RowCol<double> imagePoint =
+                helper.mModel->sceneToImage(scenePoint);
+
+        math::linear::MatrixMxN<2, 3> imagePartials;
+        math::linear::MatrixMxN<2, 7> sensorPartials;
+        helper.mModel->sceneToImageAnalyticPartials(scenePoint, imagePoint,
+                                                    imagePartials,
+                                                    sensorPartials);
+
+        // The finite differences are only good to about the convergence
+        // tolerance of sceneToImage() over the step size
+        const math::linear::MatrixMxN<2, 3> expectedImagePartials =
+                helper.mModel->sceneToImagePartials(scenePoint, imagePoint);
+        const math::linear::MatrixMxN<2, 7> expectedSensorPartials =
+                helper.mModel->sceneToImageSensorPartials(scenePoint,
+                                                          imagePoint);
+        for (size_t row = 0; row < 2; ++row)
+        {
+            for (size_t col = 0; col < 3; ++col)
+            {
+                TEST_ASSERT_ALMOST_EQ_EPS(imagePartials(row, col),
+                                          expectedImagePartials(row, col),
+                                          1e-3);
+            }
+            for (size_t col = 0; col < 7; ++col)
+            {
+                TEST_ASSERT_ALMOST_EQ_EPS(sensorPartials(row, col),
+                                          expectedSensorPartials(row, col),
+                                          1e-3);
+            }
+        }
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testImageToHeight);
+    TEST_CHECK(testImageToGroundPlane);
+    TEST_CHECK(testSceneToImage);
+    TEST_CHECK(testWarmStart);
+    TEST_CHECK(testAnalyticPartials);
+    return 0;
+}
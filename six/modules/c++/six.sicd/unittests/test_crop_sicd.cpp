@@ -0,0 +1,154 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <io/TempFile.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/NITFReadControl.h>
+#include <six/sicd/CropUtils.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+typedef std::complex<sys::Int16_T> Pixel;
+
+struct TestHelper
+{
+    TestHelper() :
+        mPathname(mFile.pathname()),
+        mCropPathname(mCropFile.pathname()),
+        mDims(123, 45),
+        mImage(mDims.area())
+    {
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = Pixel(static_cast<sys::Int16_T>(ii * 7),
+                               static_cast<sys::Int16_T>(-3 * ii));
+        }
+
+        // Several image segments
+        six::Options options;
+        options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                             mDims.col * sizeof(Pixel) * 50);
+
+        writeFakeSICD(mPathname, mDims,
+                      six::PixelType::RE16I_IM16I,
+                      &mImage[0], options);
+    }
+
+    bool matches(const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& extent,
+                 const Pixel* buffer) const
+    {
+        for (size_t row = 0; row < extent.row; ++row)
+        {
+            for (size_t col = 0; col < extent.col; ++col)
+            {
+                if (buffer[row * extent.col + col] !=
+                    mImage[(offset.row + row) * mDims.col + offset.col + col])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const io::TempFile mFile;
+    const io::TempFile mCropFile;
+    const std::string mPathname;
+    const std::string mCropPathname;
+    const types::RowCol<size_t> mDims;
+    std::vector<Pixel> mImage;
+};
+
+TEST_CASE(testReadRaw)
+{
+    TestHelper helper;
+    six::NITFReadControl reader;
+    reader.load(helper.mPathname);
+    TEST_ASSERT(reader.getRecord().getNumImages() > 1);
+    TEST_ASSERT(reader.canReadRaw(0));
+
+    // Straddles the segment boundaries
+    const types::RowCol<size_t> offset(10, 3);
+    const types::RowCol<size_t> extent(100, 40);
+    for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+    {
+        reader.getOptions().setParameter(
+                six::NITFReadControl::OPT_NUM_READ_THREADS, numThreads);
+
+        std::vector<Pixel> buffer(extent.area());
+        six::Region region;
+        region.setStartRow(offset.row);
+        region.setStartCol(offset.col);
+        region.setNumRows(extent.row);
+        region.setNumCols(extent.col);
+        region.setBuffer(reinterpret_cast<six::UByte*>(&buffer[0]));
+        reader.readRaw(region, 0);
+
+        // Raw pixels are big endian
+        if (!sys::isBigEndianSystem())
+        {
+            sys::byteSwap(&buffer[0], sizeof(sys::Int16_T),
+                          buffer.size() * 2);
+        }
+        TEST_ASSERT(helper.matches(offset, extent, &buffer[0]));
+    }
+}
+
+TEST_CASE(testCrop)
+{
+    TestHelper helper;
+
+    const types::RowCol<size_t> offset(20, 5);
+    const types::RowCol<size_t> extent(90, 31);
+    six::sicd::cropSICD(helper.mPathname, std::vector<std::string>(),
+                        offset, extent, helper.mCropPathname);
+
+    six::NITFReadControl reader;
+    reader.load(helper.mCropPathname);
+    const six::Data* const data = reader.getContainer()->getData(0);
+    TEST_ASSERT_EQ(data->getNumRows(), extent.row);
+    TEST_ASSERT_EQ(data->getNumCols(), extent.col);
+    TEST_ASSERT_EQ(data->getPixelType(), six::PixelType::RE16I_IM16I);
+
+    std::vector<Pixel> buffer(extent.area());
+    six::Region region;
+    region.setBuffer(reinterpret_cast<six::UByte*>(&buffer[0]));
+    reader.interleaved(region, 0);
+    TEST_ASSERT(helper.matches(offset, extent, &buffer[0]));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testReadRaw);
+    TEST_CHECK(testCrop);
+    return 0;
+}
@@ -0,0 +1,225 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/TempFile.h>
+#include <six/NITFReadControl.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+struct TestHelper
+{
+    TestHelper() :
+        mPathname(mFile.pathname()),
+        mDims(123, 45),
+        mImage(mDims.area())
+    {
+        // Scramble the magnitudes so the max isn't always in the same
+        // corner of each window
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = std::complex<sys::Int16_T>(
+                    static_cast<sys::Int16_T>((ii * 37) % 101) - 50,
+                    static_cast<sys::Int16_T>((ii * 11) % 53) - 26);
+        }
+
+        // Force several image segments
+        six::Options options;
+        options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                             mDims.col * 4 * 50);
+
+        writeFakeSICD(mPathname, mDims,
+                      six::PixelType::RE16I_IM16I,
+                      &mImage[0], options);
+    }
+
+    const std::complex<sys::Int16_T>& getPixel(size_t row, size_t col) const
+    {
+        return mImage[row * mDims.col + col];
+    }
+
+    const io::TempFile mFile;
+    const std::string mPathname;
+    const types::RowCol<size_t> mDims;
+    std::vector<std::complex<sys::Int16_T> > mImage;
+};
+
+void read(const TestHelper& helper,
+          size_t numThreads,
+          const types::RowCol<size_t>& offset,
+          const types::RowCol<size_t>& extent,
+          const types::RowCol<size_t>& decimation,
+          six::Region::DownsampleMethod method,
+          std::vector<std::complex<float> >& buffer)
+{
+    six::NITFReadControl reader;
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_NUM_READ_THREADS, numThreads);
+    reader.load(helper.mPathname);
+    std::auto_ptr<six::sicd::ComplexData> complexData =
+            six::sicd::Utilities::getComplexData(reader);
+
+    six::Region region;
+    region.setNumRows(extent.row);
+    region.setNumCols(extent.col);
+    region.setDecimation(decimation.row, decimation.col);
+    buffer.resize(std::max<size_t>(
+            region.getNumDecimatedRows() * region.getNumDecimatedCols(), 1));
+    six::sicd::Utilities::getWidebandData(reader, *complexData, offset,
+                                          extent, decimation, method,
+                                          &buffer[0]);
+}
+
+double getMagnitude(const std::complex<sys::Int16_T>& pixel)
+{
+    const double i = pixel.real();
+    const double q = pixel.imag();
+    return i * i + q * q;
+}
+
+TEST_CASE(testPixelSkip)
+{
+    const TestHelper helper;
+
+    // Straddle segment boundaries and leave partial windows at the edges
+    const types::RowCol<size_t> offset(3, 2);
+    const types::RowCol<size_t> extent(110, 40);
+    const types::RowCol<size_t> decimation(7, 3);
+    std::vector<std::complex<float> > buffer;
+    read(helper, 1, offset, extent, decimation, six::Region::PIXEL_SKIP,
+         buffer);
+
+    const size_t numCols = (extent.col + decimation.col - 1) / decimation.col;
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        const std::complex<sys::Int16_T>& expected = helper.getPixel(
+                offset.row + (ii / numCols) * decimation.row,
+                offset.col + (ii % numCols) * decimation.col);
+        TEST_ASSERT_EQ(buffer[ii].real(), expected.real());
+        TEST_ASSERT_EQ(buffer[ii].imag(), expected.imag());
+    }
+}
+
+TEST_CASE(testMaxMagnitude)
+{
+    const TestHelper helper;
+
+    const types::RowCol<size_t> offset(3, 2);
+    const types::RowCol<size_t> extent(110, 40);
+    const types::RowCol<size_t> decimation(7, 3);
+    std::vector<std::complex<float> > buffer;
+    read(helper, 1, offset, extent, decimation, six::Region::MAX_MAGNITUDE,
+         buffer);
+
+    const size_t numCols = (extent.col + decimation.col - 1) / decimation.col;
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        const size_t startRow = offset.row + (ii / numCols) * decimation.row;
+        const size_t startCol = offset.col + (ii % numCols) * decimation.col;
+        const size_t endRow = std::min(startRow + decimation.row,
+                                       offset.row + extent.row);
+        const size_t endCol = std::min(startCol + decimation.col,
+                                       offset.col + extent.col);
+
+        double maxMagnitude = 0;
+        for (size_t row = startRow; row < endRow; ++row)
+        {
+            for (size_t col = startCol; col < endCol; ++col)
+            {
+                maxMagnitude = std::max(
+                        maxMagnitude, getMagnitude(helper.getPixel(row, col)));
+            }
+        }
+
+        const std::complex<sys::Int16_T> actual(
+                static_cast<sys::Int16_T>(buffer[ii].real()),
+                static_cast<sys::Int16_T>(buffer[ii].imag()));
+        TEST_ASSERT_EQ(getMagnitude(actual), maxMagnitude);
+    }
+}
+
+TEST_CASE(testThreaded)
+{
+    const TestHelper helper;
+
+    const types::RowCol<size_t> offset(0, 0);
+    const types::RowCol<size_t> decimation(4, 4);
+    for (size_t method = 0; method < 2; ++method)
+    {
+        const six::Region::DownsampleMethod downsampleMethod =
+                static_cast<six::Region::DownsampleMethod>(method);
+
+        std::vector<std::complex<float> > expected;
+        read(helper, 1, offset, helper.mDims, decimation, downsampleMethod,
+             expected);
+
+        std::vector<std::complex<float> > actual;
+        read(helper, 3, offset, helper.mDims, decimation, downsampleMethod,
+             actual);
+
+        TEST_ASSERT(actual == expected);
+    }
+}
+
+TEST_CASE(testNoDecimation)
+{
+    const TestHelper helper;
+
+    // Decimation factors of 1 are a regular read
+    const types::RowCol<size_t> offset(10, 5);
+    const types::RowCol<size_t> extent(60, 30);
+    std::vector<std::complex<float> > buffer;
+    read(helper, 1, offset, extent, types::RowCol<size_t>(1, 1),
+         six::Region::MAX_MAGNITUDE, buffer);
+
+    for (size_t ii = 0; ii < buffer.size(); ++ii)
+    {
+        const std::complex<sys::Int16_T>& expected = helper.getPixel(
+                offset.row + ii / extent.col, offset.col + ii % extent.col);
+        TEST_ASSERT_EQ(buffer[ii].real(), expected.real());
+        TEST_ASSERT_EQ(buffer[ii].imag(), expected.imag());
+    }
+
+    std::vector<std::complex<float> > unused;
+    TEST_EXCEPTION(read(helper, 1, offset, extent,
+                        types::RowCol<size_t>(0, 2),
+                        six::Region::PIXEL_SKIP, unused));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testPixelSkip);
+    TEST_CHECK(testMaxMagnitude);
+    TEST_CHECK(testThreaded);
+    TEST_CHECK(testNoDecimation);
+    return 0;
+}
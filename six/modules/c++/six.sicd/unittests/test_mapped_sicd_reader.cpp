@@ -0,0 +1,164 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <io/TempFile.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/sicd/MappedSICDReader.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+struct TestHelper
+{
+    TestHelper() :
+        mPathname(mFile.pathname()),
+        mDims(123, 45),
+        mImage(mDims.area())
+    {
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = std::complex<sys::Int16_T>(
+                    static_cast<sys::Int16_T>(ii),
+                    static_cast<sys::Int16_T>(-2 * ii));
+        }
+
+        // Force several image segments
+        six::Options options;
+        options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                             mDims.col * 4 * 50);
+
+        writeFakeSICD(mPathname, mDims,
+                      six::PixelType::RE16I_IM16I,
+                      &mImage[0], options);
+    }
+
+    std::complex<sys::Int16_T> getPixel(const sys::ubyte* pixel) const
+    {
+        sys::Int16_T iq[2];
+        ::memcpy(iq, pixel, sizeof(iq));
+        if (six::sicd::MappedSICDReader::needsByteSwap())
+        {
+            sys::byteSwap(iq, sizeof(sys::Int16_T), 2);
+        }
+        return std::complex<sys::Int16_T>(iq[0], iq[1]);
+    }
+
+    const io::TempFile mFile;
+    const std::string mPathname;
+    const types::RowCol<size_t> mDims;
+    std::vector<std::complex<sys::Int16_T> > mImage;
+};
+
+TEST_CASE(testSegmentViews)
+{
+    const TestHelper helper;
+    const six::sicd::MappedSICDReader reader(helper.mPathname,
+                                             std::vector<std::string>());
+    TEST_ASSERT_EQ(reader.getComplexData().getNumRows(), helper.mDims.row);
+    TEST_ASSERT(reader.getNumSegments() > 1);
+
+    size_t numRows = 0;
+    for (size_t seg = 0; seg < reader.getNumSegments(); ++seg)
+    {
+        const six::sicd::MappedSICDReader::SegmentView& view =
+                reader.getSegment(seg);
+        TEST_ASSERT_EQ(view.firstRow, numRows);
+        TEST_ASSERT_EQ(view.numCols, helper.mDims.col);
+
+        for (size_t row = 0; row < view.numRows; ++row)
+        {
+            const sys::ubyte* const rowPtr = view.getRow(row);
+            for (size_t col = 0; col < view.numCols; ++col)
+            {
+                TEST_ASSERT(helper.getPixel(
+                        rowPtr + col * view.numBytesPerPixel) ==
+                        helper.mImage[(view.firstRow + row) *
+                                helper.mDims.col + col]);
+            }
+        }
+        numRows += view.numRows;
+    }
+    TEST_ASSERT_EQ(numRows, helper.mDims.row);
+}
+
+TEST_CASE(testRandomAccess)
+{
+    const TestHelper helper;
+    const six::sicd::MappedSICDReader reader(helper.mPathname,
+                                             std::vector<std::string>());
+
+    const size_t rows[] = {0, 49, 50, 51, 99, 100, 122};
+    for (size_t ii = 0; ii < sizeof(rows) / sizeof(rows[0]); ++ii)
+    {
+        const size_t col = ii * 5;
+        TEST_ASSERT(helper.getPixel(reader.getPixel(rows[ii], col)) ==
+                    helper.mImage[rows[ii] * helper.mDims.col + col]);
+    }
+
+    TEST_EXCEPTION(reader.getRow(helper.mDims.row));
+}
+
+TEST_CASE(testWidebandData)
+{
+    const TestHelper helper;
+    const six::sicd::MappedSICDReader reader(helper.mPathname,
+                                             std::vector<std::string>());
+
+    // Straddle a segment boundary
+    const types::RowCol<size_t> offset(40, 7);
+    const types::RowCol<size_t> extent(20, 30);
+    std::vector<std::complex<float> > buffer(extent.area());
+    reader.getWidebandData(offset, extent, &buffer[0]);
+
+    for (size_t row = 0; row < extent.row; ++row)
+    {
+        for (size_t col = 0; col < extent.col; ++col)
+        {
+            const std::complex<sys::Int16_T> expected = helper.mImage[
+                    (offset.row + row) * helper.mDims.col + offset.col + col];
+            const std::complex<float>& actual =
+                    buffer[row * extent.col + col];
+            TEST_ASSERT_EQ(actual.real(), expected.real());
+            TEST_ASSERT_EQ(actual.imag(), expected.imag());
+        }
+    }
+
+    TEST_EXCEPTION(reader.getWidebandData(
+            types::RowCol<size_t>(helper.mDims.row - 1, 0),
+            types::RowCol<size_t>(2, 1),
+            &buffer[0]));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testSegmentViews);
+    TEST_CHECK(testRandomAccess);
+    TEST_CHECK(testWidebandData);
+    return 0;
+}
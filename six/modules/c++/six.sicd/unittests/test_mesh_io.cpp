@@ -0,0 +1,207 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include <complex>
+#include <string>
+#include <vector>
+
+#include <io/ByteStream.h>
+#include <io/TempFile.h>
+#include <six/NITFReadControl.h>
+#include <six/sicd/SICDMesh.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+std::vector<double> makeField(const types::RowCol<size_t>& dims,
+                              double scale)
+{
+    std::vector<double> field(dims.area());
+    for (size_t ii = 0; ii < field.size(); ++ii)
+    {
+        field[ii] = scale * static_cast<double>(ii) + 0.25;
+    }
+    return field;
+}
+
+six::sicd::NoiseMesh makeNoiseMesh(const types::RowCol<size_t>& dims)
+{
+    return six::sicd::NoiseMesh(six::sicd::SICDMeshes::NOISE_MESH_ID,
+                                dims,
+                                makeField(dims, 1.0),
+                                makeField(dims, -2.0),
+                                makeField(dims, 3.0),
+                                makeField(dims, 4.0),
+                                makeField(dims, -5.0));
+}
+
+// Checks that 'window' holds 'dims' values of 'field' starting at 'offset'
+bool windowMatches(const std::vector<double>& field,
+                   const types::RowCol<size_t>& meshDims,
+                   const types::RowCol<size_t>& offset,
+                   const types::RowCol<size_t>& dims,
+                   const std::vector<double>& window)
+{
+    if (window.size() != dims.area())
+    {
+        return false;
+    }
+
+    for (size_t row = 0; row < dims.row; ++row)
+    {
+        for (size_t col = 0; col < dims.col; ++col)
+        {
+            if (window[row * dims.col + col] !=
+                field[(offset.row + row) * meshDims.col + offset.col + col])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool windowMatches(const six::sicd::NoiseMesh& mesh,
+                   const types::RowCol<size_t>& offset,
+                   const six::sicd::NoiseMesh& window)
+{
+    const types::RowCol<size_t> meshDims = mesh.getMeshDims();
+    const types::RowCol<size_t> dims = window.getMeshDims();
+    return windowMatches(mesh.getX(), meshDims, offset, dims,
+                         window.getX()) &&
+           windowMatches(mesh.getY(), meshDims, offset, dims,
+                         window.getY()) &&
+           windowMatches(mesh.getMainBeamNoise(), meshDims, offset, dims,
+                         window.getMainBeamNoise()) &&
+           windowMatches(mesh.getAzimuthAmbiguityNoise(), meshDims, offset,
+                         dims, window.getAzimuthAmbiguityNoise()) &&
+           windowMatches(mesh.getCombinedNoise(), meshDims, offset, dims,
+                         window.getCombinedNoise());
+}
+
+TEST_CASE(testStreamMatchesBuffer)
+{
+    const types::RowCol<size_t> dims(7, 5);
+    const six::sicd::NoiseMesh mesh = makeNoiseMesh(dims);
+
+    std::vector<sys::byte> buffer;
+    mesh.serialize(buffer);
+
+    io::ByteStream stream;
+    mesh.serialize(stream);
+    TEST_ASSERT_EQ(stream.getSize(), buffer.size());
+    TEST_ASSERT(std::equal(buffer.begin(), buffer.end(),
+                           reinterpret_cast<const sys::byte*>(stream.get())));
+
+    stream.reset();
+    six::sicd::NoiseMesh streamedMesh(six::sicd::SICDMeshes::NOISE_MESH_ID);
+    streamedMesh.deserialize(stream);
+    TEST_ASSERT(streamedMesh.getMeshDims() == dims);
+    TEST_ASSERT(streamedMesh.getX() == mesh.getX());
+    TEST_ASSERT(streamedMesh.getY() == mesh.getY());
+    TEST_ASSERT(streamedMesh.getMainBeamNoise() == mesh.getMainBeamNoise());
+    TEST_ASSERT(streamedMesh.getAzimuthAmbiguityNoise() ==
+                mesh.getAzimuthAmbiguityNoise());
+    TEST_ASSERT(streamedMesh.getCombinedNoise() == mesh.getCombinedNoise());
+    TEST_ASSERT_EQ(stream.tell(), static_cast<sys::Off_T>(buffer.size()));
+
+    const sys::byte* bufferPtr = &buffer[0];
+    six::sicd::NoiseMesh bufferedMesh(six::sicd::SICDMeshes::NOISE_MESH_ID);
+    bufferedMesh.deserialize(bufferPtr);
+    TEST_ASSERT(bufferedMesh.getCombinedNoise() == mesh.getCombinedNoise());
+    TEST_ASSERT(bufferPtr == &buffer[0] + buffer.size());
+}
+
+TEST_CASE(testWindow)
+{
+    const types::RowCol<size_t> dims(7, 5);
+    const six::sicd::NoiseMesh mesh = makeNoiseMesh(dims);
+    io::ByteStream stream;
+    mesh.serialize(stream);
+
+    // An interior window, a full width one, and the whole mesh
+    const types::RowCol<size_t> offsets[] = {
+        types::RowCol<size_t>(2, 1),
+        types::RowCol<size_t>(3, 0),
+        types::RowCol<size_t>(0, 0)};
+    const types::RowCol<size_t> windowDims[] = {
+        types::RowCol<size_t>(4, 3),
+        types::RowCol<size_t>(2, 5),
+        dims};
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        stream.reset();
+        six::sicd::NoiseMesh window(six::sicd::SICDMeshes::NOISE_MESH_ID);
+        TEST_ASSERT(window.deserializeWindow(stream, offsets[ii],
+                                             windowDims[ii]) == dims);
+        TEST_ASSERT(window.getMeshDims() == windowDims[ii]);
+        TEST_ASSERT(windowMatches(mesh, offsets[ii], window));
+        TEST_ASSERT_EQ(stream.tell(),
+                       static_cast<sys::Off_T>(stream.getSize()));
+    }
+
+    stream.reset();
+    six::sicd::NoiseMesh window(six::sicd::SICDMeshes::NOISE_MESH_ID);
+    TEST_EXCEPTION(window.deserializeWindow(stream,
+                                            types::RowCol<size_t>(5, 0),
+                                            types::RowCol<size_t>(3, 1)));
+}
+
+TEST_CASE(testNITFRoundTrip)
+{
+    const io::TempFile file;
+    const types::RowCol<size_t> imageDims(16, 8);
+    const types::RowCol<size_t> meshDims(9, 6);
+    const six::sicd::NoiseMesh mesh = makeNoiseMesh(meshDims);
+
+    const std::vector<std::complex<float> > image(imageDims.area());
+    writeFakeSICD(file.pathname(), imageDims,
+                  six::PixelType::RE32F_IM32F,
+                  &image[0], six::Options(), &mesh);
+
+    six::NITFReadControl reader;
+    reader.load(file.pathname());
+
+    const std::auto_ptr<six::sicd::NoiseMesh> readMesh =
+            six::sicd::Utilities::getNoiseMesh(reader);
+    TEST_ASSERT(readMesh->getMeshDims() == meshDims);
+    TEST_ASSERT(windowMatches(mesh, types::RowCol<size_t>(0, 0), *readMesh));
+
+    const types::RowCol<size_t> offset(4, 2);
+    const std::auto_ptr<six::sicd::NoiseMesh> window =
+            six::sicd::Utilities::getNoiseMesh(reader, offset,
+                                               types::RowCol<size_t>(3, 3));
+    TEST_ASSERT(window->getMeshDims() == types::RowCol<size_t>(3, 3));
+    TEST_ASSERT(windowMatches(mesh, offset, *window));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testStreamMatchesBuffer);
+    TEST_CHECK(testWindow);
+    TEST_CHECK(testNITFRoundTrip);
+    return 0;
+}
@@ -0,0 +1,85 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <complex>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <six/sicd/PixelConversion.h>
+#include "TestCase.h"
+
+namespace
+{
+std::vector<sys::Int16_T> getValues()
+{
+    std::vector<sys::Int16_T> values;
+    for (int ii = -32768; ii < 32768; ii += 257)
+    {
+        values.push_back(static_cast<sys::Int16_T>(ii));
+    }
+    values.push_back(32767);
+    return values;
+}
+
+TEST_CASE(testPromote)
+{
+    const std::vector<sys::Int16_T> values = getValues();
+    const size_t numPixels = values.size() / 2;
+
+    std::vector<std::complex<float> > output(numPixels);
+    six::sicd::promotePixels(&values[0], numPixels, false, &output[0]);
+
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        TEST_ASSERT_EQ(output[ii].real(), values[ii * 2]);
+        TEST_ASSERT_EQ(output[ii].imag(), values[ii * 2 + 1]);
+    }
+}
+
+TEST_CASE(testSwapAndPromoteUnaligned)
+{
+    const std::vector<sys::Int16_T> values = getValues();
+    const size_t numPixels = values.size() / 2;
+
+    // Store the values swapped, one byte past an aligned address
+    std::vector<sys::ubyte> swapped(numPixels * 4 + 1);
+    sys::byteSwap(&values[0], sizeof(sys::Int16_T), numPixels * 2,
+                  &swapped[1]);
+
+    std::vector<std::complex<float> > output(numPixels);
+    six::sicd::promotePixels(&swapped[1], numPixels, true, &output[0]);
+
+    for (size_t ii = 0; ii < numPixels; ++ii)
+    {
+        TEST_ASSERT_EQ(output[ii].real(), values[ii * 2]);
+        TEST_ASSERT_EQ(output[ii].imag(), values[ii * 2 + 1]);
+    }
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testPromote);
+    TEST_CHECK(testSwapAndPromoteUnaligned);
+    return 0;
+}
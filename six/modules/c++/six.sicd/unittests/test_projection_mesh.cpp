@@ -0,0 +1,209 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <scene/ProjectionModel.h>
+#include <scene/SceneGeometry.h>
+#include <six/Serialize.h>
+#include <six/sicd/SICDMesh.h>
+#include <six/sicd/SlantPlanePixelTransformer.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+
+namespace
+{
+struct TestHelper
+{
+    explicit TestHelper(size_t numRows = 1000, size_t numCols = 800) :
+        mData(createData(numRows, numCols)),
+        mGeometry(six::sicd::Utilities::getSceneGeometry(mData.get())),
+        mModel(six::sicd::Utilities::getProjectionModel(mData.get(),
+                                                         mGeometry.get()))
+    {
+    }
+
+    static std::auto_ptr<six::sicd::ComplexData> createData(size_t numRows,
+                                                            size_t numCols)
+    {
+        std::auto_ptr<six::sicd::ComplexData> data =
+                six::sicd::Utilities::createFakeComplexData();
+        data->setNumRows(numRows);
+        data->setNumCols(numCols);
+        data->imageData->firstRow = 0;
+        data->imageData->firstCol = 0;
+        data->imageData->scpPixel = six::RowColInt(numRows / 2, numCols / 2);
+        data->grid->row->sampleSpacing = 0.5;
+        data->grid->col->sampleSpacing = 0.5;
+        return data;
+    }
+
+    const std::auto_ptr<six::sicd::ComplexData> mData;
+    const std::auto_ptr<scene::SceneGeometry> mGeometry;
+    const std::auto_ptr<scene::ProjectionModel> mModel;
+};
+
+TEST_CASE(testInterpolationError)
+{
+    const TestHelper helper;
+    const six::sicd::SlantPlanePixelTransformer exact(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+    six::sicd::SlantPlanePixelTransformer meshed(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+
+    const double maxError = 0.01;
+    mem::SharedPtr<const six::sicd::ProjectionMesh> mesh =
+            meshed.buildMesh(types::RowCol<double>(256, 256), maxError, 2);
+    TEST_ASSERT(meshed.getMesh().get() == mesh.get());
+    TEST_ASSERT(mesh->getMeshDims().row >= 2);
+    TEST_ASSERT(mesh->getMeshDims().col >= 2);
+
+    for (double row = 0; row < 1000; row += 37.3)
+    {
+        for (double col = 0; col < 800; col += 41.7)
+        {
+            const types::RowCol<double> pixel(row, col);
+            const scene::Vector3 diff =
+                    meshed.toECEF(pixel) - exact.toECEF(pixel);
+            TEST_ASSERT(diff.norm() < 10 * maxError);
+        }
+    }
+
+    // Nodes are exact
+    const types::RowCol<double> node(mesh->getSpacing().row,
+                                     2 * mesh->getSpacing().col);
+    const scene::Vector3 diff = meshed.toECEF(node) - exact.toECEF(node);
+    TEST_ASSERT_ALMOST_EQ_EPS(diff.norm(), 0.0, 1e-6);
+}
+
+TEST_CASE(testSerialization)
+{
+    const TestHelper helper;
+    six::sicd::SlantPlanePixelTransformer transformer(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+    mem::SharedPtr<const six::sicd::ProjectionMesh> mesh =
+            transformer.buildMesh(types::RowCol<double>(128, 128), 1.0);
+
+    std::vector<sys::byte> buffer;
+    mesh->serialize(buffer);
+
+    mem::SharedPtr<six::sicd::ProjectionMesh> copy(
+            new six::sicd::ProjectionMesh(
+                    six::sicd::SICDMeshes::PROJECTION_MESH_ID));
+    const sys::byte* bufferPtr = &buffer[0];
+    copy->deserialize(bufferPtr);
+    TEST_ASSERT_EQ(static_cast<size_t>(bufferPtr - &buffer[0]),
+                   buffer.size());
+
+    TEST_ASSERT_EQ(copy->getMeshDims().row, mesh->getMeshDims().row);
+    TEST_ASSERT_EQ(copy->getMeshDims().col, mesh->getMeshDims().col);
+    TEST_ASSERT_EQ(copy->getSpacing().row, mesh->getSpacing().row);
+    TEST_ASSERT_EQ(copy->getSpacing().col, mesh->getSpacing().col);
+    TEST_ASSERT(copy->getX() == mesh->getX());
+    TEST_ASSERT(copy->getY() == mesh->getY());
+    TEST_ASSERT(copy->getZ() == mesh->getZ());
+
+    // A second transformer can reuse the mesh
+    six::sicd::SlantPlanePixelTransformer reused(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+    reused.setMesh(copy);
+    const types::RowCol<double> pixel(123.4, 567.8);
+    const scene::Vector3 diff =
+            reused.toECEF(pixel) - transformer.toECEF(pixel);
+    TEST_ASSERT_EQ(diff.norm(), 0.0);
+}
+
+TEST_CASE(testBuildFailures)
+{
+    const TestHelper helper(40, 30);
+    six::sicd::SlantPlanePixelTransformer transformer(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+
+    // Too many nodes to get there
+    TEST_EXCEPTION(transformer.buildMesh(types::RowCol<double>(16, 16),
+                                         1e-9, 1, 20));
+
+    // Never good enough, even at a pixel apart
+    TEST_EXCEPTION(transformer.buildMesh(types::RowCol<double>(16, 16),
+                                         -1.0));
+    TEST_ASSERT(transformer.getMesh().get() == NULL);
+}
+
+TEST_CASE(testValidation)
+{
+    const std::string name(six::sicd::SICDMeshes::PROJECTION_MESH_ID);
+    const std::vector<double> coords(6);
+    TEST_EXCEPTION(six::sicd::ProjectionMesh(
+            name, types::RowCol<size_t>(1, 6),
+            types::RowCol<double>(1, 1), coords, coords, coords));
+    TEST_EXCEPTION(six::sicd::ProjectionMesh(
+            name, types::RowCol<size_t>(2, 3),
+            types::RowCol<double>(0, 1), coords, coords, coords));
+    TEST_EXCEPTION(six::sicd::ProjectionMesh(
+            name, types::RowCol<size_t>(2, 4),
+            types::RowCol<double>(1, 1), coords, coords, coords));
+
+    // Dimensions that don't match the coordinates
+    const bool swap = !sys::isBigEndianSystem();
+    std::vector<sys::byte> buffer;
+    six::serialize(static_cast<size_t>(3), swap, buffer);
+    six::serialize(static_cast<size_t>(3), swap, buffer);
+    six::serialize(1.0, swap, buffer);
+    six::serialize(1.0, swap, buffer);
+    six::serialize(coords, swap, buffer);
+    six::serialize(coords, swap, buffer);
+    six::serialize(coords, swap, buffer);
+    six::sicd::ProjectionMesh mesh(name);
+    const sys::byte* bufferPtr = &buffer[0];
+    TEST_EXCEPTION(mesh.deserialize(bufferPtr));
+
+    const TestHelper helper;
+    six::sicd::SlantPlanePixelTransformer transformer(
+            *helper.mData, *helper.mGeometry, *helper.mModel);
+    TEST_EXCEPTION(transformer.setMesh(
+            mem::SharedPtr<const six::sicd::ProjectionMesh>(
+                    new six::sicd::ProjectionMesh(name))));
+
+    // A mesh for a smaller image doesn't reach the far edges of this one
+    const TestHelper smallHelper(500, 800);
+    six::sicd::SlantPlanePixelTransformer smallTransformer(
+            *smallHelper.mData, *smallHelper.mGeometry, *smallHelper.mModel);
+    TEST_EXCEPTION(transformer.setMesh(smallTransformer.buildMesh(
+            types::RowCol<double>(128, 128), 1.0)));
+    TEST_ASSERT(transformer.getMesh().get() == NULL);
+
+    transformer.setMesh(mem::SharedPtr<const six::sicd::ProjectionMesh>());
+    TEST_ASSERT(transformer.getMesh().get() == NULL);
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testInterpolationError);
+    TEST_CHECK(testSerialization);
+    TEST_CHECK(testBuildFailures);
+    TEST_CHECK(testValidation);
+    return 0;
+}
@@ -0,0 +1,111 @@
+/* =========================================================================
+ * This file is part of six.sicd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sicd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <complex>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/TempFile.h>
+#include <six/NITFReadControl.h>
+#include <six/ReadControlFactory.h>
+#include <six/sicd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+struct TestHelper
+{
+    TestHelper() :
+        mSicdPathname(mSicdFile.pathname()),
+        mOtherPathname(mOtherFile.pathname())
+    {
+        const types::RowCol<size_t> dims(30, 20);
+        const std::vector<std::complex<float> > image(dims.area());
+        writeFakeSICD(mSicdPathname, dims,
+                      six::PixelType::RE32F_IM32F,
+                      &image[0]);
+
+        std::ofstream other(mOtherPathname.c_str());
+        other << std::string(1024, 'x');
+    }
+
+    const io::TempFile mSicdFile;
+    const io::TempFile mOtherFile;
+    const std::string mSicdPathname;
+    const std::string mOtherPathname;
+};
+
+TEST_CASE(testSniff)
+{
+    const TestHelper helper;
+    TEST_ASSERT_EQ(six::NITFReadControl::sniffDataType(helper.mSicdPathname),
+                   six::DataType::COMPLEX);
+    TEST_ASSERT_EQ(six::NITFReadControl::sniffDataType(helper.mOtherPathname),
+                   six::DataType::NOT_SET);
+    TEST_ASSERT_EQ(six::NITFReadControl::sniffDataType("does_not_exist.nitf"),
+                   six::DataType::NOT_SET);
+
+    // Agrees with a full parse
+    six::NITFReadControl reader;
+    TEST_ASSERT_EQ(reader.identify(helper.mSicdPathname),
+                   six::DataType::COMPLEX);
+    nitf::Record record = reader.getRecord();
+    TEST_ASSERT_EQ(six::NITFReadControl::getDataType(record),
+                   six::DataType::COMPLEX);
+
+    const six::NITFReadControlCreator creator;
+    TEST_ASSERT(creator.supports(helper.mSicdPathname));
+    TEST_ASSERT(!creator.supports(helper.mOtherPathname));
+}
+
+TEST_CASE(testFactoryLoad)
+{
+    const TestHelper helper;
+    six::ReadControlRegistry registry;
+    registry.addCreator(new six::NITFReadControlCreator());
+
+    std::auto_ptr<six::ReadControl> reader(
+            registry.newReadControl(helper.mSicdPathname));
+    reader->load(helper.mSicdPathname);
+    TEST_ASSERT_EQ(reader->getContainer()->getNumData(),
+                   static_cast<size_t>(1));
+    TEST_ASSERT_EQ(reader->getContainer()->getData(0)->getNumRows(),
+                   static_cast<size_t>(30));
+
+    // Loading a second time has to parse the file again
+    reader->load(helper.mSicdPathname);
+    TEST_ASSERT_EQ(reader->getContainer()->getNumData(),
+                   static_cast<size_t>(1));
+
+    TEST_EXCEPTION(registry.newReadControl(helper.mOtherPathname));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testSniff);
+    TEST_CHECK(testFactoryLoad);
+    return 0;
+}
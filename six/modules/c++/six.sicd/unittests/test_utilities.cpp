@@ -20,8 +20,49 @@
 *
 */
 
+#include <io/TempFile.h>
+#include <mt/CriticalSection.h>
 #include <import/six/sicd.h>
 #include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+// Sums every pixel it's handed and remembers where each block was so we
+// can tell each row was seen exactly once
+class SummingProcessor : public six::sicd::WidebandBlockProcessor
+{
+public:
+    SummingProcessor() :
+        mNumPixels(0),
+        mSum(0.0)
+    {
+    }
+
+    virtual void operator()(const types::RowCol<size_t>& offset,
+                            const types::RowCol<size_t>& extent,
+                            std::complex<float>* block)
+    {
+        double sum(0.0);
+        for (size_t ii = 0; ii < extent.area(); ++ii)
+        {
+            sum += block[ii].real();
+        }
+
+        mt::CriticalSection<sys::Mutex> crit(&mMutex);
+        mNumPixels += extent.area();
+        mSum += sum;
+        mOffsets.push_back(offset);
+        mExtents.push_back(extent);
+    }
+
+    sys::Mutex mMutex;
+    size_t mNumPixels;
+    double mSum;
+    std::vector<types::RowCol<size_t> > mOffsets;
+    std::vector<types::RowCol<size_t> > mExtents;
+};
+}
 
 TEST_CASE(testClockwiseBox)
 {
@@ -45,10 +86,85 @@ TEST_CASE(testCounterClockwiseTriangle)
     TEST_ASSERT(six::sicd::Utilities::isClockwise(vertices));
 }
 
+TEST_CASE(testPipelinedWidebandData)
+{
+    const io::TempFile file;
+    const types::RowCol<size_t> dims(97, 31);
+    std::vector<std::complex<sys::Int16_T> > image(dims.area());
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = std::complex<sys::Int16_T>(
+                static_cast<sys::Int16_T>(ii),
+                static_cast<sys::Int16_T>(-static_cast<int>(ii)));
+    }
+
+    writeFakeSICD(file.pathname(), dims,
+                  six::PixelType::RE16I_IM16I,
+                  &image[0]);
+
+    six::NITFReadControl reader;
+    reader.load(file.pathname());
+    const std::auto_ptr<six::sicd::ComplexData> complexData =
+            six::sicd::Utilities::getComplexData(reader);
+
+    // 13 swaths, the last of which is short, so both scratch buffers are
+    // reused several times
+    const types::RowCol<size_t> offset(3, 5);
+    const types::RowCol<size_t> extent(90, 20);
+    const size_t numRowsPerSwath = 7;
+    std::vector<std::complex<float> > buffer(extent.area());
+    SummingProcessor processor;
+    six::sicd::Utilities::getWidebandData(reader, *complexData, offset, extent,
+                                          3, &buffer[0], &processor,
+                                          numRowsPerSwath);
+
+    // Every pixel, including the rows on either side of each swath
+    // boundary
+    double expectedSum(0.0);
+    for (size_t row = 0; row < extent.row; ++row)
+    {
+        for (size_t col = 0; col < extent.col; ++col)
+        {
+            const std::complex<sys::Int16_T>& expected = image[
+                    (offset.row + row) * dims.col + offset.col + col];
+            const std::complex<float>& actual = buffer[row * extent.col + col];
+            TEST_ASSERT_EQ(actual.real(), expected.real());
+            TEST_ASSERT_EQ(actual.imag(), expected.imag());
+            expectedSum += expected.real();
+        }
+    }
+    TEST_ASSERT_EQ(processor.mNumPixels, extent.area());
+    TEST_ASSERT_EQ(processor.mSum, expectedSum);
+
+    // Each row went to the processor once, in a block within one swath
+    std::vector<size_t> timesProcessed(extent.row, 0);
+    for (size_t ii = 0; ii < processor.mOffsets.size(); ++ii)
+    {
+        const types::RowCol<size_t>& blockOffset = processor.mOffsets[ii];
+        const types::RowCol<size_t>& blockExtent = processor.mExtents[ii];
+        TEST_ASSERT_EQ(blockOffset.col, offset.col);
+        TEST_ASSERT_EQ(blockExtent.col, extent.col);
+        TEST_ASSERT(blockExtent.row > 0);
+
+        const size_t firstRow = blockOffset.row - offset.row;
+        const size_t lastRow = firstRow + blockExtent.row - 1;
+        TEST_ASSERT_EQ(firstRow / numRowsPerSwath, lastRow / numRowsPerSwath);
+        for (size_t row = firstRow; row <= lastRow; ++row)
+        {
+            ++timesProcessed[row];
+        }
+    }
+    for (size_t row = 0; row < extent.row; ++row)
+    {
+        TEST_ASSERT_EQ(timesProcessed[row], 1);
+    }
+}
+
 int main(int, char**)
 {
     TEST_CHECK(testClockwiseBox);
     TEST_CHECK(testCounterClockwiseTriangle);
+    TEST_CHECK(testPipelinedWidebandData);
     return 0;
 }
 
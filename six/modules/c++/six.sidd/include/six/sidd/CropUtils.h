@@ -39,6 +39,11 @@ namespace sidd
  * TODO: The SIDD standard supports more complicated chipping than this -
  * you can translate, rotate, and/or scale.
  *
+ * Each image's AOI is streamed from the input to the output a chunk of rows
+ * at a time, read with a thread per CPU, so it's never all in memory at
+ * once.  If every image is uncompressed and unblocked, pixels are copied as
+ * they're stored without being byte swapped.
+ *
  * \param inPathname Input SIDD pathname
  * \param schemaPaths Schema paths to use for reading and writing
  * \param aoiOffset Upper left corner of AOI
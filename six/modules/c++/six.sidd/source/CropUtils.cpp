@@ -23,9 +23,11 @@
 #include <memory>
 
 #include <sys/Conf.h>
+#include <sys/OS.h>
 #include <except/Exception.h>
-#include <mem/ScopedArray.h>
+#include <mem/SharedPtr.h>
 #include <six/NITFReadControl.h>
+#include <six/NITFRegionInputStream.h>
 #include <six/NITFWriteControl.h>
 #include <six/sidd/Utilities.h>
 #include <six/sidd/CropUtils.h>
@@ -33,37 +35,6 @@
 
 namespace
 {
-class Buffers
-{
-public:
-    Buffers()
-    {
-    }
-
-    ~Buffers()
-    {
-        for (size_t ii = 0; ii < mBuffers.size(); ++ii)
-        {
-            delete[] mBuffers[ii];
-        }
-    }
-
-    sys::ubyte* add(size_t numBytes)
-    {
-        mem::ScopedArray<sys::ubyte> buffer(new sys::ubyte[numBytes]);
-        mBuffers.push_back(buffer.get());
-        return buffer.release();
-    }
-
-    std::vector<sys::ubyte*> get() const
-    {
-        return mBuffers;
-    }
-
-private:
-    std::vector<sys::ubyte*> mBuffers;
-};
-
 class ChipCoordinateToFullImageCoordinate
 {
 public:
@@ -138,15 +109,36 @@ void cropSIDD(const std::string& inPathname,
 {
     // Make sure it's a SIDD
     six::NITFReadControl reader;
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_NUM_READ_THREADS,
+            six::Parameter(sys::OS().getNumCPUs()));
     reader.load(inPathname, schemaPaths);
-    mem::SharedPtr<six::Container> container(reader.getContainer());
+
+    // The AOI's metadata is updated in a copy, since the pixels are read
+    // through the reader as the output is written
+    mem::SharedPtr<six::Container> container(
+            new six::Container(*reader.getContainer()));
 
     if (container->getDataType() != six::DataType::DERIVED)
     {
         throw except::Exception(Ctxt(inPathname + " is not a SIDD"));
     }
 
-    Buffers buffers;
+    // Byte swapping is on or off for the whole output, so pixels are only
+    // copied as they're stored if every image can be read that way
+    bool raw = true;
+    for (size_t ii = 0, imageNum = 0; ii < container->getNumData(); ++ii)
+    {
+        if (container->getData(ii)->getDataType() == six::DataType::DERIVED)
+        {
+            raw = raw && reader.canReadRaw(imageNum++);
+        }
+    }
+
+    // Each image's AOI is streamed from the input to the output a chunk of
+    // rows at a time
+    std::vector<mem::SharedPtr<six::NITFRegionInputStream> > streams;
+    six::SourceList sources;
     for (size_t ii = 0, imageNum = 0; ii < container->getNumData(); ++ii)
     {
         six::Data* const dataPtr = container->getData(ii);
@@ -170,19 +162,11 @@ void cropSIDD(const std::string& inPathname,
                 throw except::Exception(Ctxt("AOI must be non-empty"));
             }
 
-            // Read in the AOI
-            const size_t numBytesPerPixel(data->getNumBytesPerPixel());
-            const size_t numBytes =
-                    origDims.row * origDims.col * numBytesPerPixel;
-            sys::ubyte* const buffer = buffers.add(numBytes);
-
-            six::Region region;
-            region.setStartRow(aoiOffset.row);
-            region.setStartCol(aoiOffset.col);
-            region.setNumRows(aoiDims.row);
-            region.setNumCols(aoiDims.col);
-            region.setBuffer(buffer);
-            reader.interleaved(region, imageNum++);
+            streams.push_back(mem::SharedPtr<six::NITFRegionInputStream>(
+                    new six::NITFRegionInputStream(
+                            reader, imageNum++, aoiOffset, aoiDims,
+                            data->getNumBytesPerPixel(), raw)));
+            sources.push_back(streams.back().get());
 
             // Update to reflect the AOI in the SIX metadata
             // Construct the pixel --> lat/lon functor first so updating this
@@ -237,8 +221,15 @@ void cropSIDD(const std::string& inPathname,
     }
 
     // Write the AOI SIDD out
-    six::NITFWriteControl writer(container);
-    writer.save(buffers.get(), outPathname, schemaPaths);
+    six::Options options;
+    if (raw)
+    {
+        options.setParameter(six::WriteControl::OPT_BYTE_SWAP,
+                             six::Parameter(static_cast<int>(
+                                     six::ByteSwapping::SWAP_OFF)));
+    }
+    six::NITFWriteControl writer(options, container);
+    writer.save(sources, outPathname, schemaPaths);
 }
 }
 }
@@ -205,6 +205,12 @@ six::UByte* six::sidd::GeoTIFFReadControl::interleaved(six::Region& region,
                 "Invalid index: " + str::toString(imIndex)));
     }
 
+    if (region.isDecimated())
+    {
+        throw except::Exception(Ctxt(
+                "Decimated reads are not supported for GeoTIFF"));
+    }
+
     tiff::ImageReader *imReader = mReader[imIndex];
     tiff::IFD *ifd = imReader->getIFD();
 
@@ -0,0 +1,77 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_SIDD_TEST_UTILITIES_H__
+#define __SIX_SIDD_TEST_UTILITIES_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <mem/SharedPtr.h>
+#include <types/RowCol.h>
+#include <six/Container.h>
+#include <six/NITFWriteControl.h>
+#include <six/Options.h>
+#include <six/XMLControlFactory.h>
+#include <six/sidd/DerivedXMLControl.h>
+#include <six/sidd/Utilities.h>
+
+/*!
+ * Write a SIDD created by createFakeDerivedData() to a NITF.  The
+ * DerivedXMLControl is registered with the XMLControlFactory so that the
+ * test can read the SIDD back.
+ *
+ * \param pathname Pathname of the NITF to write
+ * \param dims Number of rows and columns of the image
+ * \param pixelType Pixel type of the image
+ * \param image dims.area() pixels in native byte order
+ * \param options Writer options (e.g. to force several image segments
+ * or blocking)
+ */
+inline
+void writeFakeSIDD(const std::string& pathname,
+                   const types::RowCol<size_t>& dims,
+                   six::PixelType pixelType,
+                   const void* image,
+                   const six::Options& options = six::Options())
+{
+    six::XMLControlFactory::getInstance().addCreator(
+            six::DataType::DERIVED,
+            new six::XMLControlCreatorT<six::sidd::DerivedXMLControl>());
+
+    std::auto_ptr<six::sidd::DerivedData> data =
+            six::sidd::Utilities::createFakeDerivedData();
+    data->setNumRows(dims.row);
+    data->setNumCols(dims.col);
+    data->setPixelType(pixelType);
+
+    mem::SharedPtr<six::Container> container(
+            new six::Container(six::DataType::DERIVED));
+    container->addData(data.release());
+
+    six::NITFWriteControl writer(options, container);
+    six::BufferList buffers;
+    buffers.push_back(static_cast<const six::UByte*>(image));
+    writer.save(buffers, pathname, std::vector<std::string>());
+}
+
+#endif
@@ -0,0 +1,251 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <io/TempFile.h>
+#include <six/NITFBlockCache.h>
+#include <six/NITFReadControl.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/sidd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+typedef sys::ubyte Pixel;
+
+mem::SharedPtr<const six::NITFBlockCache::Block> makeBlock(size_t size)
+{
+    return mem::SharedPtr<const six::NITFBlockCache::Block>(
+            new six::NITFBlockCache::Block(size));
+}
+
+struct TestHelper
+{
+    TestHelper(size_t step = 7) :
+        mPathname(mFile.pathname()),
+        mDims(123, 45),
+        mImage(mDims.area())
+    {
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = static_cast<Pixel>((ii * step) % 251);
+        }
+
+        // Several image segments, with partial blocks on the bottom and
+        // right
+        six::Options options;
+        options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                             mDims.col * 50);
+        options.setParameter(six::NITFHeaderCreator::OPT_NUM_ROWS_PER_BLOCK,
+                             16);
+        options.setParameter(six::NITFHeaderCreator::OPT_NUM_COLS_PER_BLOCK,
+                             16);
+
+        writeFakeSIDD(mPathname, mDims,
+                      six::PixelType::MONO8I,
+                      &mImage[0], options);
+    }
+
+    bool matches(const types::RowCol<size_t>& offset,
+                 const types::RowCol<size_t>& extent,
+                 const std::vector<Pixel>& buffer) const
+    {
+        for (size_t row = 0; row < extent.row; ++row)
+        {
+            for (size_t col = 0; col < extent.col; ++col)
+            {
+                if (buffer[row * extent.col + col] !=
+                    mImage[(offset.row + row) * mDims.col + offset.col + col])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const io::TempFile mFile;
+    const std::string mPathname;
+    const types::RowCol<size_t> mDims;
+    std::vector<Pixel> mImage;
+};
+
+void read(six::NITFReadControl& reader,
+          const types::RowCol<size_t>& offset,
+          const types::RowCol<size_t>& extent,
+          std::vector<Pixel>& buffer)
+{
+    buffer.resize(extent.area());
+
+    six::Region region;
+    region.setStartRow(offset.row);
+    region.setStartCol(offset.col);
+    region.setNumRows(extent.row);
+    region.setNumCols(extent.col);
+    region.setBuffer(reinterpret_cast<six::UByte*>(&buffer[0]));
+    reader.interleaved(region, 0);
+}
+
+TEST_CASE(testEviction)
+{
+    six::NITFBlockCache cache(100);
+    const six::NITFBlockCache::Key key0(0, 0, 0);
+    const six::NITFBlockCache::Key key1(0, 0, 1);
+    const six::NITFBlockCache::Key key2(1, 0, 0);
+
+    cache.put(key0, makeBlock(40));
+    cache.put(key1, makeBlock(40));
+    TEST_ASSERT_EQ(cache.getNumBlocks(), static_cast<size_t>(2));
+    TEST_ASSERT_EQ(cache.getSize(), static_cast<size_t>(80));
+
+    // Using key0 makes key1 the one to go
+    TEST_ASSERT(cache.get(key0).get() != NULL);
+    cache.put(key2, makeBlock(40));
+    TEST_ASSERT(cache.get(key0).get() != NULL);
+    TEST_ASSERT(cache.get(key1).get() == NULL);
+    TEST_ASSERT(cache.get(key2).get() != NULL);
+    TEST_ASSERT_EQ(cache.getSize(), static_cast<size_t>(80));
+
+    // Replacing a block doesn't count it twice
+    cache.put(key2, makeBlock(10));
+    TEST_ASSERT_EQ(cache.getSize(), static_cast<size_t>(50));
+
+    // Blocks that can never fit aren't held
+    cache.put(key1, makeBlock(101));
+    TEST_ASSERT(cache.get(key1).get() == NULL);
+    TEST_ASSERT_EQ(cache.getNumBlocks(), static_cast<size_t>(2));
+
+    // key0 was used less recently than key2
+    cache.setCapacity(20);
+    TEST_ASSERT(cache.get(key0).get() == NULL);
+    TEST_ASSERT(cache.get(key2).get() != NULL);
+    TEST_ASSERT_EQ(cache.getSize(), static_cast<size_t>(10));
+
+    cache.clear();
+    TEST_ASSERT_EQ(cache.getNumBlocks(), static_cast<size_t>(0));
+    TEST_ASSERT_EQ(cache.getSize(), static_cast<size_t>(0));
+}
+
+TEST_CASE(testCachedRead)
+{
+    const TestHelper helper;
+
+    // Straddle segment and block boundaries
+    const types::RowCol<size_t> offsets[] = {
+        types::RowCol<size_t>(3, 2),
+        types::RowCol<size_t>(40, 17),
+        types::RowCol<size_t>(0, 0),
+        types::RowCol<size_t>(100, 40)};
+    const types::RowCol<size_t> extents[] = {
+        types::RowCol<size_t>(110, 40),
+        types::RowCol<size_t>(20, 10),
+        helper.mDims,
+        types::RowCol<size_t>(23, 5)};
+
+    for (size_t numThreads = 1; numThreads <= 3; numThreads += 2)
+    {
+        six::NITFReadControl reader;
+        reader.getOptions().setParameter(
+                six::NITFReadControl::OPT_NUM_READ_THREADS, numThreads);
+        reader.getOptions().setParameter(
+                six::NITFReadControl::OPT_BLOCK_CACHE_SIZE, 1024 * 1024);
+        reader.load(helper.mPathname);
+
+        std::vector<Pixel> buffer;
+        for (size_t ii = 0; ii < 4; ++ii)
+        {
+            read(reader, offsets[ii], extents[ii], buffer);
+            TEST_ASSERT(helper.matches(offsets[ii], extents[ii], buffer));
+        }
+
+        // Reading the whole image cached every block (the segments are
+        // rounded to whole blocks, so 4 segments of 2 by 3 blocks)
+        const six::NITFBlockCache* const cache = reader.getBlockCache();
+        TEST_ASSERT(cache != NULL);
+        TEST_ASSERT_EQ(cache->getSize(),
+                       helper.mDims.area() * sizeof(Pixel));
+        TEST_ASSERT_EQ(cache->getNumBlocks(), static_cast<size_t>(24));
+    }
+}
+
+TEST_CASE(testReload)
+{
+    // The threads' Readers belong to the file that was loaded, so reading
+    // after loading another file has to read the new one
+    const TestHelper first;
+    const TestHelper second(13);
+
+    six::NITFReadControl reader;
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_NUM_READ_THREADS, 3);
+
+    std::vector<Pixel> buffer;
+    reader.load(first.mPathname);
+    read(reader, types::RowCol<size_t>(0, 0), first.mDims, buffer);
+    TEST_ASSERT(first.matches(types::RowCol<size_t>(0, 0), first.mDims,
+                              buffer));
+
+    reader.load(second.mPathname);
+    read(reader, types::RowCol<size_t>(0, 0), second.mDims, buffer);
+    TEST_ASSERT(second.matches(types::RowCol<size_t>(0, 0), second.mDims,
+                               buffer));
+}
+
+TEST_CASE(testSmallCache)
+{
+    const TestHelper helper;
+
+    // Room for only a couple of blocks at a time
+    six::NITFReadControl reader;
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_BLOCK_CACHE_SIZE, 16 * 16 * 2);
+    reader.load(helper.mPathname);
+
+    std::vector<Pixel> buffer;
+    read(reader, types::RowCol<size_t>(0, 0), helper.mDims, buffer);
+    TEST_ASSERT(helper.matches(types::RowCol<size_t>(0, 0), helper.mDims,
+                               buffer));
+    TEST_ASSERT(reader.getBlockCache()->getSize() <= 16 * 16 * 2);
+
+    // Turning the cache off drops it
+    reader.getOptions().setParameter(
+            six::NITFReadControl::OPT_BLOCK_CACHE_SIZE, 0);
+    read(reader, types::RowCol<size_t>(10, 10),
+         types::RowCol<size_t>(5, 5), buffer);
+    TEST_ASSERT(reader.getBlockCache() == NULL);
+    TEST_ASSERT(helper.matches(types::RowCol<size_t>(10, 10),
+                               types::RowCol<size_t>(5, 5), buffer));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testEviction);
+    TEST_CHECK(testCachedRead);
+    TEST_CHECK(testReload);
+    TEST_CHECK(testSmallCache);
+    return 0;
+}
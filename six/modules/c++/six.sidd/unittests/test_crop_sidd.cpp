@@ -0,0 +1,145 @@
+/* =========================================================================
+ * This file is part of six.sidd-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six.sidd-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <io/TempFile.h>
+#include <six/NITFHeaderCreator.h>
+#include <six/NITFReadControl.h>
+#include <six/sidd/CropUtils.h>
+#include <six/sidd/Utilities.h>
+#include "TestCase.h"
+#include "TestUtilities.h"
+
+namespace
+{
+typedef sys::Uint16_T Pixel;
+
+struct TestHelper
+{
+    // Several image segments, blocked or not
+    TestHelper(bool blocked) :
+        mPathname(mFile.pathname()),
+        mCropPathname(mCropFile.pathname()),
+        mDims(123, 45),
+        mImage(mDims.area())
+    {
+        for (size_t ii = 0; ii < mImage.size(); ++ii)
+        {
+            mImage[ii] = static_cast<Pixel>(ii * 263);
+        }
+
+        six::Options options;
+        options.setParameter(six::NITFHeaderCreator::OPT_MAX_PRODUCT_SIZE,
+                             mDims.col * sizeof(Pixel) * 50);
+        if (blocked)
+        {
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_NUM_ROWS_PER_BLOCK, 16);
+            options.setParameter(
+                    six::NITFHeaderCreator::OPT_NUM_COLS_PER_BLOCK, 16);
+        }
+
+        writeFakeSIDD(mPathname, mDims,
+                      six::PixelType::MONO16I,
+                      &mImage[0], options);
+    }
+
+    // Crops the SIDD and checks the pixels of the cropped one
+    bool cropMatches(const types::RowCol<size_t>& offset,
+                     const types::RowCol<size_t>& extent) const
+    {
+        six::sidd::cropSIDD(mPathname, std::vector<std::string>(),
+                            offset, extent, mCropPathname);
+
+        six::NITFReadControl reader;
+        reader.load(mCropPathname);
+        const six::Data* const data = reader.getContainer()->getData(0);
+        if (data->getNumRows() != extent.row ||
+            data->getNumCols() != extent.col)
+        {
+            return false;
+        }
+
+        std::vector<Pixel> buffer(extent.area());
+        six::Region region;
+        region.setBuffer(reinterpret_cast<six::UByte*>(&buffer[0]));
+        reader.interleaved(region, 0);
+
+        for (size_t row = 0; row < extent.row; ++row)
+        {
+            for (size_t col = 0; col < extent.col; ++col)
+            {
+                if (buffer[row * extent.col + col] !=
+                    mImage[(offset.row + row) * mDims.col + offset.col + col])
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const io::TempFile mFile;
+    const io::TempFile mCropFile;
+    const std::string mPathname;
+    const std::string mCropPathname;
+    const types::RowCol<size_t> mDims;
+    std::vector<Pixel> mImage;
+};
+
+TEST_CASE(testCropRaw)
+{
+    const TestHelper helper(false);
+    {
+        six::NITFReadControl reader;
+        reader.load(helper.mPathname);
+        TEST_ASSERT(reader.getRecord().getNumImages() > 1);
+        TEST_ASSERT(reader.canReadRaw(0));
+    }
+
+    TEST_ASSERT(helper.cropMatches(types::RowCol<size_t>(30, 4),
+                                   types::RowCol<size_t>(80, 33)));
+}
+
+TEST_CASE(testCropBlocked)
+{
+    const TestHelper helper(true);
+    {
+        six::NITFReadControl reader;
+        reader.load(helper.mPathname);
+        TEST_ASSERT(!reader.canReadRaw(0));
+    }
+
+    TEST_ASSERT(helper.cropMatches(types::RowCol<size_t>(30, 4),
+                                   types::RowCol<size_t>(80, 33)));
+}
+}
+
+int main(int, char**)
+{
+    TEST_CHECK(testCropRaw);
+    TEST_CHECK(testCropBlocked);
+    return 0;
+}
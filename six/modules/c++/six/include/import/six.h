@@ -30,6 +30,7 @@
 #include "six/Mesh.h"
 #include "six/NITFImageInfo.h"
 #include "six/NITFImageInputStream.h"
+#include "six/NITFRegionInputStream.h"
 #include "six/NITFSegmentInfo.h"
 #include "six/NITFReadControl.h"
 #include "six/NITFWriteControl.h"
@@ -26,6 +26,7 @@
 #include <import/nitf.hpp>
 #include <import/sys.h>
 #include "six/Types.h"
+#include "six/Mesh.h"
 #include "six/NITFSegmentInfo.h"
 #include "six/Utilities.h"
 
@@ -45,9 +46,11 @@ namespace six
  *
  *  NITRO use a nitf::SegmentReader to get the data out of the DES.  This
  *  class adapts this object so that it can be used by xml.lite's parser.
+ *  It's seekable so that parts of a DES (e.g. a window of a mesh) can be
+ *  read without reading the rest.
  *
  */
-class SegmentInputStreamAdapter: public ::io::InputStream
+class SegmentInputStreamAdapter: public ::io::SeekableInputStream
 {
 
     nitf::SegmentReader& mReader;
@@ -77,6 +80,30 @@ public:
         return (sys::Off_T) mReader.getSize();
     }
 
+    //! Seek to an offset from the start, current position, or end of the DES
+    virtual sys::Off_T seek(sys::Off_T offset, Whence whence)
+    {
+        int nitfWhence = NITF_SEEK_SET;
+        switch (whence)
+        {
+        case CURRENT:
+            nitfWhence = NITF_SEEK_CUR;
+            break;
+        case END:
+            nitfWhence = NITF_SEEK_END;
+            break;
+        default:
+            break;
+        }
+        return (sys::Off_T) mReader.seek(offset, nitfWhence);
+    }
+
+    //! \return The current offset into the DES
+    virtual sys::Off_T tell()
+    {
+        return (sys::Off_T) mReader.tell();
+    }
+
 protected:
     /*!
      *  Read len bytes from the DES.  Returns the number of 
@@ -94,8 +121,11 @@ protected:
  *  \class MemoryWriteHandler
  *  \brief Overloaded NITF write handler from memory buffer
  *
- *  This is used to write an image buffer from memory.  Each row is read
- *  one at a time and transferred into the write handle.  It makes use
+ *  This is used to write an image buffer from memory.  If no byte swapping
+ *  is needed, the segment is written straight out of the buffer in one
+ *  write.  Otherwise, rows are swapped a multi-row chunk at a time into a
+ *  reusable buffer, swapping the next chunk while the current one is
+ *  written.  It makes use
  *  of NITRO's low-level WriteHandler API, which assumes that you will handle
  *  the heavy lifting.  This is not typically used, since the ImageWriter
  *  is more general, but in the case of pixel interleaved data, the 
@@ -130,8 +160,9 @@ public:
  *  \class StreamWriteHandler
  *  \brief Derived implementation for nitf::WriteHandler
  *
- *  This is used to write an image buffer from a file source.  Each row is read
- *  one at a time and transferred into the write handle.
+ *  This is used to write an image buffer from a file source.  Rows are read
+ *  (and swapped if need be) a multi-row chunk at a time, with the next chunk
+ *  read while the current one is written.
  *
  *  This class can handle both SIDD and SICD data.  In the current state
  *  of SIDD, data is always 1 or 3 channels and the size of the channel
@@ -153,6 +184,21 @@ public:
                        bool doByteSwap);
 };
 
+/*!
+ *  \class MeshWriteHandler
+ *  \brief Writes a mesh to a DES
+ *
+ *  The mesh is serialized straight into the file via
+ *  Mesh::serialize(io::OutputStream&) rather than first being serialized
+ *  into memory and then copied into a nitf::SegmentMemorySource.  The mesh
+ *  isn't copied, so it must outlive the write.
+ */
+class MeshWriteHandler: public nitf::SegmentWriter
+{
+public:
+    MeshWriteHandler(const Mesh& mesh);
+};
+
 }
 
 #endif
@@ -0,0 +1,111 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_BYTE_SWAP_H__
+#define __SIX_BYTE_SWAP_H__
+
+#include <string.h>
+
+#include <sys/Conf.h>
+
+namespace six
+{
+namespace detail
+{
+inline sys::Uint16_T swapBytes(sys::Uint16_T val)
+{
+    return static_cast<sys::Uint16_T>((val >> 8) | (val << 8));
+}
+
+inline sys::Uint32_T swapBytes(sys::Uint32_T val)
+{
+    return ((val & 0x000000FF) << 24) |
+           ((val & 0x0000FF00) << 8) |
+           ((val & 0x00FF0000) >> 8) |
+           ((val & 0xFF000000) >> 24);
+}
+
+inline sys::Uint64_T swapBytes(sys::Uint64_T val)
+{
+    const sys::Uint64_T low = swapBytes(static_cast<sys::Uint32_T>(val));
+    const sys::Uint64_T high =
+            swapBytes(static_cast<sys::Uint32_T>(val >> 32));
+    return (low << 32) | high;
+}
+
+// Simple enough loop that the compiler vectorizes it
+template <typename T>
+void byteSwap(const sys::byte* input, size_t numElems, sys::byte* output)
+{
+    for (size_t ii = 0;
+         ii < numElems;
+         ++ii, input += sizeof(T), output += sizeof(T))
+    {
+        T val;
+        ::memcpy(&val, input, sizeof(T));
+        val = swapBytes(val);
+        ::memcpy(output, &val, sizeof(T));
+    }
+}
+}
+
+/*!
+ * Byte swaps 'numElems' elements from 'input' into 'output' in a single
+ * pass.  This is much faster than sys::byteSwap() for the common element
+ * sizes.
+ *
+ * \param input Elements to swap
+ * \param elemSize Size of each element in bytes
+ * \param numElems Number of elements
+ * \param[out] output Swapped elements.  May be the same as 'input'.
+ */
+inline
+void byteSwap(const void* input,
+              size_t elemSize,
+              size_t numElems,
+              void* output)
+{
+    const sys::byte* const inputPtr = static_cast<const sys::byte*>(input);
+    sys::byte* const outputPtr = static_cast<sys::byte*>(output);
+
+    switch (elemSize)
+    {
+    case 2:
+        detail::byteSwap<sys::Uint16_T>(inputPtr, numElems, outputPtr);
+        break;
+    case 4:
+        detail::byteSwap<sys::Uint32_T>(inputPtr, numElems, outputPtr);
+        break;
+    case 8:
+        detail::byteSwap<sys::Uint64_T>(inputPtr, numElems, outputPtr);
+        break;
+    default:
+        if (inputPtr != outputPtr)
+        {
+            ::memcpy(outputPtr, inputPtr, elemSize * numElems);
+        }
+        sys::byteSwap(outputPtr, static_cast<unsigned short>(elemSize),
+                      numElems);
+    }
+}
+}
+
+#endif
@@ -27,6 +27,8 @@
 #include <string>
 
 #include <sys/Conf.h>
+#include <io/InputStream.h>
+#include <io/OutputStream.h>
 #include <six/Parameter.h>
 #include <types/RowCol.h>
 
@@ -120,6 +122,28 @@ public:
      *  function.
      */
     virtual void deserialize(const sys::byte*& values) = 0;
+
+    /*!
+     * Serializes the mesh to a stream, producing the same bytes as
+     * serialize() does.  Meshes that override this write their fields
+     * straight to the stream so that the serialized mesh is never held
+     * in memory (e.g. when writing a large mesh to a DES; see
+     * MeshWriteHandler).  The default implementation serializes into a
+     * byte array and writes that.
+     * \param stream The stream to write to.
+     */
+    virtual void serialize(io::OutputStream& stream) const;
+
+    /*!
+     * Deserializes a mesh from a stream written by serialize().  Fields
+     * are read straight into the mesh without first reading the whole
+     * serialized mesh into memory.
+     * \param stream The stream to read from.  This is advanced by the
+     *  serialized storage size of the Mesh.
+     *
+     * \throws except::NotImplementedException unless overridden
+     */
+    virtual void deserialize(io::InputStream& stream);
 };
 }
 #endif
@@ -0,0 +1,152 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_NITF_BLOCK_CACHE_H__
+#define __SIX_NITF_BLOCK_CACHE_H__
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include <mem/SharedPtr.h>
+#include <sys/Mutex.h>
+#include "six/Types.h"
+
+namespace six
+{
+/*!
+ *  \class NITFBlockCache
+ *  \brief Least recently used cache of decoded NITF image blocks
+ *
+ *  NITRO's image readers only hold onto the last block they read, and
+ *  each read of a region gets a new reader, so panning around a blocked
+ *  (and possibly compressed) image reads and decodes the same blocks over
+ *  and over.  NITFReadControl keeps the blocks it reads in one of these
+ *  (see NITFReadControl::OPT_BLOCK_CACHE_SIZE) so that they can be reused
+ *  by later reads.
+ *
+ *  The cache holds at most a given number of bytes of blocks, evicting the
+ *  least recently used ones to make room.  It's safe to use from multiple
+ *  threads.
+ */
+class NITFBlockCache
+{
+public:
+    //! A decoded block
+    typedef std::vector<UByte> Block;
+
+    /*!
+     *  \struct Key
+     *  \brief Identifies a block within a NITF
+     */
+    struct Key
+    {
+        Key(size_t segment, size_t band, size_t block) :
+            segment(segment),
+            band(band),
+            block(block)
+        {
+        }
+
+        bool operator<(const Key& rhs) const;
+
+        //! Image segment index
+        size_t segment;
+
+        //! Band index within the segment
+        size_t band;
+
+        //! Block index within the band (row-major)
+        size_t block;
+    };
+
+    /*!
+     *  \param capacity Maximum number of bytes of blocks to hold
+     */
+    NITFBlockCache(size_t capacity);
+
+    //! \return The maximum number of bytes of blocks held
+    size_t getCapacity() const;
+
+    /*!
+     *  Changes the maximum number of bytes of blocks held, evicting blocks
+     *  if need be
+     */
+    void setCapacity(size_t capacity);
+
+    //! \return The number of bytes of blocks currently held
+    size_t getSize() const;
+
+    //! \return The number of blocks currently held
+    size_t getNumBlocks() const;
+
+    /*!
+     *  Looks up a block, marking it as the most recently used
+     *
+     *  \param key The block to look up
+     *
+     *  \return The block, or NULL if it isn't in the cache.  The block
+     *  stays valid even if it's evicted while the caller is using it.
+     */
+    mem::SharedPtr<const Block> get(const Key& key);
+
+    /*!
+     *  Adds a block as the most recently used, evicting the least recently
+     *  used blocks to make room.  Blocks bigger than the whole cache aren't
+     *  held.  If the block is already held, it's replaced.
+     *
+     *  \param key The block
+     *  \param block The block's decoded bytes
+     */
+    void put(const Key& key, mem::SharedPtr<const Block> block);
+
+    //! Evicts every block
+    void clear();
+
+private:
+    typedef std::list<Key> Order;
+
+    struct Entry
+    {
+        mem::SharedPtr<const Block> block;
+        Order::iterator position;
+    };
+
+    typedef std::map<Key, Entry> Entries;
+
+    // Assumes mMutex is held
+    void evict(size_t capacity);
+
+    // Assumes mMutex is held
+    void erase(Entries::iterator entry);
+
+private:
+    mutable sys::Mutex mMutex;
+    size_t mCapacity;
+    size_t mSize;
+
+    // Most recently used at the front
+    Order mOrder;
+    Entries mEntries;
+};
+}
+
+#endif
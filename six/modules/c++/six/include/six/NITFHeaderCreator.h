@@ -256,6 +256,16 @@ public:
                          const std::vector<sys::byte>& meshBuffer,
                          const six::Classification& classification);
 
+    /*!
+     * Load a mesh segment's information.  Rather than serializing the mesh
+     * up front, it's serialized straight into the file when the NITF is
+     * written, so it must outlive the write.
+     * \param mesh The mesh.  Its name is used as the DES type ID.
+     * \param classification The classification of the information.
+     */
+    void loadMeshSegment(const Mesh& mesh,
+                         const six::Classification& classification);
+
     /*!
      * Construct complex image sub-header identifier.
      * \static
@@ -397,6 +407,11 @@ protected:
     {
     }
 
+private:
+    //! Adds a DES to the record for a mesh, populating its subheader
+    void addMeshSegmentSubheader(const std::string& meshName,
+                                 const six::Classification& classification);
+
 private:
     std::string mOrganizationId;
     std::string mLocationId;
@@ -28,7 +28,9 @@
 #include "six/ReadControl.h"
 #include "six/ReadControlFactory.h"
 #include "six/Adapters.h"
+#include "six/NITFBlockCache.h"
 #include <io/SeekableStreams.h>
+#include <mem/SharedPtr.h>
 #include <import/nitf.hpp>
 #include <nitf/IOStreamReader.hpp>
 
@@ -62,6 +64,23 @@ public:
         reset();
     }
 
+    /*!
+     *  Number of threads interleaved() may use to read image data.  The
+     *  requested rows are split across the threads, each of which opens
+     *  its own handle to the file, so this only takes effect when the
+     *  file was loaded by pathname.  Defaults to 1 (serial reads).
+     */
+    static const char OPT_NUM_READ_THREADS[];
+
+    /*!
+     *  Maximum number of bytes of decoded image blocks interleaved() keeps
+     *  around between calls, so that reads of nearby or overlapping regions
+     *  of a blocked image don't read and decode the same blocks again.
+     *  The cache is shared by all of the read threads.  Defaults to 0 (no
+     *  caching).
+     */
+    static const char OPT_BLOCK_CACHE_SIZE[];
+
     /*!
      *  Read whether a file has COMPLEX or DERIVED data
      *  \param fromFile path to file
@@ -69,6 +88,26 @@ public:
      */
     virtual DataType getDataType(const std::string& fromFile) const;
 
+    /*!
+     *  Read whether a file has COMPLEX or DERIVED data, looking only at
+     *  the NITF file header and the first DES subheader rather than
+     *  parsing the entire Record
+     *  \param fromFile path to file
+     *  \return datatype of file contents
+     */
+    static
+    DataType sniffDataType(const std::string& fromFile);
+
+    /*!
+     *  Parse the Record of a file and determine whether it has COMPLEX or
+     *  DERIVED data.  If it has either, the parsed Record is held onto so
+     *  that a following load() of the same pathname doesn't parse it
+     *  again.
+     *  \param fromFile path to file
+     *  \return datatype of file contents
+     */
+    DataType identify(const std::string& fromFile);
+
     /*!
     *  Read whether a Record has COMPLEX or DERIVED data
     *  \param record the Record in question
@@ -144,7 +183,9 @@ public:
      * of rows and/or number of columns is set to -1, this indicates to read
      * the entirety of the image in that dimension.  In this case, this
      * parameter will be updated with the actual number of rows and/or
-     * columns that were read.
+     * columns that were read.  If the region is decimated, the buffer holds
+     * region.getNumDecimatedRows() x region.getNumDecimatedCols() pixels,
+     * each one reduced from its window with the region's downsample method.
      * \param imageNumber Index of the image to read
      *
      * \return Buffer of image data.  This is simply a pointer to the buffer
@@ -154,6 +195,34 @@ public:
      */
     virtual UByte* interleaved(Region& region, size_t imageNumber);
 
+    /*!
+     * \param imageNumber Index of the image
+     *
+     * \return Whether readRaw() can read the image.  The file must have
+     * been loaded by pathname, and each of the image's segments must be
+     * uncompressed, a single block, and either a single band or pixel
+     * interleaved.
+     */
+    bool canReadRaw(size_t imageNumber) const;
+
+    /*!
+     * Read section of image data specified by region as the bytes stored
+     * in the file.  Unlike interleaved(), the pixels are left in the
+     * file's (big endian) byte order, so they can be written to another
+     * NITF as is.  The rows are read directly from the file, split across
+     * OPT_NUM_READ_THREADS threads.
+     *
+     * \param region Rows and columns of the image to read, as in
+     * interleaved().  Must not be decimated.
+     * \param imageNumber Index of the image to read
+     *
+     * \return Buffer of image data, allocated as in interleaved() if the
+     * region doesn't have one
+     *
+     * \throws except::Exception if canReadRaw() is false for the image
+     */
+    UByte* readRaw(Region& region, size_t imageNumber);
+
     virtual std::string getFileType() const
     {
         return "NITF";
@@ -171,6 +240,15 @@ public:
         return mReader;
     }
 
+    /*!
+     *  \return The blocks cached by interleaved(), or NULL if
+     *  OPT_BLOCK_CACHE_SIZE was 0 on the last call
+     */
+    const NITFBlockCache* getBlockCache() const
+    {
+        return mBlockCache.get();
+    }
+
 protected:
     //! We keep a ref to the reader
     mutable nitf::Reader mReader;
@@ -182,6 +260,28 @@ protected:
 
     std::map<std::string, void*> mCompressionOptions;
 
+    //! Pathname of the loaded file (empty if loaded from an IOInterface)
+    std::string mFilename;
+
+    //! Decoded image blocks (NULL if caching is off)
+    std::auto_ptr<NITFBlockCache> mBlockCache;
+
+    //! A handle to the loaded file and a Reader that has parsed its Record
+    struct ThreadReader
+    {
+        ThreadReader(const std::string& pathname);
+
+        nitf::IOHandle handle;
+        nitf::Reader reader;
+    };
+
+    /*!
+     *  One ThreadReader per thread interleaved() reads with, so that the
+     *  Record is only parsed once per thread rather than on every read.
+     *  Opened as needed and kept until the next load.
+     */
+    std::vector<mem::SharedPtr<ThreadReader> > mThreadReaders;
+
     /*!
      *  This function grabs the IID out of the NITF file.
      *  If the data is Complex, it follows the following convention.
@@ -213,6 +313,15 @@ protected:
     //! Resets the object internals
     void reset();
 
+    //! Creates, resizes, or drops mBlockCache per OPT_BLOCK_CACHE_SIZE
+    NITFBlockCache* updateBlockCache();
+
+    //! The Reader for thread 'threadNum', opening it if needed
+    nitf::Reader& getThreadReader(size_t threadNum);
+
+    //! Loads everything but the Record itself, which must already be read
+    void loadRecord(const std::vector<std::string>& schemaPaths);
+
     //! All pointers populated within the options need
     //  to be cleaned up elsewhere. There is no access
     //  to deallocation in NITFReadControl directly
@@ -247,6 +356,10 @@ private:
     // The issue occurs from the explicit destructor of
     // IOControl
     mem::SharedPtr<nitf::IOInterface> mInterface;
+
+    // Set by identify() until the next load()
+    mem::SharedPtr<nitf::IOInterface> mIdentifiedInterface;
+    std::string mIdentifiedFilename;
 };
 
 
@@ -254,6 +367,9 @@ struct NITFReadControlCreator : public ReadControlCreator
 {
     six::ReadControl* newReadControl() const;
 
+    //! Returns a NITFReadControl that has already parsed the file's Record
+    six::ReadControl* newReadControl(const std::string& filename) const;
+
     bool supports(const std::string& filename) const;
 
 };
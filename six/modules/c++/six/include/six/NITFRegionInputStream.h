@@ -0,0 +1,93 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_NITF_REGION_INPUT_STREAM_H__
+#define __SIX_NITF_REGION_INPUT_STREAM_H__
+
+#include <vector>
+
+#include <io/InputStream.h>
+#include <types/RowCol.h>
+#include "six/NITFReadControl.h"
+
+namespace six
+{
+/*!
+ *  \class NITFRegionInputStream
+ *  \brief Streams a region of an image read by a NITFReadControl
+ *
+ *  The region's rows are read as they're asked for rather than all at
+ *  once, so a region of any size can be handed to NITFWriteControl::save()
+ *  without ever being held in memory.
+ *
+ *  Raw streams read the rows with NITFReadControl::readRaw(), leaving them
+ *  in the file's byte order, so they should be saved with
+ *  WriteControl::OPT_BYTE_SWAP set to ByteSwapping::SWAP_OFF.  Other
+ *  streams read them with NITFReadControl::interleaved().
+ */
+class NITFRegionInputStream : public io::InputStream
+{
+public:
+    /*!
+     *  \param reader Reader of the image.  Must outlive the stream and not
+     *  be used by anything else while the stream is being read from.
+     *  \param imageNumber Index of the image
+     *  \param offset First row and column of the region
+     *  \param dims Number of rows and columns in the region
+     *  \param numBytesPerPixel Number of bytes per pixel of the image
+     *  \param raw Whether to read the rows raw.  See
+     *  NITFReadControl::canReadRaw().
+     */
+    NITFRegionInputStream(NITFReadControl& reader,
+                          size_t imageNumber,
+                          const types::RowCol<size_t>& offset,
+                          const types::RowCol<size_t>& dims,
+                          size_t numBytesPerPixel,
+                          bool raw);
+
+    //! \return The number of bytes of the region left to read
+    virtual sys::Off_T available();
+
+protected:
+    virtual sys::SSize_T readImpl(void* buffer, size_t len);
+
+private:
+    // Reads the next 'numRows' rows of the region into 'buffer'
+    void readRows(size_t numRows, UByte* buffer);
+
+private:
+    NITFReadControl& mReader;
+    const size_t mImageNumber;
+    const types::RowCol<size_t> mOffset;
+    const types::RowCol<size_t> mDims;
+    const bool mRaw;
+    const size_t mNumBytesPerRow;
+
+    //! Next row of the region to read, relative to mOffset
+    size_t mNextRow;
+
+    //! Holds a row when a read ends partway through it
+    std::vector<UByte> mPartialRow;
+    size_t mPartialRowOffset;
+};
+}
+
+#endif
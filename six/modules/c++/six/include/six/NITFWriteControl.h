@@ -274,6 +274,17 @@ public:
      */
     void addAdditionalDES(mem::SharedPtr<nitf::SegmentWriter> writer);
 
+    /*!
+     *  Add a DES holding a mesh.  The mesh is serialized straight into
+     *  the file when it's saved so it must outlive the call to save().
+     *  See NITFHeaderCreator::loadMeshSegment().
+     *
+     * \param mesh The mesh.  Its name is used as the DES type ID.
+     * \param classification The classification of the mesh
+     */
+    void loadMeshSegment(const Mesh& mesh,
+                         const six::Classification& classification);
+
     /*!
      *  Takes in a string representing the classification level
      *  and returns the value expected by the NITF
@@ -378,6 +389,12 @@ protected:
      */
     void addDataAndWrite(const std::vector<std::string>& schemaPaths);
 
+    /*!
+     *  If the given image has a legend, sets it up to be written after the
+     *  image's segments
+     */
+    void addLegendWriter(const NITFImageInfo& info, size_t imageNumber);
+
     /*!
      * This function sets the NITF blocking.  By default, the product
      * will be unblocked, but for SIDDs the user can override this via
@@ -0,0 +1,637 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_NUMBER_CONVERSION_H__
+#define __SIX_NUMBER_CONVERSION_H__
+
+#include <errno.h>
+#include <float.h>
+#include <locale.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#include <sys/Conf.h>
+#include <except/Exception.h>
+
+namespace six
+{
+/*!
+ *  \class NumberConversion
+ *  \brief Locale independent conversions between doubles and the text
+ *  used for them in SICD, SIDD and CPHD XML.
+ *
+ *  toString() produces the shortest digit string that reads back to
+ *  exactly the same double (Grisu2), written in scientific notation with
+ *  an upper case 'E', no '+' and at least two exponent digits, e.g.
+ *  "1.25E-03".  It never touches an iostream or the C locale.
+ *
+ *  toDouble() handles the common case of at most 19 significant digits and
+ *  a small exponent exactly with a single multiply or divide, and falls
+ *  back to strtod() for everything else (to a classic locale stream if the
+ *  C library is using a decimal point other than '.').
+ */
+class NumberConversion
+{
+public:
+    //! Enough room for any double written by toString()
+    enum { MAX_LENGTH = 32 };
+
+    /*!
+     *  Writes 'value' to 'buffer'.  No terminating null is written.
+     *
+     *  \param value Value to write
+     *  \param[out] buffer Output text.  Must be at least MAX_LENGTH bytes.
+     *
+     *  \return The number of characters written
+     */
+    static size_t toString(double value, char* buffer)
+    {
+        char* out = buffer;
+        if (value != value)
+        {
+            return copy("NaN", buffer);
+        }
+        if (value < 0 || (value == 0 && isNegativeZero(value)))
+        {
+            *out++ = '-';
+            value = -value;
+        }
+        if (value > std::numeric_limits<double>::max())
+        {
+            return (out - buffer) + copy("INF", out);
+        }
+
+        char digits[20];
+        int numDigits = 1;
+        int exponent = 0;
+        if (value == 0)
+        {
+            digits[0] = '0';
+        }
+        else
+        {
+            int k = 0;
+            grisu2(value, digits, numDigits, k);
+            exponent = numDigits - 1 + k;
+        }
+
+        *out++ = digits[0];
+        *out++ = '.';
+        if (numDigits == 1)
+        {
+            *out++ = '0';
+        }
+        else
+        {
+            ::memcpy(out, digits + 1, numDigits - 1);
+            out += numDigits - 1;
+        }
+
+        *out++ = 'E';
+        if (exponent < 0)
+        {
+            *out++ = '-';
+            exponent = -exponent;
+        }
+        if (exponent >= 100)
+        {
+            *out++ = static_cast<char>('0' + exponent / 100);
+            exponent %= 100;
+        }
+        *out++ = static_cast<char>('0' + exponent / 10);
+        *out++ = static_cast<char>('0' + exponent % 10);
+        return out - buffer;
+    }
+
+    //! \return 'value' as text.  See toString(double, char*).
+    static std::string toString(double value)
+    {
+        char buffer[MAX_LENGTH];
+        return std::string(buffer, toString(value, buffer));
+    }
+
+    /*!
+     *  Reads a double.  Leading whitespace is skipped, and as with
+     *  str::toType(), anything following the number is ignored.
+     *
+     *  \param s Text to read
+     *
+     *  \return The value
+     *
+     *  \throws except::BadCastException if 's' does not start with a number
+     *  or the number is out of range
+     */
+    static double toDouble(const std::string& s)
+    {
+        double value;
+        if (parseFast(s.c_str(), value))
+        {
+            return value;
+        }
+
+        if (!s.empty() && parseSlow(s, value))
+        {
+            return value;
+        }
+
+        throw except::BadCastException(Ctxt(
+                "Conversion failed: '" + s + "' -> double"));
+    }
+
+private:
+    // A floating point value with a 64 bit significand and a binary
+    // exponent, as used by the Grisu algorithms
+    struct DiyFp
+    {
+        static const sys::Uint64_T EXPONENT_MASK = 0x7FF0000000000000ULL;
+        static const sys::Uint64_T SIGNIFICAND_MASK = 0x000FFFFFFFFFFFFFULL;
+        static const sys::Uint64_T HIDDEN_BIT = 0x0010000000000000ULL;
+
+        DiyFp() :
+            f(0),
+            e(0)
+        {
+        }
+
+        DiyFp(sys::Uint64_T f_, int e_) :
+            f(f_),
+            e(e_)
+        {
+        }
+
+        explicit DiyFp(double value)
+        {
+            sys::Uint64_T bits;
+            ::memcpy(&bits, &value, sizeof(bits));
+            const int biasedExponent =
+                    static_cast<int>((bits & EXPONENT_MASK) >> 52);
+            const sys::Uint64_T significand = bits & SIGNIFICAND_MASK;
+            if (biasedExponent != 0)
+            {
+                f = significand + HIDDEN_BIT;
+                e = biasedExponent - 1075;
+            }
+            else
+            {
+                f = significand;
+                e = -1074;
+            }
+        }
+
+        DiyFp operator-(const DiyFp& rhs) const
+        {
+            return DiyFp(f - rhs.f, e);
+        }
+
+        // Multiplies the significands, keeping the rounded upper 64 bits
+        DiyFp operator*(const DiyFp& rhs) const
+        {
+            const sys::Uint64_T mask = 0xFFFFFFFFULL;
+            const sys::Uint64_T a = f >> 32;
+            const sys::Uint64_T b = f & mask;
+            const sys::Uint64_T c = rhs.f >> 32;
+            const sys::Uint64_T d = rhs.f & mask;
+            const sys::Uint64_T ac = a * c;
+            const sys::Uint64_T bc = b * c;
+            const sys::Uint64_T ad = a * d;
+            const sys::Uint64_T bd = b * d;
+            sys::Uint64_T tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+            tmp += 1ULL << 31;
+            return DiyFp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32),
+                         e + rhs.e + 64);
+        }
+
+        DiyFp normalize() const
+        {
+            DiyFp result(*this);
+            while (!(result.f & (1ULL << 63)))
+            {
+                result.f <<= 1;
+                --result.e;
+            }
+            return result;
+        }
+
+        // Computes the normalized upper boundary and the lower boundary
+        // (with the same exponent) halfway to the neighboring doubles
+        void boundaries(DiyFp& minus, DiyFp& plus) const
+        {
+            plus = DiyFp((f << 1) + 1, e - 1).normalize();
+            minus = (f == HIDDEN_BIT) ? DiyFp((f << 2) - 1, e - 2) :
+                                        DiyFp((f << 1) - 1, e - 1);
+            minus.f <<= minus.e - plus.e;
+            minus.e = plus.e;
+        }
+
+        sys::Uint64_T f;
+        int e;
+    };
+
+    static size_t copy(const char* text, char* buffer)
+    {
+        const size_t length = ::strlen(text);
+        ::memcpy(buffer, text, length);
+        return length;
+    }
+
+    static bool isNegativeZero(double value)
+    {
+        sys::Uint64_T bits;
+        ::memcpy(&bits, &value, sizeof(bits));
+        return (bits >> 63) != 0;
+    }
+
+    static const sys::Uint64_T* powersOfTen()
+    {
+        static const sys::Uint64_T POWERS[] =
+        {
+            1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+            10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+            100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+            100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+            100000000000000000ULL, 1000000000000000000ULL,
+            10000000000000000000ULL
+        };
+        return POWERS;
+    }
+
+    // Normalized 10^-348, 10^-340, ..., 10^340
+    static DiyFp getCachedPower(int e, int& k)
+    {
+        static const sys::Uint64_T SIGNIFICANDS[] =
+        {
+            0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+            0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+            0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+            0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+            0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+            0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+            0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+            0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+            0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+            0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+            0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+            0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+            0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+            0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+            0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+            0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+            0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+            0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+            0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+            0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+            0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+            0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+            0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+            0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+            0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+            0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+            0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+            0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+            0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+        };
+        static const short EXPONENTS[] =
+        {
+            -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007,
+            -980, -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+            -688, -661, -635, -608, -582, -555, -529, -502, -475, -449, -422,
+            -396, -369, -343, -316, -289, -263, -236, -210, -183, -157, -130,
+            -103, -77, -50, -24, 3, 30, 56, 83, 109, 136, 162, 189, 216, 242,
+            269, 295, 322, 348, 375, 402, 428, 455, 481, 508, 534, 561, 588,
+            614, 641, 667, 694, 720, 747, 774, 800, 827, 853, 880, 907, 933,
+            960, 986, 1013, 1039, 1066
+        };
+
+        // Pick the power that brings 'e' into [-60, -32]
+        const double dk = (-61 - e) * 0.30102999566398114 + 347;
+        int kk = static_cast<int>(dk);
+        if (dk - kk > 0.0)
+        {
+            ++kk;
+        }
+        const size_t index = static_cast<size_t>((kk >> 3) + 1);
+        k = -(-348 + static_cast<int>(index) * 8);
+        return DiyFp(SIGNIFICANDS[index], EXPONENTS[index]);
+    }
+
+    static int countDigits(sys::Uint32_T n)
+    {
+        int numDigits = 1;
+        for (sys::Uint32_T limit = 10; numDigits < 10 && n >= limit;
+             limit *= 10)
+        {
+            ++numDigits;
+        }
+        return numDigits;
+    }
+
+    // Steps the last digit down while that moves closer to the exact value
+    static void roundWeed(char* buffer, int length, sys::Uint64_T delta,
+                      sys::Uint64_T rest, sys::Uint64_T tenKappa,
+                      sys::Uint64_T distance)
+    {
+        while (rest < distance && delta - rest >= tenKappa &&
+               (rest + tenKappa < distance ||
+                distance - rest > rest + tenKappa - distance))
+        {
+            --buffer[length - 1];
+            rest += tenKappa;
+        }
+    }
+
+    static void generateDigits(const DiyFp& w, const DiyFp& mp,
+                               sys::Uint64_T delta, char* buffer,
+                               int& length, int& k)
+    {
+        const sys::Uint64_T* const pow10 = powersOfTen();
+        const DiyFp one(1ULL << -mp.e, mp.e);
+        const DiyFp distance = mp - w;
+        sys::Uint32_T p1 = static_cast<sys::Uint32_T>(mp.f >> -one.e);
+        sys::Uint64_T p2 = mp.f & (one.f - 1);
+        int kappa = countDigits(p1);
+        length = 0;
+
+        while (kappa > 0)
+        {
+            const sys::Uint32_T divisor =
+                    static_cast<sys::Uint32_T>(pow10[kappa - 1]);
+            const sys::Uint32_T digit = p1 / divisor;
+            p1 %= divisor;
+            if (digit || length)
+            {
+                buffer[length++] = static_cast<char>('0' + digit);
+            }
+            --kappa;
+
+            const sys::Uint64_T rest =
+                    (static_cast<sys::Uint64_T>(p1) << -one.e) + p2;
+            if (rest <= delta)
+            {
+                k += kappa;
+                roundWeed(buffer, length, delta, rest,
+                      pow10[kappa] << -one.e, distance.f);
+                return;
+            }
+        }
+
+        for (;;)
+        {
+            p2 *= 10;
+            delta *= 10;
+            const char digit = static_cast<char>(p2 >> -one.e);
+            if (digit || length)
+            {
+                buffer[length++] = static_cast<char>('0' + digit);
+            }
+            p2 &= one.f - 1;
+            --kappa;
+            if (p2 < delta)
+            {
+                k += kappa;
+                const int index = -kappa;
+                roundWeed(buffer, length, delta, p2, one.f,
+                      distance.f * (index < 20 ? pow10[index] : 0));
+                return;
+            }
+        }
+    }
+
+    // Writes the digits of a positive, finite 'value' to 'buffer' such that
+    // value == digits * 10^k
+    static void grisu2(double value, char* buffer, int& length, int& k)
+    {
+        const DiyFp v(value);
+        DiyFp minus;
+        DiyFp plus;
+        v.boundaries(minus, plus);
+
+        const DiyFp cachedPower = getCachedPower(plus.e, k);
+        const DiyFp w = v.normalize() * cachedPower;
+        DiyFp wPlus = plus * cachedPower;
+        DiyFp wMinus = minus * cachedPower;
+        ++wMinus.f;
+        --wPlus.f;
+        generateDigits(w, wPlus, wPlus.f - wMinus.f, buffer, length, k);
+    }
+
+    static bool isSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+               c == '\f' || c == '\v';
+    }
+
+    static bool matches(const char* str, const char* word)
+    {
+        for (; *word; ++str, ++word)
+        {
+            if ((*str | 0x20) != *word)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Reads values that can be computed exactly from a mantissa that fits
+    // in a double and an exact power of ten.  Returns false for everything
+    // else.
+    static bool parseFast(const char* str, double& value)
+    {
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD != 0
+        // Extended precision intermediates would round twice
+        return false;
+#endif
+        static const double EXACT_POWERS[] =
+        {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        const sys::Uint64_T MAX_EXACT_MANTISSA = 1ULL << 53;
+
+        const char* p = str;
+        while (isSpace(*p))
+        {
+            ++p;
+        }
+
+        const bool negative = (*p == '-');
+        if (*p == '-' || *p == '+')
+        {
+            ++p;
+        }
+
+        if (matches(p, "nan"))
+        {
+            value = std::numeric_limits<double>::quiet_NaN();
+            return true;
+        }
+        if (matches(p, "inf"))
+        {
+            value = negative ? -std::numeric_limits<double>::infinity() :
+                               std::numeric_limits<double>::infinity();
+            return true;
+        }
+
+        sys::Uint64_T mantissa = 0;
+        int numDigits = 0;
+        int exponent = 0;
+        bool sawDigit = false;
+        for (; *p >= '0' && *p <= '9'; ++p)
+        {
+            sawDigit = true;
+            const int digit = *p - '0';
+            if (numDigits < 19)
+            {
+                mantissa = mantissa * 10 + digit;
+                if (mantissa != 0)
+                {
+                    ++numDigits;
+                }
+            }
+            else if (digit != 0)
+            {
+                return false;
+            }
+            else
+            {
+                ++exponent;
+            }
+        }
+
+        if (*p == '.')
+        {
+            for (++p; *p >= '0' && *p <= '9'; ++p)
+            {
+                sawDigit = true;
+                const int digit = *p - '0';
+                if (numDigits < 19)
+                {
+                    mantissa = mantissa * 10 + digit;
+                    if (mantissa != 0)
+                    {
+                        ++numDigits;
+                    }
+                    --exponent;
+                }
+                else if (digit != 0)
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (!sawDigit)
+        {
+            return false;
+        }
+
+        if (*p == 'e' || *p == 'E')
+        {
+            ++p;
+            const bool negativeExponent = (*p == '-');
+            if (*p == '-' || *p == '+')
+            {
+                ++p;
+            }
+            if (!(*p >= '0' && *p <= '9'))
+            {
+                return false;
+            }
+
+            int explicitExponent = 0;
+            for (; *p >= '0' && *p <= '9'; ++p)
+            {
+                if (explicitExponent < 100000)
+                {
+                    explicitExponent = explicitExponent * 10 + (*p - '0');
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent :
+                                           explicitExponent;
+        }
+
+        if (mantissa == 0)
+        {
+            value = negative ? -0.0 : 0.0;
+            return true;
+        }
+        if (mantissa > MAX_EXACT_MANTISSA)
+        {
+            return false;
+        }
+
+        // Shift extra powers of ten into the mantissa while it stays exact
+        while (exponent > 22 && mantissa <= MAX_EXACT_MANTISSA / 10)
+        {
+            mantissa *= 10;
+            --exponent;
+        }
+        if (exponent < -22 || exponent > 22)
+        {
+            return false;
+        }
+
+        value = static_cast<double>(mantissa);
+        if (exponent < 0)
+        {
+            value /= EXACT_POWERS[-exponent];
+        }
+        else
+        {
+            value *= EXACT_POWERS[exponent];
+        }
+        if (negative)
+        {
+            value = -value;
+        }
+        return true;
+    }
+
+    static bool parseSlow(const std::string& s, double& value)
+    {
+        const struct lconv* const conventions = ::localeconv();
+        if (conventions && conventions->decimal_point &&
+            ::strcmp(conventions->decimal_point, ".") == 0)
+        {
+            const char* const str = s.c_str();
+            char* end = NULL;
+            errno = 0;
+            value = ::strtod(str, &end);
+            return end != str &&
+                   !(errno == ERANGE && (value == HUGE_VAL ||
+                                         value == -HUGE_VAL));
+        }
+
+        std::istringstream stream(s);
+        stream.imbue(std::locale::classic());
+        stream >> value;
+        return !stream.fail();
+    }
+};
+}
+
+#endif
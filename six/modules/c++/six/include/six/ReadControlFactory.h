@@ -37,6 +37,16 @@ struct ReadControlCreator
 
     virtual six::ReadControl* newReadControl() const = 0;
 
+    /**
+     * Creates a ReadControl for filename if supported, otherwise returns
+     * NULL.  Creators that parse the file to determine support may hand
+     * what they parsed off to the ReadControl so it's not done twice.
+     */
+    virtual six::ReadControl* newReadControl(const std::string& filename) const
+    {
+        return supports(filename) ? newReadControl() : NULL;
+    }
+
     virtual bool supports(const std::string& filename) const = 0;
 
 };
@@ -42,19 +42,43 @@ namespace six
  *
  *  Returned data is always component-interleaved.
  *
+ *  The window may optionally be decimated, in which case each
+ *  rowDecimation x colDecimation block of the window is reduced to a single
+ *  output pixel during the read.  This is meant for quick-looks and
+ *  overviews, where it avoids holding the full resolution window in memory.
  *
  */
 class Region
 {
+public:
+    /*!
+     *  How each decimation window is reduced to a single output pixel
+     */
+    enum DownsampleMethod
+    {
+        //! Keep the first (upper left) pixel of the window
+        PIXEL_SKIP,
+
+        //! Keep the pixel with the largest magnitude in the window.  For
+        //! complex pixels this is the pixel with the largest I^2 + Q^2.
+        //! Not supported for AMP8I_PHS8I, lookup table or RGB pixel types.
+        MAX_MAGNITUDE
+    };
+
+private:
     UByte* mBuffer;
     sys::SSize_T startRow;
     sys::SSize_T numRows;
     sys::SSize_T startCol;
     sys::SSize_T numCols;
+    size_t rowDecimation;
+    size_t colDecimation;
+    DownsampleMethod downsampleMethod;
 public:
     //!  Constructor.  Sets params for full window size, and buffer is NULL
     Region() :
-        mBuffer(NULL), startRow(0), numRows(-1), startCol(0), numCols(-1)
+        mBuffer(NULL), startRow(0), numRows(-1), startCol(0), numCols(-1),
+        rowDecimation(1), colDecimation(1), downsampleMethod(PIXEL_SKIP)
     {
     }
 
@@ -141,6 +165,75 @@ public:
         return numCols;
     }
 
+    /*!
+     *  Set the decimation factors.  The window set by the start and number
+     *  of rows and cols is still in full resolution pixels.  A factor of 1
+     *  (the default) means no decimation in that direction.
+     */
+    void setDecimation(size_t rowDecimation_, size_t colDecimation_)
+    {
+        rowDecimation = rowDecimation_;
+        colDecimation = colDecimation_;
+    }
+
+    /*!
+     *  Get the row decimation factor
+     */
+    size_t getRowDecimation() const
+    {
+        return rowDecimation;
+    }
+
+    /*!
+     *  Get the col decimation factor
+     */
+    size_t getColDecimation() const
+    {
+        return colDecimation;
+    }
+
+    /*!
+     *  Set how each decimation window is reduced.  Defaults to PIXEL_SKIP.
+     */
+    void setDownsampleMethod(DownsampleMethod method)
+    {
+        downsampleMethod = method;
+    }
+
+    /*!
+     *  Get how each decimation window is reduced
+     */
+    DownsampleMethod getDownsampleMethod() const
+    {
+        return downsampleMethod;
+    }
+
+    /*!
+     *  Whether the read will be decimated at all
+     */
+    bool isDecimated() const
+    {
+        return rowDecimation != 1 || colDecimation != 1;
+    }
+
+    /*!
+     *  Get the number of rows in the returned buffer.  Like getNumRows(),
+     *  this is only meaningful once the number of rows is known.
+     */
+    sys::SSize_T getNumDecimatedRows() const
+    {
+        return decimate(numRows, rowDecimation);
+    }
+
+    /*!
+     *  Get the number of cols in the returned buffer.  Like getNumCols(),
+     *  this is only meaningful once the number of cols is known.
+     */
+    sys::SSize_T getNumDecimatedCols() const
+    {
+        return decimate(numCols, colDecimation);
+    }
+
     /*!
      *  Get the buffer.  Before a read has been done, this may be NULL,
      *  depending on if the user has initialized the buffer using the
@@ -163,6 +256,17 @@ public:
     {
         mBuffer = (UByte*) buffer;
     }
+
+private:
+    static sys::SSize_T decimate(sys::SSize_T num, size_t decimation)
+    {
+        if (num < 0 || decimation == 0)
+        {
+            return num;
+        }
+        return static_cast<sys::SSize_T>(
+                (static_cast<size_t>(num) + decimation - 1) / decimation);
+    }
 };
 }
 
@@ -25,8 +25,15 @@
 #include <vector>
 #include <algorithm>
 #include <iterator>
+#include <sstream>
 
 #include <sys/Conf.h>
+#include <except/Exception.h>
+#include <io/InputStream.h>
+#include <io/OutputStream.h>
+#include <io/SeekableStreams.h>
+#include <types/RowCol.h>
+#include <six/ByteSwap.h>
 
 namespace six
 {
@@ -86,13 +93,93 @@ struct Serializer
 
         buffer += length;
     }
+
+    /*!
+     * Serialize a value to a stream.
+     * \param val The value to serialize.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param stream The stream to write to.
+     */
+    static void serializeImpl(const T& val,
+                              bool swapBytes,
+                              io::OutputStream& stream)
+    {
+        T swapped(val);
+        if (swapBytes)
+        {
+            six::byteSwap(&val, sizeof(T), 1, &swapped);
+        }
+        stream.write(&swapped, sizeof(T));
+    }
+
+    /*!
+     * Deserialize a value from a stream.
+     * \param stream The stream to read from.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param[out] val The value to deserialize into.
+     */
+    static void deserializeImpl(io::InputStream& stream,
+                                bool swapBytes,
+                                T& val)
+    {
+        stream.read(&val, sizeof(T), true);
+        if (swapBytes)
+        {
+            six::byteSwap(&val, sizeof(T), 1, &val);
+        }
+    }
+};
+
+namespace detail
+{
+/*!
+ * \struct IsArithmetic
+ * \brief value is true if T is a built-in arithmetic type.  Vectors of
+ *  these can be (de)serialized as one block of bytes, since each value
+ *  is serialized as its own sizeof(T) bytes.
+ */
+template<typename T>
+struct IsArithmetic
+{
+    static const bool value = false;
 };
 
+#define SIX_SERIALIZE_ARITHMETIC(T) \
+    template<> struct IsArithmetic<T> { static const bool value = true; };
+// bool is left out since std::vector<bool> doesn't store one bool per
+// element
+SIX_SERIALIZE_ARITHMETIC(char)
+SIX_SERIALIZE_ARITHMETIC(signed char)
+SIX_SERIALIZE_ARITHMETIC(unsigned char)
+SIX_SERIALIZE_ARITHMETIC(wchar_t)
+SIX_SERIALIZE_ARITHMETIC(short)
+SIX_SERIALIZE_ARITHMETIC(unsigned short)
+SIX_SERIALIZE_ARITHMETIC(int)
+SIX_SERIALIZE_ARITHMETIC(unsigned int)
+SIX_SERIALIZE_ARITHMETIC(long)
+SIX_SERIALIZE_ARITHMETIC(unsigned long)
+SIX_SERIALIZE_ARITHMETIC(long long)
+SIX_SERIALIZE_ARITHMETIC(unsigned long long)
+SIX_SERIALIZE_ARITHMETIC(float)
+SIX_SERIALIZE_ARITHMETIC(double)
+SIX_SERIALIZE_ARITHMETIC(long double)
+#undef SIX_SERIALIZE_ARITHMETIC
+
+//! Selects the bulk or per-value implementation at compile time
+template<bool Bulk>
+struct BulkTag
+{
+};
+}
+
 /*!
  * \struct Serializer
- * \tparam T Scalar type
- * \brief Implements serialization and deserialization for vectors of
- *  scalar types
+ * \tparam T Value type
+ * \brief Implements serialization and deserialization for vectors.
+ *  Vectors of arithmetic types are (de)serialized as one block of bytes
+ *  with a bulk byte swap.  Anything else (e.g. nested vectors or types
+ *  with their own Serializer) goes through Serializer<T> one value at a
+ *  time.
  */
 template<typename T>
 struct Serializer<std::vector<T> >
@@ -107,19 +194,17 @@ struct Serializer<std::vector<T> >
                               bool swapBytes,
                               std::vector<sys::byte>& buffer)
     {
-        const size_t length = val.size();
-
-        Serializer<size_t>::serializeImpl(length, swapBytes, buffer);
-        for (size_t ii = 0; ii < length; ++ii)
+        Serializer<size_t>::serializeImpl(val.size(), swapBytes, buffer);
+        if (!val.empty())
         {
-            Serializer<T>::serializeImpl(val[ii], swapBytes, buffer);
+            serializeValues(val, swapBytes, buffer, Tag());
         }
     }
 
     /*!
      * Deserialize a byte array into a vector of values
      * \param buffer The data to deserialize. Pointer is incremented
-     *  by sizeof(size_t) + vector_length * sizeof(T) after calling
+     *  by the total serialized storage size of the vector after calling
      *  this function.
      * \param swapBytes Should byte-swapping be applied?
      * \param[out] val The vector of values to deserialize into.
@@ -131,12 +216,184 @@ struct Serializer<std::vector<T> >
         const size_t currentVectorLength = val.size();
         size_t length;
         Serializer<size_t>::deserializeImpl(buffer, swapBytes, length);
-        val.resize(currentVectorLength + length);
+        if (length != 0)
+        {
+            val.resize(currentVectorLength + length);
+            deserializeValues(buffer, swapBytes, currentVectorLength, val,
+                              Tag());
+        }
+    }
+
+    /*!
+     * Serialize a vector of values to a stream.  Arithmetic values that
+     * need swapping are swapped a chunk at a time so that a swapped copy
+     * of the whole vector is never held in memory.
+     * \param val The vector of values to serialize.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param stream The stream to write to.
+     */
+    static void serializeImpl(const std::vector<T>& val,
+                              bool swapBytes,
+                              io::OutputStream& stream)
+    {
+        Serializer<size_t>::serializeImpl(val.size(), swapBytes, stream);
+        if (!val.empty())
+        {
+            serializeValues(val, swapBytes, stream, Tag());
+        }
+    }
+
+    /*!
+     * Deserialize a vector of values from a stream.  Arithmetic values
+     * are read straight into the vector and swapped in place.
+     * \param stream The stream to read from.
+     * \param swapBytes Should byte-swapping be applied?
+     * \param[out] val The vector of values to deserialize into.  As with
+     *  the byte array version, values are appended.
+     */
+    static void deserializeImpl(io::InputStream& stream,
+                                bool swapBytes,
+                                std::vector<T>& val)
+    {
+        const size_t currentVectorLength = val.size();
+        size_t length;
+        Serializer<size_t>::deserializeImpl(stream, swapBytes, length);
+        if (length != 0)
+        {
+            val.resize(currentVectorLength + length);
+            deserializeValues(stream, swapBytes, currentVectorLength, val,
+                              Tag());
+        }
+    }
+
+private:
+    typedef detail::BulkTag<detail::IsArithmetic<T>::value> Tag;
+    typedef detail::BulkTag<true> Bulk;
+    typedef detail::BulkTag<false> PerValue;
+
+    // Swapped values are staged through a buffer of this many bytes
+    static const size_t CHUNK_SIZE = 1024 * 1024;
+
+    static void serializeValues(const std::vector<T>& val,
+                                bool swapBytes,
+                                std::vector<sys::byte>& buffer,
+                                Bulk )
+    {
+        const size_t numBytes = val.size() * sizeof(T);
+        const size_t prevLength = buffer.size();
+        buffer.resize(prevLength + numBytes);
+        const sys::byte* const data =
+                reinterpret_cast<const sys::byte*>(&val[0]);
+        if (swapBytes)
+        {
+            six::byteSwap(data, sizeof(T), val.size(), &buffer[prevLength]);
+        }
+        else
+        {
+            std::copy(data, data + numBytes, &buffer[prevLength]);
+        }
+    }
+
+    static void serializeValues(const std::vector<T>& val,
+                                bool swapBytes,
+                                std::vector<sys::byte>& buffer,
+                                PerValue )
+    {
+        for (size_t ii = 0; ii < val.size(); ++ii)
+        {
+            Serializer<T>::serializeImpl(val[ii], swapBytes, buffer);
+        }
+    }
+
+    static void deserializeValues(const sys::byte*& buffer,
+                                  bool swapBytes,
+                                  size_t first,
+                                  std::vector<T>& val,
+                                  Bulk )
+    {
+        const size_t length = val.size() - first;
+        sys::byte* const data = reinterpret_cast<sys::byte*>(&val[first]);
+        std::copy(buffer, buffer + length * sizeof(T), data);
+        if (swapBytes)
+        {
+            six::byteSwap(data, sizeof(T), length, data);
+        }
+        buffer += length * sizeof(T);
+    }
+
+    static void deserializeValues(const sys::byte*& buffer,
+                                  bool swapBytes,
+                                  size_t first,
+                                  std::vector<T>& val,
+                                  PerValue )
+    {
+        for (size_t ii = first; ii < val.size(); ++ii)
+        {
+            Serializer<T>::deserializeImpl(buffer, swapBytes, val[ii]);
+        }
+    }
+
+    static void serializeValues(const std::vector<T>& val,
+                                bool swapBytes,
+                                io::OutputStream& stream,
+                                Bulk )
+    {
+        const size_t length = val.size();
+        const sys::byte* const data =
+                reinterpret_cast<const sys::byte*>(&val[0]);
+        if (!swapBytes)
+        {
+            stream.write(data, length * sizeof(T));
+            return;
+        }
+
+        const size_t chunkLength =
+                std::min(length, std::max<size_t>(CHUNK_SIZE / sizeof(T), 1));
+        std::vector<sys::byte> chunk(chunkLength * sizeof(T));
+        for (size_t ii = 0; ii < length; ii += chunkLength)
+        {
+            const size_t numThisChunk = std::min(chunkLength, length - ii);
+            six::byteSwap(data + ii * sizeof(T), sizeof(T), numThisChunk,
+                          &chunk[0]);
+            stream.write(&chunk[0], numThisChunk * sizeof(T));
+        }
+    }
+
+    static void serializeValues(const std::vector<T>& val,
+                                bool swapBytes,
+                                io::OutputStream& stream,
+                                PerValue )
+    {
+        for (size_t ii = 0; ii < val.size(); ++ii)
+        {
+            Serializer<T>::serializeImpl(val[ii], swapBytes, stream);
+        }
+    }
+
+    static void deserializeValues(io::InputStream& stream,
+                                  bool swapBytes,
+                                  size_t first,
+                                  std::vector<T>& val,
+                                  Bulk )
+    {
+        const size_t length = val.size() - first;
+        T* const data = &val[first];
+        stream.read(data, length * sizeof(T), true);
+        if (swapBytes)
+        {
+            six::byteSwap(data, sizeof(T), length, data);
+        }
+    }
 
-        for (size_t ii = 0; ii < length; ++ii)
+    static void deserializeValues(io::InputStream& stream,
+                                  bool swapBytes,
+                                  size_t first,
+                                  std::vector<T>& val,
+                                  PerValue )
+    {
+        for (size_t ii = first; ii < val.size(); ++ii)
         {
-            Serializer<T>::deserializeImpl(buffer, swapBytes,
-                val[currentVectorLength + ii]);
+            Serializer<T>::deserializeImpl(stream, swapBytes, val[ii]);
         }
     }
 };
@@ -170,5 +427,102 @@ void deserialize(const sys::byte*& buffer, bool swapBytes, T& val)
 {
     Serializer<T>::deserializeImpl(buffer, swapBytes, val);
 }
+
+/*!
+ * Function interface to serialize to a stream.
+ * \tparam T Data type to serialize. Argument determines which
+ *  Serializer functor's implementation to use.
+ * \param val Value(s) to serialize
+ * \param swapBytes Should the bytes be swapped?
+ * \param stream Stream to serialize to.  Produces the same bytes as
+ *  serializing into a byte array.
+ */
+template<typename T>
+void serialize(const T& val, bool swapBytes, io::OutputStream& stream)
+{
+    Serializer<T>::serializeImpl(val, swapBytes, stream);
+}
+
+/*!
+ * Function interface to deserialize from a stream
+ * \tparam T Data type to deserialize. Argument determines which
+ *  Serializer functor's implementation to use.
+ * \param stream Stream to deserialize from.  This is advanced by the
+ *  total serialized storage size of T.
+ * \param swapBytes Should bytes be swapped?
+ * \param[out] Value(s) to deserialize into.
+ */
+template<typename T>
+void deserialize(io::InputStream& stream, bool swapBytes, T& val)
+{
+    Serializer<T>::deserializeImpl(stream, swapBytes, val);
+}
+
+/*!
+ * Deserializes a window of a serialized vector that holds a row-major
+ * grid (e.g. one field of a mesh).  Only the window's values are read;
+ * the rest are seeked past.
+ * \tparam T Scalar type of the vector's values
+ * \param stream Stream positioned at the start of the serialized vector.
+ *  On return, it's positioned just past the end of it.
+ * \param swapBytes Should bytes be swapped?
+ * \param dims The dimensions of the whole grid
+ * \param offset The first row and column of the window
+ * \param windowDims The dimensions of the window
+ * \param[out] val The window's values in row-major order.  Unlike
+ *  deserialize(), any existing values are replaced.
+ *
+ * \throws except::Exception if the serialized vector isn't the size of
+ *  the grid or the window doesn't fit in the grid
+ */
+template<typename T>
+void deserializeWindow(io::SeekableInputStream& stream,
+                       bool swapBytes,
+                       const types::RowCol<size_t>& dims,
+                       const types::RowCol<size_t>& offset,
+                       const types::RowCol<size_t>& windowDims,
+                       std::vector<T>& val)
+{
+    size_t length;
+    deserialize(stream, swapBytes, length);
+    if (length != dims.area())
+    {
+        std::ostringstream ostr;
+        ostr << "Serialized vector has " << length << " values but the grid "
+             << "is " << dims.row << " x " << dims.col;
+        throw except::Exception(Ctxt(ostr.str()));
+    }
+    if (offset.row + windowDims.row > dims.row ||
+        offset.col + windowDims.col > dims.col)
+    {
+        throw except::Exception(Ctxt("Window extends past the grid"));
+    }
+
+    const sys::Off_T start = stream.tell();
+    val.resize(windowDims.area());
+    if (!val.empty())
+    {
+        // Full width windows are contiguous so read them in one shot
+        const size_t numReads =
+                (windowDims.col == dims.col) ? 1 : windowDims.row;
+        const size_t numPerRead = (windowDims.col == dims.col) ?
+                val.size() : windowDims.col;
+        for (size_t ii = 0; ii < numReads; ++ii)
+        {
+            const size_t first = (offset.row + ii) * dims.col + offset.col;
+            stream.seek(start + static_cast<sys::Off_T>(first * sizeof(T)),
+                        io::Seekable::START);
+            stream.read(&val[ii * numPerRead], numPerRead * sizeof(T), true);
+        }
+
+        if (swapBytes)
+        {
+            six::byteSwap(&val[0], sizeof(T), val.size(), &val[0]);
+        }
+    }
+
+    stream.seek(start + static_cast<sys::Off_T>(length * sizeof(T)),
+                io::Seekable::START);
+}
 }
 #endif
@@ -84,6 +84,7 @@ template<typename T> T toType(const std::string& s)
 
 template<> std::string toString(const float& value);
 template<> std::string toString(const double& value);
+template<> double toType<double>(const std::string& s);
 template<> std::string toString(const six::Vector3 & v);
 template<> std::string toString(const six::PolyXYZ & p);
 template<> six::EarthModelType
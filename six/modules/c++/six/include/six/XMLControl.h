@@ -98,6 +98,15 @@ public:
     void splitVersion(const std::string& versionStr,
                       std::vector<std::string>& version);
 
+    /*!
+     * Schemas are only loaded and compiled the first time a given set of
+     * schema paths is used for validation; after that the compiled grammar
+     * is shared by every XMLControl in the process.  Call this if the
+     * schemas on disk change while the process is running.
+     */
+    static
+    void clearSchemaCache();
+
 protected:
     logging::Logger *mLog;
     bool mOwnLog;
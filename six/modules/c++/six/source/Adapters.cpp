@@ -19,10 +19,412 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sys/Thread.h>
+#include <mt/RequestQueue.h>
 #include "six/Adapters.h"
+#include "six/ByteSwap.h"
 
 using namespace six;
 
+namespace
+{
+// Rows are staged and written in chunks of roughly this many bytes.  This is
+// large enough that the per-write overhead is negligible but small enough
+// that a chunk being swapped stays in cache.
+const size_t CHUNK_SIZE = 4 * 1024 * 1024;
+
+// Special buffer indices passed through ChunkPrefetcher's queues
+const size_t NO_BUFFER = std::numeric_limits<size_t>::max();
+const size_t READ_FAILED = NO_BUFFER - 1;
+const size_t STOP = NO_BUFFER - 2;
+
+/*
+ *  Supplies a segment's rows, a chunk at a time, ready to be written
+ */
+class RowSource
+{
+public:
+    RowSource(size_t numCols,
+              size_t numChannels,
+              size_t pixelSize,
+              bool doByteSwap) :
+        mRowSize(pixelSize * numCols),
+        mElemSize(pixelSize / numChannels),
+        mNumElemsPerRow(numCols * numChannels),
+        mDoByteSwap(doByteSwap)
+    {
+    }
+
+    virtual ~RowSource()
+    {
+    }
+
+    size_t getRowSize() const
+    {
+        return mRowSize;
+    }
+
+    /*
+     *  \return The rows in place if they can be written as is, or NULL if
+     *  they must be staged through getRows()
+     */
+    virtual const UByte* getAllRows() const = 0;
+
+    /*
+     *  Produces the next 'numRows' rows.  'scratch' holds at least that
+     *  many rows and may be used for staging.
+     *
+     *  \return The rows to write
+     */
+    virtual const UByte* getRows(size_t numRows, UByte* scratch) = 0;
+
+protected:
+    const size_t mRowSize;
+    const size_t mElemSize;
+    const size_t mNumElemsPerRow;
+    const bool mDoByteSwap;
+};
+
+class MemoryRowSource : public RowSource
+{
+public:
+    MemoryRowSource(const UByte* buffer,
+                    size_t numCols,
+                    size_t numChannels,
+                    size_t pixelSize,
+                    bool doByteSwap) :
+        RowSource(numCols, numChannels, pixelSize, doByteSwap),
+        mBuffer(buffer)
+    {
+    }
+
+    virtual const UByte* getAllRows() const
+    {
+        return mDoByteSwap ? NULL : mBuffer;
+    }
+
+    virtual const UByte* getRows(size_t numRows, UByte* scratch)
+    {
+        const UByte* const rows = mBuffer;
+        mBuffer += numRows * mRowSize;
+
+        if (!mDoByteSwap)
+        {
+            return rows;
+        }
+
+        six::byteSwap(rows, mElemSize, numRows * mNumElemsPerRow, scratch);
+        return scratch;
+    }
+
+private:
+    const UByte* mBuffer;
+};
+
+class StreamRowSource : public RowSource
+{
+public:
+    StreamRowSource(io::InputStream& inputStream,
+                    size_t numCols,
+                    size_t numChannels,
+                    size_t pixelSize,
+                    bool doByteSwap) :
+        RowSource(numCols, numChannels, pixelSize, doByteSwap),
+        mInputStream(inputStream)
+    {
+    }
+
+    virtual const UByte* getAllRows() const
+    {
+        return NULL;
+    }
+
+    virtual const UByte* getRows(size_t numRows, UByte* scratch)
+    {
+        // Streams are allowed to return short reads
+        const size_t numBytes = numRows * mRowSize;
+        size_t numBytesRead = 0;
+        while (numBytesRead < numBytes)
+        {
+            const sys::SSize_T numBytesThisRead = mInputStream.read(
+                    scratch + numBytesRead, numBytes - numBytesRead);
+            if (numBytesThisRead <= 0)
+            {
+                throw except::IOException(Ctxt(
+                        "Tried to read " + str::toString(numBytes) +
+                        " bytes but only read " +
+                        str::toString(numBytesRead) + " bytes"));
+            }
+            numBytesRead += numBytesThisRead;
+        }
+
+        if (mDoByteSwap)
+        {
+            six::byteSwap(scratch, mElemSize, numRows * mNumElemsPerRow,
+                          scratch);
+        }
+        return scratch;
+    }
+
+private:
+    io::InputStream& mInputStream;
+};
+
+/*
+ *  Reads a segment's rows a chunk at a time on a single background thread.
+ *  The chunks are staged through two buffers, so the next chunk is read
+ *  and/or swapped while the caller writes the current one.
+ */
+class ChunkPrefetcher
+{
+public:
+    ChunkPrefetcher(RowSource& source,
+                    size_t numRows,
+                    size_t numRowsPerChunk) :
+        mSource(source),
+        mNumRows(numRows),
+        mNumRowsPerChunk(numRowsPerChunk),
+        mCurrentBuffer(NO_BUFFER)
+    {
+        // There's nothing to overlap with a single chunk
+        const size_t numBuffers = (numRowsPerChunk < numRows) ? 2 : 1;
+        for (size_t ii = 0; ii < numBuffers; ++ii)
+        {
+            mScratch[ii].resize(numRowsPerChunk * source.getRowSize());
+            mFreeBuffers.enqueue(ii);
+        }
+
+        mThread.reset(new sys::Thread(new PrefetchRunnable(*this)));
+        mThread->start();
+    }
+
+    ~ChunkPrefetcher()
+    {
+        try
+        {
+            stop();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /*
+     *  Waits for the next chunk.  Its rows remain valid until the next call.
+     *
+     *  \throws except::Exception if reading the chunk failed
+     */
+    const UByte* next()
+    {
+        if (mCurrentBuffer != NO_BUFFER)
+        {
+            mFreeBuffers.enqueue(mCurrentBuffer);
+            mCurrentBuffer = NO_BUFFER;
+        }
+
+        size_t buffer(NO_BUFFER);
+        mReadyBuffers.dequeue(buffer);
+        if (buffer == READ_FAILED)
+        {
+            // The background thread has exited, so mError is safe to read
+            stop();
+            throw except::Exception(Ctxt(mError));
+        }
+
+        mCurrentBuffer = buffer;
+        return mRows[buffer];
+    }
+
+private:
+    // Noncopyable
+    ChunkPrefetcher(const ChunkPrefetcher& );
+    const ChunkPrefetcher& operator=(const ChunkPrefetcher& );
+
+    class PrefetchRunnable : public sys::Runnable
+    {
+    public:
+        PrefetchRunnable(ChunkPrefetcher& prefetcher) :
+            mPrefetcher(prefetcher)
+        {
+        }
+
+        virtual void run()
+        {
+            mPrefetcher.prefetch();
+        }
+
+    private:
+        ChunkPrefetcher& mPrefetcher;
+    };
+
+    // Runs on the background thread
+    void prefetch()
+    {
+        for (size_t row = 0; row < mNumRows; row += mNumRowsPerChunk)
+        {
+            size_t buffer(NO_BUFFER);
+            mFreeBuffers.dequeue(buffer);
+            if (buffer == STOP)
+            {
+                return;
+            }
+
+            try
+            {
+                mRows[buffer] = mSource.getRows(
+                        std::min(mNumRowsPerChunk, mNumRows - row),
+                        &mScratch[buffer][0]);
+            }
+            catch (const except::Exception& ex)
+            {
+                mError = ex.getMessage();
+                mReadyBuffers.enqueue(READ_FAILED);
+                return;
+            }
+            catch (const std::exception& ex)
+            {
+                mError = ex.what();
+                mReadyBuffers.enqueue(READ_FAILED);
+                return;
+            }
+            catch (...)
+            {
+                mError = "Unknown exception";
+                mReadyBuffers.enqueue(READ_FAILED);
+                return;
+            }
+
+            mReadyBuffers.enqueue(buffer);
+        }
+    }
+
+    void stop()
+    {
+        if (mThread.get())
+        {
+            // If the caller is bailing out early, the background thread may
+            // read one more chunk before it sees this
+            mFreeBuffers.enqueue(STOP);
+            mThread->join();
+            mThread.reset();
+        }
+    }
+
+private:
+    RowSource& mSource;
+    const size_t mNumRows;
+    const size_t mNumRowsPerChunk;
+
+    std::vector<UByte> mScratch[2];
+    const UByte* mRows[2];
+
+    // Buffer indices move from mFreeBuffers to the background thread, to
+    // mReadyBuffers, to the caller (mCurrentBuffer), and back again
+    mt::RequestQueue<size_t> mFreeBuffers;
+    mt::RequestQueue<size_t> mReadyBuffers;
+    size_t mCurrentBuffer;
+    std::string mError;
+
+    std::auto_ptr<sys::Thread> mThread;
+};
+
+/*
+ *  Writes straight through to the NITF being written
+ */
+class IOInterfaceOutputStream : public io::OutputStream
+{
+public:
+    IOInterfaceOutputStream(nitf_IOInterface* io) :
+        mIO(io)
+    {
+    }
+
+    using io::OutputStream::write;
+
+    virtual void write(const void* buffer, size_t len)
+    {
+        nitf_Error error;
+        if (!nitf_IOInterface_write(mIO, static_cast<const char*>(buffer),
+                                    len, &error))
+        {
+            throw nitf::NITFException(&error);
+        }
+    }
+
+private:
+    nitf_IOInterface* const mIO;
+};
+
+/*
+ *  Writes 'numRows' rows from 'source'.  Rows that can go out as is are
+ *  written in one shot.  Otherwise, they're staged in chunks through a
+ *  ChunkPrefetcher.
+ *
+ *  This is called from NITRO's C write handlers, so exceptions can't
+ *  propagate out of it.  They're reported through 'error' instead.
+ */
+NITF_BOOL writeRows(RowSource& source,
+                    size_t numRows,
+                    nitf_IOInterface* io,
+                    nitf_Error* error)
+{
+    if (numRows == 0)
+    {
+        return NITF_SUCCESS;
+    }
+
+    try
+    {
+        const size_t rowSize = source.getRowSize();
+        const UByte* const allRows = source.getAllRows();
+        if (allRows)
+        {
+            return nitf_IOInterface_write(io, (const char*) allRows,
+                                          numRows * rowSize, error);
+        }
+
+        const size_t numRowsPerChunk =
+                std::min(std::max<size_t>(CHUNK_SIZE / rowSize, 1), numRows);
+        ChunkPrefetcher chunks(source, numRows, numRowsPerChunk);
+        for (size_t row = 0; row < numRows; row += numRowsPerChunk)
+        {
+            const size_t numRowsThisChunk =
+                    std::min(numRowsPerChunk, numRows - row);
+            const UByte* const rows = chunks.next();
+            if (!nitf_IOInterface_write(io, (const char*) rows,
+                                        numRowsThisChunk * rowSize, error))
+            {
+                return NITF_FAILURE;
+            }
+        }
+
+        return NITF_SUCCESS;
+    }
+    catch (const except::Exception& ex)
+    {
+        nitf_Error_init(error, ex.getMessage().c_str(), NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    catch (const std::exception& ex)
+    {
+        nitf_Error_init(error, ex.what(), NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    catch (...)
+    {
+        nitf_Error_init(error, "Unknown exception", NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    return NITF_FAILURE;
+}
+}
+
 extern "C"
 {
 void __six_StreamWriteHandler_destruct(NITF_DATA * data);
@@ -32,6 +434,10 @@ NITF_BOOL __six_StreamWriteHandler_write(NITF_DATA * data,
 void __six_MemoryWriteHandler_destruct(NITF_DATA * data);
 NITF_BOOL __six_MemoryWriteHandler_write(NITF_DATA * data,
         nitf_IOInterface* io, nitf_Error * error);
+
+void __six_MeshWriteHandler_destruct(NITF_DATA * data);
+NITF_BOOL __six_MeshWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error);
 }
 
 typedef struct _MemoryWriteHandlerImpl
@@ -55,36 +461,15 @@ extern "C" void __six_MemoryWriteHandler_destruct(NITF_DATA * data)
 extern "C" NITF_BOOL __six_MemoryWriteHandler_write(NITF_DATA * data,
         nitf_IOInterface* io, nitf_Error * error)
 {
-    size_t rowSize;
-    sys::Uint64_T off;
-    UByte* rowCopy;
-    unsigned int i;
-
     MemoryWriteHandlerImpl *impl = (MemoryWriteHandlerImpl *) data;
 
-    rowSize = impl->pixelSize * impl->numCols;
-    off = impl->firstRow * rowSize;
-    rowCopy = new UByte[rowSize];
-
-    for (i = 0; i < impl->numRows; i++)
-    {
-
-        memcpy(rowCopy, (const sys::byte*) &impl->buffer[off], rowSize);
-
-        if (impl->doByteSwap)
-            sys::byteSwap((sys::byte*) rowCopy, impl->pixelSize
-                    / impl->numChannels, impl->numCols * impl->numChannels);
-        // And write it back
-        if (!nitf_IOInterface_write(io, (const sys::byte*) rowCopy, rowSize,
-                                    error))
-            goto CATCH_ERROR;
-        off += rowSize;
-    }
-    delete[] rowCopy;
-    return NITF_SUCCESS;
-
-    CATCH_ERROR: delete[] rowCopy;
-    return NITF_FAILURE;
+    const size_t rowSize = impl->pixelSize * impl->numCols;
+    MemoryRowSource source(impl->buffer + impl->firstRow * rowSize,
+                           impl->numCols,
+                           impl->numChannels,
+                           impl->pixelSize,
+                           impl->doByteSwap != 0);
+    return writeRows(source, impl->numRows, io, error);
 }
 
 MemoryWriteHandler::MemoryWriteHandler(const NITFSegmentInfo& info,
@@ -148,34 +533,14 @@ extern "C" void __six_StreamWriteHandler_destruct(NITF_DATA * data)
 extern "C" NITF_BOOL __six_StreamWriteHandler_write(NITF_DATA * data,
         nitf_IOInterface* io, nitf_Error * error)
 {
-    size_t rowSize;
-    UByte* rowCopy;
-    unsigned int i;
-
     StreamWriteHandlerImpl *impl = (StreamWriteHandlerImpl *) data;
 
-    rowSize = impl->pixelSize * impl->numCols;
-    rowCopy = new UByte[rowSize];
-
-    for (i = 0; i < impl->numRows; i++)
-    {
-
-        impl->inputStream->read((sys::byte*) rowCopy, rowSize);
-
-        if (impl->doByteSwap)
-            sys::byteSwap((sys::byte*) rowCopy, impl->pixelSize
-                    / impl->numChannels, impl->numCols * impl->numChannels);
-
-        // And write it back
-        if (!nitf_IOInterface_write(io, (const sys::byte*) rowCopy, rowSize,
-                                    error))
-            goto CATCH_ERROR;
-    }
-    delete[] rowCopy;
-    return NITF_SUCCESS;
-
-    CATCH_ERROR: delete[] rowCopy;
-    return NITF_FAILURE;
+    StreamRowSource source(*impl->inputStream,
+                           impl->numCols,
+                           impl->numChannels,
+                           impl->pixelSize,
+                           impl->doByteSwap != 0);
+    return writeRows(source, impl->numRows, io, error);
 }
 
 StreamWriteHandler::StreamWriteHandler(const NITFSegmentInfo& info,
@@ -216,4 +581,66 @@ StreamWriteHandler::StreamWriteHandler(const NITFSegmentInfo& info,
     setManaged(false);
 }
 
+//
+// MeshWriteHandler
+//
+
+extern "C" void __six_MeshWriteHandler_destruct(NITF_DATA * )
+{
+    // The mesh belongs to the caller
+}
 
+extern "C" NITF_BOOL __six_MeshWriteHandler_write(NITF_DATA * data,
+        nitf_IOInterface* io, nitf_Error * error)
+{
+    const Mesh* const mesh = static_cast<const Mesh*>(data);
+
+    // Exceptions can't propagate back through NITRO
+    try
+    {
+        IOInterfaceOutputStream stream(io);
+        mesh->serialize(stream);
+        return NITF_SUCCESS;
+    }
+    catch (const except::Exception& ex)
+    {
+        nitf_Error_init(error, ex.getMessage().c_str(), NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    catch (const std::exception& ex)
+    {
+        nitf_Error_init(error, ex.what(), NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    catch (...)
+    {
+        nitf_Error_init(error, "Unknown exception", NITF_CTXT,
+                        NITF_ERR_WRITING_TO_FILE);
+    }
+    return NITF_FAILURE;
+}
+
+namespace
+{
+nitf_SegmentWriter* createMeshSegmentWriter(const Mesh& mesh)
+{
+    static nitf_IWriteHandler iWriteHandler =
+            { &__six_MeshWriteHandler_write,
+              &__six_MeshWriteHandler_destruct };
+
+    nitf_SegmentWriter *segmentWriter =
+            (nitf_SegmentWriter *) NITF_MALLOC(sizeof(nitf_SegmentWriter));
+    if (!segmentWriter)
+        throw nitf::NITFException(Ctxt("Out of memory"));
+
+    segmentWriter->data = const_cast<Mesh*>(&mesh);
+    segmentWriter->iface = &iWriteHandler;
+    return segmentWriter;
+}
+}
+
+MeshWriteHandler::MeshWriteHandler(const Mesh& mesh) :
+    nitf::SegmentWriter(createMeshSegmentWriter(mesh))
+{
+    setManaged(false);
+}
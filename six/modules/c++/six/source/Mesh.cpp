@@ -19,6 +19,7 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <except/Exception.h>
 #include <six/Mesh.h>
 
 namespace six
@@ -60,4 +61,20 @@ std::vector<six::Parameter> Mesh::fieldsToParameters() const
 
     return parameters;
 }
+
+void Mesh::serialize(io::OutputStream& stream) const
+{
+    std::vector<sys::byte> values;
+    serialize(values);
+    if (!values.empty())
+    {
+        stream.write(&values[0], values.size());
+    }
+}
+
+void Mesh::deserialize(io::InputStream& )
+{
+    throw except::NotImplementedException(Ctxt(
+            "Mesh '" + getName() + "' can't be deserialized from a stream"));
+}
 }
@@ -0,0 +1,134 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <mt/CriticalSection.h>
+#include "six/NITFBlockCache.h"
+
+namespace six
+{
+bool NITFBlockCache::Key::operator<(const Key& rhs) const
+{
+    if (segment != rhs.segment)
+    {
+        return segment < rhs.segment;
+    }
+    if (band != rhs.band)
+    {
+        return band < rhs.band;
+    }
+    return block < rhs.block;
+}
+
+NITFBlockCache::NITFBlockCache(size_t capacity) :
+    mCapacity(capacity),
+    mSize(0)
+{
+}
+
+size_t NITFBlockCache::getCapacity() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    return mCapacity;
+}
+
+void NITFBlockCache::setCapacity(size_t capacity)
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    mCapacity = capacity;
+    evict(capacity);
+}
+
+size_t NITFBlockCache::getSize() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    return mSize;
+}
+
+size_t NITFBlockCache::getNumBlocks() const
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    return mEntries.size();
+}
+
+mem::SharedPtr<const NITFBlockCache::Block>
+NITFBlockCache::get(const Key& key)
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+
+    const Entries::iterator entry = mEntries.find(key);
+    if (entry == mEntries.end())
+    {
+        return mem::SharedPtr<const Block>();
+    }
+
+    mOrder.splice(mOrder.begin(), mOrder, entry->second.position);
+    return entry->second.block;
+}
+
+void NITFBlockCache::put(const Key& key, mem::SharedPtr<const Block> block)
+{
+    const size_t blockSize = block.get() ? block->size() : 0;
+
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+
+    const Entries::iterator existing = mEntries.find(key);
+    if (existing != mEntries.end())
+    {
+        erase(existing);
+    }
+
+    if (!block.get() || blockSize > mCapacity)
+    {
+        return;
+    }
+
+    evict(mCapacity - blockSize);
+
+    mOrder.push_front(key);
+    Entry& entry = mEntries[key];
+    entry.block = block;
+    entry.position = mOrder.begin();
+    mSize += blockSize;
+}
+
+void NITFBlockCache::clear()
+{
+    mt::CriticalSection<sys::Mutex> lock(&mMutex);
+    mOrder.clear();
+    mEntries.clear();
+    mSize = 0;
+}
+
+void NITFBlockCache::evict(size_t capacity)
+{
+    while (mSize > capacity && !mOrder.empty())
+    {
+        erase(mEntries.find(mOrder.back()));
+    }
+}
+
+void NITFBlockCache::erase(Entries::iterator entry)
+{
+    mSize -= entry->second.block->size();
+    mOrder.erase(entry->second.position);
+    mEntries.erase(entry);
+}
+}
@@ -923,6 +923,30 @@ void NITFHeaderCreator::initialize(
 void NITFHeaderCreator::loadMeshSegment(const std::string& meshName,
                                         const std::vector<sys::byte>& meshBuffer,
                                         const six::Classification& classification)
+{
+    addMeshSegmentSubheader(meshName, classification);
+
+    // Add the data and writer for this segment
+    nitf::SegmentMemorySource dataSource(
+        meshBuffer.data(), meshBuffer.size(), 0, 0, true);
+    mem::SharedPtr<nitf::SegmentWriter> desWriter(
+        new nitf::SegmentWriter(dataSource));
+    addAdditionalDES(desWriter);
+}
+
+void NITFHeaderCreator::loadMeshSegment(const Mesh& mesh,
+                                        const six::Classification& classification)
+{
+    addMeshSegmentSubheader(mesh.getName(), classification);
+
+    // The mesh is serialized straight into the file when it's written
+    mem::SharedPtr<nitf::SegmentWriter> desWriter(new MeshWriteHandler(mesh));
+    addAdditionalDES(desWriter);
+}
+
+void NITFHeaderCreator::addMeshSegmentSubheader(
+        const std::string& meshName,
+        const six::Classification& classification)
 {
     nitf::Record& record = getRecord();
 
@@ -936,12 +960,5 @@ void NITFHeaderCreator::loadMeshSegment(const std::string& meshName,
     subheader.getSecurityClass().set(getNITFClassification(
                                         classification.getLevel()));
     subheader.setSecurityGroup(security.clone());
-
-    // Add the data and writer for this segment
-    nitf::SegmentMemorySource dataSource(
-        meshBuffer.data(), meshBuffer.size(), 0, 0, true);
-    mem::SharedPtr<nitf::SegmentWriter> desWriter(
-        new nitf::SegmentWriter(dataSource));
-    addAdditionalDES(desWriter);
 }
 }
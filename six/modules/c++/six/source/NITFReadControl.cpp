@@ -20,14 +20,83 @@
  *
  */
 
+#include <string.h>
+
+#include <algorithm>
 #include <sstream>
 
+#include <io/FileInputStream.h>
+#include <sys/File.h>
+#include <sys/OS.h>
+#include <sys/Runnable.h>
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
 #include <six/NITFReadControl.h>
 #include <six/XMLControlFactory.h>
 #include <six/Utilities.h>
 
 namespace
 {
+// Fixed field lengths from the NITF 2.1 / NSIF 1.0 file header and DES
+// subheader, used to find the first DES without parsing the whole Record
+const size_t FHDR_FVER_LENGTH = 9;
+const size_t HL_OFFSET = 354;
+const size_t HL_LENGTH = 6;
+const size_t NUMI_OFFSET = 360;
+const size_t DESID_OFFSET = 2;
+const size_t DESID_LENGTH = 25;
+const size_t DESOFLW_DESITEM_LENGTH = 9;
+const size_t DESSHL_OFFSET = 196;
+const size_t DESSHL_LENGTH = 4;
+const size_t DESSHSI_OFFSET = 73;
+const size_t DESSHSI_LENGTH = 60;
+
+// Reads a fixed width numeric field, advancing 'offset' past it
+size_t readNumber(const std::string& buffer, size_t length, size_t& offset)
+{
+    if (offset + length > buffer.length())
+    {
+        throw except::Exception(Ctxt("NITF header is truncated"));
+    }
+
+    const size_t value = str::toType<size_t>(buffer.substr(offset, length));
+    offset += length;
+    return value;
+}
+
+// Sums the subheader and data lengths of a segment group in the file header
+size_t readSegmentLengths(const std::string& header,
+                          size_t subheaderLengthLength,
+                          size_t dataLengthLength,
+                          size_t& offset)
+{
+    const size_t numSegments = readNumber(header, 3, offset);
+    size_t total = 0;
+    for (size_t ii = 0; ii < numSegments; ++ii)
+    {
+        total += readNumber(header, subheaderLengthLength, offset);
+        total += readNumber(header, dataLengthLength, offset);
+    }
+    return total;
+}
+
+std::string readString(io::SeekableInputStream& inStream, size_t length)
+{
+    std::string buffer(length, ' ');
+    if (length > 0)
+    {
+        inStream.read(&buffer[0], length, true);
+    }
+    return buffer;
+}
+
+std::string trimmed(const std::string& buffer, size_t offset, size_t length)
+{
+    std::string field = buffer.substr(offset, length);
+    str::trim(field);
+    return field;
+}
+
 types::RowCol<size_t> parseILOC(const std::string& str)
 {
     // First 5 digits are the row
@@ -77,10 +146,687 @@ six::PixelType getPixelType(nitf::ImageSubheader& subheader)
                 "Unexpected image representation '" + iRep + "'"));
     }
 }
+
+// Fills in the dimensions of a region left as -1 (the whole image) and
+// makes sure the region is inside the image
+void resolveRegion(six::Region& region,
+                   size_t numRowsTotal,
+                   size_t numColsTotal)
+{
+    if (region.getNumRows() == -1)
+    {
+        region.setNumRows(numRowsTotal);
+    }
+    if (region.getNumCols() == -1)
+    {
+        region.setNumCols(numColsTotal);
+    }
+
+    const size_t numRowsReq = region.getNumRows();
+    const size_t numColsReq = region.getNumCols();
+
+    const size_t startRow = region.getStartRow();
+    const size_t startCol = region.getStartCol();
+
+    const size_t extentRows = startRow + numRowsReq;
+    const size_t extentCols = startCol + numColsReq;
+
+    if (extentRows > numRowsTotal || startRow > numRowsTotal)
+        throw except::Exception(Ctxt(FmtX("Too many rows requested [%d]",
+                                          numRowsReq)));
+
+    if (extentCols > numColsTotal || startCol > numColsTotal)
+        throw except::Exception(Ctxt(FmtX("Too many cols requested [%d]",
+                                          numColsReq)));
+}
+
+// The portion of a region read that lands in a single image segment
+struct SegmentRead
+{
+    //! NITF image segment index
+    size_t segmentIndex;
+
+    //! First row to read, relative to the start of the segment
+    size_t startRow;
+
+    size_t numRows;
+
+    //! Byte offset into the output buffer
+    size_t bufferOffset;
+
+    //! Number of rows in the whole segment
+    size_t numSegmentRows;
+};
+
+// Where readSegments() keeps the blocks it reads, if anywhere
+struct BlockCacheParams
+{
+    BlockCacheParams() :
+        cache(NULL),
+        numCols(0),
+        numBytesPerPixel(0)
+    {
+    }
+
+    six::NITFBlockCache* cache;
+
+    //! Number of columns in each segment
+    size_t numCols;
+
+    size_t numBytesPerPixel;
+};
+
+// Determines which pieces of which image segments the global rows
+// [startRow, startRow + numRows) live in
+void getSegmentReads(const std::vector<six::NITFSegmentInfo>& imageSegments,
+                     size_t startIndex,
+                     size_t regionStartRow,
+                     size_t startRow,
+                     size_t numRows,
+                     size_t numBytesPerRow,
+                     std::vector<SegmentRead>& reads)
+{
+    reads.clear();
+    for (size_t ii = 0; ii < imageSegments.size(); ++ii)
+    {
+        size_t firstGlobalRow;
+        size_t numRowsInSegment;
+        if (imageSegments[ii].isInRange(startRow, numRows,
+                                        firstGlobalRow, numRowsInSegment))
+        {
+            SegmentRead read;
+            read.segmentIndex = startIndex + ii;
+            read.startRow = firstGlobalRow - imageSegments[ii].firstRow;
+            read.numRows = numRowsInSegment;
+            read.bufferOffset =
+                    (firstGlobalRow - regionStartRow) * numBytesPerRow;
+            read.numSegmentRows = imageSegments[ii].numRows;
+            reads.push_back(read);
+        }
+    }
+}
+
+// Reads the columns [startCol, startCol + numCols) of a segment read a block
+// at a time, taking the blocks from the cache when they're there and adding
+// them when they're not.  Returns false, having read nothing, if the segment
+// isn't blocked or its blocks are too big to cache.
+bool readCachedBlocks(nitf::ImageReader& imageReader,
+                      const SegmentRead& read,
+                      size_t startCol,
+                      size_t numCols,
+                      const BlockCacheParams& cacheParams,
+                      nitf::Uint8* buffer)
+{
+    nitf::BlockingInfo blocking = imageReader.getBlockingInfo();
+    const size_t numBlocksPerRow = blocking.getNumBlocksPerRow();
+    const size_t numRowsPerBlock = blocking.getNumRowsPerBlock();
+    const size_t numColsPerBlock = blocking.getNumColsPerBlock();
+    const size_t numBytesPerPixel = cacheParams.numBytesPerPixel;
+    if (numBlocksPerRow * blocking.getNumBlocksPerCol() < 2 ||
+        numRowsPerBlock * numColsPerBlock * numBytesPerPixel >
+                cacheParams.cache->getCapacity())
+    {
+        return false;
+    }
+
+    nitf::Uint32 bandList(0);
+    nitf::SubWindow sw;
+    sw.setNumBands(1);
+    sw.setBandList(&bandList);
+
+    const size_t endRow = read.startRow + read.numRows;
+    const size_t endCol = startCol + numCols;
+    const size_t numBytesPerRow = numCols * numBytesPerPixel;
+    for (size_t blockRow = read.startRow / numRowsPerBlock;
+         blockRow * numRowsPerBlock < endRow;
+         ++blockRow)
+    {
+        const size_t firstRow = blockRow * numRowsPerBlock;
+        const size_t numBlockRows =
+                std::min(numRowsPerBlock, read.numSegmentRows - firstRow);
+        const size_t rowBegin = std::max(firstRow, read.startRow);
+        const size_t rowEnd = std::min(firstRow + numBlockRows, endRow);
+
+        for (size_t blockCol = startCol / numColsPerBlock;
+             blockCol * numColsPerBlock < endCol;
+             ++blockCol)
+        {
+            const size_t firstCol = blockCol * numColsPerBlock;
+            const size_t numBlockCols =
+                    std::min(numColsPerBlock, cacheParams.numCols - firstCol);
+
+            // Blocks are stored without their padding
+            const six::NITFBlockCache::Key key(
+                    read.segmentIndex, 0,
+                    blockRow * numBlocksPerRow + blockCol);
+            mem::SharedPtr<const six::NITFBlockCache::Block> block =
+                    cacheParams.cache->get(key);
+            if (!block.get())
+            {
+                std::auto_ptr<six::NITFBlockCache::Block> newBlock(
+                        new six::NITFBlockCache::Block(
+                                numBlockRows * numBlockCols *
+                                numBytesPerPixel));
+
+                sw.setStartRow(static_cast<nitf::Uint32>(firstRow));
+                sw.setNumRows(static_cast<nitf::Uint32>(numBlockRows));
+                sw.setStartCol(static_cast<nitf::Uint32>(firstCol));
+                sw.setNumCols(static_cast<nitf::Uint32>(numBlockCols));
+                nitf::Uint8* blockPtr = &(*newBlock)[0];
+                int padded;
+                imageReader.read(sw, &blockPtr, &padded);
+
+                block = mem::SharedPtr<const six::NITFBlockCache::Block>(
+                        newBlock.release());
+                cacheParams.cache->put(key, block);
+            }
+
+            const size_t colBegin = std::max(firstCol, startCol);
+            const size_t colEnd = std::min(firstCol + numBlockCols, endCol);
+            for (size_t row = rowBegin; row < rowEnd; ++row)
+            {
+                ::memcpy(buffer + (row - read.startRow) * numBytesPerRow +
+                                 (colBegin - startCol) * numBytesPerPixel,
+                         &(*block)[((row - firstRow) * numBlockCols +
+                                    colBegin - firstCol) * numBytesPerPixel],
+                         (colEnd - colBegin) * numBytesPerPixel);
+            }
+        }
+    }
+
+    return true;
+}
+
+void readSegments(nitf::Reader& reader,
+                  const std::vector<SegmentRead>& reads,
+                  size_t startCol,
+                  size_t numCols,
+                  std::map<std::string, void*>& compressionOptions,
+                  const BlockCacheParams& cacheParams,
+                  nitf::Uint8* buffer)
+{
+    nitf::Uint32 bandList(0);
+
+    nitf::SubWindow sw;
+    sw.setStartCol(static_cast<nitf::Uint32>(startCol));
+    sw.setNumCols(static_cast<nitf::Uint32>(numCols));
+    sw.setNumBands(1);
+    sw.setBandList(&bandList);
+
+    for (size_t ii = 0; ii < reads.size(); ++ii)
+    {
+        const SegmentRead& read(reads[ii]);
+        sw.setStartRow(static_cast<nitf::Uint32>(read.startRow));
+        sw.setNumRows(static_cast<nitf::Uint32>(read.numRows));
+
+        nitf::ImageReader imageReader = reader.newImageReader(
+                static_cast<int>(read.segmentIndex),
+                compressionOptions);
+
+        nitf::Uint8* bufferPtr = buffer + read.bufferOffset;
+        if (cacheParams.cache &&
+            readCachedBlocks(imageReader, read, startCol, numCols,
+                             cacheParams, bufferPtr))
+        {
+            continue;
+        }
+
+        int padded;
+        imageReader.read(sw, &bufferPtr, &padded);
+    }
+}
+
+// Reads its share of the segment pieces through its own Reader so that no
+// seek position is shared with the other threads
+class ReadSegmentsRunnable : public sys::Runnable
+{
+public:
+    ReadSegmentsRunnable(nitf::Reader& reader,
+                         const std::vector<SegmentRead>& reads,
+                         size_t startCol,
+                         size_t numCols,
+                         const std::map<std::string, void*>& compressionOptions,
+                         const BlockCacheParams& cacheParams,
+                         nitf::Uint8* buffer) :
+        mReader(reader),
+        mReads(reads),
+        mStartCol(startCol),
+        mNumCols(numCols),
+        mCompressionOptions(compressionOptions),
+        mCacheParams(cacheParams),
+        mBuffer(buffer)
+    {
+    }
+
+    virtual void run()
+    {
+        readSegments(mReader, mReads, mStartCol, mNumCols,
+                     mCompressionOptions, mCacheParams, mBuffer);
+    }
+
+private:
+    nitf::Reader& mReader;
+    const std::vector<SegmentRead> mReads;
+    const size_t mStartCol;
+    const size_t mNumCols;
+    std::map<std::string, void*> mCompressionOptions;
+    const BlockCacheParams mCacheParams;
+    nitf::Uint8* const mBuffer;
+};
+
+// Where a segment's pixels are in the file, for reading them raw
+struct RawSegment
+{
+    //! File offset of the segment's first pixel
+    sys::Off_T offset;
+
+    //! Number of bytes from the start of one row to the start of the next
+    size_t rowStride;
+};
+
+// Finds where the pixels of each of an image's segments are in the file.
+// Returns false if any of them can't be read raw.
+bool getRawSegments(nitf::Record record,
+                    const six::NITFImageInfo& info,
+                    std::vector<RawSegment>& segments)
+{
+    segments.clear();
+    const size_t numBytesPerPixel = info.getData()->getNumBytesPerPixel();
+    const size_t numSegments = info.getImageSegments().size();
+    nitf::List images = record.getImages();
+    for (size_t ii = 0; ii < numSegments; ++ii)
+    {
+        nitf::ImageSegment segment = images[info.getStartIndex() + ii];
+        nitf::ImageSubheader subheader = segment.getSubheader();
+
+        std::string compression = subheader.getImageCompression().toString();
+        str::trim(compression);
+        const size_t numBands = subheader.getBandCount();
+        const size_t numBitsPerPixel =
+                static_cast<nitf::Uint32>(subheader.getNumBitsPerPixel());
+        if (compression != "NC" ||
+            static_cast<nitf::Uint32>(subheader.getNumBlocksPerRow()) != 1 ||
+            static_cast<nitf::Uint32>(subheader.getNumBlocksPerCol()) != 1 ||
+            (numBands > 1 &&
+             subheader.getImageMode().toString() != "P") ||
+            numBitsPerPixel % 8 != 0 ||
+            numBitsPerPixel / 8 * numBands != numBytesPerPixel)
+        {
+            return false;
+        }
+
+        // The single block may be padded out past the last column
+        RawSegment rawSegment;
+        rawSegment.offset = segment.getImageOffset();
+        const size_t numCols =
+                static_cast<nitf::Uint32>(subheader.getNumCols());
+        const size_t numColsPerBlock = static_cast<nitf::Uint32>(
+                subheader.getNumPixelsPerHorizBlock());
+        rawSegment.rowStride =
+                std::max(numCols, numColsPerBlock) * numBytesPerPixel;
+        segments.push_back(rawSegment);
+    }
+    return true;
+}
+
+// Reads the columns [startCol, startCol + numCols) of segment reads
+// straight from the file.  Rows that are contiguous in the file are read
+// all at once.
+void readRawSegments(sys::File& file,
+                     const std::vector<SegmentRead>& reads,
+                     const std::vector<RawSegment>& segments,
+                     size_t startIndex,
+                     size_t startCol,
+                     size_t numCols,
+                     size_t numBytesPerPixel,
+                     nitf::Uint8* buffer)
+{
+    const size_t numBytesPerRow = numCols * numBytesPerPixel;
+    for (size_t ii = 0; ii < reads.size(); ++ii)
+    {
+        const SegmentRead& read = reads[ii];
+        const RawSegment& segment = segments[read.segmentIndex - startIndex];
+
+        sys::Off_T offset = segment.offset +
+                static_cast<sys::Off_T>(read.startRow) * segment.rowStride +
+                startCol * numBytesPerPixel;
+        nitf::Uint8* bufferPtr = buffer + read.bufferOffset;
+
+        if (numBytesPerRow == segment.rowStride)
+        {
+            file.seekTo(offset, sys::File::FROM_START);
+            file.readInto(bufferPtr, read.numRows * numBytesPerRow);
+            continue;
+        }
+
+        for (size_t row = 0;
+             row < read.numRows;
+             ++row, offset += segment.rowStride, bufferPtr += numBytesPerRow)
+        {
+            file.seekTo(offset, sys::File::FROM_START);
+            file.readInto(bufferPtr, numBytesPerRow);
+        }
+    }
+}
+
+// Reads its share of the segment pieces raw through its own file handle
+class ReadRawSegmentsRunnable : public sys::Runnable
+{
+public:
+    ReadRawSegmentsRunnable(const std::string& pathname,
+                            const std::vector<SegmentRead>& reads,
+                            const std::vector<RawSegment>& segments,
+                            size_t startIndex,
+                            size_t startCol,
+                            size_t numCols,
+                            size_t numBytesPerPixel,
+                            nitf::Uint8* buffer) :
+        mPathname(pathname),
+        mReads(reads),
+        mSegments(segments),
+        mStartIndex(startIndex),
+        mStartCol(startCol),
+        mNumCols(numCols),
+        mNumBytesPerPixel(numBytesPerPixel),
+        mBuffer(buffer)
+    {
+    }
+
+    virtual void run()
+    {
+        sys::File file(mPathname);
+        readRawSegments(file, mReads, mSegments, mStartIndex, mStartCol,
+                        mNumCols, mNumBytesPerPixel, mBuffer);
+    }
+
+private:
+    const std::string mPathname;
+    const std::vector<SegmentRead> mReads;
+    const std::vector<RawSegment> mSegments;
+    const size_t mStartIndex;
+    const size_t mStartCol;
+    const size_t mNumCols;
+    const size_t mNumBytesPerPixel;
+    nitf::Uint8* const mBuffer;
+};
+
+// Bounds the full resolution rows staged at once for a decimated read
+const size_t DECIMATION_SCRATCH_SIZE = 16 * 1024 * 1024;
+
+// The full resolution window of a decimated read and how to reduce it
+struct DecimatedRead
+{
+    size_t startRow;
+    size_t startCol;
+    size_t numRows;
+    size_t numCols;
+    size_t rowDecimation;
+    size_t colDecimation;
+    six::Region::DownsampleMethod method;
+    six::PixelType pixelType;
+    size_t numBytesPerPixel;
+
+    size_t getNumOutputCols() const
+    {
+        return (numCols + colDecimation - 1) / colDecimation;
+    }
+};
+
+// Orders pixels by magnitude.  The NITF reader has already swapped pixels
+// to native byte order.
+template <typename T>
+struct ComplexMagnitude
+{
+    double operator()(const nitf::Uint8* pixel) const
+    {
+        T iq[2];
+        ::memcpy(iq, pixel, sizeof(iq));
+        const double i = iq[0];
+        const double q = iq[1];
+        return i * i + q * q;
+    }
+};
+
+template <typename T>
+struct RealMagnitude
+{
+    double operator()(const nitf::Uint8* pixel) const
+    {
+        T value;
+        ::memcpy(&value, pixel, sizeof(value));
+        return value;
+    }
+};
+
+// AMP8I_PHS8I isn't supported: ordering those by magnitude would need the
+// SICD's amplitude table, which isn't required to be monotonic
+bool supportsMaxMagnitude(six::PixelType pixelType)
+{
+    return pixelType == six::PixelType::RE32F_IM32F ||
+           pixelType == six::PixelType::RE16I_IM16I ||
+           pixelType == six::PixelType::MONO8I ||
+           pixelType == six::PixelType::MONO16I;
+}
+
+// Keeps the first pixel of every decimation window in a row
+void skipPixels(const nitf::Uint8* input,
+                const DecimatedRead& params,
+                nitf::Uint8* output)
+{
+    const size_t numOutputCols = params.getNumOutputCols();
+    const size_t inputStride = params.colDecimation * params.numBytesPerPixel;
+    for (size_t col = 0;
+         col < numOutputCols;
+         ++col, input += inputStride, output += params.numBytesPerPixel)
+    {
+        ::memcpy(output, input, params.numBytesPerPixel);
+    }
+}
+
+// Keeps the largest magnitude pixel of every decimation window spanning
+// 'numRows' rows of 'input'
+template <typename MagnitudeT>
+void keepMaxMagnitude(const nitf::Uint8* input,
+                      size_t numRows,
+                      const DecimatedRead& params,
+                      nitf::Uint8* output)
+{
+    const MagnitudeT magnitude;
+    const size_t numOutputCols = params.getNumOutputCols();
+    const size_t numBytesPerRow = params.numCols * params.numBytesPerPixel;
+    for (size_t outCol = 0;
+         outCol < numOutputCols;
+         ++outCol, output += params.numBytesPerPixel)
+    {
+        const size_t startCol = outCol * params.colDecimation;
+        const size_t endCol =
+                std::min(startCol + params.colDecimation, params.numCols);
+
+        const nitf::Uint8* best = input + startCol * params.numBytesPerPixel;
+        double bestMagnitude = magnitude(best);
+        for (size_t row = 0; row < numRows; ++row)
+        {
+            const nitf::Uint8* pixel = input + row * numBytesPerRow +
+                    startCol * params.numBytesPerPixel;
+            for (size_t col = startCol;
+                 col < endCol;
+                 ++col, pixel += params.numBytesPerPixel)
+            {
+                const double pixelMagnitude = magnitude(pixel);
+                if (pixelMagnitude > bestMagnitude)
+                {
+                    best = pixel;
+                    bestMagnitude = pixelMagnitude;
+                }
+            }
+        }
+        ::memcpy(output, best, params.numBytesPerPixel);
+    }
+}
+
+void keepMaxMagnitude(const nitf::Uint8* input,
+                      size_t numRows,
+                      const DecimatedRead& params,
+                      nitf::Uint8* output)
+{
+    if (params.pixelType == six::PixelType::RE32F_IM32F)
+    {
+        keepMaxMagnitude<ComplexMagnitude<float> >(
+                input, numRows, params, output);
+    }
+    else if (params.pixelType == six::PixelType::RE16I_IM16I)
+    {
+        keepMaxMagnitude<ComplexMagnitude<sys::Int16_T> >(
+                input, numRows, params, output);
+    }
+    else if (params.pixelType == six::PixelType::MONO16I)
+    {
+        keepMaxMagnitude<RealMagnitude<sys::Uint16_T> >(
+                input, numRows, params, output);
+    }
+    else
+    {
+        keepMaxMagnitude<RealMagnitude<sys::Uint8_T> >(
+                input, numRows, params, output);
+    }
+}
+
+// Reads and reduces output rows [firstOutputRow,
+// firstOutputRow + numOutputRows) of a decimated region.  The full
+// resolution rows are read in contiguous blocks through a bounded scratch
+// buffer and reduced in memory.
+void readDecimated(nitf::Reader& reader,
+                   const std::vector<six::NITFSegmentInfo>& imageSegments,
+                   size_t startIndex,
+                   const DecimatedRead& params,
+                   size_t firstOutputRow,
+                   size_t numOutputRows,
+                   std::map<std::string, void*>& compressionOptions,
+                   const BlockCacheParams& cacheParams,
+                   nitf::Uint8* buffer)
+{
+    if (numOutputRows == 0)
+    {
+        return;
+    }
+
+    const size_t numBytesPerRow = params.numCols * params.numBytesPerPixel;
+    const size_t numBytesPerOutputRow =
+            params.getNumOutputCols() * params.numBytesPerPixel;
+    const size_t endRow = params.startRow + params.numRows;
+
+    // Pixel skipping only keeps the first row of each window, but reading
+    // the rows in between as part of one block is cheaper than a read per
+    // output row.  With decimation too coarse for a block to hold more than
+    // one output row, this reads just the rows that are kept.
+    const size_t numRowsPerWindow =
+            (params.method == six::Region::PIXEL_SKIP) ?
+                    1 : params.rowDecimation;
+    const size_t numOutputRowsPerRead =
+            std::max<size_t>(DECIMATION_SCRATCH_SIZE /
+                    (params.rowDecimation * numBytesPerRow), 1);
+
+    std::vector<nitf::Uint8> scratch(
+            ((std::min(numOutputRowsPerRead, numOutputRows) - 1) *
+                    params.rowDecimation + numRowsPerWindow) *
+            numBytesPerRow);
+    std::vector<SegmentRead> reads;
+
+    const size_t endOutputRow = firstOutputRow + numOutputRows;
+    for (size_t outRow = firstOutputRow, numOutputRowsThisRead = 0;
+         outRow < endOutputRow;
+         outRow += numOutputRowsThisRead)
+    {
+        numOutputRowsThisRead =
+                std::min(numOutputRowsPerRead, endOutputRow - outRow);
+
+        const size_t row = params.startRow + outRow * params.rowDecimation;
+        const size_t numRows = std::min(
+                (numOutputRowsThisRead - 1) * params.rowDecimation +
+                        numRowsPerWindow,
+                endRow - row);
+
+        getSegmentReads(imageSegments, startIndex, row, row, numRows,
+                        numBytesPerRow, reads);
+        readSegments(reader, reads, params.startCol, params.numCols,
+                     compressionOptions, cacheParams, &scratch[0]);
+
+        for (size_t ii = 0; ii < numOutputRowsThisRead; ++ii)
+        {
+            const size_t windowRow = ii * params.rowDecimation;
+            const nitf::Uint8* const input =
+                    &scratch[0] + windowRow * numBytesPerRow;
+            nitf::Uint8* const output =
+                    buffer + (outRow + ii) * numBytesPerOutputRow;
+
+            if (params.method == six::Region::PIXEL_SKIP)
+            {
+                skipPixels(input, params, output);
+            }
+            else
+            {
+                keepMaxMagnitude(input,
+                                 std::min(numRowsPerWindow,
+                                          numRows - windowRow),
+                                 params,
+                                 output);
+            }
+        }
+    }
+}
+
+// Reads its share of the output rows of a decimated region through its own
+// Reader
+class ReadDecimatedRunnable : public sys::Runnable
+{
+public:
+    ReadDecimatedRunnable(
+            nitf::Reader& reader,
+            const std::vector<six::NITFSegmentInfo>& imageSegments,
+            size_t startIndex,
+            const DecimatedRead& params,
+            size_t firstOutputRow,
+            size_t numOutputRows,
+            const std::map<std::string, void*>& compressionOptions,
+            const BlockCacheParams& cacheParams,
+            nitf::Uint8* buffer) :
+        mReader(reader),
+        mImageSegments(imageSegments),
+        mStartIndex(startIndex),
+        mParams(params),
+        mFirstOutputRow(firstOutputRow),
+        mNumOutputRows(numOutputRows),
+        mCompressionOptions(compressionOptions),
+        mCacheParams(cacheParams),
+        mBuffer(buffer)
+    {
+    }
+
+    virtual void run()
+    {
+        readDecimated(mReader, mImageSegments, mStartIndex, mParams,
+                      mFirstOutputRow, mNumOutputRows, mCompressionOptions,
+                      mCacheParams, mBuffer);
+    }
+
+private:
+    nitf::Reader& mReader;
+    const std::vector<six::NITFSegmentInfo> mImageSegments;
+    const size_t mStartIndex;
+    const DecimatedRead mParams;
+    const size_t mFirstOutputRow;
+    const size_t mNumOutputRows;
+    std::map<std::string, void*> mCompressionOptions;
+    const BlockCacheParams mCacheParams;
+    nitf::Uint8* const mBuffer;
+};
 }
 
 namespace six
 {
+const char NITFReadControl::OPT_NUM_READ_THREADS[] = "NumReadThreads";
+const char NITFReadControl::OPT_BLOCK_CACHE_SIZE[] = "BlockCacheSize";
+
 NITFReadControl::NITFReadControl()
 {
     // Make sure that if we use XML_DATA_CONTENT that we've loaded it into the
@@ -178,19 +924,111 @@ DataType NITFReadControl::getDataType(nitf::DESegment& segment)
 
 DataType NITFReadControl::getDataType(const std::string& fromFile) const
 {
-    // Could cache this
-    if (mReader.getNITFVersion(fromFile) != NITF_VER_UNKNOWN)
+    return sniffDataType(fromFile);
+}
+
+DataType NITFReadControl::sniffDataType(const std::string& fromFile)
+{
+    if (!sys::OS().isFile(fromFile))
     {
-        nitf::IOHandle inFile(fromFile);
-        nitf::Record record = mReader.read(inFile);
+        return DataType::NOT_SET;
+    }
 
+    io::FileInputStream inStream(fromFile);
+    if (inStream.available() < static_cast<sys::Off_T>(NUMI_OFFSET))
+    {
+        return DataType::NOT_SET;
+    }
+
+    const std::string version = readString(inStream, FHDR_FVER_LENGTH);
+    if (version != "NITF02.10" && version != "NSIF01.00")
+    {
+        inStream.close();
+
+        // NITF 2.0 lays out its security fields differently, so let NITRO
+        // deal with it
+        nitf::Reader reader;
+        if (reader.getNITFVersion(fromFile) == NITF_VER_UNKNOWN)
+        {
+            return DataType::NOT_SET;
+        }
+        nitf::IOHandle inFile(fromFile);
+        nitf::Record record = reader.read(inFile);
         return getDataType(record);
     }
-    else
+
+    // The header length is fixed up through HL.  Read that far, then the
+    // rest of the header which holds the segment lengths.
+    std::string header =
+            version + readString(inStream, NUMI_OFFSET - FHDR_FVER_LENGTH);
+    size_t offset = HL_OFFSET;
+    const size_t headerLength = readNumber(header, HL_LENGTH, offset);
+    if (headerLength < NUMI_OFFSET)
+    {
+        throw except::Exception(Ctxt("Invalid NITF header length"));
+    }
+    header += readString(inStream, headerLength - NUMI_OFFSET);
+
+    // Skip the image, graphic, reserved, and text segments to get to the
+    // first DES
+    offset = NUMI_OFFSET;
+    size_t desOffset = headerLength;
+    desOffset += readSegmentLengths(header, 6, 10, offset);
+    desOffset += readSegmentLengths(header, 4, 6, offset);
+    readNumber(header, 3, offset);
+    desOffset += readSegmentLengths(header, 4, 5, offset);
+
+    const size_t numDES = readNumber(header, 3, offset);
+    if (numDES == 0)
     {
         return DataType::NOT_SET;
     }
+    const size_t desSubheaderLength = readNumber(header, 4, offset);
+
+    // Only the subheader of the first DES is needed (see
+    // getDataType(nitf::Record&))
+    inStream.seek(desOffset, io::Seekable::START);
+    const std::string subheader = readString(inStream, desSubheaderLength);
+
+    const std::string desid =
+            trimmed(subheader, DESID_OFFSET, DESID_LENGTH);
+    offset = DESSHL_OFFSET;
+    if (desid == "TRE_OVERFLOW")
+    {
+        offset += DESOFLW_DESITEM_LENGTH;
+    }
+    const size_t subheaderFieldsOffset = offset + DESSHL_LENGTH;
+    const size_t subheaderFieldsLength =
+            readNumber(subheader, DESSHL_LENGTH, offset);
+
+    // NITRO names the TRE holding the subheader fields after the DESID
+    std::string desshsiField;
+    if (subheaderFieldsLength >= DESSHSI_OFFSET + DESSHSI_LENGTH &&
+        subheaderFieldsOffset + DESSHSI_OFFSET + DESSHSI_LENGTH <=
+                subheader.length())
+    {
+        desshsiField = trimmed(subheader,
+                               subheaderFieldsOffset + DESSHSI_OFFSET,
+                               DESSHSI_LENGTH);
+    }
 
+    return getDataType(desid, subheaderFieldsLength, desshsiField,
+                       subheaderFieldsLength != 0 ? desid : "");
+}
+
+DataType NITFReadControl::identify(const std::string& fromFile)
+{
+    reset();
+
+    mem::SharedPtr<nitf::IOInterface> handle(new nitf::IOHandle(fromFile));
+    mRecord = mReader.readIO(*handle);
+    const DataType dataType = getDataType(mRecord);
+    if (dataType != DataType::NOT_SET)
+    {
+        mIdentifiedInterface = handle;
+        mIdentifiedFilename = fromFile;
+    }
+    return dataType;
 }
 
 void NITFReadControl::validateSegment(nitf::ImageSubheader subheader,
@@ -240,8 +1078,21 @@ void NITFReadControl::validateSegment(nitf::ImageSubheader subheader,
 void NITFReadControl::load(const std::string& fromFile,
                            const std::vector<std::string>& schemaPaths)
 {
-    mem::SharedPtr<nitf::IOInterface> handle(new nitf::IOHandle(fromFile));
-    load(handle, schemaPaths);
+    if (!mIdentifiedFilename.empty() && mIdentifiedFilename == fromFile)
+    {
+        // identify() already parsed the Record - pick up where it left off
+        const mem::SharedPtr<nitf::IOInterface> handle(mIdentifiedInterface);
+        reset();
+        mInterface = handle;
+        loadRecord(schemaPaths);
+    }
+    else
+    {
+        mem::SharedPtr<nitf::IOInterface> handle(
+                new nitf::IOHandle(fromFile));
+        load(handle, schemaPaths);
+    }
+    mFilename = fromFile;
 }
 
 void NITFReadControl::load(io::SeekableInputStream& stream,
@@ -263,6 +1114,11 @@ void NITFReadControl::load(mem::SharedPtr<nitf::IOInterface> ioInterface,
     mInterface = ioInterface;
 
     mRecord = mReader.readIO(*ioInterface);
+    loadRecord(schemaPaths);
+}
+
+void NITFReadControl::loadRecord(const std::vector<std::string>& schemaPaths)
+{
     DataType dataType = getDataType(mRecord);
     mContainer.reset(new Container(dataType));
 
@@ -590,21 +1446,32 @@ NITFReadControl::getIndices(nitf::ImageSubheader& subheader) const
     return imageAndSegment;
 }
 
+NITFBlockCache* NITFReadControl::updateBlockCache()
+{
+    const size_t capacity = mOptions.getParameter(
+            OPT_BLOCK_CACHE_SIZE, Parameter(0));
+    if (capacity == 0)
+    {
+        mBlockCache.reset();
+    }
+    else if (mBlockCache.get())
+    {
+        mBlockCache->setCapacity(capacity);
+    }
+    else
+    {
+        mBlockCache.reset(new NITFBlockCache(capacity));
+    }
+    return mBlockCache.get();
+}
+
 UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
 {
     NITFImageInfo* thisImage = mInfos[imageNumber];
 
     size_t numRowsTotal = thisImage->getData()->getNumRows();
     size_t numColsTotal = thisImage->getData()->getNumCols();
-
-    if (region.getNumRows() == -1)
-    {
-        region.setNumRows(numRowsTotal);
-    }
-    if (region.getNumCols() == -1)
-    {
-        region.setNumCols(numColsTotal);
-    }
+    resolveRegion(region, numRowsTotal, numColsTotal);
 
     size_t numRowsReq = region.getNumRows();
     size_t numColsReq = region.getNumCols();
@@ -612,24 +1479,27 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
     size_t startRow = region.getStartRow();
     size_t startCol = region.getStartCol();
 
-    size_t extentRows = startRow + numRowsReq;
-    size_t extentCols = startCol + numColsReq;
-
-    if (extentRows > numRowsTotal || startRow > numRowsTotal)
-        throw except::Exception(Ctxt(FmtX("Too many rows requested [%d]",
-                                          numRowsReq)));
-
-    if (extentCols > numColsTotal || startCol > numColsTotal)
-        throw except::Exception(Ctxt(FmtX("Too many cols requested [%d]",
-                                          numColsReq)));
+    if (region.getRowDecimation() == 0 || region.getColDecimation() == 0)
+    {
+        throw except::Exception(Ctxt("Decimation factors must be positive"));
+    }
 
-    // Allocate one band
-    nitf::Uint32 bandList(0);
+    const PixelType pixelType = thisImage->getData()->getPixelType();
+    if (region.isDecimated() &&
+        region.getDownsampleMethod() == Region::MAX_MAGNITUDE &&
+        !supportsMaxMagnitude(pixelType))
+    {
+        throw except::Exception(Ctxt(
+                "Max magnitude downsampling is not supported for pixel "
+                "type " + pixelType.toString()));
+    }
 
     nitf::Uint8* buffer = region.getBuffer();
 
-    size_t subWindowSize = numRowsReq * numColsReq
-            * thisImage->getData()->getNumBytesPerPixel();
+    const size_t numBytesPerPixel =
+            thisImage->getData()->getNumBytesPerPixel();
+    size_t subWindowSize = region.getNumDecimatedRows() *
+            region.getNumDecimatedCols() * numBytesPerPixel;
 
     if (buffer == NULL)
     {
@@ -637,66 +1507,202 @@ UByte* NITFReadControl::interleaved(Region& region, size_t imageNumber)
         region.setBuffer(buffer);
     }
 
-    // Do segmenting here
-    nitf::SubWindow sw;
-    sw.setStartCol(static_cast<nitf::Uint32>(startCol));
-    sw.setNumCols(static_cast<nitf::Uint32>(numColsReq));
-    sw.setNumBands(1);
-    sw.setBandList(&bandList);
-
-    std::vector < NITFSegmentInfo > imageSegments
+    const size_t numBytesPerRow = numColsReq * numBytesPerPixel;
+    const std::vector<NITFSegmentInfo> imageSegments
             = thisImage->getImageSegments();
-    size_t numIS = imageSegments.size();
-    size_t startOff = 0;
+    const size_t startIndex = thisImage->getStartIndex();
+    createCompressionOptions(mCompressionOptions);
 
-    size_t i;
-    for (i = 0; i < numIS; i++)
-    {
-        size_t firstRowSeg = imageSegments[i].firstRow;
+    const size_t numThreads = mOptions.getParameter(
+            OPT_NUM_READ_THREADS, Parameter(1));
+
+    BlockCacheParams cacheParams;
+    cacheParams.cache = updateBlockCache();
+    cacheParams.numCols = numColsTotal;
+    cacheParams.numBytesPerPixel = numBytesPerPixel;
 
-        if (firstRowSeg <= startRow)
+    if (region.isDecimated())
+    {
+        DecimatedRead params;
+        params.startRow = startRow;
+        params.startCol = startCol;
+        params.numRows = numRowsReq;
+        params.numCols = numColsReq;
+        params.rowDecimation = region.getRowDecimation();
+        params.colDecimation = region.getColDecimation();
+        params.method = region.getDownsampleMethod();
+        params.pixelType = pixelType;
+        params.numBytesPerPixel = numBytesPerPixel;
+
+        const size_t numOutputRows = region.getNumDecimatedRows();
+        if (numThreads <= 1 || mFilename.empty())
         {
-            // It could be in this segment
-            startOff = firstRowSeg;
+            readDecimated(mReader, imageSegments, startIndex, params,
+                          0, numOutputRows, mCompressionOptions,
+                          cacheParams, buffer);
         }
         else
         {
-            break;
+            mt::ThreadGroup threads;
+            const mt::ThreadPlanner planner(numOutputRows, numThreads);
+
+            size_t threadNum(0);
+            size_t startRowThisThread(0);
+            size_t numRowsThisThread(0);
+            while (planner.getThreadInfo(threadNum++,
+                                         startRowThisThread,
+                                         numRowsThisThread))
+            {
+                std::auto_ptr<sys::Runnable> runnable(
+                        new ReadDecimatedRunnable(
+                                getThreadReader(threadNum - 1),
+                                imageSegments,
+                                startIndex,
+                                params,
+                                startRowThisThread,
+                                numRowsThisThread,
+                                mCompressionOptions,
+                                cacheParams,
+                                buffer));
+                threads.createThread(runnable);
+            }
+
+            threads.joinAll();
+        }
+    }
+    else if (numThreads <= 1 || mFilename.empty())
+    {
+        std::vector<SegmentRead> reads;
+        getSegmentReads(imageSegments, startIndex, startRow,
+                        startRow, numRowsReq, numBytesPerRow, reads);
+        readSegments(mReader, reads, startCol, numColsReq,
+                     mCompressionOptions, cacheParams, buffer);
+    }
+    else
+    {
+        // Split the rows evenly across the threads.  A thread's rows may
+        // span a segment boundary, in which case it reads from each
+        // segment in turn.
+        mt::ThreadGroup threads;
+        const mt::ThreadPlanner planner(numRowsReq, numThreads);
+
+        size_t threadNum(0);
+        size_t startRowThisThread(0);
+        size_t numRowsThisThread(0);
+        std::vector<SegmentRead> reads;
+        while (planner.getThreadInfo(threadNum++,
+                                     startRowThisThread,
+                                     numRowsThisThread))
+        {
+            getSegmentReads(imageSegments, startIndex, startRow,
+                            startRow + startRowThisThread, numRowsThisThread,
+                            numBytesPerRow, reads);
+
+            std::auto_ptr<sys::Runnable> runnable(new ReadSegmentsRunnable(
+                    getThreadReader(threadNum - 1),
+                    reads,
+                    startCol,
+                    numColsReq,
+                    mCompressionOptions,
+                    cacheParams,
+                    buffer));
+            threads.createThread(runnable);
         }
 
+        threads.joinAll();
     }
-    --i; // Need to get rid of the last one
-    size_t totalRead = 0;
-    size_t numRowsLeft = numRowsReq;
-    sw.setStartRow(static_cast<nitf::Uint32>(startRow - startOff));
-#if DEBUG_OFFSETS
-    std::cout << "startRow: " << startRow
-    << " startOff: " << startOff
-    << " sw.startRow: " << sw.getStartRow()
-    << " i: " << i << std::endl;
-#endif
 
-    size_t nbpp = thisImage->getData()->getNumBytesPerPixel();
-    size_t startIndex = thisImage->getStartIndex();
-    createCompressionOptions(mCompressionOptions);
-    for (; i < numIS && totalRead < subWindowSize; i++)
+    return buffer;
+}
+
+bool NITFReadControl::canReadRaw(size_t imageNumber) const
+{
+    std::vector<RawSegment> segments;
+    return !mFilename.empty() &&
+           getRawSegments(mRecord, *mInfos[imageNumber], segments);
+}
+
+UByte* NITFReadControl::readRaw(Region& region, size_t imageNumber)
+{
+    const NITFImageInfo& thisImage = *mInfos[imageNumber];
+    std::vector<RawSegment> segments;
+    if (mFilename.empty() || !getRawSegments(mRecord, thisImage, segments))
     {
-        size_t numRowsReqSeg =
-                std::min<size_t>(numRowsLeft, imageSegments[i].numRows
-                        - sw.getStartRow());
+        throw except::Exception(Ctxt(
+                "Image " + str::toString(imageNumber) +
+                " can't be read raw"));
+    }
 
-        sw.setNumRows(static_cast<nitf::Uint32>(numRowsReqSeg));
-        nitf::ImageReader imageReader = mReader.newImageReader(
-                static_cast<int>(startIndex + i),
-                mCompressionOptions);
+    if (region.isDecimated())
+    {
+        throw except::Exception(Ctxt("Raw reads can't be decimated"));
+    }
 
-        nitf::Uint8* bufferPtr = buffer + totalRead;
+    resolveRegion(region,
+                  thisImage.getData()->getNumRows(),
+                  thisImage.getData()->getNumCols());
 
-        int padded;
-        imageReader.read(sw, &bufferPtr, &padded);
-        totalRead += numColsReq * nbpp * numRowsReqSeg;
-        sw.setStartRow(0);
-        numRowsLeft -= numRowsReqSeg;
+    const size_t numRowsReq = region.getNumRows();
+    const size_t numColsReq = region.getNumCols();
+    const size_t startRow = region.getStartRow();
+    const size_t startCol = region.getStartCol();
+    const size_t numBytesPerPixel =
+            thisImage.getData()->getNumBytesPerPixel();
+    const size_t numBytesPerRow = numColsReq * numBytesPerPixel;
+
+    nitf::Uint8* buffer = region.getBuffer();
+    if (buffer == NULL)
+    {
+        buffer = new nitf::Uint8[numRowsReq * numBytesPerRow];
+        region.setBuffer(buffer);
+    }
+
+    const std::vector<NITFSegmentInfo> imageSegments =
+            thisImage.getImageSegments();
+    const size_t startIndex = thisImage.getStartIndex();
+    const size_t numThreads = mOptions.getParameter(
+            OPT_NUM_READ_THREADS, Parameter(1));
+
+    if (numThreads <= 1)
+    {
+        std::vector<SegmentRead> reads;
+        getSegmentReads(imageSegments, startIndex, startRow,
+                        startRow, numRowsReq, numBytesPerRow, reads);
+
+        sys::File file(mFilename);
+        readRawSegments(file, reads, segments, startIndex, startCol,
+                        numColsReq, numBytesPerPixel, buffer);
+    }
+    else
+    {
+        mt::ThreadGroup threads;
+        const mt::ThreadPlanner planner(numRowsReq, numThreads);
+
+        size_t threadNum(0);
+        size_t startRowThisThread(0);
+        size_t numRowsThisThread(0);
+        std::vector<SegmentRead> reads;
+        while (planner.getThreadInfo(threadNum++,
+                                     startRowThisThread,
+                                     numRowsThisThread))
+        {
+            getSegmentReads(imageSegments, startIndex, startRow,
+                            startRow + startRowThisThread, numRowsThisThread,
+                            numBytesPerRow, reads);
+
+            std::auto_ptr<sys::Runnable> runnable(
+                    new ReadRawSegmentsRunnable(mFilename,
+                                                reads,
+                                                segments,
+                                                startIndex,
+                                                startCol,
+                                                numColsReq,
+                                                numBytesPerPixel,
+                                                buffer));
+            threads.createThread(runnable);
+        }
+
+        threads.joinAll();
     }
 
     return buffer;
@@ -780,6 +1786,27 @@ void NITFReadControl::reset()
     }
     mInfos.clear();
     mInterface.reset();
+    mFilename.clear();
+    mIdentifiedInterface.reset();
+    mBlockCache.reset();
+    mThreadReaders.clear();
+    mIdentifiedFilename.clear();
+}
+
+NITFReadControl::ThreadReader::ThreadReader(const std::string& pathname) :
+    handle(pathname)
+{
+    reader.read(handle);
+}
+
+nitf::Reader& NITFReadControl::getThreadReader(size_t threadNum)
+{
+    while (mThreadReaders.size() <= threadNum)
+    {
+        mThreadReaders.push_back(mem::SharedPtr<ThreadReader>(
+                new ThreadReader(mFilename)));
+    }
+    return mThreadReaders[threadNum]->reader;
 }
 
 
@@ -788,12 +1815,36 @@ six::ReadControl* NITFReadControlCreator::newReadControl() const
     return new NITFReadControl();
 }
 
+six::ReadControl*
+NITFReadControlCreator::newReadControl(const std::string& filename) const
+{
+    try
+    {
+        // Cheaply rule out files that aren't SICD/SIDD before parsing the
+        // full Record, which the returned control then reuses in load()
+        if (NITFReadControl::sniffDataType(filename) == DataType::NOT_SET)
+        {
+            return NULL;
+        }
+
+        std::auto_ptr<NITFReadControl> control(new NITFReadControl());
+        if (control->identify(filename) == DataType::NOT_SET)
+        {
+            return NULL;
+        }
+        return control.release();
+    }
+    catch(except::Exception&)
+    {
+        return NULL;
+    }
+}
+
 bool NITFReadControlCreator::supports(const std::string& filename) const
 {
     try
     {
-        NITFReadControl control;
-        return control.getDataType(filename) != DataType::NOT_SET;
+        return NITFReadControl::sniffDataType(filename) != DataType::NOT_SET;
     }
     catch(except::Exception&)
     {
@@ -0,0 +1,123 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <string.h>
+
+#include <algorithm>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include "six/NITFRegionInputStream.h"
+
+namespace six
+{
+NITFRegionInputStream::NITFRegionInputStream(
+        NITFReadControl& reader,
+        size_t imageNumber,
+        const types::RowCol<size_t>& offset,
+        const types::RowCol<size_t>& dims,
+        size_t numBytesPerPixel,
+        bool raw) :
+    mReader(reader),
+    mImageNumber(imageNumber),
+    mOffset(offset),
+    mDims(dims),
+    mRaw(raw),
+    mNumBytesPerRow(dims.col * numBytesPerPixel),
+    mNextRow(0),
+    mPartialRowOffset(0)
+{
+    if (mRaw && !mReader.canReadRaw(mImageNumber))
+    {
+        throw except::Exception(Ctxt(
+                "Image " + str::toString(mImageNumber) +
+                " can't be read raw"));
+    }
+}
+
+sys::Off_T NITFRegionInputStream::available()
+{
+    return static_cast<sys::Off_T>(mDims.row - mNextRow) * mNumBytesPerRow +
+            (mPartialRow.size() - mPartialRowOffset);
+}
+
+sys::SSize_T NITFRegionInputStream::readImpl(void* buffer, size_t len)
+{
+    UByte* bufferPtr = static_cast<UByte*>(buffer);
+    size_t numBytesLeft = len;
+
+    // Finish off the last row a read ended partway through
+    if (mPartialRowOffset < mPartialRow.size())
+    {
+        const size_t numBytes = std::min(
+                numBytesLeft, mPartialRow.size() - mPartialRowOffset);
+        ::memcpy(bufferPtr, &mPartialRow[mPartialRowOffset], numBytes);
+        mPartialRowOffset += numBytes;
+        bufferPtr += numBytes;
+        numBytesLeft -= numBytes;
+    }
+
+    // Whole rows go straight into the caller's buffer
+    const size_t numRows = std::min(numBytesLeft / mNumBytesPerRow,
+                                    mDims.row - mNextRow);
+    if (numRows > 0)
+    {
+        readRows(numRows, bufferPtr);
+        bufferPtr += numRows * mNumBytesPerRow;
+        numBytesLeft -= numRows * mNumBytesPerRow;
+    }
+
+    // The caller wants part of a row
+    if (numBytesLeft > 0 && mNextRow < mDims.row)
+    {
+        mPartialRow.resize(mNumBytesPerRow);
+        readRows(1, &mPartialRow[0]);
+        ::memcpy(bufferPtr, &mPartialRow[0], numBytesLeft);
+        mPartialRowOffset = numBytesLeft;
+        numBytesLeft = 0;
+    }
+
+    const size_t numBytesRead = len - numBytesLeft;
+    return (numBytesRead == 0 && len > 0) ?
+            io::InputStream::IS_EOF :
+            static_cast<sys::SSize_T>(numBytesRead);
+}
+
+void NITFRegionInputStream::readRows(size_t numRows, UByte* buffer)
+{
+    Region region;
+    region.setStartRow(mOffset.row + mNextRow);
+    region.setNumRows(numRows);
+    region.setStartCol(mOffset.col);
+    region.setNumCols(mDims.col);
+    region.setBuffer(buffer);
+
+    if (mRaw)
+    {
+        mReader.readRaw(region, mImageNumber);
+    }
+    else
+    {
+        mReader.interleaved(region, mImageNumber);
+    }
+    mNextRow += numRows;
+}
+}
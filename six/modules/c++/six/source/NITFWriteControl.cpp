@@ -216,6 +216,8 @@ void NITFWriteControl::save(
                     static_cast<int>(info.getStartIndex() + j),
                     writeHandler);
         }
+
+        addLegendWriter(info, i);
     }
 
     addDataAndWrite(schemaPaths);
@@ -336,38 +338,44 @@ void NITFWriteControl::save(
             }
         }
 
-        const Legend* const legend = getContainer()->getLegend(i);
-        if (legend)
+        addLegendWriter(info, i);
+    }
+
+    addDataAndWrite(schemaPaths);
+}
+
+void NITFWriteControl::addLegendWriter(const NITFImageInfo& info,
+                                       size_t imageNumber)
+{
+    const Legend* const legend = getContainer()->getLegend(imageNumber);
+    if (legend)
+    {
+        if (legend->mDims.row * legend->mDims.col != legend->mImage.size())
         {
-            if (legend->mDims.row * legend->mDims.col != legend->mImage.size())
-            {
-                throw except::Exception(Ctxt("Legend dimensions don't match"));
-            }
+            throw except::Exception(Ctxt("Legend dimensions don't match"));
+        }
 
-            if (legend->mImage.empty())
-            {
-                throw except::Exception(Ctxt("Empty legend"));
-            }
+        if (legend->mImage.empty())
+        {
+            throw except::Exception(Ctxt("Empty legend"));
+        }
 
-            nitf::ImageSource iSource;
+        nitf::ImageSource iSource;
 
-            nitf::MemorySource memSource(&legend->mImage[0],
-                                         legend->mImage.size(),
-                                         0,
-                                         sizeof(sys::ubyte),
-                                         0);
+        nitf::MemorySource memSource(&legend->mImage[0],
+                                     legend->mImage.size(),
+                                     0,
+                                     sizeof(sys::ubyte),
+                                     0);
 
-            iSource.addBand(memSource);
+        iSource.addBand(memSource);
 
-            nitf::ImageWriter iWriter =
-                mWriter.newImageWriter(static_cast<int>(
-                        info.getStartIndex() + numIS));
-            iWriter.setWriteCaching(1);
-            iWriter.attachSource(iSource);
-        }
+        nitf::ImageWriter iWriter =
+            mWriter.newImageWriter(static_cast<int>(
+                    info.getStartIndex() + info.getImageSegments().size()));
+        iWriter.setWriteCaching(1);
+        iWriter.attachSource(iSource);
     }
-
-    addDataAndWrite(schemaPaths);
 }
 
 void NITFWriteControl::addDataAndWrite(
@@ -440,4 +448,11 @@ void NITFWriteControl::addAdditionalDES(mem::SharedPtr<nitf::SegmentWriter> segm
 {
     mNITFHeaderCreator->addAdditionalDES(segmentWriter);
 }
+
+void NITFWriteControl::loadMeshSegment(
+        const Mesh& mesh,
+        const six::Classification& classification)
+{
+    mNITFHeaderCreator->loadMeshSegment(mesh, classification);
+}
 }
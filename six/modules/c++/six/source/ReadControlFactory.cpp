@@ -29,8 +29,9 @@ six::ReadControl* ReadControlRegistry::newReadControl(
     for (std::list<ReadControlCreator*>::const_iterator it = mCreators.begin(); it
             != mCreators.end(); ++it)
     {
-        if ((*it)->supports(filename))
-            return (*it)->newReadControl();
+        six::ReadControl* const control = (*it)->newReadControl(filename);
+        if (control)
+            return control;
     }
     throw except::NotImplementedException(
                                           Ctxt(
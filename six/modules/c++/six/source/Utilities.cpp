@@ -26,6 +26,7 @@
 #include <nitf/PluginRegistry.hpp>
 #include <logging/NullLogger.h>
 #include <math/Utilities.h>
+#include "six/NumberConversion.h"
 #include "six/Utilities.h"
 #include "six/XMLControl.h"
 
@@ -125,17 +126,14 @@ template<> std::string six::toString<double>(const double& value)
             Ctxt("Attempted use of uninitialized double value"));
     }
 
-   std::ostringstream os;
-   os << std::uppercase << std::scientific << std::setprecision(15) << value;
-   std::string strValue = os.str();
+    // Shortest round trip digits, and no + in the exponent to meet the
+    // SICD XML standard
+    return NumberConversion::toString(value);
+}
 
-   // remove any + in scientific notation to meet SICD XML standard
-   size_t plusPos = strValue.find("+");
-   if(plusPos != std::string::npos)
-   {
-      strValue.erase(plusPos, 1);
-   }
-   return strValue;
+template<> double six::toType<double>(const std::string& s)
+{
+    return NumberConversion::toDouble(s);
 }
 
 template<> std::string six::toString<BooleanType>(const BooleanType& value)
@@ -20,11 +20,58 @@
  *
  */
 
+#include <map>
+
 #include <logging/NullLogger.h>
+#include <mem/SharedPtr.h>
+#include <mt/CriticalSection.h>
+#include <sys/Mutex.h>
 #include <six/XMLControl.h>
 
 namespace
 {
+//! A compiled schema pool along with the lock needed to use it, since a
+//  validator can only validate one document at a time
+struct CachedValidator
+{
+    CachedValidator(const std::vector<std::string>& schemaPaths,
+                    logging::Logger* log) :
+        validator(schemaPaths, log, true)
+    {
+    }
+
+    xml::lite::Validator validator;
+    sys::Mutex mutex;
+};
+
+typedef std::map<std::string, mem::SharedPtr<CachedValidator> > ValidatorCache;
+
+// The validator loads every schema under the paths regardless of namespace,
+// so the set of paths alone identifies the compiled grammar.  These are
+// namespace scope (rather than function statics) so they are constructed
+// before any threads can get here.
+ValidatorCache validatorCache;
+sys::Mutex validatorCacheMutex;
+
+mem::SharedPtr<CachedValidator>
+getValidator(const std::vector<std::string>& schemaPaths,
+             logging::Logger* log)
+{
+    std::string key;
+    for (size_t ii = 0; ii < schemaPaths.size(); ++ii)
+    {
+        key += schemaPaths[ii] + '\n';
+    }
+
+    mt::CriticalSection<sys::Mutex> crit(&validatorCacheMutex);
+    mem::SharedPtr<CachedValidator>& validator = validatorCache[key];
+    if (!validator.get())
+    {
+        validator.reset(new CachedValidator(schemaPaths, log));
+    }
+    return validator;
+}
+
 //! Validate the xml and log any errors
 //  NOTE: Errors are treated as detriments to valid processing
 //        and fail accordingly
@@ -61,8 +108,6 @@ void validate(const xml::lite::Document* doc,
     // validate against any specified schemas
     if (!paths.empty())
     {
-        xml::lite::Validator validator(paths, log, true);
-
         std::vector<xml::lite::ValidationInfo> errors;
 
         if (doc->getRootElement()->getUri().empty())
@@ -76,9 +121,16 @@ void validate(const xml::lite::Document* doc,
         io::StringStream xmlStream;
         doc->getRootElement()->prettyPrint(xmlStream);
 
-        validator.validate(xmlStream,
-                           doc->getRootElement()->getUri(),
-                           errors);
+        // Validate the serialized string directly rather than through the
+        // stream overload, which would copy it into a second stream first
+        const mem::SharedPtr<CachedValidator> cached =
+                getValidator(paths, log);
+        {
+            mt::CriticalSection<sys::Mutex> crit(&cached->mutex);
+            cached->validator.validate(xmlStream.stream().str(),
+                                       doc->getRootElement()->getUri(),
+                                       errors);
+        }
 
         // log any error found and throw
         if (!errors.empty())
@@ -196,6 +248,12 @@ Data* XMLControl::fromXML(const xml::lite::Document* doc,
     return data;
 }
 
+void XMLControl::clearSchemaCache()
+{
+    mt::CriticalSection<sys::Mutex> crit(&validatorCacheMutex);
+    validatorCache.clear();
+}
+
 std::string XMLControl::dataTypeToString(DataType dataType, bool appendXML)
 {
     std::string str;
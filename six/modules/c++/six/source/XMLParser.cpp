@@ -24,6 +24,7 @@
 #include <except/Exception.h>
 #include <str/Convert.h>
 #include <logging/NullLogger.h>
+#include <six/NumberConversion.h>
 #include <six/XMLParser.h>
 #include <six/Utilities.h>
 
@@ -329,7 +330,7 @@ void XMLParser::parseDouble(XMLElem element, double& value) const
 {
     try
     {
-        value = str::toType<double>(element->getCharacterData());
+        value = NumberConversion::toDouble(element->getCharacterData());
     }
     catch (const except::BadCastException& ex)
     {
@@ -0,0 +1,152 @@
+/* =========================================================================
+* This file is part of six-c++
+* =========================================================================
+*
+* (C) Copyright 2004 - 2019, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+
+/*
+ *  Compares the throughput of six::NumberConversion against the iostream
+ *  based conversions six used before it, on values that look like SICD
+ *  polynomial coefficients.
+ *
+ *  Usage: number_conversion_benchmark [numValues]
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include <sys/StopWatch.h>
+#include <six/NumberConversion.h>
+
+namespace
+{
+std::string legacyToString(double value)
+{
+    std::ostringstream os;
+    os << std::uppercase << std::scientific << std::setprecision(15) << value;
+    std::string strValue = os.str();
+
+    const size_t plusPos = strValue.find("+");
+    if (plusPos != std::string::npos)
+    {
+        strValue.erase(plusPos, 1);
+    }
+    return strValue;
+}
+
+void report(const std::string& name, size_t numValues, double millis)
+{
+    std::cout << std::setw(28) << std::left << name
+              << std::setw(10) << std::right << std::fixed
+              << std::setprecision(1) << millis << " ms  "
+              << std::setw(8) << numValues / (millis * 1000.0)
+              << " M values/s\n";
+}
+}
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        const size_t numValues = (argc > 1) ?
+                str::toType<size_t>(argv[1]) : 1000000;
+
+        // Coefficients span many orders of magnitude and most have a full
+        // 16-17 digits
+        srand(1);
+        std::vector<double> values(numValues);
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            const double mantissa = (rand() / static_cast<double>(RAND_MAX)) *
+                    2.0 - 1.0;
+            values[ii] = mantissa * ::pow(10.0, (rand() % 60) - 30);
+        }
+
+        std::vector<std::string> legacyStrings(numValues);
+        std::vector<std::string> strings(numValues);
+        std::vector<double> parsed(numValues);
+        sys::RealTimeStopWatch watch;
+
+        watch.start();
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            legacyStrings[ii] = legacyToString(values[ii]);
+        }
+        report("format (ostringstream)", numValues, watch.stop());
+
+        watch.start();
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            strings[ii] = six::NumberConversion::toString(values[ii]);
+        }
+        report("format (NumberConversion)", numValues, watch.stop());
+
+        watch.start();
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            parsed[ii] = str::toType<double>(legacyStrings[ii]);
+        }
+        report("parse (str::toType)", numValues, watch.stop());
+
+        watch.start();
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            parsed[ii] = six::NumberConversion::toDouble(legacyStrings[ii]);
+        }
+        report("parse (NumberConversion)", numValues, watch.stop());
+
+        size_t numMismatches = 0;
+        size_t legacyLength = 0;
+        size_t length = 0;
+        for (size_t ii = 0; ii < numValues; ++ii)
+        {
+            if (six::NumberConversion::toDouble(strings[ii]) != values[ii])
+            {
+                ++numMismatches;
+            }
+            legacyLength += legacyStrings[ii].length();
+            length += strings[ii].length();
+        }
+
+        std::cout << "\nAverage length: " << std::setprecision(2)
+                  << legacyLength / static_cast<double>(numValues)
+                  << " (ostringstream), "
+                  << length / static_cast<double>(numValues)
+                  << " (NumberConversion)\n"
+                  << "Round trip mismatches: " << numMismatches << std::endl;
+        return (numMismatches == 0) ? 0 : 1;
+    }
+    catch (const except::Exception& ex)
+    {
+        std::cerr << ex.toString() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown exception" << std::endl;
+    }
+    return 1;
+}
@@ -0,0 +1,159 @@
+/* =========================================================================
+* This file is part of six-c++
+* =========================================================================
+*
+* (C) Copyright 2004 - 2019, MDA Information Systems LLC
+*
+* six-c++ is free software; you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation; either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public
+* License along with this program; If not,
+* see <http://www.gnu.org/licenses/>.
+*
+*/
+#include <locale.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <limits>
+#include <string>
+
+#include "TestCase.h"
+#include <six/NumberConversion.h>
+
+namespace
+{
+double fromBits(sys::Uint64_T bits)
+{
+    double value;
+    ::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+sys::Uint64_T toBits(double value)
+{
+    sys::Uint64_T bits;
+    ::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+sys::Uint64_T getRandomBits()
+{
+    sys::Uint64_T bits = 0;
+    for (size_t ii = 0; ii < 4; ++ii)
+    {
+        bits = (bits << 16) | (rand() & 0xFFFF);
+    }
+    return bits;
+}
+}
+
+TEST_CASE(Format)
+{
+    TEST_ASSERT_EQ(six::NumberConversion::toString(0.0), "0.0E00");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(-0.0), "-0.0E00");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(1.0), "1.0E00");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(0.1), "1.0E-01");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(-123.456), "-1.23456E02");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(2.6269628e-4),
+                   "2.6269628E-04");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(1e100), "1.0E100");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(5e-324), "5.0E-324");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(
+            std::numeric_limits<double>::max()), "1.7976931348623157E308");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(
+            std::numeric_limits<double>::infinity()), "INF");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(
+            -std::numeric_limits<double>::infinity()), "-INF");
+    TEST_ASSERT_EQ(six::NumberConversion::toString(
+            std::numeric_limits<double>::quiet_NaN()), "NaN");
+}
+
+TEST_CASE(Parse)
+{
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble("1.000000000000000E001"),
+                   10.0);
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble(" 2.5E-03"), 2.5e-3);
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble("+7"), 7.0);
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble(".5"), 0.5);
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble("-1.5e3"), -1500.0);
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble("1.5abc"), 1.5);
+    TEST_ASSERT_EQ(toBits(six::NumberConversion::toDouble("-0")),
+                   toBits(-0.0));
+    TEST_ASSERT_EQ(six::NumberConversion::toDouble("-INF"),
+                   -std::numeric_limits<double>::infinity());
+    const double nan = six::NumberConversion::toDouble("NaN");
+    TEST_ASSERT(nan != nan);
+
+    // Too many digits or too large an exponent for the exact path
+    const char* const slow[] =
+    {
+        "12345678901234567890123",
+        "3.333333333333333333333E-01",
+        "1.7976931348623157E308",
+        "4.9E-324"
+    };
+    for (size_t ii = 0; ii < sizeof(slow) / sizeof(slow[0]); ++ii)
+    {
+        TEST_ASSERT_EQ(six::NumberConversion::toDouble(slow[ii]),
+                       ::strtod(slow[ii], NULL));
+    }
+
+    TEST_EXCEPTION(six::NumberConversion::toDouble(""));
+    TEST_EXCEPTION(six::NumberConversion::toDouble("abc"));
+    TEST_EXCEPTION(six::NumberConversion::toDouble("1E400"));
+}
+
+TEST_CASE(RoundTrip)
+{
+    for (size_t ii = 0; ii < 100000; ++ii)
+    {
+        const double value = fromBits(getRandomBits());
+        if (value != value ||
+            value == std::numeric_limits<double>::infinity() ||
+            value == -std::numeric_limits<double>::infinity())
+        {
+            continue;
+        }
+
+        const std::string str = six::NumberConversion::toString(value);
+        TEST_ASSERT(str.length() < six::NumberConversion::MAX_LENGTH);
+        TEST_ASSERT_EQ(toBits(six::NumberConversion::toDouble(str)),
+                       toBits(value));
+        TEST_ASSERT_EQ(toBits(::strtod(str.c_str(), NULL)), toBits(value));
+    }
+}
+
+TEST_CASE(LocaleIndependence)
+{
+    const char* const locales[] = {"de_DE.UTF-8", "de_DE", "fr_FR.UTF-8"};
+    for (size_t ii = 0; ii < sizeof(locales) / sizeof(locales[0]); ++ii)
+    {
+        if (::setlocale(LC_NUMERIC, locales[ii]))
+        {
+            TEST_ASSERT_EQ(six::NumberConversion::toString(1.5), "1.5E00");
+            TEST_ASSERT_EQ(six::NumberConversion::toDouble("1.5"), 1.5);
+            TEST_ASSERT_EQ(six::NumberConversion::toDouble(
+                    "3.333333333333333333333E-01"), 1.0 / 3.0);
+        }
+    }
+    ::setlocale(LC_NUMERIC, "C");
+}
+
+int main(int, char**)
+{
+    srand(42);
+    TEST_CHECK(Format);
+    TEST_CHECK(Parse);
+    TEST_CHECK(RoundTrip);
+    TEST_CHECK(LocaleIndependence);
+    return 0;
+}
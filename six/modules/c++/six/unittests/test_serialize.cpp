@@ -23,7 +23,10 @@
 #include <stdlib.h>
 #include <time.h>
 
+#include <vector>
+
 #include "TestCase.h"
+#include <io/ByteStream.h>
 #include <six/Serialize.h>
 
 namespace
@@ -81,6 +84,94 @@ bool testVector(size_t length, bool byteSwap)
     six::deserialize<std::vector<T> >(buffer, byteSwap, valCopy);
     return val == valCopy;
 }
+
+// Checks that val serializes to numBytes bytes, that serializing to a
+// stream produces the same bytes, and that both deserialize back to val
+template<typename T>
+bool testRoundTrip(const T& val, bool byteSwap, size_t numBytes)
+{
+    std::vector<sys::byte> serializedData;
+    six::serialize(val, byteSwap, serializedData);
+    if (serializedData.size() != numBytes)
+    {
+        return false;
+    }
+
+    io::ByteStream stream;
+    six::serialize(val, byteSwap, stream);
+    std::vector<sys::byte> streamData(numBytes);
+    stream.seek(0, io::Seekable::START);
+    stream.read(&streamData[0], numBytes, true);
+    if (streamData != serializedData ||
+        stream.getSize() != numBytes)
+    {
+        return false;
+    }
+
+    const sys::byte* buffer = &serializedData[0];
+    T bufferCopy;
+    six::deserialize(buffer, byteSwap, bufferCopy);
+
+    stream.seek(0, io::Seekable::START);
+    T streamCopy;
+    six::deserialize(stream, byteSwap, streamCopy);
+
+    return buffer == &serializedData[0] + numBytes &&
+           bufferCopy == val &&
+           streamCopy == val;
+}
+
+// Serialized a field at a time, so it takes up fewer bytes than sizeof()
+struct Record
+{
+    sys::Int16_T id;
+    double value;
+
+    bool operator==(const Record& rhs) const
+    {
+        return id == rhs.id && value == rhs.value;
+    }
+};
+const size_t RECORD_SIZE = sizeof(sys::Int16_T) + sizeof(double);
+}
+
+namespace six
+{
+template<>
+struct Serializer<Record>
+{
+    static void serializeImpl(const Record& val,
+                              bool swapBytes,
+                              std::vector<sys::byte>& buffer)
+    {
+        serialize(val.id, swapBytes, buffer);
+        serialize(val.value, swapBytes, buffer);
+    }
+
+    static void deserializeImpl(const sys::byte*& buffer,
+                                bool swapBytes,
+                                Record& val)
+    {
+        deserialize(buffer, swapBytes, val.id);
+        deserialize(buffer, swapBytes, val.value);
+    }
+
+    static void serializeImpl(const Record& val,
+                              bool swapBytes,
+                              io::OutputStream& stream)
+    {
+        serialize(val.id, swapBytes, stream);
+        serialize(val.value, swapBytes, stream);
+    }
+
+    static void deserializeImpl(io::InputStream& stream,
+                                bool swapBytes,
+                                Record& val)
+    {
+        deserialize(stream, swapBytes, val.id);
+        deserialize(stream, swapBytes, val.value);
+    }
+};
 }
 
 TEST_CASE(ScalarSerialize)
@@ -117,9 +208,38 @@ TEST_CASE(VectorSerialize)
     TEST_ASSERT_TRUE(testVector<double>(length, true));
 }
 
+TEST_CASE(NestedVectorSerialize)
+{
+    // Each inner vector carries its own length
+    std::vector<std::vector<double> > val;
+    val.push_back(getRandomVector<double>(3));
+    val.push_back(std::vector<double>());
+    val.push_back(getRandomVector<double>(5));
+    const size_t numBytes = 4 * sizeof(size_t) + 8 * sizeof(double);
+
+    TEST_ASSERT_TRUE(testRoundTrip(val, false, numBytes));
+    TEST_ASSERT_TRUE(testRoundTrip(val, true, numBytes));
+}
+
+TEST_CASE(CustomVectorSerialize)
+{
+    std::vector<Record> val(7);
+    for (size_t ii = 0; ii < val.size(); ++ii)
+    {
+        val[ii].id = static_cast<sys::Int16_T>(rand());
+        val[ii].value = getRandomScalar<double>();
+    }
+    const size_t numBytes = sizeof(size_t) + val.size() * RECORD_SIZE;
+
+    TEST_ASSERT_TRUE(testRoundTrip(val, false, numBytes));
+    TEST_ASSERT_TRUE(testRoundTrip(val, true, numBytes));
+}
+
 int main(int, char**)
 {
     srand(time(NULL));
     TEST_CHECK(ScalarSerialize);
     TEST_CHECK(VectorSerialize);
+    TEST_CHECK(NestedVectorSerialize);
+    TEST_CHECK(CustomVectorSerialize);
 }
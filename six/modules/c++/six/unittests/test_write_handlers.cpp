@@ -0,0 +1,208 @@
+/* =========================================================================
+ * This file is part of six-c++
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2014, MDA Information Systems LLC
+ *
+ * six-c++ is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <stdlib.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <io/ByteStream.h>
+#include <nitf/MemoryIO.hpp>
+#include <six/Adapters.h>
+#include "TestCase.h"
+
+namespace
+{
+// Complex float pixels, so each row is 8000 bytes.  The handlers stage rows
+// in 4 MB chunks of 524 rows, so this is two full chunks followed by a
+// partial, odd-sized one.
+const size_t NUM_ROWS = 1201;
+const size_t NUM_COLS = 1000;
+const size_t NUM_CHANNELS = 2;
+const size_t PIXEL_SIZE = 8;
+const size_t ELEM_SIZE = PIXEL_SIZE / NUM_CHANNELS;
+const size_t NUM_BYTES = NUM_ROWS * NUM_COLS * PIXEL_SIZE;
+
+std::vector<six::UByte> getImage()
+{
+    std::vector<six::UByte> image(NUM_BYTES);
+    for (size_t ii = 0; ii < image.size(); ++ii)
+    {
+        image[ii] = static_cast<six::UByte>(rand());
+    }
+    return image;
+}
+
+std::vector<six::UByte> getSwapped(const std::vector<six::UByte>& image)
+{
+    std::vector<six::UByte> swapped(image);
+    for (size_t ii = 0; ii < swapped.size(); ii += ELEM_SIZE)
+    {
+        std::reverse(&swapped[ii], &swapped[ii] + ELEM_SIZE);
+    }
+    return swapped;
+}
+
+six::NITFSegmentInfo getSegmentInfo(size_t numRows)
+{
+    six::NITFSegmentInfo info;
+    info.firstRow = 0;
+    info.rowOffset = 0;
+    info.numRows = numRows;
+    return info;
+}
+
+std::vector<six::UByte> write(nitf::WriteHandler& handler, size_t numBytes)
+{
+    std::vector<six::UByte> output(numBytes);
+    nitf::MemoryIO io(&output[0], output.size());
+    handler.write(io);
+    return output;
+}
+
+void writeStream(const std::vector<six::UByte>& image,
+                 size_t numRows,
+                 bool doByteSwap,
+                 std::vector<six::UByte>& output)
+{
+    io::ByteStream stream;
+    stream.write(&image[0], image.size());
+    stream.seek(0, io::Seekable::START);
+
+    six::StreamWriteHandler handler(getSegmentInfo(numRows),
+                                    &stream,
+                                    NUM_COLS,
+                                    NUM_CHANNELS,
+                                    PIXEL_SIZE,
+                                    doByteSwap);
+    output = write(handler, NUM_BYTES);
+}
+
+TEST_CASE(testMemoryWriteHandler)
+{
+    const std::vector<six::UByte> image(getImage());
+
+    six::MemoryWriteHandler noSwap(getSegmentInfo(NUM_ROWS),
+                                   &image[0],
+                                   0,
+                                   NUM_COLS,
+                                   NUM_CHANNELS,
+                                   PIXEL_SIZE,
+                                   false);
+    TEST_ASSERT(write(noSwap, NUM_BYTES) == image);
+
+    six::MemoryWriteHandler swap(getSegmentInfo(NUM_ROWS),
+                                 &image[0],
+                                 0,
+                                 NUM_COLS,
+                                 NUM_CHANNELS,
+                                 PIXEL_SIZE,
+                                 true);
+    TEST_ASSERT(write(swap, NUM_BYTES) == getSwapped(image));
+}
+
+TEST_CASE(testMemoryWriteHandlerFirstRow)
+{
+    // Write just the rows after the first one
+    const std::vector<six::UByte> image(getImage());
+    const size_t rowSize = NUM_COLS * PIXEL_SIZE;
+
+    six::MemoryWriteHandler handler(getSegmentInfo(NUM_ROWS - 1),
+                                    &image[0],
+                                    1,
+                                    NUM_COLS,
+                                    NUM_CHANNELS,
+                                    PIXEL_SIZE,
+                                    true);
+    const std::vector<six::UByte> output(write(handler, NUM_BYTES - rowSize));
+
+    const std::vector<six::UByte> swapped(getSwapped(image));
+    TEST_ASSERT(std::equal(output.begin(), output.end(),
+                           swapped.begin() + rowSize));
+}
+
+TEST_CASE(testStreamWriteHandler)
+{
+    const std::vector<six::UByte> image(getImage());
+
+    std::vector<six::UByte> output;
+    writeStream(image, NUM_ROWS, false, output);
+    TEST_ASSERT(output == image);
+
+    writeStream(image, NUM_ROWS, true, output);
+    TEST_ASSERT(output == getSwapped(image));
+}
+
+TEST_CASE(testStreamWriteHandlerShortRead)
+{
+    // The stream runs out partway through the last chunk.  The failure has
+    // to come back through NITRO as an error rather than an exception.
+    std::vector<six::UByte> image(getImage());
+    image.resize(NUM_BYTES - NUM_COLS * PIXEL_SIZE);
+
+    bool threw(false);
+    try
+    {
+        std::vector<six::UByte> output;
+        writeStream(image, NUM_ROWS, true, output);
+    }
+    catch (const nitf::NITFException& )
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+}
+
+TEST_CASE(testWriteFailure)
+{
+    // The output is too small to hold the second chunk
+    const std::vector<six::UByte> image(getImage());
+
+    six::MemoryWriteHandler handler(getSegmentInfo(NUM_ROWS),
+                                    &image[0],
+                                    0,
+                                    NUM_COLS,
+                                    NUM_CHANNELS,
+                                    PIXEL_SIZE,
+                                    true);
+
+    bool threw(false);
+    try
+    {
+        write(handler, NUM_BYTES / 2);
+    }
+    catch (const nitf::NITFException& )
+    {
+        threw = true;
+    }
+    TEST_ASSERT(threw);
+}
+}
+
+int main(int, char**)
+{
+    srand(334);
+    TEST_CHECK(testMemoryWriteHandler);
+    TEST_CHECK(testMemoryWriteHandlerFirstRow);
+    TEST_CHECK(testStreamWriteHandler);
+    TEST_CHECK(testStreamWriteHandlerShortRead);
+    TEST_CHECK(testWriteFailure);
+}
@@ -26,6 +26,7 @@
 
 %{
 
+#include <algorithm>
 #include <complex>
 #include <utility>
 
@@ -37,6 +38,7 @@
 #include "six/sicd/GeoLocator.h"
 #include "six/sicd/SICDWriteControl.h"
 #include "six/sicd/Utilities.h"
+#include <mt/CriticalSection.h>
 #include <numpyutils/numpyutils.h>
 
 
@@ -383,6 +385,298 @@ SCOPED_COPYABLE(six::sicd, InterPulsePeriod)
 void getWidebandData(std::string sicdPathname, const std::vector<std::string>& schemaPaths, six::sicd::ComplexData* complexData, long long arrayBuffer);
 void getWidebandRegion(std::string sicdPathname, const std::vector<std::string>& schemaPaths, six::sicd::ComplexData* complexData, long long startRow, long long numRows, long long startCol, long long numCols, long long arrayBuffer);
 
+/*
+ * Reading with the functions above opens the SICD and parses its XML on
+ * every call.  SICDReader keeps the SICD open instead, which is what you
+ * want when reading many regions out of the same file.  Reads release the
+ * GIL, so Python threads sharing a SICDReader read in parallel.
+ */
+%{
+    /*
+     * Releases the GIL for as long as it's in scope.  Nothing touching
+     * Python objects can happen while it's released.
+     */
+    class ReleaseGIL
+    {
+    public:
+        ReleaseGIL() :
+            mState(PyEval_SaveThread())
+        {
+        }
+
+        ~ReleaseGIL()
+        {
+            PyEval_RestoreThread(mState);
+        }
+
+    private:
+        PyThreadState* const mState;
+    };
+
+    class SICDReader
+    {
+    public:
+        SICDReader(const std::string& pathname,
+                   const std::vector<std::string>& schemaPaths =
+                           std::vector<std::string>()) :
+            mPathname(pathname),
+            mSchemaPaths(schemaPaths)
+        {
+            mXMLRegistry.addCreator(six::DataType::COMPLEX,
+                                    new six::XMLControlCreatorT<
+                                            six::sicd::ComplexXMLControl>());
+
+            ReleaseGIL noGIL;
+            six::NITFReadControl* const reader = acquireReader();
+            try
+            {
+                mComplexData = Utilities::getComplexData(*reader);
+            }
+            catch (...)
+            {
+                releaseReader(reader);
+                throw;
+            }
+            releaseReader(reader);
+        }
+
+        std::auto_ptr<six::sicd::ComplexData> getComplexData() const
+        {
+            return std::auto_ptr<six::sicd::ComplexData>(
+                    static_cast<six::sicd::ComplexData*>(
+                            mComplexData->clone()));
+        }
+
+        size_t getNumRows() const
+        {
+            return mComplexData->getNumRows();
+        }
+
+        size_t getNumCols() const
+        {
+            return mComplexData->getNumCols();
+        }
+
+        /*
+         * Reads a region as complex64, into 'output' if it's an array or
+         * into a new array if it's None.  Integer pixels are converted (and
+         * amplitude table lookups applied) the same way the module-level
+         * read() and readRegion() functions convert them.
+         */
+        PyObject* read(size_t startRow, size_t numRows,
+                       size_t startCol, size_t numCols,
+                       PyObject* output)
+        {
+            const types::RowCol<size_t> offset(startRow, startCol);
+            const types::RowCol<size_t> extent(numRows, numCols);
+            verifyRegion(offset, extent);
+
+            const bool newArray = (output == Py_None);
+            numpyutils::createOrVerify(output, NPY_COMPLEX64, extent);
+            if (!newArray)
+            {
+                Py_INCREF(output);
+            }
+
+            try
+            {
+                verifyWritable(output);
+                std::complex<float>* const buffer =
+                        numpyutils::getBuffer<std::complex<float> >(output);
+
+                ReleaseGIL noGIL;
+                six::NITFReadControl* const reader = acquireReader();
+                try
+                {
+                    Utilities::getWidebandData(*reader, *mComplexData,
+                                               offset, extent, buffer);
+                }
+                catch (...)
+                {
+                    releaseReader(reader);
+                    throw;
+                }
+                releaseReader(reader);
+            }
+            catch (...)
+            {
+                Py_DECREF(output);
+                throw;
+            }
+            return output;
+        }
+
+        /*
+         * Reads a region of an RE16I_IM16I SICD as its stored int16 I/Q
+         * pairs, without promoting to float, into an (N, M, 2) int16 array.
+         * As with read(), 'output' is either such an array or None.
+         */
+        PyObject* readInt16(size_t startRow, size_t numRows,
+                            size_t startCol, size_t numCols,
+                            PyObject* output)
+        {
+            if (mComplexData->getPixelType() != six::PixelType::RE16I_IM16I)
+            {
+                throw except::Exception(Ctxt(
+                        "readInt16() requires RE16I_IM16I pixels, not " +
+                        mComplexData->getPixelType().toString()));
+            }
+
+            const types::RowCol<size_t> offset(startRow, startCol);
+            const types::RowCol<size_t> extent(numRows, numCols);
+            verifyRegion(offset, extent);
+
+            npy_intp dims[3];
+            dims[0] = static_cast<npy_intp>(numRows);
+            dims[1] = static_cast<npy_intp>(numCols);
+            dims[2] = 2;
+
+            if (output == Py_None)
+            {
+                output = PyArray_SimpleNew(3, dims, NPY_INT16);
+                numpyutils::verifyNewPyObject(output);
+            }
+            else
+            {
+                numpyutils::verifyArrayType(output, NPY_INT16);
+                PyArrayObject* const array =
+                        reinterpret_cast<PyArrayObject*>(output);
+                if (PyArray_NDIM(array) != 3 ||
+                    !std::equal(dims, dims + 3, PyArray_DIMS(array)))
+                {
+                    throw except::Exception(Ctxt(
+                            "Expected an (" + str::toString(numRows) + ", " +
+                            str::toString(numCols) + ", 2) array"));
+                }
+                Py_INCREF(output);
+            }
+
+            try
+            {
+                verifyWritable(output);
+                six::Region region;
+                region.setStartRow(startRow);
+                region.setNumRows(numRows);
+                region.setStartCol(startCol);
+                region.setNumCols(numCols);
+                region.setBuffer(numpyutils::getBuffer<six::UByte>(output));
+
+                // NITFReadControl hands back pixels in native byte order, so
+                // they can go straight into the array
+                ReleaseGIL noGIL;
+                six::NITFReadControl* const reader = acquireReader();
+                try
+                {
+                    reader->interleaved(region, 0);
+                }
+                catch (...)
+                {
+                    releaseReader(reader);
+                    throw;
+                }
+                releaseReader(reader);
+            }
+            catch (...)
+            {
+                Py_DECREF(output);
+                throw;
+            }
+            return output;
+        }
+
+    private:
+        SICDReader(const SICDReader& );
+        SICDReader& operator=(const SICDReader& );
+
+        void verifyRegion(const types::RowCol<size_t>& offset,
+                          const types::RowCol<size_t>& extent) const
+        {
+            if (extent.row == 0 || extent.col == 0 ||
+                offset.row + extent.row > getNumRows() ||
+                offset.col + extent.col > getNumCols())
+            {
+                throw except::Exception(Ctxt(
+                        "Region [" + str::toString(offset.row) + ", " +
+                        str::toString(offset.col) + "] + [" +
+                        str::toString(extent.row) + ", " +
+                        str::toString(extent.col) +
+                        "] is empty or outside the image"));
+            }
+        }
+
+        static void verifyWritable(PyObject* output)
+        {
+            if (!PyArray_ISCARRAY(reinterpret_cast<PyArrayObject*>(output)))
+            {
+                throw except::Exception(Ctxt(
+                        "Output array must be C-contiguous and writable"));
+            }
+        }
+
+        /*
+         * A NITFReadControl can't be read from by two threads at once, so
+         * each read checks one out of the pool, loading another one only if
+         * they're all in use.
+         */
+        six::NITFReadControl* acquireReader()
+        {
+            {
+                mt::CriticalSection<sys::Mutex> lock(&mMutex);
+                if (!mFreeReaders.empty())
+                {
+                    six::NITFReadControl* const reader = mFreeReaders.back();
+                    mFreeReaders.pop_back();
+                    return reader;
+                }
+            }
+
+            mem::SharedPtr<six::NITFReadControl> reader(
+                    new six::NITFReadControl());
+            reader->setLogger(&mLogger);
+            reader->setXMLControlRegistry(&mXMLRegistry);
+            reader->load(mPathname, mSchemaPaths);
+
+            mt::CriticalSection<sys::Mutex> lock(&mMutex);
+            mReaders.push_back(reader);
+            return reader.get();
+        }
+
+        void releaseReader(six::NITFReadControl* reader)
+        {
+            mt::CriticalSection<sys::Mutex> lock(&mMutex);
+            mFreeReaders.push_back(reader);
+        }
+
+    private:
+        const std::string mPathname;
+        const std::vector<std::string> mSchemaPaths;
+        logging::Logger mLogger;
+        six::XMLControlRegistry mXMLRegistry;
+        std::auto_ptr<six::sicd::ComplexData> mComplexData;
+
+        sys::Mutex mMutex;
+        std::vector<mem::SharedPtr<six::NITFReadControl> > mReaders;
+        std::vector<six::NITFReadControl*> mFreeReaders;
+    };
+%}
+
+class SICDReader
+{
+public:
+    SICDReader(const std::string& pathname,
+               const std::vector<std::string>& schemaPaths =
+                       std::vector<std::string>());
+    std::auto_ptr<six::sicd::ComplexData> getComplexData() const;
+    size_t getNumRows() const;
+    size_t getNumCols() const;
+    PyObject* read(size_t startRow, size_t numRows,
+                   size_t startCol, size_t numCols,
+                   PyObject* output = Py_None);
+    PyObject* readInt16(size_t startRow, size_t numRows,
+                        size_t startCol, size_t numCols,
+                        PyObject* output = Py_None);
+};
+
 %pythoncode %{
 import numpy as np
 from coda.coda_types import VectorString
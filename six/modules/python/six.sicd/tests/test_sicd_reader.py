@@ -0,0 +1,111 @@
+#!/user/bin/env/python
+#
+# =========================================================================
+# This file is part of six.sicd-python
+# =========================================================================
+#
+# (C) Copyright 2004 - 2019, MDA Information Systems LLC
+#
+# six.sicd-python is free software; you can redistribute it and/or modify
+# it under the terms of the GNU Lesser General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this program; If not,
+# see <http://www.gnu.org/licenses/>.
+#
+
+import os
+import subprocess
+import sys
+import threading
+
+import numpy as np
+
+from pysix.six_sicd import SICDReader, read
+
+
+def createNITF():
+    location = os.path.split(os.path.realpath(__file__))[0]
+    testPath = os.path.join(location, 'test_create_sicd_xml.py')
+    subprocess.call(['python', testPath, '--includeNITF'])
+    return os.path.join(os.getcwd(), 'test_create_sicd.nitf')
+
+
+def readChips(reader, expectedArray, chipSize, failures):
+    numRows, numCols = expectedArray.shape
+    for row in range(0, numRows - chipSize + 1, chipSize):
+        for col in range(0, numCols - chipSize + 1, chipSize):
+            chip = reader.read(row, chipSize, col, chipSize)
+            if not (chip == expectedArray[row:row + chipSize,
+                                          col:col + chipSize]).all():
+                failures.append((row, col))
+
+
+if __name__ == '__main__':
+    pathname = createNITF()
+    assert os.path.exists(pathname)
+    expectedArray, expectedData = read(pathname)
+    numRows, numCols = expectedArray.shape
+
+    try:
+        reader = SICDReader(pathname)
+        assert reader.getNumRows() == numRows
+        assert reader.getNumCols() == numCols
+        assert reader.getComplexData() == expectedData
+
+        actualArray = reader.read(0, numRows, 0, numCols)
+        assert actualArray.dtype == np.complex64
+        assert (actualArray == expectedArray).all()
+
+        # Reading into a caller's array hands back that same array
+        chip = np.zeros((2, 3), dtype='complex64')
+        assert reader.read(1, 2, 2, 3, chip) is chip
+        assert (chip == expectedArray[1:3, 2:5]).all()
+
+        # Parallel reads from one reader
+        chipSize = max(1, min(numRows, numCols) // 4)
+        failures = []
+        threads = [threading.Thread(target=readChips,
+                                    args=(reader, expectedArray, chipSize,
+                                          failures))
+                   for _ in range(4)]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        assert not failures
+
+        # Out of bounds regions, wrong output arrays, and int16 reads of
+        # float pixels are all errors
+        for args in [(0, numRows + 1, 0, numCols),
+                     (0, 1, numCols, 1),
+                     (0, 0, 0, 1)]:
+            try:
+                reader.read(*args)
+                assert False
+            except RuntimeError:
+                pass
+        try:
+            reader.read(0, 2, 0, 2, np.zeros((2, 3), dtype='complex64'))
+            assert False
+        except RuntimeError:
+            pass
+        try:
+            reader.readInt16(0, 1, 0, 1)
+            assert False
+        except RuntimeError:
+            pass
+    except AssertionError:
+        print('SICDReader and read() differ. Test failed')
+        sys.exit(1)
+    except Exception as e:
+        sys.exit(repr(e))
+    print('Test passed')
+    sys.exit(0)
@@ -0,0 +1,193 @@
+/* =========================================================================
+ * This file is part of the CSM SIX Plugin
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * The CSM SIX Plugin is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifndef __SIX_CSM_MODEL_STATE_H__
+#define __SIX_CSM_MODEL_STATE_H__
+
+#include <string>
+#include <vector>
+
+#include <sys/Conf.h>
+#include <mem/ScopedCopyablePtr.h>
+#include <six/Types.h>
+#include <six/ErrorStatistics.h>
+
+namespace six
+{
+namespace CSM
+{
+/*!
+ * The binary sensor model state is the sensor model name, a space, a magic
+ * number, a format version, and then a little-endian payload holding just
+ * what the projection model needs.  It's produced and consumed in a few
+ * microseconds rather than the milliseconds it takes to write and parse the
+ * full SICD/SIDD XML.  The XML form (the sensor model name, a space, and the
+ * XML) is still accepted when restoring state.
+ *
+ * Both sides of the payload must write and read the same fields in the same
+ * order; bump VERSION whenever that changes.
+ */
+struct ModelState
+{
+    static const char MAGIC[];
+    static const sys::Uint32_T VERSION;
+
+    /*!
+     * \param state A sensor model state
+     * \param modelName The name of the sensor model
+     *
+     * \return True if 'state' is a binary state for 'modelName', false
+     * otherwise (i.e. it's presumably XML)
+     */
+    static
+    bool isBinary(const std::string& state, const std::string& modelName);
+};
+
+/*!
+ * \class ModelStateWriter
+ * \brief Builds up a binary sensor model state
+ */
+class ModelStateWriter
+{
+public:
+    /*!
+     * \param modelName The name of the sensor model.  This, the magic number,
+     * and the version are written immediately.
+     */
+    ModelStateWriter(const std::string& modelName);
+
+    void writeBool(bool value);
+
+    void writeSize(size_t value);
+
+    void writeInt(int value);
+
+    void writeDouble(double value);
+
+    void writeString(const std::string& value);
+
+    void writeVector3(const Vector3& value);
+
+    void writeRowColInt(const RowColInt& value);
+
+    void writeRowColDouble(const RowColDouble& value);
+
+    void writeDateTime(const DateTime& value);
+
+    void writePoly1D(const Poly1D& value);
+
+    void writePoly2D(const Poly2D& value);
+
+    void writePolyXYZ(const PolyXYZ& value);
+
+    /*!
+     * Writes the parts of the error statistics that feed the projection
+     * model's error covariance (see six::getErrors())
+     *
+     * \param value Error statistics.  May be NULL.
+     */
+    void writeErrorStatistics(const ErrorStatistics* value);
+
+    //! \return The sensor model state
+    std::string toString() const;
+
+private:
+    template <typename T>
+    void write(const T& value);
+
+    void writeDecorrType(const DecorrType& value);
+
+private:
+    const bool mSwapBytes;
+    std::vector<sys::byte> mBuffer;
+};
+
+/*!
+ * \class ModelStateReader
+ * \brief Reads back a binary sensor model state written by ModelStateWriter
+ *
+ * Every read throws if it would run off the end of the state.
+ */
+class ModelStateReader
+{
+public:
+    /*!
+     * \param state The sensor model state.  This must outlive the reader.
+     * \param modelName The expected name of the sensor model
+     *
+     * \throws except::Exception if 'state' is not a binary state for
+     * 'modelName' or has a version this reader doesn't support
+     */
+    ModelStateReader(const std::string& state, const std::string& modelName);
+
+    bool readBool();
+
+    size_t readSize();
+
+    int readInt();
+
+    double readDouble();
+
+    std::string readString();
+
+    Vector3 readVector3();
+
+    RowColInt readRowColInt();
+
+    RowColDouble readRowColDouble();
+
+    DateTime readDateTime();
+
+    Poly1D readPoly1D();
+
+    Poly2D readPoly2D();
+
+    PolyXYZ readPolyXYZ();
+
+    /*!
+     * Reads error statistics written by
+     * ModelStateWriter::writeErrorStatistics()
+     *
+     * \param[out] value Error statistics.  Reset to NULL if none were
+     * written.
+     */
+    void readErrorStatistics(mem::ScopedCopyablePtr<ErrorStatistics>& value);
+
+    //! \throws except::Exception if there are unread bytes left over
+    void checkEnd() const;
+
+private:
+    template <typename T>
+    T read();
+
+    DecorrType readDecorrType();
+
+    void require(size_t numElements, size_t elementSize) const;
+
+private:
+    const bool mSwapBytes;
+    const sys::byte* mCurrent;
+    const sys::byte* const mEnd;
+};
+}
+}
+
+#endif
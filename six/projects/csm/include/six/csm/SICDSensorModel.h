@@ -181,6 +181,8 @@ private:
 
     void replaceModelStateImpl(const std::string& sensorModelState);
 
+    virtual void writeModelStateImpl(ModelStateWriter& writer) const;
+
     void initializeFromFile(const std::string& pathname);
 
     void initializeFromISD(const csm::Nitf21Isd& isd);
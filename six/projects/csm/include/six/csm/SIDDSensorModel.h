@@ -172,6 +172,8 @@ private:
 
     void replaceModelStateImpl(const std::string& sensorModelState);
 
+    virtual void writeModelStateImpl(ModelStateWriter& writer) const;
+
     void initializeFromFile(const std::string& pathname, size_t imageIndex);
 
     void initializeFromISD(const csm::Nitf21Isd& isd, size_t imageIndex);
@@ -34,6 +34,7 @@
 #include <scene/ECEFToLLATransform.h>
 #include <six/Enums.h>
 #include <six/Types.h>
+#include <six/csm/ModelState.h>
 
 namespace six
 {
@@ -64,7 +65,9 @@ public: // Model methods
     /**
      * Returns a string representing the state of the sensor model.  The state
      * string is made up of the sensor model name, followed by a space, then
-     * the SICD XML as a string.
+     * a compact binary encoding of just what the projection model needs,
+     * including the current adjustable parameters and their covariance (see
+     * ModelState).  This is binary data, not text.
      *
      * \return State of the sensor model
      */
@@ -73,8 +76,10 @@ public: // Model methods
     /**
      * Initialize the current model with argState
      *
-     * \param[in] argState The sensor model state to update to.  If the string
-     *     is empty, the model is unchanged.
+     * \param[in] argState The sensor model state to update to.  This may be
+     *     either the binary state returned by getModelState() or the sensor
+     *     model name, followed by a space, then the SICD/SIDD XML.  If the
+     *     string is empty, the model is unchanged.
      */
     virtual void replaceModelState(const std::string& argState);
 
@@ -582,6 +587,106 @@ public: // RasterGM methods
             csm::param::Set pSet = csm::param::VALID,
             const GeometricModelList& otherModels = GeometricModelList()) const;
 
+public: // Batch methods
+    /*
+     * The batch methods below are for projecting many points at once (e.g.
+     * for mensuration or DEM draping).  They give the same results as
+     * calling the corresponding single point methods in a loop (to within
+     * the convergence tolerance of the iterative projections) but share the
+     * per-image setup across points, start each point's iteration from
+     * where its neighbor converged, compute partials without any further
+     * iterative projections (see
+     * scene::ProjectionModel::sceneToImageAnalyticPartials()), and split
+     * the points across 'numThreads' threads.  Points that are near each
+     * other in the arrays should be near each other on the ground for the
+     * warm start to help.  The output arrays must hold 'numPoints' points.
+     * The arrays are stepped through as arrays of exactly the declared type,
+     * so e.g. an array of csm::EcefCoordCovar's can't be passed where
+     * csm::EcefCoord's are expected.
+     *
+     * As with the single point methods, errors are thrown as csm::Error's.
+     * They're virtual so that callers holding a model made through the CSM
+     * plugin can reach them without linking against the plugin.
+     */
+
+    /**
+     * Batch version of groundToImage()
+     *
+     * \param[in] groundPts Ground coordinates in ECEF meters
+     * \param[in] numPoints The number of points
+     * \param[in] numThreads The number of threads to use
+     * \param[out] imagePts Image coordinates in pixels
+     */
+    virtual void groundToImage(const csm::EcefCoord* groundPts,
+                               size_t numPoints,
+                               size_t numThreads,
+                               csm::ImageCoord* imagePts) const;
+
+    /**
+     * Batch version of groundToImage() with covariance
+     *
+     * \param[in] groundPts Ground coordinates in ECEF meters with 3x3
+     *     covariances in ECEF meters squared
+     * \param[in] numPoints The number of points
+     * \param[in] numThreads The number of threads to use
+     * \param[out] imagePts Image coordinates in pixels with 2x2 covariances
+     *     in pixels squared
+     */
+    virtual void groundToImage(const csm::EcefCoordCovar* groundPts,
+                               size_t numPoints,
+                               size_t numThreads,
+                               csm::ImageCoordCovar* imagePts) const;
+
+    /**
+     * Batch version of imageToGround()
+     *
+     * \param[in] imagePts Image lines and samples in pixels
+     * \param[in] numPoints The number of points
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[in] numThreads The number of threads to use
+     * \param[out] groundPts Ground coordinates in ECEF meters
+     */
+    virtual void imageToGround(const csm::ImageCoord* imagePts,
+                               size_t numPoints,
+                               double height,
+                               size_t numThreads,
+                               csm::EcefCoord* groundPts) const;
+
+    /**
+     * Batch version of imageToGround() with covariance
+     *
+     * \param[in] imagePts Image lines and samples in pixels with 2x2
+     *     covariances in pixels squared
+     * \param[in] numPoints The number of points
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[in] heightVariance Height variance in meters
+     * \param[in] numThreads The number of threads to use
+     * \param[out] groundPts Ground coordinates in ECEF meters with 3x3
+     *     covariances in ECEF meters squared
+     */
+    virtual void imageToGround(const csm::ImageCoordCovar* imagePts,
+                               size_t numPoints,
+                               double height,
+                               double heightVariance,
+                               size_t numThreads,
+                               csm::EcefCoordCovar* groundPts) const;
+
+    /**
+     * Batch version of computeGroundPartials()
+     *
+     * \param[in] groundPts Ground coordinates in ECEF meters
+     * \param[in] numPoints The number of points
+     * \param[in] numThreads The number of threads to use
+     * \param[out] partials Six partials per point, ordered as returned by
+     *     computeGroundPartials().  Must hold 6 * 'numPoints' values.
+     */
+    virtual void computeGroundPartials(const csm::EcefCoord* groundPts,
+                                       size_t numPoints,
+                                       size_t numThreads,
+                                       double* partials) const;
+
     static
     size_t getNumSensorModelParameters()
     {
@@ -644,6 +749,24 @@ protected:
     virtual
     void replaceModelStateImpl(const std::string& sensorModelState) = 0;
 
+    /**
+     * Writes the parts of the SICD/SIDD that the sensor model uses to a
+     * binary sensor model state
+     *
+     * \param writer The state to write to
+     */
+    virtual void writeModelStateImpl(ModelStateWriter& writer) const = 0;
+
+    /**
+     * Restores the adjustable parameters, their types, and the sensor
+     * covariance from a binary sensor model state.  Call this after the
+     * model has been reinitialized from the rest of the state.
+     *
+     * \param reader The state to read from, positioned just after what
+     *     writeModelStateImpl() wrote
+     */
+    void readAdjustments(ModelStateReader& reader);
+
     virtual types::RowCol<double> getSampleSpacing() const = 0;
 
     virtual void setSchemaDir(const std::string& schemaDir);
@@ -652,6 +775,50 @@ protected:
                                       double desiredPrecision,
                                       double* achievedPrecision) const;
 
+    /**
+     * Projects ground points to image grid points (meters) without
+     * converting to pixels
+     *
+     * \param[in] groundPts Ground coordinates in ECEF meters
+     * \param[in] numPoints The number of points
+     * \param[out] imagePts Image grid points in meters.  Resized to
+     *     'numPoints'.
+     */
+    void groundToImageGrid(const csm::EcefCoord* groundPts,
+                           size_t numPoints,
+                           std::vector<types::RowCol<double> >& imagePts) const;
+
+    /**
+     * The image point and covariance for groundToImage() with covariance
+     *
+     * \param[in] groundPt Ground point and covariance
+     * \param[in] imagePt The image grid point (meters) that groundPt
+     *     projects to
+     *
+     * \return Image point in pixels and covariance in pixels squared
+     */
+    csm::ImageCoordCovar toImageCoordCovar(
+            const csm::EcefCoordCovar& groundPt,
+            const types::RowCol<double>& imagePt) const;
+
+    /**
+     * The ground point and covariance for imageToGround() with covariance
+     *
+     * \param[in] imagePt Image point in pixels and covariance in pixels
+     *     squared
+     * \param[in] height Height in meters measured with respect to the
+     *     WGS-84 ellipsoid
+     * \param[in] heightVariance Height variance in meters
+     * \param[in] groundPt The ground point that imagePt projects to at
+     *     'height'
+     *
+     * \return Ground point and covariance in ECEF meters
+     */
+    csm::EcefCoordCovar toEcefCoordCovar(const csm::ImageCoordCovar& imagePt,
+                                         double height,
+                                         double heightVariance,
+                                         const scene::Vector3& groundPt) const;
+
     static
     scene::Vector3 toVector3(const csm::EcefCoord& pt)
     {
@@ -687,7 +854,6 @@ protected:
     const scene::ECEFToLLATransform mECEFToLLA;
     const csm::NoCorrelationModel mCorrelationModel;
     std::vector<std::string> mSchemaDirs;
-    std::string mSensorModelState;
     std::auto_ptr<const scene::SceneGeometry> mGeometry;
     std::auto_ptr<scene::ProjectionModel> mProjection;
     csm::param::Type mAdjustableTypes[scene::AdjustableParams::NUM_PARAMS];
@@ -0,0 +1,537 @@
+/* =========================================================================
+ * This file is part of the CSM SIX Plugin
+ * =========================================================================
+ *
+ * (C) Copyright 2004 - 2019, MDA Information Systems LLC
+ *
+ * The CSM SIX Plugin is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this program; if not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <except/Exception.h>
+#include <str/Convert.h>
+#include <six/Serialize.h>
+#include <six/csm/ModelState.h>
+
+namespace
+{
+const size_t MAGIC_LENGTH = 4;
+
+size_t getHeaderLength(const std::string& modelName)
+{
+    return modelName.length() + 1 + MAGIC_LENGTH + sizeof(sys::Uint32_T);
+}
+}
+
+namespace six
+{
+namespace CSM
+{
+const char ModelState::MAGIC[] = "SIXB";
+const sys::Uint32_T ModelState::VERSION = 1;
+
+bool ModelState::isBinary(const std::string& state,
+                          const std::string& modelName)
+{
+    return (state.length() >= getHeaderLength(modelName) &&
+            state.compare(0, modelName.length(), modelName) == 0 &&
+            state[modelName.length()] == ' ' &&
+            state.compare(modelName.length() + 1, MAGIC_LENGTH, MAGIC) == 0);
+}
+
+ModelStateWriter::ModelStateWriter(const std::string& modelName) :
+    // The payload is always little endian
+    mSwapBytes(sys::isBigEndianSystem())
+{
+    mBuffer.reserve(4096);
+    mBuffer.insert(mBuffer.end(), modelName.begin(), modelName.end());
+    mBuffer.push_back(' ');
+    mBuffer.insert(mBuffer.end(), ModelState::MAGIC,
+                   ModelState::MAGIC + MAGIC_LENGTH);
+    write(ModelState::VERSION);
+}
+
+template <typename T>
+void ModelStateWriter::write(const T& value)
+{
+    six::serialize(value, mSwapBytes, mBuffer);
+}
+
+void ModelStateWriter::writeBool(bool value)
+{
+    write(static_cast<sys::Uint8_T>(value ? 1 : 0));
+}
+
+void ModelStateWriter::writeSize(size_t value)
+{
+    write(static_cast<sys::Uint64_T>(value));
+}
+
+void ModelStateWriter::writeInt(int value)
+{
+    write(static_cast<sys::Int32_T>(value));
+}
+
+void ModelStateWriter::writeDouble(double value)
+{
+    write(value);
+}
+
+void ModelStateWriter::writeString(const std::string& value)
+{
+    writeSize(value.length());
+    mBuffer.insert(mBuffer.end(), value.begin(), value.end());
+}
+
+void ModelStateWriter::writeVector3(const Vector3& value)
+{
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        writeDouble(value[ii]);
+    }
+}
+
+void ModelStateWriter::writeRowColInt(const RowColInt& value)
+{
+    write(static_cast<sys::Int64_T>(value.row));
+    write(static_cast<sys::Int64_T>(value.col));
+}
+
+void ModelStateWriter::writeRowColDouble(const RowColDouble& value)
+{
+    writeDouble(value.row);
+    writeDouble(value.col);
+}
+
+void ModelStateWriter::writeDateTime(const DateTime& value)
+{
+    writeDouble(value.getTimeInMillis());
+}
+
+void ModelStateWriter::writePoly1D(const Poly1D& value)
+{
+    const std::vector<double>& coeffs(value.coeffs());
+    writeSize(coeffs.size());
+    for (size_t ii = 0; ii < coeffs.size(); ++ii)
+    {
+        writeDouble(coeffs[ii]);
+    }
+}
+
+void ModelStateWriter::writePoly2D(const Poly2D& value)
+{
+    if (value.empty())
+    {
+        writeSize(0);
+        return;
+    }
+
+    const size_t numX = value.orderX() + 1;
+    const size_t numY = value.orderY() + 1;
+    writeSize(numX);
+    writeSize(numY);
+    for (size_t ii = 0; ii < numX; ++ii)
+    {
+        const Poly1D poly(value[ii]);
+        for (size_t jj = 0; jj < numY; ++jj)
+        {
+            writeDouble(poly[jj]);
+        }
+    }
+}
+
+void ModelStateWriter::writePolyXYZ(const PolyXYZ& value)
+{
+    const std::vector<Vector3>& coeffs(value.coeffs());
+    writeSize(coeffs.size());
+    for (size_t ii = 0; ii < coeffs.size(); ++ii)
+    {
+        writeVector3(coeffs[ii]);
+    }
+}
+
+void ModelStateWriter::writeDecorrType(const DecorrType& value)
+{
+    writeDouble(value.corrCoefZero);
+    writeDouble(value.decorrRate);
+}
+
+void ModelStateWriter::writeErrorStatistics(const ErrorStatistics* value)
+{
+    writeBool(value != NULL);
+    if (!value)
+    {
+        return;
+    }
+
+    const CompositeSCP* const compositeSCP = value->compositeSCP.get();
+    writeBool(compositeSCP != NULL);
+    if (compositeSCP)
+    {
+        writeInt(compositeSCP->scpType);
+        writeDouble(compositeSCP->xErr);
+        writeDouble(compositeSCP->yErr);
+        writeDouble(compositeSCP->xyErr);
+    }
+
+    const Components* const components = value->components.get();
+    writeBool(components != NULL);
+    if (!components)
+    {
+        return;
+    }
+
+    const PosVelError* const posVelError = components->posVelError.get();
+    writeBool(posVelError != NULL);
+    if (posVelError)
+    {
+        writeInt(posVelError->frame.mValue);
+        writeDouble(posVelError->p1);
+        writeDouble(posVelError->p2);
+        writeDouble(posVelError->p3);
+        writeDouble(posVelError->v1);
+        writeDouble(posVelError->v2);
+        writeDouble(posVelError->v3);
+
+        const CorrCoefs* const corrCoefs = posVelError->corrCoefs.get();
+        writeBool(corrCoefs != NULL);
+        if (corrCoefs)
+        {
+            writeDouble(corrCoefs->p1p2);
+            writeDouble(corrCoefs->p1p3);
+            writeDouble(corrCoefs->p1v1);
+            writeDouble(corrCoefs->p1v2);
+            writeDouble(corrCoefs->p1v3);
+            writeDouble(corrCoefs->p2p3);
+            writeDouble(corrCoefs->p2v1);
+            writeDouble(corrCoefs->p2v2);
+            writeDouble(corrCoefs->p2v3);
+            writeDouble(corrCoefs->p3v1);
+            writeDouble(corrCoefs->p3v2);
+            writeDouble(corrCoefs->p3v3);
+            writeDouble(corrCoefs->v1v2);
+            writeDouble(corrCoefs->v1v3);
+            writeDouble(corrCoefs->v2v3);
+        }
+        writeDecorrType(posVelError->positionDecorr);
+    }
+
+    const RadarSensor* const radarSensor = components->radarSensor.get();
+    writeBool(radarSensor != NULL);
+    if (radarSensor)
+    {
+        writeDouble(radarSensor->rangeBias);
+        writeDouble(radarSensor->clockFreqSF);
+        writeDouble(radarSensor->transmitFreqSF);
+        writeDecorrType(radarSensor->rangeBiasDecorr);
+    }
+
+    const TropoError* const tropoError = components->tropoError.get();
+    writeBool(tropoError != NULL);
+    if (tropoError)
+    {
+        writeDouble(tropoError->tropoRangeVertical);
+        writeDouble(tropoError->tropoRangeSlant);
+        writeDecorrType(tropoError->tropoRangeDecorr);
+    }
+
+    const IonoError* const ionoError = components->ionoError.get();
+    writeBool(ionoError != NULL);
+    if (ionoError)
+    {
+        writeDouble(ionoError->ionoRangeVertical);
+        writeDouble(ionoError->ionoRangeRateVertical);
+        writeDouble(ionoError->ionoRgRgRateCC);
+        writeDecorrType(ionoError->ionoRangeVertDecorr);
+    }
+}
+
+std::string ModelStateWriter::toString() const
+{
+    return std::string(mBuffer.begin(), mBuffer.end());
+}
+
+ModelStateReader::ModelStateReader(const std::string& state,
+                                   const std::string& modelName) :
+    mSwapBytes(sys::isBigEndianSystem()),
+    mCurrent(state.data()),
+    mEnd(state.data() + state.length())
+{
+    if (!ModelState::isBinary(state, modelName))
+    {
+        throw except::Exception(Ctxt(
+                "Not a binary " + modelName + " sensor model state"));
+    }
+
+    mCurrent += modelName.length() + 1 + MAGIC_LENGTH;
+    const sys::Uint32_T version = read<sys::Uint32_T>();
+    if (version != ModelState::VERSION)
+    {
+        throw except::Exception(Ctxt(
+                "Unsupported sensor model state version " +
+                str::toString(version)));
+    }
+}
+
+void ModelStateReader::require(size_t numElements, size_t elementSize) const
+{
+    // Divide rather than multiply so a corrupt count can't overflow
+    if (numElements > static_cast<size_t>(mEnd - mCurrent) / elementSize)
+    {
+        throw except::Exception(Ctxt("Sensor model state is truncated"));
+    }
+}
+
+template <typename T>
+T ModelStateReader::read()
+{
+    require(1, sizeof(T));
+    T value;
+    six::deserialize(mCurrent, mSwapBytes, value);
+    return value;
+}
+
+bool ModelStateReader::readBool()
+{
+    return (read<sys::Uint8_T>() != 0);
+}
+
+size_t ModelStateReader::readSize()
+{
+    return static_cast<size_t>(read<sys::Uint64_T>());
+}
+
+int ModelStateReader::readInt()
+{
+    return read<sys::Int32_T>();
+}
+
+double ModelStateReader::readDouble()
+{
+    return read<double>();
+}
+
+std::string ModelStateReader::readString()
+{
+    const size_t length = readSize();
+    require(length, 1);
+    const std::string value(mCurrent, length);
+    mCurrent += length;
+    return value;
+}
+
+Vector3 ModelStateReader::readVector3()
+{
+    Vector3 value;
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        value[ii] = readDouble();
+    }
+    return value;
+}
+
+RowColInt ModelStateReader::readRowColInt()
+{
+    const sys::Int64_T row = read<sys::Int64_T>();
+    const sys::Int64_T col = read<sys::Int64_T>();
+    return RowColInt(static_cast<sys::SSize_T>(row),
+                     static_cast<sys::SSize_T>(col));
+}
+
+RowColDouble ModelStateReader::readRowColDouble()
+{
+    const double row = readDouble();
+    const double col = readDouble();
+    return RowColDouble(row, col);
+}
+
+DateTime ModelStateReader::readDateTime()
+{
+    return DateTime(readDouble());
+}
+
+Poly1D ModelStateReader::readPoly1D()
+{
+    const size_t numCoeffs = readSize();
+    require(numCoeffs, sizeof(double));
+
+    std::vector<double> coeffs(numCoeffs);
+    for (size_t ii = 0; ii < numCoeffs; ++ii)
+    {
+        coeffs[ii] = readDouble();
+    }
+    return Poly1D(coeffs);
+}
+
+Poly2D ModelStateReader::readPoly2D()
+{
+    const size_t numX = readSize();
+    if (numX == 0)
+    {
+        return Poly2D();
+    }
+
+    const size_t numY = readSize();
+    if (numY == 0)
+    {
+        throw except::Exception(Ctxt("Invalid 2D polynomial in sensor "
+                                     "model state"));
+    }
+    require(numY, sizeof(double));
+    require(numX, numY * sizeof(double));
+
+    std::vector<double> coeffs(numX * numY);
+    for (size_t ii = 0; ii < coeffs.size(); ++ii)
+    {
+        coeffs[ii] = readDouble();
+    }
+    return Poly2D(numX - 1, numY - 1, coeffs);
+}
+
+PolyXYZ ModelStateReader::readPolyXYZ()
+{
+    const size_t numCoeffs = readSize();
+    require(numCoeffs, 3 * sizeof(double));
+
+    std::vector<Vector3> coeffs(numCoeffs);
+    for (size_t ii = 0; ii < numCoeffs; ++ii)
+    {
+        coeffs[ii] = readVector3();
+    }
+    return PolyXYZ(coeffs);
+}
+
+DecorrType ModelStateReader::readDecorrType()
+{
+    const double corrCoefZero = readDouble();
+    const double decorrRate = readDouble();
+    return DecorrType(corrCoefZero, decorrRate);
+}
+
+void ModelStateReader::readErrorStatistics(
+        mem::ScopedCopyablePtr<ErrorStatistics>& value)
+{
+    value.reset();
+    if (!readBool())
+    {
+        return;
+    }
+    value.reset(new ErrorStatistics());
+
+    if (readBool())
+    {
+        value->compositeSCP.reset(new CompositeSCP());
+        CompositeSCP& compositeSCP(*value->compositeSCP);
+        const int scpType = readInt();
+        if (scpType != CompositeSCP::ROW_COL && scpType != CompositeSCP::RG_AZ)
+        {
+            throw except::Exception(Ctxt(
+                    "Invalid composite SCP type " + str::toString(scpType)));
+        }
+        compositeSCP.scpType = static_cast<CompositeSCP::SCPType>(scpType);
+        compositeSCP.xErr = readDouble();
+        compositeSCP.yErr = readDouble();
+        compositeSCP.xyErr = readDouble();
+    }
+
+    if (!readBool())
+    {
+        return;
+    }
+    value->components.reset(new Components());
+    Components& components(*value->components);
+
+    if (readBool())
+    {
+        components.posVelError.reset(new PosVelError());
+        PosVelError& posVelError(*components.posVelError);
+        const int frame = readInt();
+        if (frame < FrameType::ECF || frame > FrameType::NOT_SET)
+        {
+            throw except::Exception(Ctxt(
+                    "Invalid frame type " + str::toString(frame)));
+        }
+        posVelError.frame =
+                FrameType(static_cast<FrameType::FrameTypesEnum>(frame));
+        posVelError.p1 = readDouble();
+        posVelError.p2 = readDouble();
+        posVelError.p3 = readDouble();
+        posVelError.v1 = readDouble();
+        posVelError.v2 = readDouble();
+        posVelError.v3 = readDouble();
+
+        if (readBool())
+        {
+            posVelError.corrCoefs.reset(new CorrCoefs());
+            CorrCoefs& corrCoefs(*posVelError.corrCoefs);
+            corrCoefs.p1p2 = readDouble();
+            corrCoefs.p1p3 = readDouble();
+            corrCoefs.p1v1 = readDouble();
+            corrCoefs.p1v2 = readDouble();
+            corrCoefs.p1v3 = readDouble();
+            corrCoefs.p2p3 = readDouble();
+            corrCoefs.p2v1 = readDouble();
+            corrCoefs.p2v2 = readDouble();
+            corrCoefs.p2v3 = readDouble();
+            corrCoefs.p3v1 = readDouble();
+            corrCoefs.p3v2 = readDouble();
+            corrCoefs.p3v3 = readDouble();
+            corrCoefs.v1v2 = readDouble();
+            corrCoefs.v1v3 = readDouble();
+            corrCoefs.v2v3 = readDouble();
+        }
+        posVelError.positionDecorr = readDecorrType();
+    }
+
+    if (readBool())
+    {
+        components.radarSensor.reset(new RadarSensor());
+        RadarSensor& radarSensor(*components.radarSensor);
+        radarSensor.rangeBias = readDouble();
+        radarSensor.clockFreqSF = readDouble();
+        radarSensor.transmitFreqSF = readDouble();
+        radarSensor.rangeBiasDecorr = readDecorrType();
+    }
+
+    if (readBool())
+    {
+        components.tropoError.reset(new TropoError());
+        TropoError& tropoError(*components.tropoError);
+        tropoError.tropoRangeVertical = readDouble();
+        tropoError.tropoRangeSlant = readDouble();
+        tropoError.tropoRangeDecorr = readDecorrType();
+    }
+
+    if (readBool())
+    {
+        components.ionoError.reset(new IonoError());
+        IonoError& ionoError(*components.ionoError);
+        ionoError.ionoRangeVertical = readDouble();
+        ionoError.ionoRangeRateVertical = readDouble();
+        ionoError.ionoRgRgRateCC = readDouble();
+        ionoError.ionoRangeVertDecorr = readDecorrType();
+    }
+}
+
+void ModelStateReader::checkEnd() const
+{
+    if (mCurrent != mEnd)
+    {
+        throw except::Exception(Ctxt(
+                "Sensor model state has " +
+                str::toString(mEnd - mCurrent) + " unexpected trailing bytes"));
+    }
+}
+}
+}
@@ -31,6 +31,65 @@
 #include <six/sicd/ComplexXMLControl.h>
 #include <six/sicd/Utilities.h>
 
+namespace
+{
+// Rebuilds just the parts of the SICD written by
+// SICDSensorModel::writeModelStateImpl()
+std::auto_ptr<six::sicd::ComplexData>
+readComplexData(six::CSM::ModelStateReader& reader)
+{
+    std::auto_ptr<six::sicd::ComplexData> data(new six::sicd::ComplexData());
+
+    six::sicd::CollectionInformation& collectionInfo(
+            *data->collectionInformation);
+    collectionInfo.collectorName = reader.readString();
+    collectionInfo.coreName = reader.readString();
+    collectionInfo.radarMode = six::RadarModeType(reader.readInt());
+    data->timeline->collectStart = reader.readDateTime();
+
+    six::sicd::ImageData& imageData(*data->imageData);
+    imageData.numRows = reader.readSize();
+    imageData.numCols = reader.readSize();
+    imageData.firstRow = reader.readSize();
+    imageData.firstCol = reader.readSize();
+    imageData.scpPixel = reader.readRowColInt();
+
+    six::sicd::Grid& grid(*data->grid);
+    grid.type = six::ComplexImageGridType(reader.readInt());
+    grid.row->unitVector = reader.readVector3();
+    grid.row->sampleSpacing = reader.readDouble();
+    grid.col->unitVector = reader.readVector3();
+    grid.col->sampleSpacing = reader.readDouble();
+    grid.timeCOAPoly = reader.readPoly2D();
+
+    data->geoData->scp.ecf = reader.readVector3();
+    data->scpcoa->arpPos = reader.readVector3();
+    data->scpcoa->arpVel = reader.readVector3();
+    data->scpcoa->sideOfTrack = six::SideOfTrackType(reader.readInt());
+    data->position->arpPoly = reader.readPolyXYZ();
+
+    if (reader.readBool())
+    {
+        data->pfa.reset(new six::sicd::PFA());
+        data->pfa->polarAnglePoly = reader.readPoly1D();
+        data->pfa->spatialFrequencyScaleFactorPoly = reader.readPoly1D();
+    }
+
+    if (reader.readBool())
+    {
+        data->rma.reset(new six::sicd::RMA());
+        data->rma->inca.reset(new six::sicd::INCA());
+        six::sicd::INCA& inca(*data->rma->inca);
+        inca.timeCAPoly = reader.readPoly1D();
+        inca.dopplerRateScaleFactorPoly = reader.readPoly2D();
+        inca.rangeCA = reader.readDouble();
+    }
+
+    reader.readErrorStatistics(data->errorStatistics);
+    return data;
+}
+}
+
 namespace six
 {
 namespace CSM
@@ -102,10 +161,6 @@ void SICDSensorModel::initializeFromFile(const std::string& pathname)
         // Cast it and grab a copy
         mData.reset(reinterpret_cast<six::sicd::ComplexData*>(
                 container->getData(0)->clone()));
-
-        // get xml as string for sensor model state
-        const std::string xmlStr = six::toXMLString(mData.get(), &xmlRegistry);
-        mSensorModelState = NAME + std::string(" ") + xmlStr;
         reinitialize();
     }
     catch (const except::Exception& ex)
@@ -181,11 +236,6 @@ void SICDSensorModel::initializeFromISD(const csm::Nitf21Isd& isd)
                                "SICDSensorModel::SICDSensorModel");
         }
 
-        // get xml as string for sensor model state
-        io::StringStream stringStream;
-        sicdXML->getRootElement()->print(stringStream);
-        mSensorModelState = NAME + std::string(" ") + stringStream.stream().str();
-
         six::XMLControlRegistry xmlRegistry;
         xmlRegistry.addCreator(six::DataType::COMPLEX,
                 new six::XMLControlCreatorT<six::sicd::ComplexXMLControl>());
@@ -389,6 +439,24 @@ csm::ImageVector SICDSensorModel::getImageSize() const
 
 void SICDSensorModel::replaceModelStateImpl(const std::string& sensorModelState)
 {
+    if (ModelState::isBinary(sensorModelState, NAME))
+    {
+        try
+        {
+            ModelStateReader reader(sensorModelState, NAME);
+            mData = readComplexData(reader);
+            reinitialize();
+            readAdjustments(reader);
+        }
+        catch (const except::Exception& ex)
+        {
+            throw csm::Error(csm::Error::INVALID_SENSOR_MODEL_STATE,
+                               ex.getMessage(),
+                               "SICDSensorModel::replaceModelStateImpl");
+        }
+        return;
+    }
+
     const size_t idx = sensorModelState.find(' ');
     if (idx == std::string::npos)
     {
@@ -423,9 +491,6 @@ void SICDSensorModel::replaceModelStateImpl(const std::string& sensorModelState)
         std::auto_ptr<six::XMLControl> control(
                 xmlRegistry.newXMLControl(six::DataType::COMPLEX, &logger));
 
-        // get xml as string for sensor model state
-        mSensorModelState = sensorModelState;
-
         mData.reset(reinterpret_cast<six::sicd::ComplexData*>(control->fromXML(
                 domParser.getDocument(), mSchemaDirs)));
         reinitialize();
@@ -438,6 +503,57 @@ void SICDSensorModel::replaceModelStateImpl(const std::string& sensorModelState)
     }
 }
 
+void SICDSensorModel::writeModelStateImpl(ModelStateWriter& writer) const
+{
+    const six::sicd::CollectionInformation& collectionInfo(
+            *mData->collectionInformation);
+    writer.writeString(collectionInfo.collectorName);
+    writer.writeString(collectionInfo.coreName);
+    writer.writeInt(collectionInfo.radarMode.value);
+    writer.writeDateTime(mData->timeline->collectStart);
+
+    const six::sicd::ImageData& imageData(*mData->imageData);
+    writer.writeSize(imageData.numRows);
+    writer.writeSize(imageData.numCols);
+    writer.writeSize(imageData.firstRow);
+    writer.writeSize(imageData.firstCol);
+    writer.writeRowColInt(imageData.scpPixel);
+
+    const six::sicd::Grid& grid(*mData->grid);
+    writer.writeInt(grid.type.value);
+    writer.writeVector3(grid.row->unitVector);
+    writer.writeDouble(grid.row->sampleSpacing);
+    writer.writeVector3(grid.col->unitVector);
+    writer.writeDouble(grid.col->sampleSpacing);
+    writer.writePoly2D(grid.timeCOAPoly);
+
+    writer.writeVector3(mData->geoData->scp.ecf);
+    writer.writeVector3(mData->scpcoa->arpPos);
+    writer.writeVector3(mData->scpcoa->arpVel);
+    writer.writeInt(mData->scpcoa->sideOfTrack.value);
+    writer.writePolyXYZ(mData->position->arpPoly);
+
+    const six::sicd::PFA* const pfa = mData->pfa.get();
+    writer.writeBool(pfa != NULL);
+    if (pfa)
+    {
+        writer.writePoly1D(pfa->polarAnglePoly);
+        writer.writePoly1D(pfa->spatialFrequencyScaleFactorPoly);
+    }
+
+    const six::sicd::INCA* const inca =
+            mData->rma.get() ? mData->rma->inca.get() : NULL;
+    writer.writeBool(inca != NULL);
+    if (inca)
+    {
+        writer.writePoly1D(inca->timeCAPoly);
+        writer.writePoly2D(inca->dopplerRateScaleFactorPoly);
+        writer.writeDouble(inca->rangeCA);
+    }
+
+    writer.writeErrorStatistics(mData->errorStatistics.get());
+}
+
 void SICDSensorModel::reinitialize()
 {
     mGeometry.reset(six::sicd::Utilities::getSceneGeometry(mData.get()));
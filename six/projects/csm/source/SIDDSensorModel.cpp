@@ -31,6 +31,77 @@
 #include <six/sidd/DerivedXMLControl.h>
 #include <six/sidd/Utilities.h>
 
+namespace
+{
+// Rebuilds just the parts of the SIDD written by
+// SIDDSensorModel::writeModelStateImpl()
+std::auto_ptr<six::sidd::DerivedData>
+readDerivedData(six::CSM::ModelStateReader& reader)
+{
+    std::auto_ptr<six::sidd::DerivedData> data(new six::sidd::DerivedData());
+    data->productCreation->productName = reader.readString();
+
+    data->exploitationFeatures.reset(new six::sidd::ExploitationFeatures(1));
+    six::sidd::Collection& collection(
+            *data->exploitationFeatures->collections[0]);
+    collection.identifier = reader.readString();
+    collection.information->sensorName = reader.readString();
+    collection.information->radarMode = six::RadarModeType(reader.readInt());
+    collection.information->collectionDateTime = reader.readDateTime();
+    collection.information->collectionDuration = reader.readDouble();
+
+    const six::RowColInt pixelFootprint = reader.readRowColInt();
+    const six::PolyXYZ arpPoly = reader.readPolyXYZ();
+
+    const six::ProjectionType projectionType(reader.readInt());
+    if (projectionType != six::ProjectionType::PLANE &&
+        projectionType != six::ProjectionType::GEOGRAPHIC)
+    {
+        throw except::Exception(Ctxt("Grid type not supported: " +
+                projectionType.toString()));
+    }
+
+    data->measurement.reset(new six::sidd::Measurement(projectionType));
+    six::sidd::Measurement& measurement(*data->measurement);
+    measurement.pixelFootprint = pixelFootprint;
+    measurement.arpPoly = arpPoly;
+
+    six::sidd::MeasurableProjection& projection(
+            *reinterpret_cast<six::sidd::MeasurableProjection*>(
+                    measurement.projection.get()));
+    projection.referencePoint.ecef = reader.readVector3();
+    projection.referencePoint.rowCol = reader.readRowColDouble();
+    projection.sampleSpacing = reader.readRowColDouble();
+    projection.timeCOAPoly = reader.readPoly2D();
+    if (projectionType == six::ProjectionType::PLANE)
+    {
+        six::sidd::ProductPlane& productPlane(
+                reinterpret_cast<six::sidd::PlaneProjection&>(projection).
+                        productPlane);
+        productPlane.rowUnitVector = reader.readVector3();
+        productPlane.colUnitVector = reader.readVector3();
+    }
+
+    if (reader.readBool())
+    {
+        data->downstreamReprocessing.reset(
+                new six::sidd::DownstreamReprocessing());
+        data->downstreamReprocessing->geometricChip.reset(
+                new six::sidd::GeometricChip());
+        six::sidd::GeometricChip& chip(
+                *data->downstreamReprocessing->geometricChip);
+        chip.chipSize = reader.readRowColInt();
+        chip.originalUpperLeftCoordinate = reader.readRowColDouble();
+        chip.originalUpperRightCoordinate = reader.readRowColDouble();
+        chip.originalLowerLeftCoordinate = reader.readRowColDouble();
+        chip.originalLowerRightCoordinate = reader.readRowColDouble();
+    }
+
+    reader.readErrorStatistics(data->errorStatistics);
+    return data;
+}
+}
+
 namespace six
 {
 namespace CSM
@@ -135,10 +206,6 @@ void SIDDSensorModel::initializeFromFile(const std::string& pathname,
 
         // Cast it and grab a copy
         mData.reset(reinterpret_cast<six::sidd::DerivedData*>(data->clone()));
-
-        // get xml as string for sensor model state
-        const std::string xmlStr = six::toXMLString(mData.get(), &xmlRegistry);
-        mSensorModelState = NAME + std::string(" ") + xmlStr;
         reinitialize();
     }
     catch (const except::Exception& ex)
@@ -212,11 +279,6 @@ void SIDDSensorModel::initializeFromISD(const csm::Nitf21Isd& isd,
                                "SIDDSensorModel::SIDDSensorModel");
         }
 
-        // get xml as string for sensor model state
-        io::StringStream stringStream;
-        siddXML->getRootElement()->print(stringStream);
-        mSensorModelState = NAME + std::string(" ") + stringStream.stream().str();
-
         six::XMLControlRegistry xmlRegistry;
         xmlRegistry.addCreator(six::DataType::DERIVED,
                 new six::XMLControlCreatorT<six::sidd::DerivedXMLControl>());
@@ -394,6 +456,24 @@ csm::ImageVector SIDDSensorModel::getImageSize() const
 
 void SIDDSensorModel::replaceModelStateImpl(const std::string& sensorModelState)
 {
+    if (ModelState::isBinary(sensorModelState, NAME))
+    {
+        try
+        {
+            ModelStateReader reader(sensorModelState, NAME);
+            mData = readDerivedData(reader);
+            reinitialize();
+            readAdjustments(reader);
+        }
+        catch (const except::Exception& ex)
+        {
+            throw csm::Error(csm::Error::INVALID_SENSOR_MODEL_STATE,
+                               ex.getMessage(),
+                               "SIDDSensorModel::replaceModelStateImpl");
+        }
+        return;
+    }
+
     const size_t idx = sensorModelState.find(' ');
     if (idx == std::string::npos)
     {
@@ -428,9 +508,6 @@ void SIDDSensorModel::replaceModelStateImpl(const std::string& sensorModelState)
         std::auto_ptr<six::XMLControl> control(xmlRegistry.newXMLControl(
                 six::DataType::DERIVED, &logger));
 
-        // get xml as string for sensor model state
-        mSensorModelState = sensorModelState;
-
         mData.reset(reinterpret_cast<six::sidd::DerivedData*>(control->fromXML(
                 domParser.getDocument(), mSchemaDirs)));
         reinitialize();
@@ -458,6 +535,54 @@ const six::sidd::MeasurableProjection* SIDDSensorModel::getProjection() const
     return projection;
 }
 
+void SIDDSensorModel::writeModelStateImpl(ModelStateWriter& writer) const
+{
+    writer.writeString(mData->productCreation->productName);
+
+    // TODO: If there's more than one collection, what should we use?
+    const six::sidd::Collection& collection(
+            *mData->exploitationFeatures->collections[0]);
+    writer.writeString(collection.identifier);
+    writer.writeString(collection.information->sensorName);
+    writer.writeInt(collection.information->radarMode.value);
+    writer.writeDateTime(collection.information->collectionDateTime);
+    writer.writeDouble(collection.information->collectionDuration);
+
+    const six::sidd::Measurement& measurement(*mData->measurement);
+    writer.writeRowColInt(measurement.pixelFootprint);
+    writer.writePolyXYZ(measurement.arpPoly);
+
+    const six::sidd::MeasurableProjection* const projection(getProjection());
+    writer.writeInt(projection->projectionType.value);
+    writer.writeVector3(projection->referencePoint.ecef);
+    writer.writeRowColDouble(projection->referencePoint.rowCol);
+    writer.writeRowColDouble(projection->sampleSpacing);
+    writer.writePoly2D(projection->timeCOAPoly);
+    if (projection->projectionType == six::ProjectionType::PLANE)
+    {
+        const six::sidd::ProductPlane& productPlane(
+                reinterpret_cast<const six::sidd::PlaneProjection*>(
+                        projection)->productPlane);
+        writer.writeVector3(productPlane.rowUnitVector);
+        writer.writeVector3(productPlane.colUnitVector);
+    }
+
+    const six::sidd::GeometricChip* const chip =
+            mData->downstreamReprocessing.get() ?
+                    mData->downstreamReprocessing->geometricChip.get() : NULL;
+    writer.writeBool(chip != NULL);
+    if (chip)
+    {
+        writer.writeRowColInt(chip->chipSize);
+        writer.writeRowColDouble(chip->originalUpperLeftCoordinate);
+        writer.writeRowColDouble(chip->originalUpperRightCoordinate);
+        writer.writeRowColDouble(chip->originalLowerLeftCoordinate);
+        writer.writeRowColDouble(chip->originalLowerRightCoordinate);
+    }
+
+    writer.writeErrorStatistics(mData->errorStatistics.get());
+}
+
 void SIDDSensorModel::reinitialize()
 {
     // This goofiness is for Sun Studio 11 which can't figure out an auto_ptr
@@ -24,6 +24,9 @@
 #include <limits>
 
 #include "Error.h"
+#include <sys/Runnable.h>
+#include <mt/ThreadGroup.h>
+#include <mt/ThreadPlanner.h>
 #include <six/NITFReadControl.h>
 #include <six/csm/SIXSensorModel.h>
 
@@ -121,6 +124,155 @@ math::linear::Matrix2D<T> matrixSqrt(const math::linear::Matrix2D<T>& m)
     const math::linear::Matrix2D<T> eigenVec = eig.getV();
     return (eigenVec * diag * eigenVec.transpose());
 }
+
+// Runs batch(startPoint, numPoints) on one thread's share of the points
+template <typename BatchT>
+class BatchRunnable : public sys::Runnable
+{
+public:
+    BatchRunnable(const BatchT& batch, size_t startPoint, size_t numPoints) :
+        mBatch(batch),
+        mStartPoint(startPoint),
+        mNumPoints(numPoints)
+    {
+    }
+
+    virtual void run()
+    {
+        mBatch(mStartPoint, mNumPoints);
+    }
+
+private:
+    const BatchT& mBatch;
+    const size_t mStartPoint;
+    const size_t mNumPoints;
+};
+
+// Splits 'numPoints' points across 'numThreads' threads
+template <typename BatchT>
+void runBatch(const BatchT& batch, size_t numPoints, size_t numThreads)
+{
+    const mt::ThreadPlanner planner(numPoints, numThreads);
+    mt::ThreadGroup threads;
+    size_t threadNum(0);
+    size_t startPoint(0);
+    size_t numPointsThisThread(0);
+    while (planner.getThreadInfo(threadNum++, startPoint, numPointsThisThread))
+    {
+        threads.createThread(new BatchRunnable<BatchT>(
+                batch, startPoint, numPointsThisThread));
+    }
+    threads.joinAll();
+}
+
+// Each of these runs the corresponding SIXSensorModel batch method on a
+// subset of the points with a single thread
+template <typename InputT, typename OutputT>
+class GroundToImageBatch
+{
+public:
+    GroundToImageBatch(const six::CSM::SIXSensorModel& model,
+                       const InputT* groundPts,
+                       OutputT* imagePts) :
+        mModel(model),
+        mGroundPts(groundPts),
+        mImagePts(imagePts)
+    {
+    }
+
+    void operator()(size_t startPoint, size_t numPoints) const
+    {
+        mModel.groundToImage(mGroundPts + startPoint, numPoints, 1,
+                             mImagePts + startPoint);
+    }
+
+private:
+    const six::CSM::SIXSensorModel& mModel;
+    const InputT* const mGroundPts;
+    OutputT* const mImagePts;
+};
+
+class ImageToGroundBatch
+{
+public:
+    ImageToGroundBatch(const six::CSM::SIXSensorModel& model,
+                       const csm::ImageCoord* imagePts,
+                       double height,
+                       csm::EcefCoord* groundPts) :
+        mModel(model),
+        mImagePts(imagePts),
+        mHeight(height),
+        mGroundPts(groundPts)
+    {
+    }
+
+    void operator()(size_t startPoint, size_t numPoints) const
+    {
+        mModel.imageToGround(mImagePts + startPoint, numPoints, mHeight, 1,
+                             mGroundPts + startPoint);
+    }
+
+private:
+    const six::CSM::SIXSensorModel& mModel;
+    const csm::ImageCoord* const mImagePts;
+    const double mHeight;
+    csm::EcefCoord* const mGroundPts;
+};
+
+class ImageToGroundCovarBatch
+{
+public:
+    ImageToGroundCovarBatch(const six::CSM::SIXSensorModel& model,
+                            const csm::ImageCoordCovar* imagePts,
+                            double height,
+                            double heightVariance,
+                            csm::EcefCoordCovar* groundPts) :
+        mModel(model),
+        mImagePts(imagePts),
+        mHeight(height),
+        mHeightVariance(heightVariance),
+        mGroundPts(groundPts)
+    {
+    }
+
+    void operator()(size_t startPoint, size_t numPoints) const
+    {
+        mModel.imageToGround(mImagePts + startPoint, numPoints,
+                             mHeight, mHeightVariance, 1,
+                             mGroundPts + startPoint);
+    }
+
+private:
+    const six::CSM::SIXSensorModel& mModel;
+    const csm::ImageCoordCovar* const mImagePts;
+    const double mHeight;
+    const double mHeightVariance;
+    csm::EcefCoordCovar* const mGroundPts;
+};
+
+class GroundPartialsBatch
+{
+public:
+    GroundPartialsBatch(const six::CSM::SIXSensorModel& model,
+                        const csm::EcefCoord* groundPts,
+                        double* partials) :
+        mModel(model),
+        mGroundPts(groundPts),
+        mPartials(partials)
+    {
+    }
+
+    void operator()(size_t startPoint, size_t numPoints) const
+    {
+        mModel.computeGroundPartials(mGroundPts + startPoint, numPoints, 1,
+                                     mPartials + 6 * startPoint);
+    }
+
+private:
+    const six::CSM::SIXSensorModel& mModel;
+    const csm::EcefCoord* const mGroundPts;
+    double* const mPartials;
+};
 }
 
 namespace six
@@ -135,7 +287,53 @@ SIXSensorModel::SIXSensorModel()
 
 std::string SIXSensorModel::getModelState() const
 {
-    return mSensorModelState;
+    ModelStateWriter writer(getModelName());
+    writeModelStateImpl(writer);
+
+    // The adjustments aren't part of the SICD/SIDD, so write them separately
+    const scene::AdjustableParams& params(mProjection->getAdjustableParams());
+    for (size_t ii = 0; ii < scene::AdjustableParams::NUM_PARAMS; ++ii)
+    {
+        writer.writeDouble(params[ii]);
+        writer.writeInt(mAdjustableTypes[ii]);
+    }
+
+    for (size_t ii = 0; ii < scene::AdjustableParams::NUM_PARAMS; ++ii)
+    {
+        for (size_t jj = 0; jj < scene::AdjustableParams::NUM_PARAMS; ++jj)
+        {
+            writer.writeDouble(mSensorCovariance(ii, jj));
+        }
+    }
+
+    return writer.toString();
+}
+
+void SIXSensorModel::readAdjustments(ModelStateReader& reader)
+{
+    scene::AdjustableParams& params(mProjection->getAdjustableParams());
+    for (size_t ii = 0; ii < scene::AdjustableParams::NUM_PARAMS; ++ii)
+    {
+        params.mParams[ii] = reader.readDouble();
+
+        const int type = reader.readInt();
+        if (type < csm::param::NONE || type > csm::param::FIXED)
+        {
+            throw except::Exception(Ctxt(
+                    "Invalid parameter type " + str::toString(type)));
+        }
+        mAdjustableTypes[ii] = static_cast<csm::param::Type>(type);
+    }
+
+    for (size_t ii = 0; ii < scene::AdjustableParams::NUM_PARAMS; ++ii)
+    {
+        for (size_t jj = 0; jj < scene::AdjustableParams::NUM_PARAMS; ++jj)
+        {
+            mSensorCovariance(ii, jj) = reader.readDouble();
+        }
+    }
+
+    reader.checkEnd();
 }
 
 void SIXSensorModel::replaceModelState(const std::string& argState)
@@ -353,8 +551,11 @@ SIXSensorModel::computeGroundPartials(const csm::EcefCoord& groundPt) const
         const types::RowCol<double> imagePt =
                 mProjection->sceneToImage(sceneGroundPt);
 
-        const math::linear::MatrixMxN<2, 3> groundPartials =
-                mProjection->sceneToImagePartials(sceneGroundPt, imagePt);
+        math::linear::MatrixMxN<2, 3> groundPartials;
+        math::linear::MatrixMxN<2, 7> sensorPartials;
+        mProjection->sceneToImageAnalyticPartials(sceneGroundPt, imagePt,
+                                                  groundPartials,
+                                                  sensorPartials);
 
         // sceneToImagePartials() return value is in m/m,
         // computeGroundPartials wants pixels/m
@@ -455,9 +656,11 @@ csm::RasterGM::SensorPartials SIXSensorModel::computeSensorPartials(
 
         const types::RowCol<double> pixelPt = fromPixel(imagePt);
 
-        const math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(sceneGroundPt,
-                                                        pixelPt);
+        math::linear::MatrixMxN<2, 3> groundPartials;
+        math::linear::MatrixMxN<2, 7> sensorPartials;
+        mProjection->sceneToImageAnalyticPartials(sceneGroundPt, pixelPt,
+                                                  groundPartials,
+                                                  sensorPartials);
 
         // TODO: Currently no way to determine the actual precision that was
         //       achieved, so setting it to the desired precision
@@ -524,9 +727,11 @@ SIXSensorModel::computeAllSensorPartials(
         const scene::Vector3 sceneGroundPt(toVector3(groundPt));
 
         const types::RowCol<double> pixelPt = fromPixel(imagePt);
-        const math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(sceneGroundPt,
-                                                        pixelPt);
+        math::linear::MatrixMxN<2, 3> groundPartials;
+        math::linear::MatrixMxN<2, 7> sensorPartials;
+        mProjection->sceneToImageAnalyticPartials(sceneGroundPt, pixelPt,
+                                                  groundPartials,
+                                                  sensorPartials);
 
         // TODO: Currently no way to determine the actual precision that was
         //       achieved, so setting it to the desired precision
@@ -672,44 +877,17 @@ csm::ImageCoordCovar SIXSensorModel::groundToImage(
 {
     try
     {
-        const csm::ImageCoord imagePt = groundToImageImpl(groundPt,
-                                                          desiredPrecision,
-                                                          achievedPrecision);
-        const scene::Vector3 scenePt(toVector3(groundPt));
-        types::RowCol<double> pixelPt(fromPixel(imagePt));
-        // m^2
-        // NOTE: See mSensorCovariance member variable definition in header
-        //       for why we're not computing the sensor covariance for this
-        //       point
-        const math::linear::MatrixMxN<3, 3> userCovar(groundPt.covariance);
-        const math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(scenePt);
-        const math::linear::MatrixMxN<2, 3> imagePartials =
-                mProjection->sceneToImagePartials(scenePt);
-        const math::linear::MatrixMxN<2, 2> unmodeledCovar =
-                mProjection->getUnmodeledErrorCovariance(pixelPt);
-        const math::linear::MatrixMxN<2, 2> errorCovar =
-                unmodeledCovar +
-                (imagePartials * userCovar * imagePartials.transpose()) +
-                (sensorPartials * mSensorCovariance *
-                 sensorPartials.transpose());
-        csm::ImageCoordCovar csmErrorCovar;
-        types::RowCol<double> ss = getSampleSpacing();
-        csmErrorCovar.line = imagePt.line;
-        csmErrorCovar.samp = imagePt.samp;
-        csmErrorCovar.covariance[0] =
-                errorCovar[0][0] / (ss.row * ss.row);
-        csmErrorCovar.covariance[1] =
-                errorCovar[0][1] /
-                (ss.row *
-                 ss.col);
-        csmErrorCovar.covariance[2] =
-                errorCovar[1][0] /
-                (ss.row *
-                 ss.col);
-        csmErrorCovar.covariance[3] =
-                errorCovar[1][1] / (ss.col * ss.col);
-        return csmErrorCovar;
+        // TODO: Currently no way to specify desiredPrecision when calling
+        //       sceneToImage()
+        const types::RowCol<double> imagePt =
+                mProjection->sceneToImage(toVector3(groundPt));
+
+        if (achievedPrecision)
+        {
+            *achievedPrecision = desiredPrecision;
+        }
+
+        return toImageCoordCovar(groundPt, imagePt);
     }
     catch (const except::Exception& ex)
     {
@@ -719,6 +897,49 @@ csm::ImageCoordCovar SIXSensorModel::groundToImage(
     }
 }
 
+csm::ImageCoordCovar SIXSensorModel::toImageCoordCovar(
+        const csm::EcefCoordCovar& groundPt,
+        const types::RowCol<double>& imagePt) const
+{
+    const scene::Vector3 scenePt(toVector3(groundPt));
+    math::linear::MatrixMxN<2, 3> imagePartials;
+    math::linear::MatrixMxN<2, 7> sensorPartials;
+    mProjection->sceneToImageAnalyticPartials(scenePt, imagePt,
+                                              imagePartials, sensorPartials);
+
+    // m^2
+    // NOTE: See mSensorCovariance member variable definition in header
+    //       for why we're not computing the sensor covariance for this
+    //       point
+    const math::linear::MatrixMxN<3, 3> userCovar(groundPt.covariance);
+    const math::linear::MatrixMxN<2, 2> unmodeledCovar =
+            mProjection->getUnmodeledErrorCovariance(imagePt);
+    const math::linear::MatrixMxN<2, 2> errorCovar =
+            unmodeledCovar +
+            (imagePartials * userCovar * imagePartials.transpose()) +
+            (sensorPartials * mSensorCovariance *
+             sensorPartials.transpose());
+
+    const types::RowCol<double> pixelPt = toPixel(imagePt);
+    csm::ImageCoordCovar csmErrorCovar;
+    types::RowCol<double> ss = getSampleSpacing();
+    csmErrorCovar.line = pixelPt.row;
+    csmErrorCovar.samp = pixelPt.col;
+    csmErrorCovar.covariance[0] =
+            errorCovar[0][0] / (ss.row * ss.row);
+    csmErrorCovar.covariance[1] =
+            errorCovar[0][1] /
+            (ss.row *
+             ss.col);
+    csmErrorCovar.covariance[2] =
+            errorCovar[1][0] /
+            (ss.row *
+             ss.col);
+    csmErrorCovar.covariance[3] =
+            errorCovar[1][1] / (ss.col * ss.col);
+    return csmErrorCovar;
+}
+
 csm::EcefCoord SIXSensorModel::imageToGround(
         const csm::ImageCoord& imagePt,
         double height,
@@ -768,76 +989,271 @@ csm::EcefCoordCovar SIXSensorModel::imageToGround(
                                                       achievedPrecision,
                                                       warnings);
 
-        const double a = scene::WGS84EllipsoidModel::EQUATORIAL_RADIUS_METERS;
-        const double b = scene::WGS84EllipsoidModel::POLAR_RADIUS_METERS;
-        const scene::Vector3 scenePt(toVector3(groundPt));
-        types::RowCol<double> pixelPt(fromPixel((csm::ImageCoord&) imagePt));
-
-        // NOTE: See mSensorCovariance member variable definition in header
-        //       for why we're not computing the sensor covariance for this
-        //       point
-        const math::linear::MatrixMxN<2, 2> userCovar(imagePt.covariance);
-        math::linear::MatrixMxN<2, 2> unmodeledCovar =
-                mProjection->getUnmodeledErrorCovariance(pixelPt);
-        math::linear::MatrixMxN<2, 3> groundPartials =
-                mProjection->sceneToImagePartials(scenePt);
-        math::linear::MatrixMxN<2, 7> sensorPartials =
-                mProjection->sceneToImageSensorPartials(scenePt);
-
-        math::linear::MatrixMxN<10, 10> fullCovar(0.0);
-        unmodeledCovar = unmodeledCovar + userCovar;
-        fullCovar.addInPlace(unmodeledCovar, 0, 0);
-        fullCovar[2][2] = heightVariance;
-        fullCovar.addInPlace(mSensorCovariance, 3, 3);
-        types::RowCol<double> ss = getSampleSpacing();
-        for (size_t ii = 0; ii < 3; ++ii)
+        return toEcefCoordCovar(imagePt, height, heightVariance,
+                                toVector3(groundPt));
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::imageToGround");
+    }
+}
+
+csm::EcefCoordCovar SIXSensorModel::toEcefCoordCovar(
+        const csm::ImageCoordCovar& imagePt,
+        double height,
+        double heightVariance,
+        const scene::Vector3& groundPt) const
+{
+    const double a = scene::WGS84EllipsoidModel::EQUATORIAL_RADIUS_METERS;
+    const double b = scene::WGS84EllipsoidModel::POLAR_RADIUS_METERS;
+    const types::RowCol<double> pixelPt(fromPixel(imagePt));
+
+    // NOTE: See mSensorCovariance member variable definition in header
+    //       for why we're not computing the sensor covariance for this
+    //       point
+    const math::linear::MatrixMxN<2, 2> userCovar(imagePt.covariance);
+    math::linear::MatrixMxN<2, 2> unmodeledCovar =
+            mProjection->getUnmodeledErrorCovariance(pixelPt);
+    math::linear::MatrixMxN<2, 3> groundPartials;
+    math::linear::MatrixMxN<2, 7> sensorPartials;
+    mProjection->sceneToImageAnalyticPartials(groundPt, pixelPt,
+                                              groundPartials,
+                                              sensorPartials);
+
+    math::linear::MatrixMxN<10, 10> fullCovar(0.0);
+    unmodeledCovar = unmodeledCovar + userCovar;
+    fullCovar.addInPlace(unmodeledCovar, 0, 0);
+    fullCovar[2][2] = heightVariance;
+    fullCovar.addInPlace(mSensorCovariance, 3, 3);
+    types::RowCol<double> ss = getSampleSpacing();
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        groundPartials[0][ii] /= ss.row;
+        groundPartials[1][ii] /= ss.col;
+    }
+
+    for (size_t ii = 0; ii < 7; ++ii)
+    {
+        sensorPartials[0][ii] /= ss.row;
+        sensorPartials[1][ii] /= ss.col;
+    }
+
+    math::linear::MatrixMxN<3, 3> B(0.0);
+    B.addInPlace(groundPartials, 0, 0);
+    B[2][0] = 2 * groundPt[0] / square(a + height);
+    B[2][1] = 2 * groundPt[1] / square(a + height);
+    B[2][2] = 2 * groundPt[2] / square(b + height);
+
+    math::linear::MatrixMxN<3, 10> A(0.0);
+    A[2][2] = -2.0 * ((square(groundPt[0]) + square(groundPt[1])) /
+                      cube(a + height) +
+              square(groundPt[2]) / cube(b + height));
+    A.addInPlace(sensorPartials, 0, 3);
+    A[0][0] = A[1][1] = 1.0;
+
+    const math::linear::MatrixMxN<3, 3> Q = A * fullCovar * A.transpose();
+
+    const math::linear::MatrixMxN<3, 3> Qinv = inverse(Q);
+
+    const math::linear::MatrixMxN<3, 3> imageToGroundCovarInv =
+            B.transpose() * Qinv * B;
+
+    const math::linear::MatrixMxN<3, 3> errorCovar =
+            inverse(imageToGroundCovarInv);
+
+    csm::EcefCoordCovar csmErrorCovar;
+    csmErrorCovar.x = groundPt[0];
+    csmErrorCovar.y = groundPt[1];
+    csmErrorCovar.z = groundPt[2];
+    for (size_t ii = 0; ii < 3; ++ii)
+    {
+        for (size_t jj = 0; jj < 3; ++jj)
+        {
+            csmErrorCovar.covariance[ii * 3 + jj] = errorCovar[ii][jj];
+        }
+    }
+
+    return csmErrorCovar;
+}
+
+void SIXSensorModel::groundToImageGrid(
+        const csm::EcefCoord* groundPts,
+        size_t numPoints,
+        std::vector<types::RowCol<double> >& imagePts) const
+{
+    imagePts.resize(numPoints);
+    if (numPoints == 0)
+    {
+        return;
+    }
+
+    std::vector<double> x(numPoints);
+    std::vector<double> y(numPoints);
+    std::vector<double> z(numPoints);
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        x[ii] = groundPts[ii].x;
+        y[ii] = groundPts[ii].y;
+        z[ii] = groundPts[ii].z;
+    }
+
+    std::vector<double> rows(numPoints);
+    std::vector<double> cols(numPoints);
+    mProjection->sceneToImage(&x[0], &y[0], &z[0], numPoints,
+                              scene::AdjustableParams(), 1,
+                              &rows[0], &cols[0], NULL, true);
+    for (size_t ii = 0; ii < numPoints; ++ii)
+    {
+        imagePts[ii].row = rows[ii];
+        imagePts[ii].col = cols[ii];
+    }
+}
+
+void SIXSensorModel::groundToImage(const csm::EcefCoord* groundPts,
+                                   size_t numPoints,
+                                   size_t numThreads,
+                                   csm::ImageCoord* imagePts) const
+{
+    try
+    {
+        if (numThreads > 1 && numPoints > 1)
         {
-            groundPartials[0][ii] /= ss.row;
-            groundPartials[1][ii] /= ss.col;
+            runBatch(GroundToImageBatch<csm::EcefCoord, csm::ImageCoord>(
+                             *this, groundPts, imagePts),
+                     numPoints, numThreads);
+            return;
         }
 
-        for (size_t ii = 0; ii < 7; ++ii)
+        std::vector<types::RowCol<double> > imageGridPts;
+        groundToImageGrid(groundPts, numPoints, imageGridPts);
+        for (size_t ii = 0; ii < numPoints; ++ii)
         {
-            sensorPartials[0][ii] /= ss.row;
-            sensorPartials[1][ii] /= ss.col;
+            imagePts[ii] = toImageCoord(toPixel(imageGridPts[ii]));
         }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::groundToImage");
+    }
+}
 
-        math::linear::MatrixMxN<3, 3> B(0.0);
-        B.addInPlace(groundPartials, 0, 0);
-        B[2][0] = 2 * groundPt.x / square(a + height);
-        B[2][1] = 2 * groundPt.y / square(a + height);
-        B[2][2] = 2 * groundPt.z / square(b + height);
+void SIXSensorModel::groundToImage(const csm::EcefCoordCovar* groundPts,
+                                   size_t numPoints,
+                                   size_t numThreads,
+                                   csm::ImageCoordCovar* imagePts) const
+{
+    try
+    {
+        if (numThreads > 1 && numPoints > 1)
+        {
+            runBatch(GroundToImageBatch<csm::EcefCoordCovar,
+                                        csm::ImageCoordCovar>(
+                             *this, groundPts, imagePts),
+                     numPoints, numThreads);
+            return;
+        }
 
-        math::linear::MatrixMxN<3, 10> A(0.0);
-        A[2][2] = -2.0 * ((square(groundPt.x) + square(groundPt.y)) /
-                          cube(a + height) +
-                  square(groundPt.z) / cube(b + height));
-        A.addInPlace(sensorPartials, 0, 3);
-        A[0][0] = A[1][1] = 1.0;
+        // The projection only needs the coordinates
+        const std::vector<csm::EcefCoord> coords(groundPts,
+                                                 groundPts + numPoints);
+        std::vector<types::RowCol<double> > imageGridPts;
+        groundToImageGrid(numPoints ? &coords[0] : NULL, numPoints,
+                          imageGridPts);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            imagePts[ii] = toImageCoordCovar(groundPts[ii], imageGridPts[ii]);
+        }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::groundToImage");
+    }
+}
 
-        const math::linear::MatrixMxN<3, 3> Q = A * fullCovar * A.transpose();
+void SIXSensorModel::imageToGround(const csm::ImageCoord* imagePts,
+                                   size_t numPoints,
+                                   double height,
+                                   size_t numThreads,
+                                   csm::EcefCoord* groundPts) const
+{
+    try
+    {
+        if (numThreads > 1 && numPoints > 1)
+        {
+            runBatch(ImageToGroundBatch(*this, imagePts, height, groundPts),
+                     numPoints, numThreads);
+            return;
+        }
 
-        const math::linear::MatrixMxN<3, 3> Qinv = inverse(Q);
+        if (numPoints == 0)
+        {
+            return;
+        }
 
-        const math::linear::MatrixMxN<3, 3> imageToGroundCovarInv =
-                B.transpose() * Qinv * B;
+        std::vector<double> rows(numPoints);
+        std::vector<double> cols(numPoints);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            const types::RowCol<double> imagePtMeters =
+                    fromPixel(imagePts[ii]);
+            rows[ii] = imagePtMeters.row;
+            cols[ii] = imagePtMeters.col;
+        }
 
-        const math::linear::MatrixMxN<3, 3> errorCovar =
-                inverse(imageToGroundCovarInv);
+        std::vector<double> x(numPoints);
+        std::vector<double> y(numPoints);
+        std::vector<double> z(numPoints);
+        mProjection->imageToScene(&rows[0], &cols[0], numPoints, height,
+                                  scene::AdjustableParams(), 1,
+                                  &x[0], &y[0], &z[0],
+                                  1.0, 3, true);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            groundPts[ii] = csm::EcefCoord(x[ii], y[ii], z[ii]);
+        }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::imageToGround");
+    }
+}
 
-        csm::EcefCoordCovar csmErrorCovar;
-        csmErrorCovar.x = groundPt.x;
-        csmErrorCovar.y = groundPt.y;
-        csmErrorCovar.z = groundPt.z;
-        for (size_t ii = 0; ii < 3; ++ii)
+void SIXSensorModel::imageToGround(const csm::ImageCoordCovar* imagePts,
+                                   size_t numPoints,
+                                   double height,
+                                   double heightVariance,
+                                   size_t numThreads,
+                                   csm::EcefCoordCovar* groundPts) const
+{
+    try
+    {
+        if (numThreads > 1 && numPoints > 1)
         {
-            for (size_t jj = 0; jj < 3; ++jj)
-            {
-                csmErrorCovar.covariance[ii * 3 + jj] = errorCovar[ii][jj];
-            }
+            runBatch(ImageToGroundCovarBatch(*this, imagePts, height,
+                                             heightVariance, groundPts),
+                     numPoints, numThreads);
+            return;
         }
 
-        return csmErrorCovar;
+        const std::vector<csm::ImageCoord> coords(imagePts,
+                                                  imagePts + numPoints);
+        std::vector<csm::EcefCoord> groundCoords(numPoints);
+        imageToGround(numPoints ? &coords[0] : NULL, numPoints, height, 1,
+                      numPoints ? &groundCoords[0] : NULL);
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            groundPts[ii] = toEcefCoordCovar(imagePts[ii], height,
+                                             heightVariance,
+                                             toVector3(groundCoords[ii]));
+        }
     }
     catch (const except::Exception& ex)
     {
@@ -847,6 +1263,51 @@ csm::EcefCoordCovar SIXSensorModel::imageToGround(
     }
 }
 
+void SIXSensorModel::computeGroundPartials(const csm::EcefCoord* groundPts,
+                                           size_t numPoints,
+                                           size_t numThreads,
+                                           double* partials) const
+{
+    try
+    {
+        if (numThreads > 1 && numPoints > 1)
+        {
+            runBatch(GroundPartialsBatch(*this, groundPts, partials),
+                     numPoints, numThreads);
+            return;
+        }
+
+        std::vector<types::RowCol<double> > imageGridPts;
+        groundToImageGrid(groundPts, numPoints, imageGridPts);
+
+        // sceneToImageAnalyticPartials() return value is in m/m,
+        // computeGroundPartials wants pixels/m
+        const types::RowCol<double> ss = getSampleSpacing();
+        math::linear::MatrixMxN<2, 3> groundPartials;
+        math::linear::MatrixMxN<2, 7> sensorPartials;
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            mProjection->sceneToImageAnalyticPartials(toVector3(groundPts[ii]),
+                                                      imageGridPts[ii],
+                                                      groundPartials,
+                                                      sensorPartials);
+            double* const pointPartials = partials + 6 * ii;
+            pointPartials[0] = groundPartials[0][0] / ss.row;
+            pointPartials[1] = groundPartials[0][1] / ss.row;
+            pointPartials[2] = groundPartials[0][2] / ss.row;
+            pointPartials[3] = groundPartials[1][0] / ss.col;
+            pointPartials[4] = groundPartials[1][1] / ss.col;
+            pointPartials[5] = groundPartials[1][2] / ss.col;
+        }
+    }
+    catch (const except::Exception& ex)
+    {
+        throw csm::Error(csm::Error::UNKNOWN_ERROR,
+                           ex.getMessage(),
+                           "SIXSensorModel::computeGroundPartials");
+    }
+}
+
 csm::EcefLocus SIXSensorModel::imageToRemoteImagingLocus(
         const csm::ImageCoord& ,
         double ,
@@ -19,6 +19,8 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -28,9 +30,11 @@
 #include <six/Utilities.h>
 #include <six/sicd/ComplexXMLControl.h>
 #include <six/sicd/Utilities.h>
+#include <six/csm/SIXSensorModel.h>
 #include "utilities.h"
 
 // CSM includes
+#include <Error.h>
 #include <RasterGM.h>
 #include <Plugin.h>
 #include <NitfIsd.h>
@@ -70,7 +74,170 @@ public:
                 mComplexData.get(), mXmlRegistry));
     }
 
+    bool testModelState()
+    {
+        bool testPassed = true;
+
+        std::auto_ptr<csm::RasterGM> model(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromISD(csm::Isd(mSicdPathname),
+                                              MODEL_NAME)));
+
+        const six::SCP scp = mComplexData->geoData->scp;
+        const csm::EcefCoord groundPt(scp.ecf[0], scp.ecf[1], scp.ecf[2]);
+        const csm::ImageCoord expected = model->groundToImage(groundPt, 0);
+
+        // The XML form is still accepted
+        const std::string xmlState = std::string(MODEL_NAME) + " " +
+                six::toXMLString(mComplexData.get(), &mXmlRegistry);
+        std::auto_ptr<csm::RasterGM> xmlModel(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromState(xmlState)));
+        if (!matches(xmlModel->groundToImage(groundPt, 0), expected))
+        {
+            std::cerr << "Model restored from XML state differs\n";
+            testPassed = false;
+        }
+
+        // Adjustments should survive a round trip through the binary state
+        if (model->getNumParameters() > 0)
+        {
+            model->setParameterValue(0, 1.5);
+        }
+        const csm::ImageCoord adjusted = model->groundToImage(groundPt, 0);
+
+        const std::string state = model->getModelState();
+        if (state.length() >= xmlState.length())
+        {
+            std::cerr << "Binary state isn't smaller than the XML state\n";
+            testPassed = false;
+        }
+
+        std::auto_ptr<csm::RasterGM> restored(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromState(state)));
+        if (!matches(restored->groundToImage(groundPt, 0), adjusted) ||
+            restored->getNumParameters() != model->getNumParameters() ||
+            restored->getImageIdentifier() != model->getImageIdentifier() ||
+            restored->getReferenceDateAndTime() !=
+                    model->getReferenceDateAndTime() ||
+            restored->getModelState() != state)
+        {
+            std::cerr << "Model restored from binary state differs\n";
+            testPassed = false;
+        }
+
+        // A truncated state should be rejected rather than misread
+        try
+        {
+            std::auto_ptr<csm::Model> truncated(mPlugin.constructModelFromState(
+                    state.substr(0, state.length() - 1)));
+            std::cerr << "Truncated state was accepted\n";
+            testPassed = false;
+        }
+        catch (const csm::Error& )
+        {
+        }
+
+        return testPassed;
+    }
+
+    bool testBatch()
+    {
+        bool testPassed = true;
+
+        std::auto_ptr<csm::RasterGM> model(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromISD(csm::Isd(mSicdPathname),
+                                              MODEL_NAME)));
+        const six::CSM::SIXSensorModel& sixModel =
+                static_cast<const six::CSM::SIXSensorModel&>(*model);
+
+        // A grid of points around the SCP
+        const six::RowColInt scpPixel(
+                mComplexData->imageData->scpPixel.row -
+                        mComplexData->imageData->firstRow,
+                mComplexData->imageData->scpPixel.col -
+                        mComplexData->imageData->firstCol);
+        const double height = mComplexData->geoData->scp.llh.getAlt();
+        std::vector<csm::ImageCoordCovar> imagePts;
+        for (int row = -20; row <= 20; row += 2)
+        {
+            for (int col = -20; col <= 20; col += 2)
+            {
+                double covariance[] = {0.5, 0.1, 0.1, 0.4};
+                imagePts.push_back(csm::ImageCoordCovar(
+                        scpPixel.row + row, scpPixel.col + col, covariance));
+            }
+        }
+        const size_t numPoints = imagePts.size();
+        const size_t numThreads = 3;
+
+        std::vector<csm::EcefCoordCovar> groundPts(numPoints);
+        sixModel.imageToGround(&imagePts[0], numPoints, height, 2.0,
+                               numThreads, &groundPts[0]);
+
+        std::vector<csm::ImageCoordCovar> roundTrip(numPoints);
+        sixModel.groundToImage(&groundPts[0], numPoints, numThreads,
+                               &roundTrip[0]);
+
+        // The batch methods step through plain arrays, so the covariance
+        // points can't be passed where ground points are expected
+        const std::vector<csm::EcefCoord> plainGroundPts(groundPts.begin(),
+                                                         groundPts.end());
+        std::vector<double> partials(6 * numPoints);
+        sixModel.computeGroundPartials(&plainGroundPts[0], numPoints,
+                                       numThreads, &partials[0]);
+
+        for (size_t ii = 0; ii < numPoints; ++ii)
+        {
+            const csm::EcefCoordCovar groundPt =
+                    model->imageToGround(imagePts[ii], height, 2.0);
+            const csm::ImageCoordCovar imagePt =
+                    model->groundToImage(groundPts[ii]);
+            const std::vector<double> pointPartials =
+                    model->computeGroundPartials(groundPts[ii]);
+
+            // The batch projections start from neighboring points' solutions
+            // so only agree to within the convergence tolerances
+            if (std::abs(groundPts[ii].x - groundPt.x) > 1e-3 ||
+                std::abs(groundPts[ii].y - groundPt.y) > 1e-3 ||
+                std::abs(groundPts[ii].z - groundPt.z) > 1e-3 ||
+                !matches(roundTrip[ii], imagePt) ||
+                !matches(roundTrip[ii], imagePts[ii], 1e-3) ||
+                !matches(groundPts[ii].covariance, groundPt.covariance, 9) ||
+                !matches(roundTrip[ii].covariance, imagePt.covariance, 4) ||
+                !matches(&partials[6 * ii], &pointPartials[0], 6))
+            {
+                std::cerr << "Batch projection differs at point " << ii
+                          << "\n";
+                testPassed = false;
+                break;
+            }
+        }
+
+        return testPassed;
+    }
+
 private:
+    static
+    bool matches(const double* lhs, const double* rhs, size_t size)
+    {
+        for (size_t ii = 0; ii < size; ++ii)
+        {
+            if (std::abs(lhs[ii] - rhs[ii]) >
+                1e-6 * std::max(1.0, std::abs(rhs[ii])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static
+    bool matches(const csm::ImageCoord& lhs, const csm::ImageCoord& rhs,
+                 double tolerance = 1e-6)
+    {
+        return (std::abs(lhs.line - rhs.line) < tolerance &&
+                std::abs(lhs.samp - rhs.samp) < tolerance);
+    }
+
     scene::Vector3 imageToGround(const csm::RasterGM& model,
             const six::RowColInt& scpPixel, double height, double offset)
     {
@@ -252,7 +419,8 @@ int main(int argc, char** argv)
         }
 
         Test test(sicdPathname, confDir, plugin);
-        const bool testPassed = test.testFileISD() && test.testNitfISD();
+        const bool testPassed = test.testFileISD() && test.testNitfISD() &&
+                test.testModelState() && test.testBatch();
 
         return testPassed ? 0 : 1;
     }
@@ -19,6 +19,7 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <cmath>
 #include <iostream>
 #include <sstream>
 
@@ -31,6 +32,7 @@
 #include <scene/ECEFToLLATransform.h>
 
 // CSM includes
+#include <Error.h>
 #include <RasterGM.h>
 #include <Plugin.h>
 #include <NitfIsd.h>
@@ -76,7 +78,81 @@ public:
         return testISD(*nitfIsd);
     }
 
+    bool testModelState()
+    {
+        bool testPassed = true;
+
+        std::auto_ptr<csm::RasterGM> model(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromISD(csm::Isd(mSiddPathname),
+                                              MODEL_NAME)));
+
+        const six::Vector3 scp = mDerivedData->measurement->projection->
+                referencePoint.ecef;
+        const csm::EcefCoord groundPt(scp[0], scp[1], scp[2]);
+        const csm::ImageCoord expected = model->groundToImage(groundPt, 0);
+
+        // The XML form is still accepted
+        const std::string xmlState = std::string(MODEL_NAME) + " " +
+                six::toXMLString(mDerivedData.get(), &mXmlRegistry);
+        std::auto_ptr<csm::RasterGM> xmlModel(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromState(xmlState)));
+        if (!matches(xmlModel->groundToImage(groundPt, 0), expected))
+        {
+            std::cerr << "Model restored from XML state differs\n";
+            testPassed = false;
+        }
+
+        // Adjustments should survive a round trip through the binary state
+        if (model->getNumParameters() > 0)
+        {
+            model->setParameterValue(0, 1.5);
+        }
+        const csm::ImageCoord adjusted = model->groundToImage(groundPt, 0);
+
+        const std::string state = model->getModelState();
+        if (state.length() >= xmlState.length())
+        {
+            std::cerr << "Binary state isn't smaller than the XML state\n";
+            testPassed = false;
+        }
+
+        std::auto_ptr<csm::RasterGM> restored(reinterpret_cast<csm::RasterGM*>(
+                mPlugin.constructModelFromState(state)));
+        if (!matches(restored->groundToImage(groundPt, 0), adjusted) ||
+            restored->getNumParameters() != model->getNumParameters() ||
+            restored->getImageIdentifier() != model->getImageIdentifier() ||
+            restored->getReferenceDateAndTime() !=
+                    model->getReferenceDateAndTime() ||
+            restored->getModelState() != state)
+        {
+            std::cerr << "Model restored from binary state differs\n";
+            testPassed = false;
+        }
+
+        // A truncated state should be rejected rather than misread
+        try
+        {
+            std::auto_ptr<csm::Model> truncated(mPlugin.constructModelFromState(
+                    state.substr(0, state.length() - 1)));
+            std::cerr << "Truncated state was accepted\n";
+            testPassed = false;
+        }
+        catch (const csm::Error& )
+        {
+        }
+
+        return testPassed;
+    }
+
 private:
+    static
+    bool matches(const csm::ImageCoord& lhs, const csm::ImageCoord& rhs)
+    {
+        const double tolerance = 1e-6;
+        return (std::abs(lhs.line - rhs.line) < tolerance &&
+                std::abs(lhs.samp - rhs.samp) < tolerance);
+    }
+
     scene::Vector3 imageToGround(const csm::RasterGM& model,
             const six::RowColDouble& scpPixel, double height, double offset)
     {
@@ -269,7 +345,8 @@ int main(int argc, char** argv)
         }
 
         Test test(siddPathname, confDir, plugin);
-        const bool testPassed = test.testFileISD() && test.testNitfISD();
+        const bool testPassed = test.testFileISD() && test.testNitfISD() &&
+                test.testModelState();
 
         return testPassed ? 0 : 1;
     }